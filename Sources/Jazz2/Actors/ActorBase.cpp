@@ -170,10 +170,10 @@ namespace Jazz2::Actors
 		// Objects should override this if they need to.
 	}
 
-	bool ActorBase::OnHandleCollision(std::shared_ptr<ActorBase> other)
+	bool ActorBase::OnHandleCollision(ActorBase* other)
 	{
 		if (GetState(ActorState::CanBeFrozen)) {
-			HandleFrozenStateChange(other.get());
+			HandleFrozenStateChange(other);
 		}
 		return false;
 	}
@@ -240,9 +240,15 @@ namespace Jazz2::Actors
 				// Not doing this will cause hiccups with uphill slopes in particular.
 				// Beach tileset also has some spots where two properly set up adjacent
 				// tiles have a 2px jump, so adapt to that.
+				// Offsets blocked by tiles are skipped with a single query, so the full check is performed only once in most cases.
 				bool success = false;
 				float maxYDiff = std::max(3.0f, std::abs(effectiveSpeedX) + 2.5f);
-				for (float yDiff = maxYDiff + effectiveSpeedY; yDiff >= -maxYDiff + effectiveSpeedY; yDiff -= CollisionCheckStep) {
+				float minYDiff = -maxYDiff + effectiveSpeedY;
+				for (float yDiff = maxYDiff + effectiveSpeedY; ; yDiff -= CollisionCheckStep) {
+					yDiff = _levelHandler->FindFirstEmptyOffsetY(this, effectiveSpeedX, yDiff, minYDiff, CollisionCheckStep, params);
+					if (yDiff < minYDiff) {
+						break;
+					}
 					if (MoveInstantly(Vector2f(effectiveSpeedX, yDiff), MoveType::Relative, params)) {
 						success = true;
 						break;
@@ -857,13 +863,13 @@ namespace Jazz2::Actors
 			}
 
 			//PixelData p;
-			uint8_t* p;
+			const uint8_t* p;
 			GraphicResource* res;
 			bool isFacingLeftCurrent;
 			std::int32_t x1, y1, x2, y2, xs, dx, dy, stride;
 			if (perPixel1) {
 				res = res1;
-				p = res->Base->Mask.get();
+				p = res->Base->Mask;
 
 				isFacingLeftCurrent = GetState(ActorState::IsFacingLeft);
 
@@ -880,7 +886,7 @@ namespace Jazz2::Actors
 
 			} else {
 				res = res2;
-				p = res->Base->Mask.get();
+				p = res->Base->Mask;
 
 				isFacingLeftCurrent = other->GetState(ActorState::IsFacingLeft);
 
@@ -931,8 +937,8 @@ namespace Jazz2::Actors
 			std::int32_t stride2 = res2->Base->FrameConfiguration.X * res2->Base->FrameDimensions.X;
 
 			// Per-pixel collision check
-			auto p1 = res1->Base->Mask.get();
-			auto p2 = res2->Base->Mask.get();
+			auto p1 = res1->Base->Mask;
+			auto p2 = res2->Base->Mask;
 
 			for (std::int32_t i = x1; i < x2; i += PerPixelCollisionStep) {
 				for (std::int32_t j = y1; j < y2; j += PerPixelCollisionStep) {
@@ -1002,7 +1008,7 @@ namespace Jazz2::Actors
 		std::int32_t stride = res->Base->FrameConfiguration.X * res->Base->FrameDimensions.X;
 
 		// Per-pixel collision check
-		auto p = res->Base->Mask.get();
+		auto p = res->Base->Mask;
 
 		for (std::int32_t i = x1; i < x2; i += PerPixelCollisionStep) {
 			for (std::int32_t j = y1; j < y2; j += PerPixelCollisionStep) {
@@ -1097,8 +1103,8 @@ namespace Jazz2::Actors
 		std::int32_t dy2 = (frame2 / res2->Base->FrameConfiguration.X) * res2->Base->FrameDimensions.Y;
 		std::int32_t stride2 = res2->Base->FrameConfiguration.X * res2->Base->FrameDimensions.X;
 
-		auto p1 = res1->Base->Mask.get();
-		auto p2 = res2->Base->Mask.get();
+		auto p1 = res1->Base->Mask;
+		auto p2 = res2->Base->Mask;
 
 		for (std::int32_t y1 = 0; y1 < height1; y1 += PerPixelCollisionStep) {
 			Vector3f posIn2 = yPosIn2;
@@ -1167,7 +1173,7 @@ namespace Jazz2::Actors
 		std::int32_t dy = (frame / res->Base->FrameConfiguration.X) * res->Base->FrameDimensions.Y;
 		std::int32_t stride = res->Base->FrameConfiguration.X * res->Base->FrameDimensions.X;
 
-		auto p = res->Base->Mask.get();
+		auto p = res->Base->Mask;
 
 		for (std::int32_t y1 = 0; y1 < height; y1 += PerPixelCollisionStep) {
 			Vector3f posInAABB = yPosInAABB;
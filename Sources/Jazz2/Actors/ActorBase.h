@@ -87,7 +87,8 @@ namespace Jazz2::Actors
 		/** @brief Actor is facing left */
 		IsFacingLeft = 0x1000,
 
-		//Reserved = 0x2000,
+		/** @brief Actor emits lights, it has to be set before the actor is added to the level, otherwise @ref ActorBase::OnEmitLights() is never called */
+		EmitsLights = 0x2000,
 
 		/** @brief Actor should be preserved when state is rolled back to checkpoint */
 		PreserveOnRollback = 0x4000,
@@ -199,8 +200,13 @@ namespace Jazz2::Actors
 
 		/** @brief Called after the object is created */
 		Task<bool> OnActivated(const ActorActivationDetails& details);
-		/** @brief Called when the object collides with another object */
-		virtual bool OnHandleCollision(std::shared_ptr<ActorBase> other);
+		/**
+		 * @brief Called when the object collides with another object
+		 *
+		 * The other object is only borrowed for the duration of the call. Destroyed objects are removed later,
+		 * so the pointer stays valid, but it must not be stored.
+		 */
+		virtual bool OnHandleCollision(ActorBase* other);
 		/** @brief Called to check whether @p collider can cause damage to the object */
 		virtual bool CanCauseDamage(ActorBase* collider);
 
@@ -371,7 +377,7 @@ namespace Jazz2::Actors
 		virtual void OnUpdateHitbox();
 		/** @brief Called when the object needs to be drawn */
 		virtual bool OnDraw(RenderQueue& renderQueue);
-		/** @brief Called when emitting lights */
+		/** @brief Called when emitting lights, only if @ref ActorState::EmitsLights is set and the actor is near any viewport */
 		virtual void OnEmitLights(SmallVectorImpl<LightEmitter>& lights) { }
 		/** @brief Called when the object hits a floor */
 		virtual void OnHitFloor(float timeMult);
@@ -438,7 +444,7 @@ namespace Jazz2::Actors
 					return false;
 				}
 				void await_suspend(std::coroutine_handle<> handle) {
-					// TODO: implement async
+					// Activation is driven synchronously, preloaded metadata only has to be finished here
 					auto metadata = ContentResolver::Get().RequestMetadata(path);
 					actor->_metadata = metadata;
 					handle();
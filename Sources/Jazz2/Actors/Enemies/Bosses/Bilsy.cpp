@@ -221,7 +221,7 @@ namespace Jazz2::Actors::Bosses
 		SetFacingLeft(details.Params[1] != 0);
 		_timeLeft = 90.0f;
 
-		SetState(ActorState::IsInvulnerable, true);
+		SetState(ActorState::IsInvulnerable | ActorState::EmitsLights, true);
 		SetState(ActorState::CanBeFrozen | ActorState::ApplyGravitation, false);
 		CanCollideWithShots = false;
 
@@ -276,13 +276,13 @@ namespace Jazz2::Actors::Bosses
 		light.RadiusFar = 30.0f;
 	}
 
-	bool Bilsy::Fireball::OnHandleCollision(std::shared_ptr<ActorBase> other)
+	bool Bilsy::Fireball::OnHandleCollision(ActorBase* other)
 	{
-		if (auto* player = runtime_cast<Player>(other.get())) {
+		if (auto* player = runtime_cast<Player>(other)) {
 			DecreaseHealth(INT32_MAX);
 		}
 
-		return ActorBase::OnHandleCollision(std::move(other));
+		return ActorBase::OnHandleCollision(other);
 	}
 
 	bool Bilsy::Fireball::OnPerish(ActorBase* collider)
@@ -33,7 +33,7 @@ namespace Jazz2::Actors::Bosses
 			DEATH_RUNTIME_OBJECT(EnemyBase);
 
 		public:
-			bool OnHandleCollision(std::shared_ptr<ActorBase> other) override;
+			bool OnHandleCollision(ActorBase* other) override;
 
 		protected:
 			Task<bool> OnActivatedAsync(const ActorActivationDetails& details) override;
@@ -288,7 +288,7 @@ namespace Jazz2::Actors::Bosses
 		_speed.X = (IsFacingLeft() ? -4.8f : 4.8f);
 		_timeLeft = 50.0f;
 
-		SetState(ActorState::IsInvulnerable, true);
+		SetState(ActorState::IsInvulnerable | ActorState::EmitsLights, true);
 		SetState(ActorState::CanBeFrozen | ActorState::ApplyGravitation, false);
 		CanCollideWithShots = false;
 
@@ -326,13 +326,13 @@ namespace Jazz2::Actors::Bosses
 		light.RadiusFar = 30.0f;
 	}
 
-	bool Bubba::Fireball::OnHandleCollision(std::shared_ptr<ActorBase> other)
+	bool Bubba::Fireball::OnHandleCollision(ActorBase* other)
 	{
-		if (auto* player = runtime_cast<Player>(other.get())) {
+		if (auto* player = runtime_cast<Player>(other)) {
 			DecreaseHealth(INT32_MAX);
 		}
 
-		return ActorBase::OnHandleCollision(std::move(other));
+		return ActorBase::OnHandleCollision(other);
 	}
 
 	bool Bubba::Fireball::OnPerish(ActorBase* collider)
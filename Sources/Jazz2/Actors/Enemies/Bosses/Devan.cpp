@@ -516,7 +516,7 @@ namespace Jazz2::Actors::Bosses
 		SetFacingLeft(details.Params[0] != 0);
 		_speed.X = (IsFacingLeft() ? -8.0f : 8.0f);
 
-		SetState(ActorState::IsInvulnerable, true);
+		SetState(ActorState::IsInvulnerable | ActorState::EmitsLights, true);
 		SetState(ActorState::CanBeFrozen | ActorState::ApplyGravitation, false);
 		CanCollideWithShots = false;
 
@@ -579,7 +579,7 @@ namespace Jazz2::Actors::Bosses
 		_speed.Y = 3.5f;
 		_timeLeft = 50.0f;
 
-		SetState(ActorState::IsInvulnerable, true);
+		SetState(ActorState::IsInvulnerable | ActorState::EmitsLights, true);
 		SetState(ActorState::CanBeFrozen | ActorState::ApplyGravitation, false);
 
 		_health = INT32_MAX;
@@ -212,7 +212,7 @@ namespace Jazz2::Actors::Bosses
 	{
 		SetFacingLeft(details.Params[0] != 0);
 
-		SetState(ActorState::IsInvulnerable | ActorState::SkipPerPixelCollisions, true);
+		SetState(ActorState::IsInvulnerable | ActorState::SkipPerPixelCollisions | ActorState::EmitsLights, true);
 		SetState(ActorState::CanBeFrozen, false);
 		CanCollideWithShots = false;
 
@@ -132,7 +132,7 @@ namespace Jazz2::Actors::Enemies
 
 	Task<bool> Dragon::Fire::OnActivatedAsync(const ActorActivationDetails& details)
 	{
-		SetState(ActorState::IsInvulnerable, true);
+		SetState(ActorState::IsInvulnerable | ActorState::EmitsLights, true);
 		SetState(ActorState::CanBeFrozen | ActorState::ApplyGravitation, false);
 		// Collide with player ammo if Reforged
 		CanCollideWithShots = _levelHandler->IsReforged();
@@ -170,7 +170,7 @@ namespace Jazz2::Actors::Enemies
 		UpdateHitbox(8, 8);
 	}
 
-	bool MadderHatter::BulletSpit::OnHandleCollision(std::shared_ptr<ActorBase> other)
+	bool MadderHatter::BulletSpit::OnHandleCollision(ActorBase* other)
 	{
 		return false;
 	}
@@ -118,11 +118,11 @@ namespace Jazz2::Actors::Enemies
 		return EnemyBase::OnPerish(collider);
 	}
 
-	bool TurtleShell::OnHandleCollision(std::shared_ptr<ActorBase> other)
+	bool TurtleShell::OnHandleCollision(ActorBase* other)
 	{
 		EnemyBase::OnHandleCollision(other);
 
-		if (auto* shotBase = runtime_cast<Weapons::ShotBase>(other.get())) {
+		if (auto* shotBase = runtime_cast<Weapons::ShotBase>(other)) {
 			if (shotBase->GetStrength() > 0) {
 				if (runtime_cast<Weapons::FreezerShot>(shotBase)) {
 					return false;
@@ -148,7 +148,7 @@ namespace Jazz2::Actors::Enemies
 
 				PlaySfx("Fly"_s);
 			}
-		} else if (auto* shell = runtime_cast<TurtleShell>(other.get())) {
+		} else if (auto* shell = runtime_cast<TurtleShell>(other)) {
 			auto otherSpeed = shell->GetSpeed();
 			if (std::abs(otherSpeed.Y - _speed.Y) > 1.0f && otherSpeed.Y > 0.0f) {
 				DecreaseHealth(10, this);
@@ -164,7 +164,7 @@ namespace Jazz2::Actors::Enemies
 				PlaySfx("ImpactShell"_s, 0.8f);
 				return true;
 			}
-		} else if (auto* enemyBase = runtime_cast<EnemyBase>(other.get())) {
+		} else if (auto* enemyBase = runtime_cast<EnemyBase>(other)) {
 			if (enemyBase->CanCollideWithShots) {
 				float absSpeed = std::abs(_speed.X);
 				if (absSpeed > 2.0f) {
@@ -175,21 +175,21 @@ namespace Jazz2::Actors::Enemies
 					}
 				}
 			}
-		} else if (auto* crateContainer = runtime_cast<Solid::CrateContainer>(other.get())) {
+		} else if (auto* crateContainer = runtime_cast<Solid::CrateContainer>(other)) {
 			float absSpeed = std::abs(_speed.X);
 			if (absSpeed > 2.0f) {
 				_speed.X = std::max(absSpeed, 2.0f) * (_speed.X >= 0.0f ? -1.0f : 1.0f);
 				crateContainer->DecreaseHealth(1, this);
 				return true;
 			}
-		} else if (auto* ammoCrate = runtime_cast<Solid::AmmoCrate>(other.get())) {
+		} else if (auto* ammoCrate = runtime_cast<Solid::AmmoCrate>(other)) {
 			float absSpeed = std::abs(_speed.X);
 			if (absSpeed > 2.0f) {
 				_speed.X = std::max(absSpeed, 2.0f) * (_speed.X >= 0.0f ? -1.0f : 1.0f);
 				ammoCrate->DecreaseHealth(1, this);
 				return true;
 			}
-		} else if (auto* gemCrate = runtime_cast<Solid::GemCrate>(other.get())) {
+		} else if (auto* gemCrate = runtime_cast<Solid::GemCrate>(other)) {
 			float absSpeed = std::abs(_speed.X);
 			if (absSpeed > 2.0f) {
 				_speed.X = std::max(absSpeed, 2.0f) * (_speed.X >= 0.0f ? -1.0f : 1.0f);
@@ -143,7 +143,7 @@ namespace Jazz2::Actors::Enemies
 
 	Task<bool> Witch::MagicBullet::OnActivatedAsync(const ActorActivationDetails& details)
 	{
-		SetState(ActorState::IsInvulnerable | ActorState::SkipPerPixelCollisions, true);
+		SetState(ActorState::IsInvulnerable | ActorState::SkipPerPixelCollisions | ActorState::EmitsLights, true);
 		SetState(ActorState::CanBeFrozen | ActorState::CollideWithTileset | ActorState::ApplyGravitation, false);
 
 		_health = INT32_MAX;
@@ -172,9 +172,9 @@ namespace Jazz2::Actors::Enemies
 		UpdateHitbox(10, 10);
 	}
 
-	bool Witch::MagicBullet::OnHandleCollision(std::shared_ptr<ActorBase> other)
+	bool Witch::MagicBullet::OnHandleCollision(ActorBase* other)
 	{
-		if (auto* player = runtime_cast<Player>(other.get())) {
+		if (auto* player = runtime_cast<Player>(other)) {
 			DecreaseHealth(INT32_MAX);
 			_owner->OnPlayerHit();
 
@@ -17,7 +17,7 @@ namespace Jazz2::Actors::Environment
 	public:
 		Bird();
 
-		bool OnHandleCollision(std::shared_ptr<ActorBase> other) override;
+		bool OnHandleCollision(ActorBase* other) override;
 
 		static void Preload(const ActorActivationDetails& details);
 
@@ -132,9 +132,9 @@ namespace Jazz2::Actors::Environment
 		UpdateHitbox(50, 50);
 	}
 
-	bool RollingRock::OnHandleCollision(std::shared_ptr<ActorBase> other)
+	bool RollingRock::OnHandleCollision(ActorBase* other)
 	{
-		if (auto* rollingRock = runtime_cast<RollingRock>(other.get())) {
+		if (auto* rollingRock = runtime_cast<RollingRock>(other)) {
 			float dx = (rollingRock->_pos.X - _pos.X);
 			float dy = (rollingRock->_pos.Y - _pos.Y);
 			float distance = Vector2f(dx, dy).Length();
@@ -163,7 +163,7 @@ namespace Jazz2::Actors::Environment
 				SetState(ActorState::CanBeFrozen, true);
 			}
 			return true;
-		} else if (auto* player = runtime_cast<Player>(other.get())) {
+		} else if (auto* player = runtime_cast<Player>(other)) {
 			if (_triggered) {
 				float dx = (player->GetPos().X - _pos.X);
 				float dy = (player->GetPos().Y - _pos.Y);
@@ -190,7 +190,7 @@ namespace Jazz2::Actors::Environment
 			}
 		}
 
-		return EnemyBase::OnHandleCollision(std::move(other));
+		return EnemyBase::OnHandleCollision(other);
 	}
 
 	void RollingRock::OnTriggeredEvent(EventType eventType, std::uint8_t* eventParams)
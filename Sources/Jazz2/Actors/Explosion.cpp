@@ -30,7 +30,7 @@ namespace Jazz2::Actors
 		_type = (Type)*(std::uint16_t*)&details.Params[0];
 		_scale = *(float*)&details.Params[4];
 
-		SetState(ActorState::ForceDisableCollisions, true);
+		SetState(ActorState::ForceDisableCollisions | ActorState::EmitsLights, true);
 		SetState(ActorState::CanBeFrozen | ActorState::CollideWithTileset | ActorState::CollideWithOtherActors | ActorState::ApplyGravitation, false);
 
 		async_await RequestMetadataAsync("Common/Explosions"_s);
@@ -17,7 +17,7 @@ namespace Jazz2::Actors::Lighting
 		_radiusFar = (float)*(uint16_t*)&details.Params[4];
 		_phase = 0.6f;
 
-		SetState(ActorState::ForceDisableCollisions, true);
+		SetState(ActorState::ForceDisableCollisions | ActorState::EmitsLights, true);
 		SetState(ActorState::CanBeFrozen | ActorState::CollideWithTileset | ActorState::CollideWithOtherActors | ActorState::ApplyGravitation, false);
 
 		for (std::int32_t i = 0; i < LightPartCount; i++) {
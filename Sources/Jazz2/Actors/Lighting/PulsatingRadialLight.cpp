@@ -22,7 +22,7 @@ namespace Jazz2::Actors::Lighting
 
 		_phase = sync * fPiOver2 + _speed * _levelHandler->GetElapsedFrames();
 
-		SetState(ActorState::ForceDisableCollisions, true);
+		SetState(ActorState::ForceDisableCollisions | ActorState::EmitsLights, true);
 		SetState(ActorState::CanBeFrozen | ActorState::CollideWithTileset | ActorState::CollideWithOtherActors | ActorState::ApplyGravitation, false);
 
 		async_return true;
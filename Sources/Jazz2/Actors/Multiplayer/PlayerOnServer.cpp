@@ -26,14 +26,14 @@ namespace Jazz2::Actors::Multiplayer
 		}
 	}
 
-	bool PlayerOnServer::OnHandleCollision(std::shared_ptr<ActorBase> other)
+	bool PlayerOnServer::OnHandleCollision(ActorBase* other)
 	{
 		// TODO: Check player special move here
-		if (auto* weaponOwner = MpLevelHandler::GetWeaponOwner(other.get())) {
+		if (auto* weaponOwner = MpLevelHandler::GetWeaponOwner(other)) {
 			auto* otherPlayerOnServer = static_cast<PlayerOnServer*>(weaponOwner);
 			if (_health > 0 && GetPeerDescriptor()->Team != otherPlayerOnServer->GetPeerDescriptor()->Team) {
 				bool otherIsPlayer = false;
-				if (auto* anotherPlayer = runtime_cast<PlayerOnServer>(other.get())) {
+				if (auto* anotherPlayer = runtime_cast<PlayerOnServer>(other)) {
 					bool isAttacking = IsAttacking();
 					if (!isAttacking && !anotherPlayer->IsAttacking()) {
 						return true;
@@ -50,7 +50,7 @@ namespace Jazz2::Actors::Multiplayer
 				// Decrease remaining shield time by 5 secs
 				if (_activeShieldTime > (5.0f * FrameTimer::FramesPerSecond)) {
 					_activeShieldTime -= (5.0f * FrameTimer::FramesPerSecond);
-				} else if (auto* freezerShot = runtime_cast<Weapons::FreezerShot>(other.get())) {
+				} else if (auto* freezerShot = runtime_cast<Weapons::FreezerShot>(other)) {
 					Freeze(3.0f * FrameTimer::FramesPerSecond);
 				} else {
 					TakeDamage(1, 4.0f * (_pos.X > other->GetPos().X ? 1.0f : -1.0f));
@@ -62,7 +62,7 @@ namespace Jazz2::Actors::Multiplayer
 			}
 		}
 
-		return Player::OnHandleCollision(std::move(other));
+		return Player::OnHandleCollision(other);
 	}
 
 	bool PlayerOnServer::CanCauseDamage(ActorBase* collider)
@@ -57,29 +57,29 @@ namespace Jazz2::Actors::Solid
 		async_return true;
 	}
 
-	bool AmmoCrate::OnHandleCollision(std::shared_ptr<ActorBase> other)
+	bool AmmoCrate::OnHandleCollision(ActorBase* other)
 	{
 		if (_health == 0) {
 			return GenericContainer::OnHandleCollision(other);
 		}
 
-		if (auto* shotBase = runtime_cast<Weapons::ShotBase>(other.get())) {
+		if (auto* shotBase = runtime_cast<Weapons::ShotBase>(other)) {
 			if (shotBase->GetStrength() > 0) {
 				DecreaseHealth(shotBase->GetStrength(), shotBase);
 				shotBase->DecreaseHealth(1);
 				return true;
 			}
-		} else if (auto* tnt = runtime_cast<Weapons::TNT>(other.get())) {
+		} else if (auto* tnt = runtime_cast<Weapons::TNT>(other)) {
 			DecreaseHealth(INT32_MAX, tnt);
 			return true;
-		} else if (auto* player = runtime_cast<Player>(other.get())) {
+		} else if (auto* player = runtime_cast<Player>(other)) {
 			if (player->CanBreakSolidObjects()) {
 				DecreaseHealth(INT32_MAX, player);
 				return true;
 			}
 		}
 
-		return GenericContainer::OnHandleCollision(std::move(other));
+		return GenericContainer::OnHandleCollision(other);
 	}
 
 	bool AmmoCrate::OnPerish(ActorBase* collider)
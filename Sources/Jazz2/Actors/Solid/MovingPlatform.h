@@ -13,7 +13,7 @@ namespace Jazz2::Actors::Solid
 		MovingPlatform();
 		~MovingPlatform();
 
-		bool OnHandleCollision(std::shared_ptr<ActorBase> other) override;
+		bool OnHandleCollision(ActorBase* other) override;
 
 		static void Preload(const ActorActivationDetails& details);
 
@@ -13,7 +13,7 @@ namespace Jazz2::Actors::Solid
 	public:
 		PowerUpMorphMonitor();
 
-		bool OnHandleCollision(std::shared_ptr<ActorBase> other) override;
+		bool OnHandleCollision(ActorBase* other) override;
 		bool CanCauseDamage(ActorBase* collider) override;
 
 		static void Preload(const ActorActivationDetails& details);
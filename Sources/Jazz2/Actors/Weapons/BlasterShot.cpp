@@ -23,7 +23,7 @@ namespace Jazz2::Actors::Weapons
 
 		_upgrades = details.Params[0];
 
-		SetState(ActorState::SkipPerPixelCollisions, true);
+		SetState(ActorState::SkipPerPixelCollisions | ActorState::EmitsLights, true);
 		SetState(ActorState::ApplyGravitation, false);
 
 		async_await RequestMetadataAsync("Weapon/Blaster"_s);
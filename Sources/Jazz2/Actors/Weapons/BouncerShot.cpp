@@ -21,6 +21,8 @@ namespace Jazz2::Actors::Weapons
 
 		_upgrades = details.Params[0];
 
+		SetState(ActorState::EmitsLights, true);
+
 		async_await RequestMetadataAsync("Weapon/Bouncer"_s);
 
 		AnimState state = AnimState::Idle;
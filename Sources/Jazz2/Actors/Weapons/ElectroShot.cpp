@@ -25,7 +25,7 @@ namespace Jazz2::Actors::Weapons
 		_strength = 4;
 		_timeLeft = 55;
 
-		SetState(ActorState::SkipPerPixelCollisions, true);
+		SetState(ActorState::SkipPerPixelCollisions | ActorState::EmitsLights, true);
 		SetState(ActorState::ApplyGravitation, false);
 
 		async_await RequestMetadataAsync("Weapon/Electro"_s);
@@ -150,15 +150,15 @@ namespace Jazz2::Actors::Weapons
 		}
 	}
 
-	bool ElectroShot::OnHandleCollision(std::shared_ptr<ActorBase> other)
+	bool ElectroShot::OnHandleCollision(ActorBase* other)
 	{
-		if (auto* enemyBase = runtime_cast<Enemies::EnemyBase>(other.get())) {
+		if (auto* enemyBase = runtime_cast<Enemies::EnemyBase>(other)) {
 			if (enemyBase->IsInvulnerable() || !enemyBase->CanCollideWithShots) {
 				return false;
 			}
 		}
 
-		return ShotBase::OnHandleCollision(std::move(other));
+		return ShotBase::OnHandleCollision(other);
 	}
 
 	bool ElectroShot::OnPerish(ActorBase* collider)
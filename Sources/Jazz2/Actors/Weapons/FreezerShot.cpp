@@ -24,7 +24,7 @@ namespace Jazz2::Actors::Weapons
 
 		_upgrades = details.Params[0];
 
-		SetState(ActorState::SkipPerPixelCollisions, true);
+		SetState(ActorState::SkipPerPixelCollisions | ActorState::EmitsLights, true);
 		SetState(ActorState::ApplyGravitation, false);
 		_strength = 0;
 
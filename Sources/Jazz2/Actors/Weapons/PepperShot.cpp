@@ -22,7 +22,7 @@ namespace Jazz2::Actors::Weapons
 		_upgrades = details.Params[0];
 		_strength = 1;
 
-		SetState(ActorState::SkipPerPixelCollisions, true);
+		SetState(ActorState::SkipPerPixelCollisions | ActorState::EmitsLights, true);
 		SetState(ActorState::ApplyGravitation, false);
 
 		async_await RequestMetadataAsync("Weapon/Pepper"_s);
@@ -20,6 +20,7 @@ namespace Jazz2::Actors::Weapons
 		_upgrades = details.Params[0];
 		_strength = 2;
 
+		SetState(ActorState::EmitsLights, true);
 		SetState(ActorState::ApplyGravitation, false);
 
 		async_await RequestMetadataAsync("Weapon/RF"_s);
@@ -26,6 +26,7 @@ namespace Jazz2::Actors::Weapons
 
 		_upgrades = details.Params[0];
 
+		SetState(ActorState::EmitsLights, true);
 		SetState(ActorState::ApplyGravitation, false);
 
 		async_await RequestMetadataAsync("Weapon/Seeker"_s);
@@ -21,7 +21,7 @@ namespace Jazz2::Actors::Weapons
 	{
 		async_await ShotBase::OnActivatedAsync(details);
 
-		SetState(ActorState::SkipPerPixelCollisions, true);
+		SetState(ActorState::SkipPerPixelCollisions | ActorState::EmitsLights, true);
 		SetState(ActorState::ApplyGravitation, false);
 
 		async_await RequestMetadataAsync("Weapon/ShieldFire"_s);
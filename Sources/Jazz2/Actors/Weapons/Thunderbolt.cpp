@@ -22,6 +22,7 @@ namespace Jazz2::Actors::Weapons
 		_initialLayer = _renderer.layer();
 		_strength = 2;
 		_health = INT32_MAX;
+		SetState(ActorState::EmitsLights, true);
 		SetState(ActorState::ApplyGravitation, false);
 
 		async_await RequestMetadataAsync("Weapon/Thunderbolt"_s);
@@ -148,9 +149,9 @@ namespace Jazz2::Actors::Weapons
 		DecreaseHealth(INT32_MAX);
 	}
 
-	bool Thunderbolt::OnHandleCollision(std::shared_ptr<ActorBase> other)
+	bool Thunderbolt::OnHandleCollision(ActorBase* other)
 	{
-		if (auto* enemyBase = runtime_cast<Enemies::EnemyBase>(other.get())) {
+		if (auto* enemyBase = runtime_cast<Enemies::EnemyBase>(other)) {
 			if (enemyBase->CanCollideWithShots) {
 				_hit = true;
 			}
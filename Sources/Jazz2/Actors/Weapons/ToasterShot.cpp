@@ -21,6 +21,7 @@ namespace Jazz2::Actors::Weapons
 		_strength = 1;
 		_upgrades = details.Params[0];
 
+		SetState(ActorState::EmitsLights, true);
 		SetState(ActorState::ApplyGravitation, false);
 
 		async_await RequestMetadataAsync("Weapon/Toaster"_s);
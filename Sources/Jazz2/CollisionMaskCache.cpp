@@ -0,0 +1,276 @@
+﻿#include "CollisionMaskCache.h"
+
+#include "../nCine/Base/Algorithms.h"
+#include "../nCine/Base/Random.h"
+
+#include <Cryptography/xxHash.h>
+#include <IO/FileSystem.h>
+
+using namespace Death::Cryptography;
+using namespace Death::IO;
+using namespace nCine;
+
+namespace Jazz2
+{
+	namespace
+	{
+		struct FileHeader
+		{
+			std::uint32_t Signature;
+			std::uint16_t Version;
+			std::uint16_t Reserved1;
+			std::uint32_t EntryCount;
+			std::uint32_t Reserved2;
+		};
+
+		constexpr std::uint32_t FileSignature = 0x434D324A;	// "J2MC"
+		constexpr std::uint16_t FileVersion = 2;
+		// Masks are aligned, so bit-packed tile mask rows can be accessed directly
+		constexpr std::size_t DataAlignment = 16;
+	}
+
+	struct CollisionMaskCache::MappedFile
+	{
+		Array<char, fs::MapDeleter> Data;
+		std::uint32_t EntryCount;
+	};
+
+	CollisionMaskCache::CollisionMaskCache()
+	{
+	}
+
+	CollisionMaskCache::~CollisionMaskCache()
+	{
+	}
+
+	bool CollisionMaskCache::Open(StringView path)
+	{
+		// The file is mapped as is, so the layout must match the native one
+#if !defined(DEATH_TARGET_BIG_ENDIAN) && (defined(DEATH_TARGET_ANDROID) || defined(DEATH_TARGET_APPLE) || defined(DEATH_TARGET_UNIX) || (defined(DEATH_TARGET_WINDOWS) && !defined(DEATH_TARGET_WINDOWS_RT)))
+		auto mappedFile = fs::OpenAsMemoryMapped(path, FileAccess::Read);
+		if (!mappedFile || mappedFile->size() < sizeof(FileHeader)) {
+			return false;
+		}
+
+		FileHeader header;
+		std::memcpy(&header, mappedFile->data(), sizeof(FileHeader));
+		if (header.Signature != FileSignature || header.Version != FileVersion ||
+			header.EntryCount > (mappedFile->size() - sizeof(FileHeader)) / sizeof(FileEntry)) {
+			LOGW("Collision mask cache \"{}\" is corrupted", path);
+			return false;
+		}
+
+		// Masks returned from the previous file keep it mapped until they are released
+		auto mapping = std::make_shared<MappedFile>(MappedFile { std::move(*mappedFile), header.EntryCount });
+		{
+#	if defined(WITH_THREADS)
+			std::unique_lock lock(_mappingLock);
+#	endif
+			_mapping = std::move(mapping);
+		}
+
+		LOGI("Collision mask cache \"{}\" mapped with {} masks", path, header.EntryCount);
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	void CollisionMaskCache::Close()
+	{
+		{
+#if defined(WITH_THREADS)
+			std::unique_lock lock(_mappingLock);
+#endif
+			_mapping = nullptr;
+		}
+
+#if defined(WITH_THREADS)
+		std::unique_lock lock(_recordedLock);
+#endif
+		_recorded.clear();
+	}
+
+	bool CollisionMaskCache::IsOpen() const
+	{
+		return (GetMapping() != nullptr);
+	}
+
+	std::shared_ptr<const void> CollisionMaskCache::Find(StringView path, std::uint64_t sourceSize, std::uint64_t sourceHash, std::uint32_t size) const
+	{
+		auto mapping = GetMapping();
+		if (mapping == nullptr) {
+			return nullptr;
+		}
+
+		const FileEntry* entry = FindEntry(*mapping, GetKey(path));
+		if (entry == nullptr || entry->SourceSize != sourceSize || entry->SourceHash != sourceHash || entry->Size != size ||
+			entry->Offset > mapping->Data.size() || mapping->Data.size() - entry->Offset < size) {
+			return nullptr;
+		}
+
+		// The returned pointer shares ownership of the whole mapping
+		return std::shared_ptr<const void>(mapping, mapping->Data.data() + entry->Offset);
+	}
+
+	void CollisionMaskCache::Add(StringView path, std::uint64_t sourceSize, std::uint64_t sourceHash, const void* data, std::uint32_t size)
+	{
+		RecordedMask mask;
+		mask.Key = GetKey(path);
+		mask.SourceSize = sourceSize;
+		mask.SourceHash = sourceHash;
+		mask.Data = std::make_unique<char[]>(size);
+		std::memcpy(mask.Data.get(), data, size);
+		mask.Size = size;
+
+#if defined(WITH_THREADS)
+		std::unique_lock lock(_recordedLock);
+#endif
+		_recorded.push_back(std::move(mask));
+	}
+
+	bool CollisionMaskCache::HasChanges()
+	{
+#if defined(WITH_THREADS)
+		std::unique_lock lock(_recordedLock);
+#endif
+		return !_recorded.empty();
+	}
+
+	bool CollisionMaskCache::Save(StringView path)
+	{
+#if defined(DEATH_TARGET_BIG_ENDIAN)
+		return false;
+#else
+#	if defined(WITH_THREADS)
+		std::unique_lock lock(_recordedLock);
+#	endif
+
+		// Recorded masks replace mapped ones with the same key, entries must be sorted for binary search
+		struct SourceEntry {
+			std::uint64_t Key;
+			std::uint64_t SourceSize;
+			std::uint64_t SourceHash;
+			const char* Data;
+			std::uint32_t Size;
+		};
+
+		// The mapping is held until the new file is written, even if it's replaced in the meantime
+		auto mapping = GetMapping();
+		std::uint32_t entryCount = (mapping != nullptr ? mapping->EntryCount : 0);
+
+		SmallVector<SourceEntry, 0> entries;
+		entries.reserve(entryCount + _recorded.size());
+		for (const auto& mask : _recorded) {
+			entries.push_back({ mask.Key, mask.SourceSize, mask.SourceHash, mask.Data.get(), mask.Size });
+		}
+		for (std::uint32_t i = 0; i < entryCount; i++) {
+			const char* mappedData = mapping->Data.data();
+			std::size_t mappedSize = mapping->Data.size();
+			FileEntry entry;
+			std::memcpy(&entry, mappedData + sizeof(FileHeader) + i * sizeof(FileEntry), sizeof(FileEntry));
+			if (entry.Offset <= mappedSize && mappedSize - entry.Offset >= entry.Size) {
+				entries.push_back({ entry.Key, entry.SourceSize, entry.SourceHash, mappedData + entry.Offset, entry.Size });
+			}
+		}
+
+		// Stable sort keeps recorded masks first, so duplicates can be skipped
+		std::stable_sort(entries.begin(), entries.end(), [](const SourceEntry& a, const SourceEntry& b) {
+			return a.Key < b.Key;
+		});
+		std::size_t count = 0;
+		for (std::size_t i = 0; i < entries.size(); i++) {
+			if (count == 0 || entries[count - 1].Key != entries[i].Key) {
+				entries[count++] = entries[i];
+			}
+		}
+		entries.resize(count);
+
+		// Write to a temporary file first, so other processes never see an incomplete file
+		String tempPath = format("{}.{:.8x}", path, Random().Next());
+		{
+			auto so = fs::Open(tempPath, FileAccess::Write);
+			if (!so->IsValid()) {
+				LOGW("Failed to create collision mask cache \"{}\"", tempPath);
+				return false;
+			}
+
+			FileHeader header = { FileSignature, FileVersion, 0, std::uint32_t(count), 0 };
+			so->Write(&header, sizeof(FileHeader));
+
+			std::uint64_t offset = sizeof(FileHeader) + count * sizeof(FileEntry);
+			for (const auto& entry : entries) {
+				offset = (offset + DataAlignment - 1) & ~std::uint64_t(DataAlignment - 1);
+				FileEntry fileEntry = { entry.Key, entry.SourceSize, entry.SourceHash, offset, entry.Size, 0 };
+				so->Write(&fileEntry, sizeof(FileEntry));
+				offset += entry.Size;
+			}
+
+			static const char Padding[DataAlignment] = {};
+			std::uint64_t position = sizeof(FileHeader) + count * sizeof(FileEntry);
+			for (const auto& entry : entries) {
+				std::uint64_t alignedPosition = (position + DataAlignment - 1) & ~std::uint64_t(DataAlignment - 1);
+				so->Write(Padding, std::int64_t(alignedPosition - position));
+				so->Write(entry.Data, entry.Size);
+				position = alignedPosition + entry.Size;
+			}
+		}
+
+		// On Windows, the file cannot be replaced while any process has it mapped
+		if (!fs::Move(tempPath, path)) {
+			LOGW("Failed to replace collision mask cache \"{}\", it's probably used by another process", path);
+			fs::RemoveFile(tempPath);
+			return false;
+		}
+
+		LOGI("Collision mask cache \"{}\" saved with {} masks", path, count);
+		_recorded.clear();
+
+		// Map the new file, so saved masks are not decoded and recorded again by this process
+		Open(path);
+		return true;
+#endif
+	}
+
+	std::uint64_t CollisionMaskCache::GetSourceHash(Stream& s)
+	{
+		std::int64_t position = s.GetPosition();
+		s.Seek(0, SeekOrigin::Begin);
+
+		// Blocks are chained through the seed, so the whole file doesn't have to be loaded at once
+		std::uint64_t hash = 0;
+		char buffer[16384];
+		while (true) {
+			std::int64_t bytesRead = s.Read(buffer, sizeof(buffer));
+			if (bytesRead <= 0) {
+				break;
+			}
+			hash = xxHash3(buffer, std::size_t(bytesRead), hash);
+		}
+
+		s.Seek(position, SeekOrigin::Begin);
+		return hash;
+	}
+
+	std::uint64_t CollisionMaskCache::GetKey(StringView path)
+	{
+		return xxHash3(path.data(), path.size());
+	}
+
+	const CollisionMaskCache::FileEntry* CollisionMaskCache::FindEntry(const MappedFile& mapping, std::uint64_t key)
+	{
+		const FileEntry* entries = reinterpret_cast<const FileEntry*>(mapping.Data.data() + sizeof(FileHeader));
+		const FileEntry* entry = std::lower_bound(entries, entries + mapping.EntryCount, key, [](const FileEntry& a, std::uint64_t b) {
+			return a.Key < b;
+		});
+		return (entry != entries + mapping.EntryCount && entry->Key == key ? entry : nullptr);
+	}
+
+	std::shared_ptr<const CollisionMaskCache::MappedFile> CollisionMaskCache::GetMapping() const
+	{
+#if defined(WITH_THREADS)
+		std::unique_lock lock(_mappingLock);
+#endif
+		return _mapping;
+	}
+}
@@ -0,0 +1,106 @@
+﻿#pragma once
+
+#include "../Main.h"
+
+#include <memory>
+
+#include <Containers/SmallVector.h>
+#include <Containers/StringView.h>
+#include <IO/Stream.h>
+
+#if defined(WITH_THREADS)
+#	include <mutex>
+#endif
+
+using namespace Death::Containers;
+using namespace Death::IO;
+
+namespace Jazz2
+{
+	/**
+		@brief Collision masks shared by multiple processes through a memory-mapped file
+
+		Decoding collision masks of all sprites and tile sets is one of the most expensive parts of loading in headless
+		mode and every process keeps its own copy of them. The cache file is memory-mapped read-only instead, so all
+		processes on the same machine (e.g., dedicated servers) share the same physical pages. Each mask is identified
+		by path, size and content hash of the source file, so outdated masks are never used. Masks are extracted before
+		any palette is applied, so they don't depend on palette offset.
+
+		Returned masks hold a reference to the mapped file, so a file replaced by @ref Save() is unmapped as soon as
+		all masks that point to it are released.
+
+		Masks that are not found are decoded as usual and recorded by @ref Add(). @ref Save() then writes a new file
+		with both mapped and recorded masks and atomically replaces the old one, which is then mapped instead. Other
+		processes that already mapped the old file keep using it until they are restarted. On Windows, a mapped file
+		cannot be replaced, so recorded masks are written only if no other process uses the file.
+	*/
+	class CollisionMaskCache
+	{
+	public:
+		CollisionMaskCache();
+		~CollisionMaskCache();
+
+		CollisionMaskCache(const CollisionMaskCache&) = delete;
+		CollisionMaskCache& operator=(const CollisionMaskCache&) = delete;
+
+		/**
+		 * @brief Maps the specified cache file into memory, returns `false` if it doesn't exist or it's not valid
+		 *
+		 * Previously mapped file stays mapped until all masks returned from it are released.
+		 */
+		bool Open(StringView path);
+		/** @brief Releases the cache file and discards all recorded masks, previously returned masks remain valid */
+		void Close();
+		/** @brief Returns `true` if the cache file is mapped */
+		bool IsOpen() const;
+
+		/** @brief Returns mapped mask of the specified resource or `nullptr` if it's not cached, it can be called from any thread */
+		std::shared_ptr<const void> Find(StringView path, std::uint64_t sourceSize, std::uint64_t sourceHash, std::uint32_t size) const;
+		/** @brief Records a mask, so it's written to the cache file by @ref Save(), it can be called from any thread */
+		void Add(StringView path, std::uint64_t sourceSize, std::uint64_t sourceHash, const void* data, std::uint32_t size);
+		/** @brief Returns `true` if any mask was recorded since the last save */
+		bool HasChanges();
+		/** @brief Writes all mapped and recorded masks to the specified file, the mapped file stays unchanged */
+		bool Save(StringView path);
+
+		/** @brief Computes content hash of the whole source stream, the stream position is preserved */
+		static std::uint64_t GetSourceHash(Stream& s);
+
+	private:
+#ifndef DOXYGEN_GENERATING_OUTPUT
+		// Doxygen 1.12.0 outputs also private structs/unions even if it shouldn't
+		struct FileEntry
+		{
+			std::uint64_t Key;
+			std::uint64_t SourceSize;
+			std::uint64_t SourceHash;
+			std::uint64_t Offset;
+			std::uint32_t Size;
+			std::uint32_t Reserved;
+		};
+
+		struct RecordedMask
+		{
+			std::uint64_t Key;
+			std::uint64_t SourceSize;
+			std::uint64_t SourceHash;
+			std::unique_ptr<char[]> Data;
+			std::uint32_t Size;
+		};
+
+		struct MappedFile;
+#endif
+
+		static std::uint64_t GetKey(StringView path);
+		static const FileEntry* FindEntry(const MappedFile& mapping, std::uint64_t key);
+
+		std::shared_ptr<const MappedFile> GetMapping() const;
+
+		std::shared_ptr<const MappedFile> _mapping;
+		SmallVector<RecordedMask, 0> _recorded;
+#if defined(WITH_THREADS)
+		mutable std::mutex _mappingLock;
+		std::mutex _recordedLock;
+#endif
+	};
+}
@@ -0,0 +1,71 @@
+﻿#pragma once
+
+#include "DynamicTreeBroadPhase.h"
+
+namespace Jazz2::Collisions
+{
+	/**
+		@brief Queries and dispatches collisions of actors stored as user data of @ref DynamicTreeBroadPhase
+
+		@p TActor has to provide `GetState()`, `IsCollidingWith()` for both AABB and other actor, and `OnHandleCollision()`.
+		@p TState is type of flags returned by `GetState()` with `CollideWithOtherActors` and `IsDestroyed` members.
+		Actors are passed to callbacks as raw pointers without type erasure, destroyed actors are only flagged,
+		so pointers stay valid until the actor is removed from the tree.
+	*/
+	template<class TActor, class TState>
+	struct CollisionDispatch
+	{
+		/** @brief Calls the callback for each actor other than @p self colliding with the specified AABB, the query stops if the callback returns `false` */
+		template<class TCallback>
+		static void QueryActors(const DynamicTreeBroadPhase& tree, const TActor* self, const AABBf& aabb, TCallback&& callback)
+		{
+			struct QueryHelper {
+				const DynamicTreeBroadPhase& Tree;
+				const TActor* Self;
+				const AABBf& AABB;
+				TCallback& Callback;
+
+				bool OnCollisionQuery(std::int32_t nodeId) {
+					TActor* actor = (TActor*)Tree.GetUserData(nodeId);
+					if (Self == actor || (actor->GetState() & (TState::CollideWithOtherActors | TState::IsDestroyed)) != TState::CollideWithOtherActors) {
+						return true;
+					}
+					if (actor->IsCollidingWith(AABB)) {
+						return Callback(actor);
+					}
+					return true;
+				}
+			};
+
+			QueryHelper helper = { tree, self, aabb, callback };
+			tree.Query(&helper, aabb);
+		}
+
+		/** @brief Calls `OnHandleCollision()` of both actors if they collide, the second actor is called only if the first one didn't handle the collision */
+		static void HandlePair(TActor* actorA, TActor* actorB)
+		{
+			if (((actorA->GetState() | actorB->GetState()) & (TState::CollideWithOtherActors | TState::IsDestroyed)) != TState::CollideWithOtherActors) {
+				return;
+			}
+
+			if (actorA->IsCollidingWith(actorB)) {
+				if (!actorA->OnHandleCollision(actorB)) {
+					actorB->OnHandleCollision(actorA);
+				}
+			}
+		}
+
+		/** @brief Updates pairs of the tree and calls @ref HandlePair() for each new pair */
+		static void ResolvePairs(DynamicTreeBroadPhase& tree)
+		{
+			struct UpdatePairsHelper {
+				void OnPairAdded(void* proxyA, void* proxyB) {
+					HandlePair((TActor*)proxyA, (TActor*)proxyB);
+				}
+			};
+
+			UpdatePairsHelper helper;
+			tree.UpdatePairs(&helper);
+		}
+	};
+}
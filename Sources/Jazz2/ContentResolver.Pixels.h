@@ -0,0 +1,179 @@
+﻿#pragma once
+
+#include "../Main.h"
+
+#include <Cpu.h>
+
+#if defined(DEATH_ENABLE_AVX2)
+#	include <IntrinsicsAvx.h>
+#elif defined(DEATH_ENABLE_SSE2)
+#	include <IntrinsicsSse2.h>
+#endif
+#if defined(DEATH_ENABLE_NEON) && !defined(DEATH_TARGET_32BIT)
+#	include <arm_neon.h>
+#endif
+
+#ifndef DOXYGEN_GENERATING_OUTPUT
+
+namespace Jazz2
+{
+	using ExtractAlphaMaskFunction = void(*)(const std::uint8_t* pixels, std::uint8_t* mask, std::size_t count);
+	using ApplyIndexedPaletteFunction = void(*)(const std::uint8_t* src, std::uint8_t* dst, std::size_t count, const std::uint32_t* palette);
+
+	// Pixels are RGBA8, indexed pixels have palette index in R channel and alpha in A channel. Palette color alpha
+	// is multiplied by pixel alpha, (x + 1 + (x >> 8)) >> 8 is exactly x / 255 for all products of two bytes.
+
+	inline ExtractAlphaMaskFunction extractAlphaMaskImplementation(Death::Cpu::ScalarT) {
+		return [](const std::uint8_t* pixels, std::uint8_t* mask, std::size_t count) {
+			for (std::size_t i = 0; i < count; i++) {
+				mask[i] = pixels[i * 4 + 3];
+			}
+		};
+	}
+
+	inline ApplyIndexedPaletteFunction applyIndexedPaletteImplementation(Death::Cpu::ScalarT) {
+		return [](const std::uint8_t* src, std::uint8_t* dst, std::size_t count, const std::uint32_t* palette) {
+			for (std::size_t i = 0; i < count; i++) {
+				std::uint32_t color = palette[src[i * 4]];
+				std::uint32_t alpha = src[i * 4 + 3];
+
+				dst[i * 4 + 0] = (color >> 0) & 0xFF;
+				dst[i * 4 + 1] = (color >> 8) & 0xFF;
+				dst[i * 4 + 2] = (color >> 16) & 0xFF;
+				dst[i * 4 + 3] = ((color >> 24) & 0xFF) * alpha / 255;
+			}
+		};
+	}
+
+#if defined(DEATH_ENABLE_SSE2)
+	DEATH_ENABLE_SSE2 inline ExtractAlphaMaskFunction extractAlphaMaskImplementation(Death::Cpu::Sse2T) {
+		return [](const std::uint8_t* pixels, std::uint8_t* mask, std::size_t count) DEATH_ENABLE_SSE2 {
+			// Shift alpha to the lowest byte of each pixel and narrow 16 pixels to 16 bytes
+			std::size_t i = 0;
+			for (; i + 16 <= count; i += 16) {
+				const __m128i* p = reinterpret_cast<const __m128i*>(pixels + i * 4);
+				__m128i a0 = _mm_srli_epi32(_mm_loadu_si128(p + 0), 24);
+				__m128i a1 = _mm_srli_epi32(_mm_loadu_si128(p + 1), 24);
+				__m128i a2 = _mm_srli_epi32(_mm_loadu_si128(p + 2), 24);
+				__m128i a3 = _mm_srli_epi32(_mm_loadu_si128(p + 3), 24);
+				__m128i result = _mm_packus_epi16(_mm_packs_epi32(a0, a1), _mm_packs_epi32(a2, a3));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(mask + i), result);
+			}
+			for (; i < count; i++) {
+				mask[i] = pixels[i * 4 + 3];
+			}
+		};
+	}
+
+	DEATH_ENABLE_SSE2 inline ApplyIndexedPaletteFunction applyIndexedPaletteImplementation(Death::Cpu::Sse2T) {
+		return [](const std::uint8_t* src, std::uint8_t* dst, std::size_t count, const std::uint32_t* palette) DEATH_ENABLE_SSE2 {
+			// SSE2 has no gather, so only the lookup is scalar
+			const __m128i one = _mm_set1_epi32(1);
+			const __m128i colorMask = _mm_set1_epi32(0x00FFFFFF);
+			std::size_t i = 0;
+			for (; i + 4 <= count; i += 4) {
+				const std::uint8_t* s = src + i * 4;
+				__m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+				__m128i colors = _mm_setr_epi32(std::int32_t(palette[s[0]]), std::int32_t(palette[s[4]]),
+					std::int32_t(palette[s[8]]), std::int32_t(palette[s[12]]));
+				// Both values are in the lower 16 bits of each 32-bit lane, so 16-bit multiplication is enough
+				__m128i x = _mm_mullo_epi16(_mm_srli_epi32(pixels, 24), _mm_srli_epi32(colors, 24));
+				x = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(x, one), _mm_srli_epi32(x, 8)), 8);
+				__m128i result = _mm_or_si128(_mm_and_si128(colors, colorMask), _mm_slli_epi32(x, 24));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), result);
+			}
+			if (i < count) {
+				applyIndexedPaletteImplementation(Death::Cpu::Scalar)(src + i * 4, dst + i * 4, count - i, palette);
+			}
+		};
+	}
+#endif
+
+#if defined(DEATH_ENABLE_AVX2)
+	DEATH_ENABLE_AVX2 inline ExtractAlphaMaskFunction extractAlphaMaskImplementation(Death::Cpu::Avx2T) {
+		return [](const std::uint8_t* pixels, std::uint8_t* mask, std::size_t count) DEATH_ENABLE_AVX2 {
+			// Packing works within 128-bit lanes, so 32-bit groups have to be reordered at the end
+			const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+			std::size_t i = 0;
+			for (; i + 32 <= count; i += 32) {
+				const __m256i* p = reinterpret_cast<const __m256i*>(pixels + i * 4);
+				__m256i a0 = _mm256_srli_epi32(_mm256_loadu_si256(p + 0), 24);
+				__m256i a1 = _mm256_srli_epi32(_mm256_loadu_si256(p + 1), 24);
+				__m256i a2 = _mm256_srli_epi32(_mm256_loadu_si256(p + 2), 24);
+				__m256i a3 = _mm256_srli_epi32(_mm256_loadu_si256(p + 3), 24);
+				__m256i result = _mm256_packus_epi16(_mm256_packs_epi32(a0, a1), _mm256_packs_epi32(a2, a3));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(mask + i), _mm256_permutevar8x32_epi32(result, order));
+			}
+			for (; i < count; i++) {
+				mask[i] = pixels[i * 4 + 3];
+			}
+		};
+	}
+
+	DEATH_ENABLE_AVX2 inline ApplyIndexedPaletteFunction applyIndexedPaletteImplementation(Death::Cpu::Avx2T) {
+		return [](const std::uint8_t* src, std::uint8_t* dst, std::size_t count, const std::uint32_t* palette) DEATH_ENABLE_AVX2 {
+			const __m256i one = _mm256_set1_epi32(1);
+			const __m256i indexMask = _mm256_set1_epi32(0xFF);
+			const __m256i colorMask = _mm256_set1_epi32(0x00FFFFFF);
+			std::size_t i = 0;
+			for (; i + 8 <= count; i += 8) {
+				__m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+				__m256i colors = _mm256_i32gather_epi32(reinterpret_cast<const int*>(palette), _mm256_and_si256(pixels, indexMask), 4);
+				__m256i x = _mm256_mullo_epi16(_mm256_srli_epi32(pixels, 24), _mm256_srli_epi32(colors, 24));
+				x = _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(x, one), _mm256_srli_epi32(x, 8)), 8);
+				__m256i result = _mm256_or_si256(_mm256_and_si256(colors, colorMask), _mm256_slli_epi32(x, 24));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), result);
+			}
+			if (i < count) {
+				applyIndexedPaletteImplementation(Death::Cpu::Scalar)(src + i * 4, dst + i * 4, count - i, palette);
+			}
+		};
+	}
+#endif
+
+#if defined(DEATH_ENABLE_NEON) && !defined(DEATH_TARGET_32BIT)
+	// `vmull_high_u8` is available only on ARM64
+	DEATH_ENABLE_NEON inline ExtractAlphaMaskFunction extractAlphaMaskImplementation(Death::Cpu::NeonT) {
+		return [](const std::uint8_t* pixels, std::uint8_t* mask, std::size_t count) DEATH_ENABLE_NEON {
+			std::size_t i = 0;
+			for (; i + 16 <= count; i += 16) {
+				uint8x16x4_t p = vld4q_u8(pixels + i * 4);
+				vst1q_u8(mask + i, p.val[3]);
+			}
+			for (; i < count; i++) {
+				mask[i] = pixels[i * 4 + 3];
+			}
+		};
+	}
+
+	DEATH_ENABLE_NEON inline ApplyIndexedPaletteFunction applyIndexedPaletteImplementation(Death::Cpu::NeonT) {
+		return [](const std::uint8_t* src, std::uint8_t* dst, std::size_t count, const std::uint32_t* palette) DEATH_ENABLE_NEON {
+			// NEON has no gather, so the lookup is scalar and colors are deinterleaved afterwards
+			const uint16x8_t one = vdupq_n_u16(1);
+			std::uint32_t colors[16];
+			std::size_t i = 0;
+			for (; i + 16 <= count; i += 16) {
+				const std::uint8_t* s = src + i * 4;
+				std::uint8_t alpha[16];
+				for (std::int32_t j = 0; j < 16; j++) {
+					colors[j] = palette[s[j * 4]];
+					alpha[j] = s[j * 4 + 3];
+				}
+				uint8x16_t a = vld1q_u8(alpha);
+				uint8x16x4_t c = vld4q_u8(reinterpret_cast<const std::uint8_t*>(colors));
+				uint16x8_t lo = vmull_u8(vget_low_u8(c.val[3]), vget_low_u8(a));
+				uint16x8_t hi = vmull_high_u8(c.val[3], a);
+				lo = vaddq_u16(vaddq_u16(lo, one), vshrq_n_u16(lo, 8));
+				hi = vaddq_u16(vaddq_u16(hi, one), vshrq_n_u16(hi, 8));
+				c.val[3] = vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+				vst4q_u8(dst + i * 4, c);
+			}
+			if (i < count) {
+				applyIndexedPaletteImplementation(Death::Cpu::Scalar)(src + i * 4, dst + i * 4, count - i, palette);
+			}
+		};
+	}
+#endif
+}
+
+#endif
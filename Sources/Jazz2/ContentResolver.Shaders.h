@@ -4,7 +4,7 @@
 
 namespace Jazz2::Shaders
 {
-	constexpr std::uint64_t Version = 9;
+	constexpr std::uint64_t Version = 12;
 
 	constexpr char LightingVs[] = "#line " DEATH_LINE_STRING "\n" R"(
 uniform mat4 uProjectionMatrix;
@@ -64,6 +64,40 @@ void main() {
 	vTexCoords = i.texRect;
 	vColor = vec4(i.color.x, i.color.y, aPosition.x * 2.0, aPosition.y * 2.0);
 }
+)";
+
+	constexpr char InstancedLightingVs[] = "#line " DEATH_LINE_STRING "\n" R"(
+uniform mat4 uProjectionMatrix;
+uniform mat4 uViewMatrix;
+uniform mat4 modelMatrix;
+
+struct Instance
+{
+	vec4 light; // Position, far radius, near radius ratio
+	vec4 color; // Intensity, brightness
+};
+
+layout (std140) uniform InstancesBlock
+{
+#ifndef BATCH_SIZE
+	#define BATCH_SIZE (2048) // 64 Kb / 32 b
+#endif
+	Instance[BATCH_SIZE] instances;
+} block;
+
+out vec4 vTexCoords;
+out vec4 vColor;
+
+#define i block.instances[gl_VertexID / 6]
+
+void main() {
+	vec2 aPosition = vec2(-0.5 + float(((gl_VertexID + 2) / 3) % 2), -0.5 + float(((gl_VertexID + 1) / 3) % 2));
+	vec4 position = vec4(i.light.x + aPosition.x * i.light.z * 2.0, i.light.y + aPosition.y * i.light.z * 2.0, 0.0, 1.0);
+
+	gl_Position = uProjectionMatrix * uViewMatrix * modelMatrix * position;
+	vTexCoords = vec4(i.light.x, i.light.y, i.light.w, 0.0);
+	vColor = vec4(i.color.x, i.color.y, aPosition.x * 2.0, aPosition.y * 2.0);
+}
 )";
 
 	constexpr char LightingFs[] = "#line " DEATH_LINE_STRING "\n" R"(
@@ -867,6 +901,97 @@ void main() {
 	vColor = i.color;
 	vPos = aPosition * vec2(2.0) - vec2(1.0);
 }
+)";
+
+	constexpr char TileLayerVs[] = "#line " DEATH_LINE_STRING "\n" R"(
+uniform mat4 uProjectionMatrix;
+uniform mat4 uViewMatrix;
+uniform mat4 modelMatrix;
+
+struct Instance
+{
+	vec4 texRect;
+	vec4 color;
+	vec2 position;
+};
+
+layout (std140) uniform InstancesBlock
+{
+#ifndef BATCH_SIZE
+	#define BATCH_SIZE (1365) // 64 Kb / 48 b
+#endif
+	Instance[BATCH_SIZE] instances;
+} block;
+
+out vec2 vTexCoords;
+out vec4 vColor;
+
+#define i block.instances[gl_VertexID / 6]
+#define TILE_SIZE 32.0
+
+void main() {
+	vec2 aPosition = vec2(1.0 - float(((gl_VertexID + 2) / 3) % 2), 1.0 - float(((gl_VertexID + 1) / 3) % 2));
+	vec4 position = vec4(i.position.x + aPosition.x * TILE_SIZE, i.position.y + aPosition.y * TILE_SIZE, 0.0, 1.0);
+
+	gl_Position = uProjectionMatrix * uViewMatrix * modelMatrix * position;
+	vTexCoords = vec2(aPosition.x * i.texRect.x + i.texRect.y, aPosition.y * i.texRect.z + i.texRect.w);
+	vColor = i.color;
+}
+)";
+
+	constexpr char TileLayerFs[] = "#line " DEATH_LINE_STRING "\n" R"(
+#ifdef GL_ES
+precision mediump float;
+#endif
+
+uniform sampler2D uTexture;
+
+in vec2 vTexCoords;
+in vec4 vColor;
+out vec4 fragColor;
+
+void main() {
+	fragColor = texture(uTexture, vTexCoords) * vColor;
+}
+)";
+
+	constexpr char DebrisVs[] = "#line " DEATH_LINE_STRING "\n" R"(
+uniform mat4 uProjectionMatrix;
+uniform mat4 uViewMatrix;
+uniform mat4 modelMatrix;
+
+struct Instance
+{
+	vec4 transform; // Position, angle, scale
+	vec4 texRect;
+	vec2 size;
+	float alpha;
+};
+
+layout (std140) uniform InstancesBlock
+{
+#ifndef BATCH_SIZE
+	#define BATCH_SIZE (1365) // 64 Kb / 48 b
+#endif
+	Instance[BATCH_SIZE] instances;
+} block;
+
+out vec2 vTexCoords;
+out vec4 vColor;
+
+#define i block.instances[gl_VertexID / 6]
+
+void main() {
+	vec2 aPosition = vec2(1.0 - float(((gl_VertexID + 2) / 3) % 2), 1.0 - float(((gl_VertexID + 1) / 3) % 2));
+	vec2 local = (aPosition - vec2(0.5, 0.5)) * i.size * i.transform.w;
+	float c = cos(i.transform.z);
+	float s = sin(i.transform.z);
+	vec4 position = vec4(i.transform.x + local.x * c - local.y * s, i.transform.y + local.x * s + local.y * c, 0.0, 1.0);
+
+	gl_Position = uProjectionMatrix * uViewMatrix * modelMatrix * position;
+	vTexCoords = vec2(aPosition.x * i.texRect.x + i.texRect.y, aPosition.y * i.texRect.z + i.texRect.w);
+	vColor = vec4(1.0, 1.0, 1.0, i.alpha);
+}
 )";
 
 	constexpr char ShieldFireFs[] = "#line " DEATH_LINE_STRING "\n" R"(
@@ -1,4 +1,5 @@
 ﻿#include "ContentResolver.h"
+#include "ContentResolver.Pixels.h"
 #include "ContentResolver.Shaders.h"
 #include "Compatibility/JJ2Anims.Palettes.h"
 #include "LevelFlags.h"
@@ -15,6 +16,7 @@
 #include "../nCine/Graphics/ITextureLoader.h"
 #include "../nCine/Graphics/RenderResources.h"
 #include "../nCine/Base/Random.h"
+#include "../nCine/Base/TimeStamp.h"
 
 #if defined(DEATH_TARGET_ANDROID)
 #	include "../nCine/Backends/Android/AndroidJniHelper.h"
@@ -23,6 +25,7 @@
 #	include <Environment.h>
 #endif
 
+#include <Cpu.h>
 #include <Containers/StringConcatenable.h>
 #include <Containers/StringStlView.h>
 #include <IO/MemoryStream.h>
@@ -30,6 +33,7 @@
 
 #include <jsoncpp/json.h>
 
+using namespace Death;
 using namespace Death::IO::Compression;
 using namespace Jazz2::Tiles;
 
@@ -46,6 +50,21 @@ static Vector2i GetVector2iFromJson(const Json::Value& value, Vector2i defaultVa
 
 namespace Jazz2
 {
+	extern void DEATH_CPU_DISPATCHED_DECLARATION(extractAlphaMask)(const std::uint8_t* pixels, std::uint8_t* mask, std::size_t count);
+	DEATH_CPU_DISPATCHER_DECLARATION(extractAlphaMask)
+	extern void DEATH_CPU_DISPATCHED_DECLARATION(applyIndexedPalette)(const std::uint8_t* src, std::uint8_t* dst, std::size_t count, const std::uint32_t* palette);
+	DEATH_CPU_DISPATCHER_DECLARATION(applyIndexedPalette)
+
+	DEATH_CPU_DISPATCHER_BASE(extractAlphaMaskImplementation)
+	DEATH_CPU_DISPATCHED(extractAlphaMaskImplementation, void DEATH_CPU_DISPATCHED_DECLARATION(extractAlphaMask)(const std::uint8_t* pixels, std::uint8_t* mask, std::size_t count))({
+		extractAlphaMaskImplementation(Cpu::DefaultBase)(pixels, mask, count);
+	})
+
+	DEATH_CPU_DISPATCHER_BASE(applyIndexedPaletteImplementation)
+	DEATH_CPU_DISPATCHED(applyIndexedPaletteImplementation, void DEATH_CPU_DISPATCHED_DECLARATION(applyIndexedPalette)(const std::uint8_t* src, std::uint8_t* dst, std::size_t count, const std::uint32_t* palette))({
+		applyIndexedPaletteImplementation(Cpu::DefaultBase)(src, dst, count, palette);
+	})
+
 	ContentResolver& ContentResolver::Get()
 	{
 		static ContentResolver current;
@@ -53,7 +72,7 @@ namespace Jazz2
 	}
 
 	ContentResolver::ContentResolver()
-		: _isHeadless(false), _isLoading(false), _cachedMetadata(64), _cachedGraphics(256),
+		: _isHeadless(false), _isLoading(false), _isCacheShared(false), _loadingOwnerMask(0), _cachedMetadata(64), _cachedGraphics(256),
 #if defined(WITH_AUDIO)
 			_cachedSounds(192),
 #endif
@@ -68,6 +87,13 @@ namespace Jazz2
 
 	void ContentResolver::Release()
 	{
+#if defined(WITH_THREADS)
+		DropPendingLoads();
+		_loaderThreadPool = nullptr;
+#endif
+
+		SaveCollisionMasks();
+
 		_cachedMetadata.clear();
 		_cachedGraphics.clear();
 #if defined(WITH_AUDIO)
@@ -81,6 +107,8 @@ namespace Jazz2
 		for (std::int32_t i = 0; i < (std::int32_t)PrecompiledShader::Count; i++) {
 			_precompiledShaders[i] = nullptr;
 		}
+
+		_maskCache.Close();
 	}
 
 	StringView ContentResolver::GetContentPath() const
@@ -134,6 +162,21 @@ namespace Jazz2
 	void ContentResolver::SetHeadless(bool value)
 	{
 		_isHeadless = value;
+
+		// Only headless processes use the cache, they don't need pixel data, so loading a sprite is reduced to a lookup
+		if (_isHeadless && !_maskCache.IsOpen()) {
+			_maskCache.Open(fs::CombinePath(GetCachePath(), "CollisionMasks.bin"_s));
+		}
+	}
+
+	bool ContentResolver::IsCacheShared() const
+	{
+		return _isCacheShared;
+	}
+
+	void ContentResolver::SetCacheShared(bool value)
+	{
+		_isCacheShared = value;
 	}
 
 	void ContentResolver::InitializePaths()
@@ -305,7 +348,8 @@ namespace Jazz2
 #if !defined(DEATH_TARGET_EMSCRIPTEN)
 	void ContentResolver::RemountPaks()
 	{
-		// Unload all already loaded .paks
+		// Unload all already loaded .paks, background loading could still use them
+		DropPendingLoads();
 		_mountedPaks.clear();
 
 		// Load all .paks from `Content` and `Cache` directory
@@ -315,15 +359,17 @@ namespace Jazz2
 				continue;
 			}
 
-			auto& pak = _mountedPaks.emplace_back(std::make_unique<PakFile>(item));
+			// Content is never rewritten while mounted, so it can be mapped into memory
+			auto& pak = _mountedPaks.emplace_back(std::make_unique<PakFile>(item, true));
 			if (pak->IsValid()) {
-				LOGI("File \"{}\" mounted successfully", item);
+				LOGI("File \"{}\" mounted successfully{}", item, pak->IsMemoryMapped() ? " (memory-mapped)" : "");
 			} else {
 				LOGE("Failed to mount file \"{}\"", item);
 				_mountedPaks.pop_back();
 			}
 		}
 
+		// Cache can be recreated while mounted (which is not possible for mapped files on some platforms), so use file streams
 		for (auto item : fs::Directory(GetCachePath(), fs::EnumerationOptions::SkipDirectories)) {
 			auto extension = fs::GetExtension(item);
 			if (extension != "pak"_s) {
@@ -368,10 +414,61 @@ namespace Jazz2
 		return fs::Open(fullPath, FileAccess::Read, bufferSize);
 	}
 
-	void ContentResolver::BeginLoading()
+	ArrayView<const char> ContentResolver::GetMappedContentFile(StringView path)
+	{
+#if !defined(DEATH_TARGET_EMSCRIPTEN)
+		for (std::size_t i = 0; i < _mountedPaks.size(); i++) {
+			if (!_mountedPaks[i]->IsMemoryMapped()) {
+				continue;
+			}
+			auto mountPoint = _mountedPaks[i]->GetMountPoint();
+			if (!path.hasPrefix(mountPoint)) {
+				continue;
+			}
+			// Files in .paks have higher priority, so if the file exists in this .pak (even compressed), don't try the next ones
+			bool fileExists;
+			auto mappedFile = _mountedPaks[i]->GetMappedFile(path.exceptPrefix(mountPoint.size()), fileExists);
+			if (fileExists) {
+				return mappedFile;
+			}
+		}
+#endif
+		return {};
+	}
+
+	void ContentResolver::BeginLoading(const void* owner)
 	{
 		_isLoading = true;
 
+		if (_isCacheShared) {
+			_loadingOwnerMask = GetCacheOwnerMask(owner);
+
+			// Resources requested since the last loading (e.g., spawned during gameplay) can't be attributed
+			// to a specific session, so they are conservatively kept for all known owners. References of
+			// the current owner are dropped and collected again until EndLoading() is called.
+			std::uint32_t allOwnersMask = (_cacheOwners.size() >= 32 ? ~0u : (1u << _cacheOwners.size()) - 1);
+			for (auto& resource : _cachedMetadata) {
+				if ((resource.second->Flags & MetadataFlags::Referenced) == MetadataFlags::Referenced) {
+					resource.second->Owners |= allOwnersMask;
+				}
+				resource.second->Owners &= ~_loadingOwnerMask;
+			}
+			for (auto& resource : _cachedGraphics) {
+				if ((resource.second->Flags & GenericGraphicResourceFlags::Referenced) == GenericGraphicResourceFlags::Referenced) {
+					resource.second->Owners |= allOwnersMask;
+				}
+				resource.second->Owners &= ~_loadingOwnerMask;
+			}
+#if defined(WITH_AUDIO)
+			for (auto& resource : _cachedSounds) {
+				if ((resource.second->Flags & GenericSoundResourceFlags::Referenced) == GenericSoundResourceFlags::Referenced) {
+					resource.second->Owners |= allOwnersMask;
+				}
+				resource.second->Owners &= ~_loadingOwnerMask;
+			}
+#endif
+		}
+
 		// Reset Referenced flag
 		for (auto& resource : _cachedMetadata) {
 			resource.second->Flags &= ~MetadataFlags::Referenced;
@@ -388,6 +485,35 @@ namespace Jazz2
 
 	void ContentResolver::EndLoading()
 	{
+		// Write newly decoded masks, so other processes (and next runs) don't have to decode them again
+		SaveCollisionMasks();
+
+		if (_isCacheShared) {
+			std::uint32_t ownerMask = (_loadingOwnerMask != 0 ? _loadingOwnerMask : ~0u);
+			// Resources referenced by the loaded level are now owned by the current session, Referenced flag is reset,
+			// so the next BeginLoading() can detect resources that were requested outside of the loading
+			for (auto& resource : _cachedMetadata) {
+				if ((resource.second->Flags & MetadataFlags::Referenced) == MetadataFlags::Referenced) {
+					resource.second->Owners |= ownerMask;
+					resource.second->Flags &= ~MetadataFlags::Referenced;
+				}
+			}
+			for (auto& resource : _cachedGraphics) {
+				if ((resource.second->Flags & GenericGraphicResourceFlags::Referenced) == GenericGraphicResourceFlags::Referenced) {
+					resource.second->Owners |= ownerMask;
+					resource.second->Flags &= ~GenericGraphicResourceFlags::Referenced;
+				}
+			}
+#if defined(WITH_AUDIO)
+			for (auto& resource : _cachedSounds) {
+				if ((resource.second->Flags & GenericSoundResourceFlags::Referenced) == GenericSoundResourceFlags::Referenced) {
+					resource.second->Owners |= ownerMask;
+					resource.second->Flags &= ~GenericSoundResourceFlags::Referenced;
+				}
+			}
+#endif
+		}
+
 #if defined(DEATH_DEBUG)
 		std::int32_t metadataKept = 0, metadataReleased = 0;
 		std::int32_t animationsKept = 0, animationsReleased = 0;
@@ -398,7 +524,10 @@ namespace Jazz2
 		{
 			auto it = _cachedMetadata.begin();
 			while (it != _cachedMetadata.end()) {
-				if ((it->second->Flags & MetadataFlags::Referenced) != MetadataFlags::Referenced) {
+				bool isReferenced = (_isCacheShared
+					? it->second->Owners != 0
+					: (it->second->Flags & MetadataFlags::Referenced) == MetadataFlags::Referenced);
+				if (!isReferenced) {
 					it = _cachedMetadata.erase(it);
 #if defined(DEATH_DEBUG)
 					metadataReleased++;
@@ -416,7 +545,10 @@ namespace Jazz2
 		{
 			auto it = _cachedGraphics.begin();
 			while (it != _cachedGraphics.end()) {
-				if ((it->second->Flags & GenericGraphicResourceFlags::Referenced) != GenericGraphicResourceFlags::Referenced) {
+				bool isReferenced = (_isCacheShared
+					? it->second->Owners != 0
+					: (it->second->Flags & GenericGraphicResourceFlags::Referenced) == GenericGraphicResourceFlags::Referenced);
+				if (!isReferenced) {
 					it = _cachedGraphics.erase(it);
 #if defined(DEATH_DEBUG)
 					animationsReleased++;
@@ -435,7 +567,10 @@ namespace Jazz2
 		{
 			auto it = _cachedSounds.begin();
 			while (it != _cachedSounds.end()) {
-				if ((it->second->Flags & GenericSoundResourceFlags::Referenced) != GenericSoundResourceFlags::Referenced) {
+				bool isReferenced = (_isCacheShared
+					? it->second->Owners != 0
+					: (it->second->Flags & GenericSoundResourceFlags::Referenced) == GenericSoundResourceFlags::Referenced);
+				if (!isReferenced) {
 					it = _cachedSounds.erase(it);
 #	if defined(DEATH_DEBUG)
 					soundsReleased++;
@@ -458,15 +593,114 @@ namespace Jazz2
 		_isLoading = false;
 	}
 
+	std::uint32_t ContentResolver::GetCacheOwnerMask(const void* owner)
+	{
+		for (std::size_t i = 0; i < _cacheOwners.size(); i++) {
+			if (_cacheOwners[i] == owner) {
+				return (i < 32 ? (1u << i) : 0);
+			}
+		}
+
+		_cacheOwners.push_back(owner);
+		std::size_t i = _cacheOwners.size() - 1;
+		// Only 32 owners can be tracked, resources referenced by the others are never released
+		return (i < 32 ? (1u << i) : 0);
+	}
+
 	void ContentResolver::OverridePathHandler(Function<String(StringView)>&& callback)
 	{
 		_pathHandler = std::move(callback);
 	}
 
+#if defined(WITH_THREADS)
+	namespace
+	{
+		class LoaderCommand : public IThreadCommand
+		{
+		public:
+			explicit LoaderCommand(Function<void()>&& job)
+				: _job(std::move(job)) {}
+
+			void Execute() override
+			{
+				_job();
+			}
+
+		private:
+			Function<void()> _job;
+		};
+	}
+#endif
+
+	struct ContentResolver::DecodedGraphics
+	{
+		String Path;
+		std::uint16_t PaletteOffset;
+		std::uint32_t Width;
+		std::uint32_t Height;
+		std::unique_ptr<std::uint8_t[]> Pixels;
+		std::unique_ptr<std::uint8_t[]> Mask;
+		std::shared_ptr<const void> MappedMask;
+		bool LinearSampling;
+		float AnimDuration;
+		std::int32_t FrameCount;
+		Vector2i FrameDimensions;
+		Vector2i FrameConfiguration;
+		Vector2i Hotspot;
+		Vector2i Coldspot;
+		Vector2i Gunspot;
+	};
+
+	struct ContentResolver::PendingMetadata
+	{
+		String Path;
+		Json::Value Document;
+		SmallVector<DecodedGraphics, 0> Graphics;
+		bool IsFound = false;
+		bool IsParsed = false;
+		// Guarded by `_pendingMutex`
+		bool IsReady = false;
+	};
+
 	void ContentResolver::PreloadMetadataAsync(StringView path)
 	{
-		// TODO: Reimplement async preloading
+#if defined(WITH_THREADS)
+		String pathNormalized = fs::ToNativeSeparators(path);
+		if (_cachedMetadata.find(pathNormalized) != _cachedMetadata.end()) {
+			// Already loaded, just mark it as referenced
+			RequestMetadata(pathNormalized);
+			return;
+		}
+		for (const auto& pending : _pendingMetadata) {
+			if (pending->Path == pathNormalized) {
+				return;
+			}
+		}
+
+		if (_loaderThreadPool == nullptr) {
+			// Leave one core for the main thread
+			std::uint32_t threadCount = std::min(std::max(Thread::GetProcessorCount(), 2u) - 1, 3u);
+			_loaderThreadPool = std::make_unique<ThreadPool>(threadCount);
+		}
+
+		auto pending = std::make_shared<PendingMetadata>();
+		pending->Path = std::move(pathNormalized);
+		_pendingMetadata.push_back(pending);
+
+		// Texture upload must be done on the main thread, so only file reading and decoding is done here
+		_loaderThreadPool->EnqueueCommand(std::make_unique<LoaderCommand>([this, pending]() {
+			if (ReadMetadataFile(*pending)) {
+				DecodeMetadataGraphics(*pending);
+			}
+
+			_pendingMutex.Lock();
+			pending->IsReady = true;
+			_pendingCV.Broadcast();
+			_pendingMutex.Unlock();
+		}));
+#else
 		RequestMetadata(path);
+#endif
 	}
 
 	Metadata* ContentResolver::RequestMetadata(StringView path)
@@ -492,27 +726,147 @@ namespace Jazz2
 			return it->second.get();
 		}
 
+#if defined(WITH_THREADS)
+		for (std::size_t i = 0; i < _pendingMetadata.size(); i++) {
+			if (_pendingMetadata[i]->Path == pathNormalized) {
+				// Already preloading, wait only for the remaining work
+				std::shared_ptr<PendingMetadata> pending = std::move(_pendingMetadata[i]);
+				_pendingMetadata.erase(_pendingMetadata.begin() + i);
+
+				_pendingMutex.Lock();
+				while (!pending->IsReady) {
+					_pendingCV.Wait(_pendingMutex);
+				}
+				_pendingMutex.Unlock();
+
+				return (pending->IsFound ? LoadMetadata(*pending) : nullptr);
+			}
+		}
+#endif
+
 		// Try to load it
-		auto s = fs::Open(fs::CombinePath({ GetContentPath(), "Metadata"_s, String(pathNormalized + ".res"_s) }), FileAccess::Read);
+		PendingMetadata pending;
+		pending.Path = std::move(pathNormalized);
+		if (!ReadMetadataFile(pending)) {
+			return nullptr;
+		}
+		return LoadMetadata(pending);
+	}
+
+	void ContentResolver::ProcessPendingLoads(float timeBudgetMs)
+	{
+#if defined(WITH_THREADS)
+		if (_pendingMetadata.empty()) {
+			return;
+		}
+
+		ZoneScopedC(0x888888);
+
+		TimeStamp startTime = TimeStamp::now();
+		std::size_t i = 0;
+		while (i < _pendingMetadata.size()) {
+			_pendingMutex.Lock();
+			bool isReady = _pendingMetadata[i]->IsReady;
+			_pendingMutex.Unlock();
+
+			if (!isReady) {
+				i++;
+				continue;
+			}
+
+			std::shared_ptr<PendingMetadata> pending = std::move(_pendingMetadata[i]);
+			_pendingMetadata.erase(_pendingMetadata.begin() + i);
+			if (pending->IsFound && _cachedMetadata.find(pending->Path) == _cachedMetadata.end()) {
+				LoadMetadata(*pending);
+			}
+
+			// At least one item is always finished, the rest is postponed to the next frame if the budget is exceeded
+			if (startTime.millisecondsSince() >= timeBudgetMs) {
+				break;
+			}
+		}
+#endif
+	}
+
+	bool ContentResolver::ReadMetadataFile(PendingMetadata& pending)
+	{
+		auto s = fs::Open(fs::CombinePath({ GetContentPath(), "Metadata"_s, String(pending.Path + ".res"_s) }), FileAccess::Read);
 		auto fileSize = s->GetSize();
 		if (fileSize < 4 || fileSize > 64 * 1024 * 1024) {
 			// 64 MB file size limit
-			return nullptr;
+			return false;
 		}
 
 		auto buffer = std::make_unique<char[]>(fileSize);
 		s->Read(buffer.get(), fileSize);
+		s->Dispose();
+
+		pending.IsFound = true;
 
+		Json::CharReaderBuilder builder;
+		auto reader = std::unique_ptr<Json::CharReader>(builder.newCharReader());
+		std::string errors;
+		pending.IsParsed = reader->parse(buffer.get(), buffer.get() + fileSize, &pending.Document, &errors);
+		return true;
+	}
+
+	void ContentResolver::DecodeMetadataGraphics(PendingMetadata& pending)
+	{
+		if (!pending.IsParsed) {
+			return;
+		}
+
+		const Json::Value& doc = pending.Document;
+		const auto& animations = doc["Animations"];
+		if (!animations.isObject()) {
+			return;
+		}
+
+		for (auto it = animations.begin(); it != animations.end(); ++it) {
+			std::string_view assetPath;
+			if ((*it)["Path"].get(assetPath) != Json::SUCCESS || assetPath.empty()) {
+				continue;
+			}
+
+			std::int64_t paletteOffset;
+			if ((*it)["PaletteOffset"].get(paletteOffset) != Json::SUCCESS || paletteOffset < 0) {
+				paletteOffset = 0;
+			}
+
+			// Only .aura files can be decoded without the main thread, other formats are loaded later by RequestGraphics()
+			String assetPathNormalized = fs::ToNativeSeparators(assetPath);
+			if (fs::GetExtension(assetPathNormalized) != "aura"_s) {
+				continue;
+			}
+
+			bool alreadyDecoded = false;
+			for (const auto& item : pending.Graphics) {
+				if (item.PaletteOffset == (std::uint16_t)paletteOffset && item.Path == assetPathNormalized) {
+					alreadyDecoded = true;
+					break;
+				}
+			}
+			if (alreadyDecoded) {
+				continue;
+			}
+
+			auto& decoded = pending.Graphics.emplace_back();
+			if (!DecodeGraphicsAura(assetPathNormalized, (std::uint16_t)paletteOffset, decoded)) {
+				pending.Graphics.pop_back();
+			}
+		}
+	}
+
+	Metadata* ContentResolver::LoadMetadata(PendingMetadata& pending)
+	{
 		bool multipleAnimsNoStatesWarning = false;
 
 		std::unique_ptr<Metadata> metadata = std::make_unique<Metadata>();
-		metadata->Path = std::move(pathNormalized);
+		metadata->Path = std::move(pending.Path);
 		metadata->Flags |= MetadataFlags::Referenced;
 
-		Json::CharReaderBuilder builder;
-		auto reader = std::unique_ptr<Json::CharReader>(builder.newCharReader());
-		Json::Value doc; std::string errors;
-		if (reader->parse(buffer.get(), buffer.get() + fileSize, &doc, &errors)) {
+		if (pending.IsParsed) {
+			const Json::Value& doc = pending.Document;
 			metadata->BoundingBox = GetVector2iFromJson(doc["BoundingBox"], Vector2i(InvalidValue, InvalidValue));
 
 			const auto& animations = doc["Animations"];
@@ -548,7 +902,18 @@ namespace Jazz2
 						paletteOffset = 0;
 					}
 
-					graphics.Base = RequestGraphics(assetPath, (std::uint16_t)paletteOffset);
+					// Use graphics decoded on a background thread if available
+					DecodedGraphics* decoded = nullptr;
+					if (!pending.Graphics.empty()) {
+						String assetPathNormalized = fs::ToNativeSeparators(assetPath);
+						for (auto& item : pending.Graphics) {
+							if (item.PaletteOffset == (std::uint16_t)paletteOffset && item.Path == assetPathNormalized) {
+								decoded = &item;
+								break;
+							}
+						}
+					}
+					graphics.Base = (decoded != nullptr ? FinishGraphics(*decoded) : RequestGraphics(assetPath, (std::uint16_t)paletteOffset));
 					if (graphics.Base == nullptr) {
 						continue;
 					}
@@ -590,7 +955,7 @@ namespace Jazz2
 								// Additional checks only for Debug configuration
 								for (const auto& anim : metadata->Animations) {
 									if (anim.State == (AnimState)state) {
-										LOGW("Animation state {} defined twice in file \"{}\"", state, path);
+										LOGW("Animation state {} defined twice in file \"{}\"", state, metadata->Path);
 										break;
 									}
 								}
@@ -602,7 +967,7 @@ namespace Jazz2
 					} else if (count > 1) {
 						if (!multipleAnimsNoStatesWarning) {
 							multipleAnimsNoStatesWarning = true;
-							LOGW("Multiple animations defined but no states specified in file \"{}\"", path);
+							LOGW("Multiple animations defined but no states specified in file \"{}\"", metadata->Path);
 						}
 					} else {
 						graphics.State = AnimState::Default;
@@ -656,6 +1021,43 @@ namespace Jazz2
 		return _cachedMetadata.emplace(metadata->Path, std::move(metadata)).first->second.get();
 	}
 
+	void ContentResolver::DropPendingLoads()
+	{
+#if defined(WITH_THREADS)
+		if (_pendingMetadata.empty()) {
+			return;
+		}
+
+		// Workers read palettes and mounted .pak files, so wait until all of them are finished, finished results
+		// are not inserted to the cache, because they could be decoded with an old palette or from an unmounted .pak
+		_pendingMutex.Lock();
+		for (const auto& pending : _pendingMetadata) {
+			while (!pending->IsReady) {
+				_pendingCV.Wait(_pendingMutex);
+			}
+		}
+		_pendingMutex.Unlock();
+
+		_pendingMetadata.clear();
+#endif
+	}
+
+	void ContentResolver::SaveCollisionMasks()
+	{
+		if (!_isHeadless || !_maskCache.HasChanges()) {
+			return;
+		}
+
+#if defined(WITH_THREADS)
+		// Workers look up masks in the cache, so the new file cannot be mapped while any of them is running
+		if (!_pendingMetadata.empty()) {
+			return;
+		}
+#endif
+
+		_maskCache.Save(fs::CombinePath(GetCachePath(), "CollisionMasks.bin"_s));
+	}
+
 	GenericGraphicResource* ContentResolver::RequestGraphics(StringView path, std::uint16_t paletteOffset)
 	{
 		// First resources are requested, reset _isLoading flag, because palette should be already applied
@@ -723,28 +1125,13 @@ namespace Jazz2
 				}
 
 				if (needsMask) {
-					graphics->Mask = std::make_unique<std::uint8_t[]>(w * h);
-					for (std::int32_t i = 0; i < w * h; i++) {
-						// Save original alpha value for collision checking
-						graphics->Mask[i] = pixels[(i * PixelSize) + 3];
-					}
+					// Save original alpha value for collision checking
+					graphics->MaskStorage = std::make_unique<std::uint8_t[]>(w * h);
+					graphics->Mask = graphics->MaskStorage.get();
+					extractAlphaMask(pixels, graphics->MaskStorage.get(), std::size_t(w) * h);
 				}
 				if (palette != nullptr) {
-					for (std::uint32_t i = 0; i < w * h; i++) {
-						std::uint32_t srcIdx = i * PixelSize;
-						std::uint32_t color = palette[pixels[srcIdx]];
-						std::uint8_t alpha = pixels[srcIdx + 3];
-
-						std::uint8_t r = (color >> 0) & 0xFF;
-						std::uint8_t g = (color >> 8) & 0xFF;
-						std::uint8_t b = (color >> 16) & 0xFF;
-						std::uint8_t a = ((color >> 24) & 0xFF) * alpha / 255;
-
-						pixels[srcIdx + 0] = r;
-						pixels[srcIdx + 1] = g;
-						pixels[srcIdx + 2] = b;
-						pixels[srcIdx + 3] = a;
-					}
+					applyIndexedPalette(pixels, pixels, std::size_t(w) * h, palette);
 				}
 
 				if (!_isHeadless) {
@@ -786,12 +1173,25 @@ namespace Jazz2
 
 	GenericGraphicResource* ContentResolver::RequestGraphicsAura(StringView path, std::uint16_t paletteOffset)
 	{
-		auto s = OpenContentFile(fs::CombinePath("Animations"_s, path));
+		DecodedGraphics decoded;
+		if (!DecodeGraphicsAura(path, paletteOffset, decoded)) {
+			return nullptr;
+		}
+		return FinishGraphics(decoded);
+	}
+
+	bool ContentResolver::DecodeGraphicsAura(StringView path, std::uint16_t paletteOffset, DecodedGraphics& decoded)
+	{
+		// This function can be called from worker threads, so it must not touch any cache,
+		// files from memory-mapped .paks are decoded directly from the mapping
+		String fullPath = fs::CombinePath("Animations"_s, path);
+		ArrayView<const char> mappedFile = GetMappedContentFile(fullPath);
+		std::unique_ptr<Stream> s = (!mappedFile.empty() ? std::make_unique<MemoryStream>(mappedFile) : OpenContentFile(fullPath));
 
 		auto fileSize = s->GetSize();
 		if (fileSize < 16 || fileSize > 64 * 1024 * 1024) {
 			// 64 MB file size limit, also if not found try to use cache
-			return nullptr;
+			return false;
 		}
 
 		std::uint64_t signature1 = s->ReadValueAsLE<std::uint64_t>();
@@ -800,7 +1200,7 @@ namespace Jazz2
 		std::uint8_t flags = s->ReadValue<std::uint8_t>();
 
 		if (signature1 != 0xB8EF8498E2BFBBEF || signature2 != 0x208F || version != 2 || (flags & 0x80) != 0x80) {
-			return nullptr;
+			return false;
 		}
 
 		std::uint8_t channelCount = s->ReadValue<std::uint8_t>();
@@ -824,13 +1224,6 @@ namespace Jazz2
 		std::uint32_t width = frameDimensionsX * frameConfigurationX;
 		std::uint32_t height = frameDimensionsY * frameConfigurationY;
 
-		std::unique_ptr<std::uint8_t[]> pixels = std::make_unique<std::uint8_t[]>(width * height * PixelSize);
-
-		ReadImageFromFile(s, pixels.get(), width, height, channelCount);
-
-		std::unique_ptr<GenericGraphicResource> graphics = std::make_unique<GenericGraphicResource>();
-		graphics->Flags |= GenericGraphicResourceFlags::Referenced;
-
 		const std::uint32_t* palette = _palettes + paletteOffset;
 		bool linearSampling = false;
 		bool needsMask = true;
@@ -842,134 +1235,203 @@ namespace Jazz2
 			needsMask = false;
 		}
 
-		if (needsMask) {
-			graphics->Mask = std::make_unique<std::uint8_t[]>(width * height);
-			for (std::uint32_t i = 0; i < width * height; i++) {
-				// Save original alpha value for collision checking
-				graphics->Mask[i] = pixels[(i * PixelSize) + 3];
+		// Headless processes need only the collision mask, so pixels don't have to be decoded if it's already cached
+		bool needsPixels = true;
+		std::uint64_t sourceHash = 0;
+		if (_isHeadless) {
+			if (needsMask) {
+				sourceHash = CollisionMaskCache::GetSourceHash(*s);
+				decoded.MappedMask = _maskCache.Find(fullPath, fileSize, sourceHash, width * height);
+				needsPixels = (decoded.MappedMask == nullptr);
+			} else {
+				needsPixels = false;
 			}
 		}
-		if (palette != nullptr) {
-			for (std::uint32_t i = 0; i < width * height; i++) {
-				std::uint32_t srcIdx = i * PixelSize;
-				std::uint32_t color = palette[pixels[srcIdx]];
-				std::uint8_t alpha = pixels[srcIdx + 3];
 
-				std::uint8_t r = (color >> 0) & 0xFF;
-				std::uint8_t g = (color >> 8) & 0xFF;
-				std::uint8_t b = (color >> 16) & 0xFF;
-				std::uint8_t a = ((color >> 24) & 0xFF) * alpha / 255;
+		std::unique_ptr<std::uint8_t[]> pixels;
+		if (needsPixels) {
+			pixels = std::make_unique<std::uint8_t[]>(width * height * PixelSize);
 
-				pixels[srcIdx + 0] = r;
-				pixels[srcIdx + 1] = g;
-				pixels[srcIdx + 2] = b;
-				pixels[srcIdx + 3] = a;
+			if (!mappedFile.empty()) {
+				ReadImageFromMemory(mappedFile.exceptPrefix(std::size_t(s->GetPosition())), pixels.get(), width, height, channelCount);
+			} else {
+				ReadImageFromFile(s, pixels.get(), width, height, channelCount);
 			}
-		}
 
-		if (!_isHeadless) {
-			// Don't load textures in headless mode, only collision masks
-			graphics->TextureDiffuse = std::make_unique<Texture>(path.data(), Texture::Format::RGBA8, width, height);
-			graphics->TextureDiffuse->LoadFromTexels(pixels.get(), 0, 0, width, height);
-			graphics->TextureDiffuse->SetMinFiltering(linearSampling ? SamplerFilter::Linear : SamplerFilter::Nearest);
-			graphics->TextureDiffuse->SetMagFiltering(linearSampling ? SamplerFilter::Linear : SamplerFilter::Nearest);
+			if (needsMask) {
+				// Save original alpha value for collision checking
+				decoded.Mask = std::make_unique<std::uint8_t[]>(width * height);
+				extractAlphaMask(pixels.get(), decoded.Mask.get(), std::size_t(width) * height);
+				if (_isHeadless) {
+					_maskCache.Add(fullPath, fileSize, sourceHash, decoded.Mask.get(), width * height);
+				}
+			}
+			if (palette != nullptr && !_isHeadless) {
+				applyIndexedPalette(pixels.get(), pixels.get(), std::size_t(width) * height, palette);
+			}
 		}
 
+		decoded.Path = path;
+		decoded.PaletteOffset = paletteOffset;
+		decoded.Width = width;
+		decoded.Height = height;
+		decoded.Pixels = std::move(pixels);
+		decoded.LinearSampling = linearSampling;
+
 		// AnimDuration is multiplied by 256 before saving, so divide it here back
-		graphics->AnimDuration = animDuration / 256.0f;
-		graphics->FrameDimensions = Vector2i(frameDimensionsX, frameDimensionsY);
-		graphics->FrameConfiguration = Vector2i(frameConfigurationX, frameConfigurationY);
-		graphics->FrameCount = frameCount;
+		decoded.AnimDuration = animDuration / 256.0f;
+		decoded.FrameDimensions = Vector2i(frameDimensionsX, frameDimensionsY);
+		decoded.FrameConfiguration = Vector2i(frameConfigurationX, frameConfigurationY);
+		decoded.FrameCount = frameCount;
 
 		if (hotspotX != UINT16_MAX || hotspotY != UINT16_MAX) {
-			graphics->Hotspot = Vector2i(hotspotX, hotspotY);
+			decoded.Hotspot = Vector2i(hotspotX, hotspotY);
 		} else {
-			graphics->Hotspot = Vector2i();
+			decoded.Hotspot = Vector2i();
 		}
 
 		if (coldspotX != UINT16_MAX || coldspotY != UINT16_MAX) {
-			graphics->Coldspot = Vector2i(coldspotX, coldspotY);
+			decoded.Coldspot = Vector2i(coldspotX, coldspotY);
 		} else {
-			graphics->Coldspot = Vector2i(InvalidValue, InvalidValue);
+			decoded.Coldspot = Vector2i(InvalidValue, InvalidValue);
 		}
 
 		if (gunspotX != UINT16_MAX || gunspotY != UINT16_MAX) {
-			graphics->Gunspot = Vector2i(gunspotX, gunspotY);
+			decoded.Gunspot = Vector2i(gunspotX, gunspotY);
 		} else {
-			graphics->Gunspot = Vector2i(InvalidValue, InvalidValue);
+			decoded.Gunspot = Vector2i(InvalidValue, InvalidValue);
 		}
 
-		return _cachedGraphics.emplace(Pair(String(path), paletteOffset), std::move(graphics)).first->second.get();
+		return true;
 	}
 
-	void ContentResolver::ReadImageFromFile(std::unique_ptr<Stream>& s, std::uint8_t* data, std::int32_t width, std::int32_t height, std::int32_t channelCount)
+	GenericGraphicResource* ContentResolver::FinishGraphics(DecodedGraphics& decoded)
 	{
-		typedef union {
-			struct {
-				unsigned char r, g, b, a;
-			} rgba;
-			unsigned int v;
-		} rgba_t;
-
-		#define QOI_OP_INDEX  0x00 /* 00xxxxxx */
-		#define QOI_OP_DIFF   0x40 /* 01xxxxxx */
-		#define QOI_OP_LUMA   0x80 /* 10xxxxxx */
-		#define QOI_OP_RUN    0xc0 /* 11xxxxxx */
-		#define QOI_OP_RGB    0xfe /* 11111110 */
-		#define QOI_OP_RGBA   0xff /* 11111111 */
-
-		#define QOI_MASK_2    0xc0 /* 11000000 */
-
-		#define QOI_COLOR_HASH(C) (C.rgba.r*3 + C.rgba.g*5 + C.rgba.b*7 + C.rgba.a*11)
-
-		rgba_t index[64] { };
-		rgba_t px;
-		std::int32_t run = 0;
-		std::int32_t px_len = width * height * channelCount;
-
-		px.rgba.r = 0;
-		px.rgba.g = 0;
-		px.rgba.b = 0;
-		px.rgba.a = 255;
-
-		for (std::int32_t px_pos = 0; px_pos < px_len; px_pos += channelCount) {
-			if (run > 0) {
-				run--;
-			} else {
-				std::int32_t b1 = s->ReadValue<std::uint8_t>();
-
-				if (b1 == QOI_OP_RGB) {
-					px.rgba.r = s->ReadValue<std::uint8_t>();
-					px.rgba.g = s->ReadValue<std::uint8_t>();
-					px.rgba.b = s->ReadValue<std::uint8_t>();
-				} else if (b1 == QOI_OP_RGBA) {
-					px.rgba.r = s->ReadValue<std::uint8_t>();
-					px.rgba.g = s->ReadValue<std::uint8_t>();
-					px.rgba.b = s->ReadValue<std::uint8_t>();
-					px.rgba.a = s->ReadValue<std::uint8_t>();
-				} else if ((b1 & QOI_MASK_2) == QOI_OP_INDEX) {
-					px = index[b1];
-				} else if ((b1 & QOI_MASK_2) == QOI_OP_DIFF) {
-					px.rgba.r += ((b1 >> 4) & 0x03) - 2;
-					px.rgba.g += ((b1 >> 2) & 0x03) - 2;
-					px.rgba.b += (b1 & 0x03) - 2;
-				} else if ((b1 & QOI_MASK_2) == QOI_OP_LUMA) {
-					std::int32_t b2 = s->ReadValue<std::uint8_t>();
-					std::int32_t vg = (b1 & 0x3f) - 32;
-					px.rgba.r += vg - 8 + ((b2 >> 4) & 0x0f);
-					px.rgba.g += vg;
-					px.rgba.b += vg - 8 + (b2 & 0x0f);
-				} else if ((b1 & QOI_MASK_2) == QOI_OP_RUN) {
-					run = (b1 & 0x3f);
+		// First resources are requested, reset _isLoading flag, because palette should be already applied
+		_isLoading = false;
+
+		auto it = _cachedGraphics.find(Pair(String::nullTerminatedView(decoded.Path), decoded.PaletteOffset));
+		if (it != _cachedGraphics.end()) {
+			// Already loaded by another request - Mark as referenced
+			it->second->Flags |= GenericGraphicResourceFlags::Referenced;
+			return it->second.get();
+		}
+
+		std::unique_ptr<GenericGraphicResource> graphics = std::make_unique<GenericGraphicResource>();
+		graphics->Flags |= GenericGraphicResourceFlags::Referenced;
+		graphics->MaskStorage = std::move(decoded.Mask);
+		graphics->SharedMask = std::move(decoded.MappedMask);
+		graphics->Mask = (graphics->MaskStorage != nullptr ? graphics->MaskStorage.get() : static_cast<const std::uint8_t*>(graphics->SharedMask.get()));
+
+		if (!_isHeadless) {
+			// Don't load textures in headless mode, only collision masks
+			graphics->TextureDiffuse = std::make_unique<Texture>(decoded.Path.data(), Texture::Format::RGBA8, decoded.Width, decoded.Height);
+			graphics->TextureDiffuse->LoadFromTexels(decoded.Pixels.get(), 0, 0, decoded.Width, decoded.Height);
+			graphics->TextureDiffuse->SetMinFiltering(decoded.LinearSampling ? SamplerFilter::Linear : SamplerFilter::Nearest);
+			graphics->TextureDiffuse->SetMagFiltering(decoded.LinearSampling ? SamplerFilter::Linear : SamplerFilter::Nearest);
+		}
+		decoded.Pixels = nullptr;
+
+		graphics->AnimDuration = decoded.AnimDuration;
+		graphics->FrameDimensions = decoded.FrameDimensions;
+		graphics->FrameConfiguration = decoded.FrameConfiguration;
+		graphics->FrameCount = decoded.FrameCount;
+		graphics->Hotspot = decoded.Hotspot;
+		graphics->Coldspot = decoded.Coldspot;
+		graphics->Gunspot = decoded.Gunspot;
+
+		return _cachedGraphics.emplace(Pair(decoded.Path, decoded.PaletteOffset), std::move(graphics)).first->second.get();
+	}
+
+	namespace
+	{
+		template<class TReadByte>
+		void DecodeQoiPixels(TReadByte&& readByte, std::uint8_t* data, std::int32_t width, std::int32_t height, std::int32_t channelCount)
+		{
+			typedef union {
+				struct {
+					unsigned char r, g, b, a;
+				} rgba;
+				unsigned int v;
+			} rgba_t;
+
+			#define QOI_OP_INDEX  0x00 /* 00xxxxxx */
+			#define QOI_OP_DIFF   0x40 /* 01xxxxxx */
+			#define QOI_OP_LUMA   0x80 /* 10xxxxxx */
+			#define QOI_OP_RUN    0xc0 /* 11xxxxxx */
+			#define QOI_OP_RGB    0xfe /* 11111110 */
+			#define QOI_OP_RGBA   0xff /* 11111111 */
+
+			#define QOI_MASK_2    0xc0 /* 11000000 */
+
+			#define QOI_COLOR_HASH(C) (C.rgba.r*3 + C.rgba.g*5 + C.rgba.b*7 + C.rgba.a*11)
+
+			rgba_t index[64] { };
+			rgba_t px;
+			std::int32_t run = 0;
+			std::int32_t px_len = width * height * channelCount;
+
+			px.rgba.r = 0;
+			px.rgba.g = 0;
+			px.rgba.b = 0;
+			px.rgba.a = 255;
+
+			for (std::int32_t px_pos = 0; px_pos < px_len; px_pos += channelCount) {
+				if (run > 0) {
+					run--;
+				} else {
+					std::int32_t b1 = readByte();
+
+					if (b1 == QOI_OP_RGB) {
+						px.rgba.r = readByte();
+						px.rgba.g = readByte();
+						px.rgba.b = readByte();
+					} else if (b1 == QOI_OP_RGBA) {
+						px.rgba.r = readByte();
+						px.rgba.g = readByte();
+						px.rgba.b = readByte();
+						px.rgba.a = readByte();
+					} else if ((b1 & QOI_MASK_2) == QOI_OP_INDEX) {
+						px = index[b1];
+					} else if ((b1 & QOI_MASK_2) == QOI_OP_DIFF) {
+						px.rgba.r += ((b1 >> 4) & 0x03) - 2;
+						px.rgba.g += ((b1 >> 2) & 0x03) - 2;
+						px.rgba.b += (b1 & 0x03) - 2;
+					} else if ((b1 & QOI_MASK_2) == QOI_OP_LUMA) {
+						std::int32_t b2 = readByte();
+						std::int32_t vg = (b1 & 0x3f) - 32;
+						px.rgba.r += vg - 8 + ((b2 >> 4) & 0x0f);
+						px.rgba.g += vg;
+						px.rgba.b += vg - 8 + (b2 & 0x0f);
+					} else if ((b1 & QOI_MASK_2) == QOI_OP_RUN) {
+						run = (b1 & 0x3f);
+					}
+
+					index[QOI_COLOR_HASH(px) & (64 - 1)] = px;
 				}
 
-				index[QOI_COLOR_HASH(px) & (64 - 1)] = px;
+				*(rgba_t*)(data + px_pos) = px;
 			}
-
-			*(rgba_t*)(data + px_pos) = px;
 		}
 	}
 
+	void ContentResolver::ReadImageFromFile(std::unique_ptr<Stream>& s, std::uint8_t* data, std::int32_t width, std::int32_t height, std::int32_t channelCount)
+	{
+		DecodeQoiPixels([&s]() -> std::int32_t {
+			return s->ReadValue<std::uint8_t>();
+		}, data, width, height, channelCount);
+	}
+
+	void ContentResolver::ReadImageFromMemory(ArrayView<const char> source, std::uint8_t* data, std::int32_t width, std::int32_t height, std::int32_t channelCount)
+	{
+		// Reading past the end yields zeros, same as reading past the end of a stream
+		const std::uint8_t* ptr = reinterpret_cast<const std::uint8_t*>(source.data());
+		const std::uint8_t* ptrEnd = ptr + source.size();
+		DecodeQoiPixels([&ptr, ptrEnd]() -> std::int32_t {
+			return (ptr < ptrEnd ? *ptr++ : 0);
+		}, data, width, height, channelCount);
+	}
+
 	void ContentResolver::ExpandTileDiffuse(std::uint8_t* pixelsOffset, std::uint32_t widthWithPadding)
 	{
 		// Top
@@ -1055,6 +1517,20 @@ namespace Jazz2
 		std::uint32_t height = s->ReadValueAsLE<std::uint32_t>();
 		std::uint16_t tileCount = s->ReadValueAsLE<std::uint16_t>();
 
+		// Headless processes need only the collision mask, so the file doesn't have to be decompressed if it's already cached
+		String maskCachePath;
+		std::uint64_t fileSize = 0, sourceHash = 0;
+		std::uint32_t maskRowsSize = tileCount * TileSet::DefaultTileSize * sizeof(std::uint32_t);
+		if (_isHeadless) {
+			maskCachePath = fs::CombinePath("Tilesets"_s, path);
+			fileSize = std::uint64_t(s->GetSize());
+			sourceHash = CollisionMaskCache::GetSourceHash(*s);
+			auto maskRows = _maskCache.Find(maskCachePath, fileSize, sourceHash, maskRowsSize);
+			if (maskRows != nullptr) {
+				return std::make_unique<Tiles::TileSet>(path, tileCount, std::static_pointer_cast<const std::uint32_t>(std::move(maskRows)));
+			}
+		}
+
 		// Read compressed palette and mask
 		std::int32_t compressedSize = s->ReadValueAsLE<std::int32_t>();
 
@@ -1069,6 +1545,7 @@ namespace Jazz2
 
 			if (std::memcmp(_palettes, newPalette, ColorsPerPalette * sizeof(std::uint32_t)) != 0) {
 				// Palettes differs, drop all cached resources, so it will be reloaded with new palette
+				DropPendingLoads();
 				if (_isLoading) {
 #if defined(DEATH_DEBUG)
 					LOGW("Releasing all animations because of different palette - Metadata: 0|{}, Animations: 0|{}", _cachedMetadata.size(), _cachedGraphics.size());
@@ -1124,6 +1601,16 @@ namespace Jazz2
 			std::uint32_t widthWithPadding = width + (2 * tilesPerRow);
 			std::uint32_t heightWithPadding = height + (2 * tilesPerColumn);
 			std::unique_ptr<std::uint8_t[]> pixelsWithPadding = std::make_unique<std::uint8_t[]>(widthWithPadding * heightWithPadding * 4);
+
+			// Resolve palette remapping only once, so all 8-bit tiles can be processed the same way
+			std::uint32_t remappedPalette[ColorsPerPalette];
+			const std::uint32_t* tilePalette = _palettes;
+			if (paletteRemapping != nullptr) {
+				for (std::int32_t k = 0; k < ColorsPerPalette; k++) {
+					remappedPalette[k] = _palettes[paletteRemapping[k]];
+				}
+				tilePalette = remappedPalette;
+			}
 			
 			for (uint32_t i = 0; i < tilesPerColumn; i++) {
 				std::uint32_t yf = i * TileSet::DefaultTileSize;
@@ -1139,47 +1626,16 @@ namespace Jazz2
 					if ((is32bitTile[tileIdx / 8] & (1 << (tileIdx & 7))) != 0) {
 						// 32-bit tile
 						for (std::uint32_t y = 0; y < TileSet::DefaultTileSize; y++) {
-							for (std::uint32_t x = 0; x < TileSet::DefaultTileSize; x++) {
-								std::uint32_t srcIdx = ((yf + y) * width + (xf + x)) * 4;
-								std::uint32_t dstIdx = ((y + 1) * widthWithPadding + (x + 1)) * 4;
-
-								dstTile[dstIdx + 0] = pixels[srcIdx + 0]; // R
-								dstTile[dstIdx + 1] = pixels[srcIdx + 1]; // G
-								dstTile[dstIdx + 2] = pixels[srcIdx + 2]; // B
-								dstTile[dstIdx + 3] = pixels[srcIdx + 3]; // A
-							}
-						}
-					} else if (paletteRemapping != nullptr) {
-						// Remapped 8-bit tile
-						for (std::uint32_t y = 0; y < TileSet::DefaultTileSize; y++) {
-							for (std::uint32_t x = 0; x < TileSet::DefaultTileSize; x++) {
-								std::uint32_t srcIdx = ((yf + y) * width + (xf + x)) * 4;
-								std::uint32_t dstIdx = ((y + 1) * widthWithPadding + (x + 1)) * 4;
-
-								std::uint32_t color = _palettes[paletteRemapping[pixels[srcIdx]]];
-								std::uint32_t alpha = pixels[srcIdx + 3];
-
-								dstTile[dstIdx + 0] = (color >> 0) & 0xFF;
-								dstTile[dstIdx + 1] = (color >> 8) & 0xFF;
-								dstTile[dstIdx + 2] = (color >> 16) & 0xFF;
-								dstTile[dstIdx + 3] = ((color >> 24) & 0xFF) * alpha / 255;
-							}
+							std::uint32_t srcIdx = ((yf + y) * width + xf) * 4;
+							std::uint32_t dstIdx = ((y + 1) * widthWithPadding + 1) * 4;
+							std::memcpy(&dstTile[dstIdx], &pixels[srcIdx], TileSet::DefaultTileSize * 4);
 						}
 					} else {
-						// Plain 8-bit tile
+						// 8-bit tile, remapped palette is used if provided
 						for (std::uint32_t y = 0; y < TileSet::DefaultTileSize; y++) {
-							for (std::uint32_t x = 0; x < TileSet::DefaultTileSize; x++) {
-								std::uint32_t srcIdx = ((yf + y) * width + (xf + x)) * 4;
-								std::uint32_t dstIdx = ((y + 1) * widthWithPadding + (x + 1)) * 4;
-
-								std::uint32_t color = _palettes[pixels[srcIdx]];
-								std::uint32_t alpha = pixels[srcIdx + 3];
-
-								dstTile[dstIdx + 0] = (color >> 0) & 0xFF;
-								dstTile[dstIdx + 1] = (color >> 8) & 0xFF;
-								dstTile[dstIdx + 2] = (color >> 16) & 0xFF;
-								dstTile[dstIdx + 3] = ((color >> 24) & 0xFF) * alpha / 255;
-							}
+							std::uint32_t srcIdx = ((yf + y) * width + xf) * 4;
+							std::uint32_t dstIdx = ((y + 1) * widthWithPadding + 1) * 4;
+							applyIndexedPalette(&pixels[srcIdx], &dstTile[dstIdx], TileSet::DefaultTileSize, tilePalette);
 						}
 					}
 
@@ -1223,7 +1679,11 @@ namespace Jazz2
 			return nullptr;
 		}
 
-		return std::make_unique<Tiles::TileSet>(path, tileCount, std::move(textureDiffuse), std::move(mask), maskSize * 8, std::move(captionTile));
+		auto tileSet = std::make_unique<Tiles::TileSet>(path, tileCount, std::move(textureDiffuse), std::move(mask), maskSize * 8, std::move(captionTile));
+		if (_isHeadless && tileCount > 0) {
+			_maskCache.Add(maskCachePath, fileSize, sourceHash, tileSet->GetTileMaskRows(0), maskRowsSize);
+		}
+		return tileSet;
 	}
 
 	bool ContentResolver::LevelExists(StringView levelName)
@@ -1316,6 +1776,7 @@ namespace Jazz2
 
 			if (!_isHeadless && std::memcmp(_palettes, newPalette, ColorsPerPalette * sizeof(std::uint32_t)) != 0) {
 				// Palettes differs, drop all cached resources, so it will be reloaded with new palette
+				DropPendingLoads();
 				if (_isLoading) {
 					_cachedMetadata.clear();
 					_cachedGraphics.clear();
@@ -1446,6 +1907,7 @@ namespace Jazz2
 
 		if (!_isHeadless && std::memcmp(_palettes, SpritePalette, ColorsPerPalette * sizeof(std::uint32_t)) != 0) {
 			// Palettes differs, drop all cached resources, so it will be reloaded with new palette
+			DropPendingLoads();
 			if (_isLoading) {
 				_cachedMetadata.clear();
 				_cachedGraphics.clear();
@@ -1655,6 +2117,11 @@ namespace Jazz2
 		_precompiledShaders[(std::int32_t)PrecompiledShader::BatchedShieldLightning] = CompileShader("BatchedShieldFire", Shaders::BatchedShieldVs, Shaders::ShieldLightningFs, Shader::Introspection::NoUniformsInBlocks);
 		_precompiledShaders[(std::int32_t)PrecompiledShader::ShieldLightning]->RegisterBatchedShader(*_precompiledShaders[(int32_t)PrecompiledShader::BatchedShieldLightning]);
 
+		_precompiledShaders[(std::int32_t)PrecompiledShader::TileLayer] = CompileShader("TileLayer", Shaders::TileLayerVs, Shaders::TileLayerFs, Shader::Introspection::NoUniformsInBlocks);
+		_precompiledShaders[(std::int32_t)PrecompiledShader::TileLayerTinted] = CompileShader("TileLayerTinted", Shaders::TileLayerVs, Shaders::TintedFs, Shader::Introspection::NoUniformsInBlocks);
+		_precompiledShaders[(std::int32_t)PrecompiledShader::InstancedLighting] = CompileShader("InstancedLighting", Shaders::InstancedLightingVs, Shaders::LightingFs, Shader::Introspection::NoUniformsInBlocks);
+		_precompiledShaders[(std::int32_t)PrecompiledShader::Debris] = CompileShader("Debris", Shaders::DebrisVs, Shaders::TileLayerFs, Shader::Introspection::NoUniformsInBlocks);
+
 #if !defined(DISABLE_RESCALE_SHADERS)
 		_precompiledShaders[(std::int32_t)PrecompiledShader::ResizeHQ2x] = CompileShader("ResizeHQ2x", Shaders::ResizeHQ2xVs, Shaders::ResizeHQ2xFs);
 		_precompiledShaders[(std::int32_t)PrecompiledShader::Resize3xBrz] = CompileShader("Resize3xBrz", Shaders::Resize3xBrzVs, Shaders::Resize3xBrzFs);
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "../Main.h"
+#include "CollisionMaskCache.h"
 #include "GameDifficulty.h"
 #include "LevelDescriptor.h"
 #include "Resources.h"
@@ -11,6 +12,10 @@
 #include "../nCine/Graphics/Texture.h"
 #include "../nCine/Base/HashMap.h"
 
+#if defined(WITH_THREADS)
+#	include "../nCine/Threading/ThreadPool.h"
+#endif
+
 #include <Containers/Function.h>
 #include <Containers/Pair.h>
 #include <Containers/Reference.h>
@@ -76,28 +81,50 @@ namespace Jazz2
 
 		/** @brief Returns `true` if the application is running in headless mode (i.e., without any display) */
 		bool IsHeadless() const;
-		/** @brief Sets whether the application is running in headless mode */
+		/** @brief Sets whether the application is running in headless mode, collision masks are shared with other headless processes then */
 		void SetHeadless(bool value);
+		/** @brief Returns `true` if cached resources are shared by multiple independent sessions */
+		bool IsCacheShared() const;
+		/**
+		 * @brief Sets whether cached resources are shared by multiple independent sessions
+		 *
+		 * If enabled, @ref EndLoading() releases only resources that are not referenced by any owner passed to @ref BeginLoading().
+		 */
+		void SetCacheShared(bool value);
 
 #if !defined(DEATH_TARGET_EMSCRIPTEN)
-		/** @brief Scans the `"Content"` and `"Cache"` directories for `.pak` files and mounts them  */
+		/** @brief Scans the `"Content"` and `"Cache"` directories for `.pak` files and mounts them, `.pak` files in `"Content"` are memory-mapped */
 		void RemountPaks();
 #endif
 		/** @brief Tries to find and open a file specified by the path */
 		std::unique_ptr<Stream> OpenContentFile(StringView path, std::int32_t bufferSize = 8192);
+		/**
+		 * @brief Returns contents of a file directly from a memory-mapped `.pak` file
+		 *
+		 * Returns an empty view if the file is not stored uncompressed in any memory-mapped `.pak` file, the caller
+		 * should fall back to @ref OpenContentFile() then. The view is valid until `.pak` files are remounted.
+		 */
+		ArrayView<const char> GetMappedContentFile(StringView path);
 		
-		/** @brief Marks beginning of the loading assets */
-		void BeginLoading();
+		/** @brief Marks beginning of the loading assets, @p owner identifies the session if the cache is shared */
+		void BeginLoading(const void* owner = nullptr);
 		/** @brief Marks end of the loading assets */
 		void EndLoading();
 
 		/** @brief Overrides the default path handler */
 		void OverridePathHandler(Function<String(StringView)>&& callback);
 
-		/** @brief Preloads specified metadata and its linked assets to cache */
+		/**
+		 * @brief Preloads specified metadata and its linked assets to cache
+		 *
+		 * Files are read and decoded on a background thread, textures are then uploaded by @ref ProcessPendingLoads().
+		 * If the metadata is requested before that, @ref RequestMetadata() waits only for the remaining work.
+		 */
 		void PreloadMetadataAsync(StringView path);
 		/** @brief Loads specified metadata and its linked assets if not in cache already and returns it */
 		Metadata* RequestMetadata(StringView path);
+		/** @brief Finishes metadata preloaded on background threads within the specified time budget, should be called once per frame */
+		void ProcessPendingLoads(float timeBudgetMs = 2.0f);
 		/** @brief Loads specified graphics asset if not in cache already and returns it */
 		GenericGraphicResource* RequestGraphics(StringView path, std::uint16_t paletteOffset);
 
@@ -146,23 +173,43 @@ namespace Jazz2
 		ContentResolver(const ContentResolver&) = delete;
 		ContentResolver& operator=(const ContentResolver&) = delete;
 
+#ifndef DOXYGEN_GENERATING_OUTPUT
+		struct DecodedGraphics;
+		struct PendingMetadata;
+#endif
+
 		void InitializePaths();
 
+		bool ReadMetadataFile(PendingMetadata& pending);
+		void DecodeMetadataGraphics(PendingMetadata& pending);
+		Metadata* LoadMetadata(PendingMetadata& pending);
+		/** @brief Waits for all background loads to finish and discards their results, so they are loaded again on request */
+		void DropPendingLoads();
+		void SaveCollisionMasks();
+
 		GenericGraphicResource* RequestGraphicsAura(StringView path, std::uint16_t paletteOffset);
+		bool DecodeGraphicsAura(StringView path, std::uint16_t paletteOffset, DecodedGraphics& decoded);
+		GenericGraphicResource* FinishGraphics(DecodedGraphics& decoded);
 		static void ReadImageFromFile(std::unique_ptr<Stream>& s, std::uint8_t* data, std::int32_t width, std::int32_t height, std::int32_t channelCount);
+		static void ReadImageFromMemory(ArrayView<const char> source, std::uint8_t* data, std::int32_t width, std::int32_t height, std::int32_t channelCount);
 		static void ExpandTileDiffuse(std::uint8_t* pixelsOffset, std::uint32_t widthWithPadding);
 
 		std::unique_ptr<Shader> CompileShader(const char* shaderName, Shader::DefaultVertex vertex, const char* fragment, Shader::Introspection introspection = Shader::Introspection::Enabled, std::initializer_list<StringView> defines = {});
 		std::unique_ptr<Shader> CompileShader(const char* shaderName, const char* vertex, const char* fragment, Shader::Introspection introspection = Shader::Introspection::Enabled, std::initializer_list<StringView> defines = {});
 		
 		void RecreateGemPalettes();
+		std::uint32_t GetCacheOwnerMask(const void* owner);
 #if defined(DEATH_DEBUG)
 		void MigrateGraphics(StringView path);
 #endif
 
 		bool _isHeadless;
 		bool _isLoading;
+		bool _isCacheShared;
+		std::uint32_t _loadingOwnerMask;
+		SmallVector<const void*, 0> _cacheOwners;
 		std::uint32_t _palettes[PaletteCount * ColorsPerPalette];
+		CollisionMaskCache _maskCache;
 		HashMap<Reference<const String>, std::unique_ptr<Metadata>, 
 #if defined(DEATH_TARGET_32BIT)
 			xxHash32Func<String>,
@@ -187,6 +234,13 @@ namespace Jazz2
 #if defined(DEATH_TARGET_ANDROID) || defined(DEATH_TARGET_APPLE) || defined(DEATH_TARGET_UNIX) || defined(DEATH_TARGET_WINDOWS_RT)
 		String _cachePath;
 		String _sourcePath;
+#endif
+#if defined(WITH_THREADS)
+		SmallVector<std::shared_ptr<PendingMetadata>, 0> _pendingMetadata;
+		Mutex _pendingMutex;
+		CondVariable _pendingCV;
+		// Thread pool must be destroyed first, so worker threads don't outlive the resolver state
+		std::unique_ptr<ThreadPool> _loaderThreadPool;
 #endif
 	};
 }
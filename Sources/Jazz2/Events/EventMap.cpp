@@ -9,8 +9,12 @@
 namespace Jazz2::Events
 {
 	EventMap::EventMap(Vector2i layoutSize)
-		: _levelHandler(nullptr), _layoutSize(layoutSize), _pitType(PitType::FallForever)
+		: _levelHandler(nullptr), _layoutSize(layoutSize), _pitType(PitType::FallForever),
+			_chunkCount((layoutSize.X + ChunkSize - 1) / ChunkSize, (layoutSize.Y + ChunkSize - 1) / ChunkSize)
 	{
+		_inactiveEventsInChunk = std::make_unique<std::uint8_t[]>(_chunkCount.X * _chunkCount.Y);
+		_zoneCoverage = std::make_unique<ZoneCoverage[]>(_chunkCount.X * _chunkCount.Y);
+		_actorsInChunk = std::make_unique<SmallVector<ChunkActor, 0>[]>(_chunkCount.X * _chunkCount.Y + 1);
 	}
 
 	void EventMap::SetLevelHandler(ILevelHandler* levelHandler)
@@ -60,11 +64,32 @@ namespace Jazz2::Events
 
 	void EventMap::CreateCheckpointForRollback()
 	{
+		std::int32_t chunkCount = _chunkCount.X * _chunkCount.Y;
 		if (_eventLayoutForRollback == nullptr) {
 			_eventLayoutForRollback = std::make_unique<EventTile[]>(_layoutSize.X * _layoutSize.Y);
+			std::memcpy(_eventLayoutForRollback.get(), _eventLayout.get(), _layoutSize.X * _layoutSize.Y * sizeof(EventTile));
+			_dirtyChunksForRollback.resize(ValueInit, chunkCount);
+			return;
 		}
 
-		std::memcpy(_eventLayoutForRollback.get(), _eventLayout.get(), _layoutSize.X * _layoutSize.Y * sizeof(EventTile));
+		// Chunks that weren't changed since the last checkpoint are already the same
+		for (std::int32_t cy = 0; cy < _chunkCount.Y; cy++) {
+			for (std::int32_t cx = 0; cx < _chunkCount.X; cx++) {
+				if (!_dirtyChunksForRollback[cx + cy * _chunkCount.X]) {
+					continue;
+				}
+
+				std::int32_t x1 = cx * ChunkSize;
+				std::int32_t width = std::min(ChunkSize, _layoutSize.X - x1);
+				std::int32_t y2 = std::min(cy * ChunkSize + ChunkSize, _layoutSize.Y);
+				for (std::int32_t y = cy * ChunkSize; y < y2; y++) {
+					std::int32_t tileID = y * _layoutSize.X + x1;
+					std::memcpy(&_eventLayoutForRollback[tileID], &_eventLayout[tileID], width * sizeof(EventTile));
+				}
+			}
+		}
+
+		_dirtyChunksForRollback.resetAll();
 	}
 
 	void EventMap::RollbackToCheckpoint()
@@ -73,27 +98,41 @@ namespace Jazz2::Events
 			return;
 		}
 
-		for (std::int32_t y = 0; y < _layoutSize.Y; y++) {
-			for (std::int32_t x = 0; x < _layoutSize.X; x++) {
-				std::int32_t tileID = y * _layoutSize.X + x;
-				EventTile& tile = _eventLayout[tileID];
-				EventTile& tilePrev = _eventLayoutForRollback[tileID];
-
-				bool respawn = (tilePrev.IsEventActive && !tile.IsEventActive);
-
-				// Rollback tile
-				tile = tilePrev;
-
-				if (respawn && tile.Event != EventType::Empty) {
-					tile.IsEventActive = true;
+		for (std::int32_t cy = 0; cy < _chunkCount.Y; cy++) {
+			for (std::int32_t cx = 0; cx < _chunkCount.X; cx++) {
+				std::int32_t chunkIdx = cx + cy * _chunkCount.X;
+				if (!_dirtyChunksForRollback[chunkIdx]) {
+					continue;
+				}
 
-					if (tile.Event == EventType::AreaWeather) {
-						_levelHandler->SetWeather((WeatherType)tile.EventParams[0], tile.EventParams[1]);
-					} else if (tile.Event != EventType::Generator) {
-						Actors::ActorState flags = Actors::ActorState::IsCreatedFromEventMap | tile.EventFlags;
-						std::shared_ptr<Actors::ActorBase> actor = _levelHandler->EventSpawner()->SpawnEvent(tile.Event, tile.EventParams, flags, x, y, ILevelHandler::MainPlaneZ);
-						if (actor != nullptr) {
-							_levelHandler->AddActor(actor);
+				// Respawned actors can change the chunk again, so it's marked as clean before
+				_dirtyChunksForRollback.reset(chunkIdx);
+
+				std::int32_t x2 = std::min(cx * ChunkSize + ChunkSize, _layoutSize.X);
+				std::int32_t y2 = std::min(cy * ChunkSize + ChunkSize, _layoutSize.Y);
+				for (std::int32_t y = cy * ChunkSize; y < y2; y++) {
+					for (std::int32_t x = cx * ChunkSize; x < x2; x++) {
+						std::int32_t tileID = y * _layoutSize.X + x;
+						EventTile& tile = _eventLayout[tileID];
+						EventTile& tilePrev = _eventLayoutForRollback[tileID];
+
+						bool respawn = (tilePrev.IsEventActive && !tile.IsEventActive && tilePrev.Event != EventType::Empty);
+						bool wasInactive = IsInactiveEvent(tile);
+
+						// Rollback tile
+						tile = tilePrev;
+						UpdateChunkIndex(x, y, wasInactive, IsInactiveEvent(tile));
+
+						if (respawn) {
+							if (tile.Event == EventType::AreaWeather) {
+								_levelHandler->SetWeather((WeatherType)tile.EventParams[0], tile.EventParams[1]);
+							} else if (tile.Event != EventType::Generator) {
+								Actors::ActorState flags = Actors::ActorState::IsCreatedFromEventMap | tile.EventFlags;
+								std::shared_ptr<Actors::ActorBase> actor = _levelHandler->EventSpawner()->SpawnEvent(tile.Event, tile.EventParams, flags, x, y, ILevelHandler::MainPlaneZ);
+								if (actor != nullptr) {
+									_levelHandler->AddActor(actor);
+								}
+							}
 						}
 					}
 				}
@@ -125,6 +164,8 @@ namespace Jazz2::Events
 			std::memcpy(newEvent.EventParams, tileParams, sizeof(newEvent.EventParams));
 		}
 
+		UpdateChunkIndex(x, y, IsInactiveEvent(previousEvent), IsInactiveEvent(newEvent));
+		MarkChunkDirtyForRollback(x, y);
 		previousEvent = newEvent;
 	}
 
@@ -195,24 +236,48 @@ namespace Jazz2::Events
 		std::int32_t x2 = std::min(_layoutSize.X - 1, tx2);
 		std::int32_t y1 = std::max(0, ty1);
 		std::int32_t y2 = std::min(_layoutSize.Y - 1, ty2);
+		if (x1 > x2 || y1 > y2) {
+			return;
+		}
 
-		for (std::int32_t x = x1; x <= x2; x++) {
-			for (std::int32_t y = y1; y <= y2; y++) {
-				auto& tile = _eventLayout[x + y * _layoutSize.X];
-				if (!tile.IsEventActive && tile.Event != EventType::Empty) {
-					tile.IsEventActive = true;
-
-					if (tile.Event == EventType::AreaWeather) {
-						_levelHandler->SetWeather((WeatherType)tile.EventParams[0], tile.EventParams[1]);
-					} else if (tile.Event != EventType::Generator) {
-						Actors::ActorState flags = Actors::ActorState::IsCreatedFromEventMap | tile.EventFlags;
-						if (allowAsync) {
-							flags |= Actors::ActorState::Async;
-						}
+		// Only chunks that still contain some inactive events are scanned, so the area around players
+		// is usually skipped entirely and only newly exposed parts of the rectangle are processed
+		for (std::int32_t cy = y1 / ChunkSize; cy <= y2 / ChunkSize; cy++) {
+			for (std::int32_t cx = x1 / ChunkSize; cx <= x2 / ChunkSize; cx++) {
+				std::uint8_t& inactiveEvents = _inactiveEventsInChunk[cx + cy * _chunkCount.X];
+				if (inactiveEvents == 0) {
+					continue;
+				}
 
-						std::shared_ptr<Actors::ActorBase> actor = _levelHandler->EventSpawner()->SpawnEvent(tile.Event, tile.EventParams, flags, x, y, ILevelHandler::SpritePlaneZ);
-						if (actor != nullptr) {
-							_levelHandler->AddActor(actor);
+				std::int32_t sx1 = std::max(x1, cx * ChunkSize);
+				std::int32_t sx2 = std::min(x2, cx * ChunkSize + ChunkSize - 1);
+				std::int32_t sy1 = std::max(y1, cy * ChunkSize);
+				std::int32_t sy2 = std::min(y2, cy * ChunkSize + ChunkSize - 1);
+
+				if (!_dirtyChunksForRollback.empty()) {
+					_dirtyChunksForRollback.set(cx + cy * _chunkCount.X);
+				}
+
+				for (std::int32_t x = sx1; x <= sx2; x++) {
+					for (std::int32_t y = sy1; y <= sy2; y++) {
+						auto& tile = _eventLayout[x + y * _layoutSize.X];
+						if (!tile.IsEventActive && tile.Event != EventType::Empty) {
+							tile.IsEventActive = true;
+							inactiveEvents--;
+
+							if (tile.Event == EventType::AreaWeather) {
+								_levelHandler->SetWeather((WeatherType)tile.EventParams[0], tile.EventParams[1]);
+							} else if (tile.Event != EventType::Generator) {
+								Actors::ActorState flags = Actors::ActorState::IsCreatedFromEventMap | tile.EventFlags;
+								if (allowAsync) {
+									flags |= Actors::ActorState::Async;
+								}
+
+								std::shared_ptr<Actors::ActorBase> actor = _levelHandler->EventSpawner()->SpawnEvent(tile.Event, tile.EventParams, flags, x, y, ILevelHandler::SpritePlaneZ);
+								if (actor != nullptr) {
+									_levelHandler->AddActor(actor);
+								}
+							}
 						}
 					}
 				}
@@ -220,10 +285,139 @@ namespace Jazz2::Events
 		}
 	}
 
+	void EventMap::SetActiveZones(ArrayView<const AABBi> zones)
+	{
+		// Only chunks covered until now can leave zones, chunks that are still fully covered are removed below
+		for (std::int32_t chunkIdx : _coveredChunks) {
+			_zoneCoverage[chunkIdx] = ZoneCoverage::None;
+			if (!_actorsInChunk[chunkIdx].empty()) {
+				_leavingChunks.push_back(chunkIdx);
+			}
+		}
+		_coveredChunks.clear();
+		_activeZones.clear();
+		_activeZones.append(zones.begin(), zones.end());
+
+		for (const auto& zone : zones) {
+			// Zones are exclusive, see AABB::Contains()
+			std::int32_t x1 = std::max(0, zone.L + 1);
+			std::int32_t x2 = std::min(_layoutSize.X - 1, zone.R - 1);
+			std::int32_t y1 = std::max(0, zone.T + 1);
+			std::int32_t y2 = std::min(_layoutSize.Y - 1, zone.B - 1);
+			if (x1 > x2 || y1 > y2) {
+				continue;
+			}
+
+			for (std::int32_t cy = y1 / ChunkSize; cy <= y2 / ChunkSize; cy++) {
+				for (std::int32_t cx = x1 / ChunkSize; cx <= x2 / ChunkSize; cx++) {
+					std::int32_t chunkIdx = cx + cy * _chunkCount.X;
+					bool isFull = (x1 <= cx * ChunkSize && x2 >= std::min(_layoutSize.X - 1, cx * ChunkSize + ChunkSize - 1) &&
+								   y1 <= cy * ChunkSize && y2 >= std::min(_layoutSize.Y - 1, cy * ChunkSize + ChunkSize - 1));
+
+					ZoneCoverage& coverage = _zoneCoverage[chunkIdx];
+					if (coverage == ZoneCoverage::None) {
+						_coveredChunks.push_back(chunkIdx);
+					}
+					if (isFull) {
+						coverage = ZoneCoverage::Full;
+					} else if (coverage == ZoneCoverage::None) {
+						coverage = ZoneCoverage::Partial;
+					}
+				}
+			}
+		}
+
+		// Actors outside of the layout are not covered by any chunk, so they are always checked
+		std::int32_t chunkTotal = _chunkCount.X * _chunkCount.Y;
+		if (!_actorsInChunk[chunkTotal].empty()) {
+			_leavingChunks.push_back(chunkTotal);
+		}
+
+		std::sort(_leavingChunks.begin(), _leavingChunks.end());
+		std::size_t count = 0;
+		for (std::size_t i = 0; i < _leavingChunks.size(); i++) {
+			std::int32_t chunkIdx = _leavingChunks[i];
+			if ((count == 0 || _leavingChunks[count - 1] != chunkIdx) &&
+				(chunkIdx >= chunkTotal || _zoneCoverage[chunkIdx] != ZoneCoverage::Full)) {
+				_leavingChunks[count++] = chunkIdx;
+			}
+		}
+		_leavingChunks.resize(count);
+	}
+
+	bool EventMap::IsInActiveZone(Vector2i tile) const
+	{
+		if (tile.X >= 0 && tile.Y >= 0 && tile.X < _layoutSize.X && tile.Y < _layoutSize.Y) {
+			switch (_zoneCoverage[(tile.X / ChunkSize) + (tile.Y / ChunkSize) * _chunkCount.X]) {
+				case ZoneCoverage::None: return false;
+				case ZoneCoverage::Full: return true;
+				default: break;
+			}
+		}
+
+		// Chunk is covered only partially, so all zones have to be checked
+		for (const auto& zone : _activeZones) {
+			if (zone.Contains(tile)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void EventMap::RegisterActor(Actors::ActorBase* actor, Vector2i originTile)
+	{
+		std::int32_t chunkIdx = GetActorChunkIndex(originTile);
+		_actorsInChunk[chunkIdx].push_back({ actor, originTile });
+		// New actors are checked on the next call, because they could be created outside of all zones
+		_leavingChunks.push_back(chunkIdx);
+	}
+
+	void EventMap::UnregisterActor(Actors::ActorBase* actor, Vector2i originTile)
+	{
+		auto& actors = _actorsInChunk[GetActorChunkIndex(originTile)];
+		for (std::size_t i = 0; i < actors.size(); i++) {
+			if (actors[i].Actor == actor) {
+				actors.eraseUnordered(i);
+				break;
+			}
+		}
+	}
+
+	void EventMap::DeactivateActorsOutsideActiveZones(Function<bool(Actors::ActorBase*, Vector2i)>&& callback)
+	{
+		std::size_t count = 0;
+		for (std::size_t i = 0; i < _leavingChunks.size(); i++) {
+			std::int32_t chunkIdx = _leavingChunks[i];
+			bool isPending = false;
+			// The callback can add new actors, so the list must not be iterated by reference
+			for (std::size_t j = 0; j < _actorsInChunk[chunkIdx].size(); j++) {
+				ChunkActor entry = _actorsInChunk[chunkIdx][j];
+				if (!IsInActiveZone(entry.OriginTile) && !callback(entry.Actor, entry.OriginTile)) {
+					isPending = true;
+				}
+			}
+			if (isPending) {
+				_leavingChunks[count++] = chunkIdx;
+			}
+		}
+		_leavingChunks.resize(count);
+	}
+
+	std::int32_t EventMap::GetActorChunkIndex(Vector2i tile) const
+	{
+		if (tile.X >= 0 && tile.Y >= 0 && tile.X < _layoutSize.X && tile.Y < _layoutSize.Y) {
+			return (tile.X / ChunkSize) + (tile.Y / ChunkSize) * _chunkCount.X;
+		}
+		return _chunkCount.X * _chunkCount.Y;
+	}
+
 	void EventMap::Deactivate(std::int32_t x, std::int32_t y)
 	{
 		if (HasEventByPosition(x, y)) {
-			_eventLayout[x + y * _layoutSize.X].IsEventActive = false;
+			auto& tile = _eventLayout[x + y * _layoutSize.X];
+			UpdateChunkIndex(x, y, IsInactiveEvent(tile), true);
+			MarkChunkDirtyForRollback(x, y);
+			tile.IsEventActive = false;
 		}
 	}
 
@@ -270,16 +464,24 @@ namespace Jazz2::Events
 			_eventLayout[x + y * _layoutSize.X].Event != EventType::Empty);
 	}
 
-	void EventMap::ForEachEvent(Function<bool(EventTile&, std::int32_t, std::int32_t)>&& forEachCallback) const
+	void EventMap::ForEachEvent(Function<bool(EventTile&, std::int32_t, std::int32_t)>&& forEachCallback)
 	{
-		for (std::int32_t y = 0; y < _layoutSize.Y; y++) {
+		bool shouldContinue = true;
+		for (std::int32_t y = 0; y < _layoutSize.Y && shouldContinue; y++) {
 			for (std::int32_t x = 0; x < _layoutSize.X; x++) {
 				auto& event = _eventLayout[x + y * _layoutSize.X];
 				if (event.Event != EventType::Empty && !forEachCallback(event, x, y)) {
-					return;
+					shouldContinue = false;
+					break;
 				}
 			}
 		}
+
+		// Events can be modified by the callback, so the index has to be rebuilt
+		RebuildChunkIndex();
+		if (!_dirtyChunksForRollback.empty()) {
+			_dirtyChunksForRollback.setAll();
+		}
 	}
 
 	bool EventMap::IsHurting(float x, float y, Direction dir)
@@ -468,6 +670,8 @@ namespace Jazz2::Events
 
 			// TODO: Spawn off-grid events
 		}
+
+		RebuildChunkIndex();
 	}
 
 	void EventMap::AddWarpTarget(std::uint16_t id, std::int32_t x, std::int32_t y)
@@ -500,6 +704,11 @@ namespace Jazz2::Events
 			tile.EventFlags = (Actors::ActorState)src.ReadVariableUint32();
 			src.Read(tile.EventParams, sizeof(tile.EventParams));
 		}
+
+		RebuildChunkIndex();
+		if (!_dirtyChunksForRollback.empty()) {
+			_dirtyChunksForRollback.setAll();
+		}
 	}
 
 	void EventMap::SerializeResumableToStream(Stream& dest, bool fromCheckpoint)
@@ -514,4 +723,45 @@ namespace Jazz2::Events
 			dest.Write(tile.EventParams, sizeof(tile.EventParams)); // TODO: Optimize this
 		}
 	}
-}
\ No newline at end of file
+
+	void EventMap::RebuildChunkIndex()
+	{
+		std::int32_t chunkCount = _chunkCount.X * _chunkCount.Y;
+		std::memset(_inactiveEventsInChunk.get(), 0, chunkCount * sizeof(std::uint8_t));
+
+		if (_eventLayout == nullptr) {
+			return;
+		}
+
+		for (std::int32_t y = 0; y < _layoutSize.Y; y++) {
+			for (std::int32_t x = 0; x < _layoutSize.X; x++) {
+				if (IsInactiveEvent(_eventLayout[x + y * _layoutSize.X])) {
+					_inactiveEventsInChunk[(x / ChunkSize) + (y / ChunkSize) * _chunkCount.X]++;
+				}
+			}
+		}
+	}
+
+	void EventMap::MarkChunkDirtyForRollback(std::int32_t x, std::int32_t y)
+	{
+		if (_dirtyChunksForRollback.empty() || x < 0 || y < 0 || x >= _layoutSize.X || y >= _layoutSize.Y) {
+			return;
+		}
+
+		_dirtyChunksForRollback.set((x / ChunkSize) + (y / ChunkSize) * _chunkCount.X);
+	}
+
+	void EventMap::UpdateChunkIndex(std::int32_t x, std::int32_t y, bool wasInactive, bool isInactive)
+	{
+		if (wasInactive == isInactive || x < 0 || y < 0 || x >= _layoutSize.X || y >= _layoutSize.Y) {
+			return;
+		}
+
+		std::uint8_t& inactiveEvents = _inactiveEventsInChunk[(x / ChunkSize) + (y / ChunkSize) * _chunkCount.X];
+		if (isInactive) {
+			inactiveEvents++;
+		} else {
+			inactiveEvents--;
+		}
+	}
+}
@@ -5,6 +5,8 @@
 #include "../GameDifficulty.h"
 #include "../PitType.h"
 
+#include "../../nCine/Base/BitArray.h"
+
 #include <IO/Stream.h>
 
 using namespace Death::IO;
@@ -45,9 +47,9 @@ namespace Jazz2::Events
 
 		/** @brief Returns spawn position for specified player type */
 		Vector2f GetSpawnPosition(PlayerType type);
-		/** @brief Creates a checkpoint for eventual rollback */
+		/** @brief Creates a checkpoint for eventual rollback, only chunks changed since the last checkpoint are copied */
 		void CreateCheckpointForRollback();
-		/** @brief Rolls back to the last checkpoint */
+		/** @brief Rolls back to the last checkpoint, only chunks changed since the last checkpoint are restored */
 		void RollbackToCheckpoint();
 
 		/** @brief Stores tile event description */
@@ -59,6 +61,21 @@ namespace Jazz2::Events
 		void ProcessGenerators(float timeMult);
 		/** @brief Activates all inactive events in specified tile restangle */
 		void ActivateEvents(std::int32_t tx1, std::int32_t ty1, std::int32_t tx2, std::int32_t ty2, bool allowAsync);
+		/** @brief Sets tile rectangles (usually around players) in which activated events should be kept alive */
+		void SetActiveZones(ArrayView<const AABBi> zones);
+		/** @brief Returns `true` if specified tile position lies inside any zone specified by @ref SetActiveZones() */
+		bool IsInActiveZone(Vector2i tile) const;
+		/** @brief Adds an actor created from an event to the chunk of its origin tile, so it can be deactivated later */
+		void RegisterActor(Actors::ActorBase* actor, Vector2i originTile);
+		/** @brief Removes an actor added by @ref RegisterActor() */
+		void UnregisterActor(Actors::ActorBase* actor, Vector2i originTile);
+		/**
+		 * @brief Calls the callback for registered actors whose origin tile lies outside all zones
+		 *
+		 * Only chunks that left any zone in the last @ref SetActiveZones() are checked. If the callback returns `false`,
+		 * the actor refused the deactivation and its chunk is checked again next time.
+		 */
+		void DeactivateActorsOutsideActiveZones(Function<bool(Actors::ActorBase*, Vector2i)>&& callback);
 		/** @brief Deactivates event on specified tile position */
 		void Deactivate(std::int32_t x, std::int32_t y);
 		/** @brief Resets generator on specified tile position */
@@ -73,7 +90,7 @@ namespace Jazz2::Events
 		/** @brief Returns `true` if specified tile position contains an event */
 		bool HasEventByPosition(std::int32_t x, std::int32_t y) const;
 		/** @brief Calls specified callback function for each event */
-		void ForEachEvent(Function<bool(EventTile&, std::int32_t, std::int32_t)>&& forEachCallback) const;
+		void ForEachEvent(Function<bool(EventTile&, std::int32_t, std::int32_t)>&& forEachCallback);
 		/** @brief Returns `true` if specified position contains hurt event */
 		bool IsHurting(float x, float y, Direction dir);
 		/** @overload */
@@ -96,6 +113,9 @@ namespace Jazz2::Events
 		void SerializeResumableToStream(Stream& dest, bool fromCheckpoint = false);
 
 	private:
+		// Events are indexed in square chunks of tiles, so regions without inactive events can be skipped quickly
+		static constexpr std::int32_t ChunkSize = 8;
+
 #ifndef DOXYGEN_GENERATING_OUTPUT
 		// Doxygen 1.12.0 outputs also private structs/unions even if it shouldn't
 		struct GeneratorInfo {
@@ -118,6 +138,17 @@ namespace Jazz2::Events
 			std::uint16_t Id;
 			Vector2f Pos;
 		};
+
+		enum class ZoneCoverage : std::uint8_t {
+			None,
+			Partial,
+			Full
+		};
+
+		struct ChunkActor {
+			Actors::ActorBase* Actor;
+			Vector2i OriginTile;
+		};
 #endif
 
 		ILevelHandler* _levelHandler;
@@ -125,8 +156,28 @@ namespace Jazz2::Events
 		PitType _pitType;
 		std::unique_ptr<EventTile[]> _eventLayout;
 		std::unique_ptr<EventTile[]> _eventLayoutForRollback;
+		// Chunks changed since the last checkpoint, empty until the first checkpoint is created
+		BitArray _dirtyChunksForRollback;
 		SmallVector<GeneratorInfo, 0> _generators;
 		SmallVector<SpawnPoint, 0> _spawnPoints;
 		SmallVector<WarpTarget, 0> _warpTargets;
+		Vector2i _chunkCount;
+		std::unique_ptr<std::uint8_t[]> _inactiveEventsInChunk;
+		std::unique_ptr<ZoneCoverage[]> _zoneCoverage;
+		SmallVector<std::int32_t, 0> _coveredChunks;
+		SmallVector<AABBi, 0> _activeZones;
+		// Actors are indexed by chunk of their origin tile, actors outside of the layout are stored at index `_chunkCount.X * _chunkCount.Y`
+		std::unique_ptr<SmallVector<ChunkActor, 0>[]> _actorsInChunk;
+		// Chunks that left any zone or contain actors that still need to be checked
+		SmallVector<std::int32_t, 0> _leavingChunks;
+
+		void RebuildChunkIndex();
+		std::int32_t GetActorChunkIndex(Vector2i tile) const;
+		void UpdateChunkIndex(std::int32_t x, std::int32_t y, bool wasInactive, bool isInactive);
+		void MarkChunkDirtyForRollback(std::int32_t x, std::int32_t y);
+
+		static bool IsInactiveEvent(const EventTile& tile) {
+			return (tile.Event != EventType::Empty && !tile.IsEventActive);
+		}
 	};
 }
\ No newline at end of file
@@ -122,6 +122,14 @@ namespace Jazz2
 			return IsPositionEmpty(self, aabb, params, &collider);
 		}
 
+		/**
+		 * @brief Returns the first vertical offset at which an actor moved by the specified offset may not be blocked by tiles
+		 *
+		 * Offsets from @p startY down to @p endY are probed at once, so @ref IsPositionEmpty() needs to be called
+		 * only for the returned offset. If all offsets are blocked, a value lower than @p endY is returned.
+		 */
+		virtual float FindFirstEmptyOffsetY(Actors::ActorBase* self, float offsetX, float startY, float endY, float step, const Tiles::TileCollisionParams& params) = 0;
+
 		/** @brief Calls the callback function for all colliding objects with specified AABB */
 		virtual void FindCollisionActorsByAABB(const Actors::ActorBase* self, const AABBf& aabb, Function<bool(Actors::ActorBase*)>&& callback) = 0;
 		/** @brief Calls the callback function for all colliding objects with specified circle */
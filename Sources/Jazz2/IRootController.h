@@ -24,6 +24,7 @@ namespace Jazz2
 			IsInitialized = 0x01,
 			IsVerified = 0x02,
 			IsPlayable = 0x04,
+			HasMultipleSessions = 0x08,
 
 #if defined(DEATH_TARGET_ANDROID)
 			HasExternalStoragePermission = 0x10,
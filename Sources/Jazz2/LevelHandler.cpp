@@ -107,12 +107,13 @@ namespace Jazz2
 
 	LevelHandler::LevelHandler(IRootController* root)
 		: _root(root), _lightingShader(nullptr), _blurShader(nullptr), _downsampleShader(nullptr), _combineShader(nullptr),
-			_combineWithWaterShader(nullptr), _eventSpawner(this), _difficulty(GameDifficulty::Default), _isReforged(false),
+			_combineWithWaterShader(nullptr), _emittedLightsFrame(UINT32_MAX), _maxLightExtent(0.0f), _eventSpawner(this), _difficulty(GameDifficulty::Default), _isReforged(false),
 			_cheatsUsed(false), _checkpointCreated(false), _nextLevelType(ExitType::None),
 			_nextLevelTime(0.0f), _elapsedMillisecondsBegin(0), _elapsedFrames(0.0f), _checkpointFrames(0.0f),
 			_waterLevel(FLT_MAX), _weatherType(WeatherType::None), _pressedKeys(ValueInit, (std::size_t)Keys::Count),
 			_overrideActions(0), _overrideMovement(0.0f, 0.0f)
 	{
+		_emittedLights.reserve(32);
 	}
 
 	LevelHandler::~LevelHandler()
@@ -140,7 +141,7 @@ namespace Jazz2
 		_elapsedMillisecondsBegin = levelInit.ElapsedMilliseconds;
 
 		auto& resolver = ContentResolver::Get();
-		resolver.BeginLoading();
+		resolver.BeginLoading(_root);
 
 		_noiseTexture = resolver.GetNoiseTexture();
 
@@ -195,7 +196,7 @@ namespace Jazz2
 		_checkpointFrames = src.ReadValue<float>();
 
 		auto& resolver = ContentResolver::Get();
-		resolver.BeginLoading();
+		resolver.BeginLoading(_root);
 
 		_noiseTexture = resolver.GetNoiseTexture();
 
@@ -356,6 +357,73 @@ namespace Jazz2
 		return _actors;
 	}
 
+	ArrayView<const LightEmitter> LevelHandler::GetEmittedLights()
+	{
+		std::uint32_t frameCount = theApplication().GetFrameCount();
+		if (_emittedLightsFrame != frameCount) {
+			ZoneScopedC(0x4876AF);
+
+			_emittedLightsFrame = frameCount;
+			_emittedLights.clear();
+
+			auto emitLights = [this](Actors::ActorBase* emitter) {
+				std::size_t first = _emittedLights.size();
+				emitter->OnEmitLights(_emittedLights);
+
+				// Lights can be offset from the actor, so the largest reach of any light seen so far is tracked
+				Vector2f pos = emitter->GetPos();
+				for (std::size_t i = first; i < _emittedLights.size(); i++) {
+					const auto& light = _emittedLights[i];
+					float extent = std::max(std::abs(light.Pos.X - pos.X), std::abs(light.Pos.Y - pos.Y)) + light.RadiusFar;
+					if (_maxLightExtent < extent) {
+						_maxLightExtent = extent;
+					}
+				}
+			};
+
+			// Only emitters near any viewport are asked, the bounds are expanded by the largest extent, so lights from outside still reach in
+			AABBf viewBounds(FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX);
+			for (auto& viewport : _assignedViewports) {
+				Vector2f halfView = (viewport->_view->GetSize() / 2).As<float>();
+				viewBounds = AABBf::Combine(viewBounds, AABBf(viewport->_cameraPos - halfView, viewport->_cameraPos + halfView));
+			}
+			viewBounds.L -= _maxLightExtent;
+			viewBounds.T -= _maxLightExtent;
+			viewBounds.R += _maxLightExtent;
+			viewBounds.B += _maxLightExtent;
+
+			for (auto* emitter : _lightEmitters) {
+				Vector2f pos = emitter->GetPos();
+				if (pos.X >= viewBounds.L && pos.X <= viewBounds.R && pos.Y >= viewBounds.T && pos.Y <= viewBounds.B) {
+					emitLights(emitter);
+				}
+			}
+
+			// Newly added emitters are asked once regardless of their position, so their extent is known before they can be skipped
+			for (auto* emitter : _newLightEmitters) {
+				emitLights(emitter);
+				_lightEmitters.push_back(emitter);
+			}
+			_newLightEmitters.clear();
+		}
+
+		return _emittedLights;
+	}
+
+	void LevelHandler::UnregisterLightEmitter(Actors::ActorBase* actor)
+	{
+		auto it = std::find(_lightEmitters.begin(), _lightEmitters.end(), actor);
+		if (it != _lightEmitters.end()) {
+			_lightEmitters.eraseUnordered(it);
+			return;
+		}
+
+		it = std::find(_newLightEmitters.begin(), _newLightEmitters.end(), actor);
+		if (it != _newLightEmitters.end()) {
+			_newLightEmitters.eraseUnordered(it);
+		}
+	}
+
 	ArrayView<Actors::Player* const> LevelHandler::GetPlayers() const
 	{
 		return _players;
@@ -852,6 +920,14 @@ namespace Jazz2
 			actor->_collisionProxyID = _collisions.CreateProxy(actor->AABB, actor.get());
 		}
 
+		if (_eventMap != nullptr && (actor->_state & (Actors::ActorState::IsCreatedFromEventMap | Actors::ActorState::IsFromGenerator)) != Actors::ActorState::None) {
+			_eventMap->RegisterActor(actor.get(), actor->_originTile);
+		}
+
+		if (actor->GetState(Actors::ActorState::EmitsLights)) {
+			_newLightEmitters.push_back(actor.get());
+		}
+
 		_actors.push_back(std::move(actor));
 	}
 
@@ -922,12 +998,9 @@ namespace Jazz2
 
 		if (self->GetState(Actors::ActorState::CollideWithTileset)) {
 			if (_tileMap != nullptr) {
-				if (self->GetState(Actors::ActorState::CollideWithTilesetReduced) && aabb.B - aabb.T >= 20.0f) {
-					// If hitbox height is larger than 20px, check bottom and top separately (and top only if going upwards)
-					AABBf aabbTop = aabb;
-					aabbTop.B = aabbTop.T + 6.0f;
-					AABBf aabbBottom = aabb;
-					aabbBottom.T = aabbBottom.B - std::max(14.0f, (aabb.B - aabb.T) - 10.0f);
+				AABBf aabbTop, aabbBottom;
+				if (self->GetState(Actors::ActorState::CollideWithTilesetReduced) && Tiles::TileMap::SplitReducedHitbox(aabb, aabbTop, aabbBottom)) {
+					// Check bottom and top separately (and top only if going upwards)
 					if (!_tileMap->IsTileEmpty(aabbBottom, params)) {
 						return false;
 					}
@@ -948,7 +1021,7 @@ namespace Jazz2
 		// Check for solid objects
 		if (self->GetState(Actors::ActorState::CollideWithSolidObjects)) {
 			Actors::ActorBase* colliderActor = nullptr;
-			FindCollisionActorsByAABB(self, aabb, [self, &colliderActor, &params](Actors::ActorBase* actor) -> bool {
+			QueryCollisionActors(self, aabb, [self, &colliderActor, &params](Actors::ActorBase* actor) -> bool {
 				if ((actor->GetState() & (Actors::ActorState::IsSolidObject | Actors::ActorState::IsDestroyed)) != Actors::ActorState::IsSolidObject) {
 					return true;
 				}
@@ -963,9 +1036,7 @@ namespace Jazz2
 
 				auto* solidObject = runtime_cast<Actors::SolidObjectBase>(actor);
 				if (solidObject == nullptr || !solidObject->IsOneWay || params.Downwards) {
-					std::shared_ptr selfShared = self->shared_from_this();
-					std::shared_ptr actorShared = actor->shared_from_this();
-					if (!selfShared->OnHandleCollision(actorShared) && !actorShared->OnHandleCollision(selfShared)) {
+					if (!self->OnHandleCollision(actor) && !actor->OnHandleCollision(self)) {
 						colliderActor = actor;
 						return false;
 					}
@@ -980,28 +1051,19 @@ namespace Jazz2
 		return (*collider == nullptr);
 	}
 
-	void LevelHandler::FindCollisionActorsByAABB(const Actors::ActorBase* self, const AABBf& aabb, Function<bool(Actors::ActorBase*)>&& callback)
+	float LevelHandler::FindFirstEmptyOffsetY(Actors::ActorBase* self, float offsetX, float startY, float endY, float step, const TileCollisionParams& params)
 	{
-		struct QueryHelper {
-			const LevelHandler* Handler;
-			const Actors::ActorBase* Self;
-			const AABBf& AABB;
-			Function<bool(Actors::ActorBase*)>& Callback;
+		if (_tileMap == nullptr || !self->GetState(Actors::ActorState::CollideWithTileset)) {
+			return startY;
+		}
 
-			bool OnCollisionQuery(std::int32_t nodeId) {
-				Actors::ActorBase* actor = (Actors::ActorBase*)Handler->_collisions.GetUserData(nodeId);
-				if (Self == actor || (actor->GetState() & (Actors::ActorState::CollideWithOtherActors | Actors::ActorState::IsDestroyed)) != Actors::ActorState::CollideWithOtherActors) {
-					return true;
-				}
-				if (actor->IsCollidingWith(AABB)) {
-					return Callback(actor);
-				}
-				return true;
-			}
-		};
+		return _tileMap->FindFirstEmptyOffsetY(self->AABBInner, offsetX, startY, endY, step, params,
+			self->GetState(Actors::ActorState::CollideWithTilesetReduced));
+	}
 
-		QueryHelper helper = { this, self, aabb, callback };
-		_collisions.Query(&helper, aabb);
+	void LevelHandler::FindCollisionActorsByAABB(const Actors::ActorBase* self, const AABBf& aabb, Function<bool(Actors::ActorBase*)>&& callback)
+	{
+		QueryCollisionActors(self, aabb, callback);
 	}
 
 	void LevelHandler::FindCollisionActorsByRadius(float x, float y, float radius, Function<bool(Actors::ActorBase*)>&& callback)
@@ -1532,41 +1594,36 @@ namespace Jazz2
 
 		if (!_players.empty()) {
 			std::size_t playerCount = _players.size();
-			SmallVector<AABBi, ControlScheme::MaxSupportedPlayers * 2> playerZones;
-			playerZones.reserve(playerCount * 2);
+			SmallVector<AABBi, ControlScheme::MaxSupportedPlayers> activationZones;
+			SmallVector<AABBi, ControlScheme::MaxSupportedPlayers> deactivationZones;
+			activationZones.reserve(playerCount);
+			deactivationZones.reserve(playerCount);
 			for (std::size_t i = 0; i < playerCount; i++) {
 				auto pos = _players[i]->GetPos();
 				std::int32_t tx = (std::int32_t)pos.X / TileSet::DefaultTileSize;
 				std::int32_t ty = (std::int32_t)pos.Y / TileSet::DefaultTileSize;
 
-				const auto& activationRange = playerZones.emplace_back(tx - ActivateTileRange, ty - ActivateTileRange, tx + ActivateTileRange, ty + ActivateTileRange);
-				playerZones.emplace_back(activationRange.L - 4, activationRange.T - 4, activationRange.R + 4, activationRange.B + 4);
+				const auto& activationRange = activationZones.emplace_back(tx - ActivateTileRange, ty - ActivateTileRange, tx + ActivateTileRange, ty + ActivateTileRange);
+				deactivationZones.emplace_back(activationRange.L - 4, activationRange.T - 4, activationRange.R + 4, activationRange.B + 4);
 			}
 
-			for (auto& actor : _actors) {
-				if ((actor->_state & (Actors::ActorState::IsCreatedFromEventMap | Actors::ActorState::IsFromGenerator)) != Actors::ActorState::None) {
-					Vector2i originTile = actor->_originTile;
-					bool isInside = false;
-					for (std::size_t i = 1; i < playerZones.size(); i += 2) {
-						if (playerZones[i].Contains(originTile)) {
-							isInside = true;
-							break;
-						}
-					}
-
-					if (!isInside && actor->OnTileDeactivated()) {
-						if ((actor->_state & Actors::ActorState::IsFromGenerator) == Actors::ActorState::IsFromGenerator) {
-							_eventMap->ResetGenerator(originTile.X, originTile.Y);
-						}
+			// Actors are indexed by chunks of the event map, so only actors in chunks that left any zone are checked
+			_eventMap->SetActiveZones(deactivationZones);
+			_eventMap->DeactivateActorsOutsideActiveZones([this](Actors::ActorBase* actor, Vector2i originTile) -> bool {
+				if (!actor->OnTileDeactivated()) {
+					return false;
+				}
 
-						_eventMap->Deactivate(originTile.X, originTile.Y);
-						actor->_state |= Actors::ActorState::IsDestroyed;
-					}
+				if ((actor->_state & Actors::ActorState::IsFromGenerator) == Actors::ActorState::IsFromGenerator) {
+					_eventMap->ResetGenerator(originTile.X, originTile.Y);
 				}
-			}
 
-			for (std::size_t i = 0; i < playerZones.size(); i += 2) {
-				const auto& activationZone = playerZones[i];
+				_eventMap->Deactivate(originTile.X, originTile.Y);
+				actor->_state |= Actors::ActorState::IsDestroyed;
+				return true;
+			});
+
+			for (const auto& activationZone : activationZones) {
 				_eventMap->ActivateEvents(activationZone.L, activationZone.T, activationZone.R, activationZone.B, true);
 			}
 
@@ -1797,6 +1854,12 @@ namespace Jazz2
 					_collisions.DestroyProxy(actor->_collisionProxyID);
 					actor->_collisionProxyID = Collisions::NullNode;
 				}
+				if ((actor->_state & (Actors::ActorState::IsCreatedFromEventMap | Actors::ActorState::IsFromGenerator)) != Actors::ActorState::None) {
+					_eventMap->UnregisterActor(actor, actor->_originTile);
+				}
+				if (actor->GetState(Actors::ActorState::EmitsLights)) {
+					UnregisterLightEmitter(actor);
+				}
 				it = _actors.eraseUnordered(it);
 				continue;
 			}
@@ -1813,25 +1876,8 @@ namespace Jazz2
 			++it;
 		}
 
-		struct UpdatePairsHelper {
-			void OnPairAdded(void* proxyA, void* proxyB) {
-				Actors::ActorBase* actorA = (Actors::ActorBase*)proxyA;
-				Actors::ActorBase* actorB = (Actors::ActorBase*)proxyB;
-				if (((actorA->GetState() | actorB->GetState()) & (Actors::ActorState::CollideWithOtherActors | Actors::ActorState::IsDestroyed)) != Actors::ActorState::CollideWithOtherActors) {
-					return;
-				}
-
-				if (actorA->IsCollidingWith(actorB)) {
-					std::shared_ptr<Actors::ActorBase> actorSharedA = actorA->shared_from_this();
-					std::shared_ptr<Actors::ActorBase> actorSharedB = actorB->shared_from_this();
-					if (!actorSharedA->OnHandleCollision(actorSharedB->shared_from_this())) {
-						actorSharedB->OnHandleCollision(actorSharedA->shared_from_this());
-					}
-				}
-			}
-		};
-		UpdatePairsHelper helper;
-		_collisions.UpdatePairs(&helper);
+		// Actors are only marked as destroyed during collision handling and removed later, so raw pointers stay valid
+		Collisions::CollisionDispatch<Actors::ActorBase, Actors::ActorState>::ResolvePairs(_collisions);
 	}
 
 	void LevelHandler::AssignViewport(Actors::Player* player)
@@ -5,12 +5,13 @@
 #include "IStateHandler.h"
 #include "IRootController.h"
 #include "LevelDescriptor.h"
+#include "LightEmitter.h"
 #include "WeatherType.h"
 #include "Events/EventMap.h"
 #include "Events/EventSpawner.h"
 #include "Tiles/ITileMapOwner.h"
 #include "Tiles/TileMap.h"
-#include "Collisions/DynamicTreeBroadPhase.h"
+#include "Collisions/CollisionDispatch.h"
 #include "Input/RumbleProcessor.h"
 #include "Input/ControlScheme.h"
 #include "Rendering/UpscaleRenderPass.h"
@@ -140,6 +141,7 @@ namespace Jazz2
 		std::shared_ptr<AudioBufferPlayer> PlayCommonSfx(StringView identifier, const Vector3f& pos, float gain = 1.0f, float pitch = 1.0f) override;
 		void WarpCameraToTarget(Actors::ActorBase* actor, bool fast = false) override;
 		bool IsPositionEmpty(Actors::ActorBase* self, const AABBf& aabb, Tiles::TileCollisionParams& params, Actors::ActorBase** collider) override;
+		float FindFirstEmptyOffsetY(Actors::ActorBase* self, float offsetX, float startY, float endY, float step, const Tiles::TileCollisionParams& params) override;
 		void FindCollisionActorsByAABB(const Actors::ActorBase* self, const AABBf& aabb, Function<bool(Actors::ActorBase*)>&& callback) override;
 		void FindCollisionActorsByRadius(float x, float y, float radius, Function<bool(Actors::ActorBase*)>&& callback) override;
 		void GetCollidingPlayers(const AABBf& aabb, Function<bool(Actors::ActorBase*)>&& callback) override;
@@ -220,6 +222,11 @@ namespace Jazz2
 #endif
 		SmallVector<std::shared_ptr<Actors::ActorBase>, 0> _actors;
 		SmallVector<Actors::Player*, LevelInitialization::MaxPlayerCount> _players;
+		SmallVector<Actors::ActorBase*, 0> _lightEmitters;
+		SmallVector<Actors::ActorBase*, 0> _newLightEmitters;
+		SmallVector<LightEmitter, 0> _emittedLights;
+		std::uint32_t _emittedLightsFrame;
+		float _maxLightExtent;
 
 		String _levelName;
 		String _levelDisplayName;
@@ -300,6 +307,13 @@ namespace Jazz2
 		void ProcessWeather(float timeMult);
 		/** @brief Resolves collisions */
 		void ResolveCollisions(float timeMult);
+		/** @brief Calls the callback for each actor colliding with the specified AABB, unlike @ref FindCollisionActorsByAABB() the callback is not type-erased */
+		template<class TCallback>
+		void QueryCollisionActors(const Actors::ActorBase* self, const AABBf& aabb, TCallback&& callback);
+		/** @brief Returns lights emitted by actors near any viewport, they are collected only once per frame and shared by all viewports */
+		ArrayView<const LightEmitter> GetEmittedLights();
+		/** @brief Removes destroyed actor from registered light emitters */
+		void UnregisterLightEmitter(Actors::ActorBase* actor);
 		/** @brief Assigns viewport */
 		void AssignViewport(Actors::Player* player);
 		/** @brief Unassigns viewport */
@@ -344,4 +358,10 @@ namespace Jazz2
 		bool CheatMorph();
 		bool CheatShield();
 	};
+
+	template<class TCallback>
+	void LevelHandler::QueryCollisionActors(const Actors::ActorBase* self, const AABBf& aabb, TCallback&& callback)
+	{
+		Collisions::CollisionDispatch<Actors::ActorBase, Actors::ActorState>::QueryActors(_collisions, self, aabb, callback);
+	}
 }
\ No newline at end of file
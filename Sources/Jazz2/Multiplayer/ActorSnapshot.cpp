@@ -0,0 +1,235 @@
+﻿#include "ActorSnapshot.h"
+
+#if defined(WITH_MULTIPLAYER)
+
+#include <algorithm>
+
+namespace Jazz2::Multiplayer
+{
+	// Bit widths of variable-length groups, chosen for typical values of each field
+	static constexpr std::uint32_t ActorIdGroupBits = 4;
+	static constexpr std::uint32_t PositionDeltaGroupBits = 6;
+	static constexpr std::uint32_t PositionGroupBits = 10;
+	static constexpr std::uint32_t AnimationGroupBits = 8;
+	static constexpr std::uint32_t FieldCount = 5;
+	static constexpr std::uint32_t MiscFlagsBits = 5;
+	static constexpr std::uint32_t RendererTypeBits = 3;
+
+	ActorSnapshotFields ActorSnapshotState::GetChangedFields(const ActorSnapshotState& other) const
+	{
+		ActorSnapshotFields fields = ActorSnapshotFields::None;
+		if (PosX != other.PosX || PosY != other.PosY) {
+			fields |= ActorSnapshotFields::Position;
+		}
+		if (Animation != other.Animation) {
+			fields |= ActorSnapshotFields::Animation;
+		}
+		if (Rotation != other.Rotation) {
+			fields |= ActorSnapshotFields::Rotation;
+		}
+		if (ScaleX != other.ScaleX || ScaleY != other.ScaleY) {
+			fields |= ActorSnapshotFields::Scale;
+		}
+		if (Flags != other.Flags || RendererType != other.RendererType) {
+			fields |= ActorSnapshotFields::Misc;
+		}
+		return fields;
+	}
+
+	ActorSnapshot::ActorSnapshot()
+		: UpdateID(0)
+	{
+	}
+
+	const ActorSnapshotState* ActorSnapshot::Find(std::uint32_t actorId) const
+	{
+		auto it = std::lower_bound(States.begin(), States.end(), actorId, [](const ActorSnapshotState& state, std::uint32_t id) {
+			return state.ActorID < id;
+		});
+		return (it != States.end() && it->ActorID == actorId ? &*it : nullptr);
+	}
+
+	std::uint32_t ActorSnapshot::WriteDelta(BitWriter& writer, const ActorSnapshot* baseline) const
+	{
+		// Removed states are written first, so they can be skipped while merging with the baseline
+		if (baseline != nullptr) {
+			std::uint32_t lastActorId = 0;
+			std::size_t j = 0;
+			for (const auto& prevState : baseline->States) {
+				while (j < States.size() && States[j].ActorID < prevState.ActorID) {
+					j++;
+				}
+				if (j < States.size() && States[j].ActorID == prevState.ActorID) {
+					continue;
+				}
+				writer.WriteBool(true);
+				writer.WriteVariableUint32(prevState.ActorID - lastActorId, ActorIdGroupBits);
+				lastActorId = prevState.ActorID;
+			}
+		}
+		writer.WriteBool(false);
+
+		std::uint32_t writtenCount = 0;
+		std::uint32_t lastActorId = 0;
+		std::size_t j = 0;
+		for (const auto& state : States) {
+			const ActorSnapshotState* prevState = nullptr;
+			if (baseline != nullptr) {
+				while (j < baseline->States.size() && baseline->States[j].ActorID < state.ActorID) {
+					j++;
+				}
+				if (j < baseline->States.size() && baseline->States[j].ActorID == state.ActorID) {
+					prevState = &baseline->States[j];
+				}
+			}
+
+			ActorSnapshotFields fields = (prevState != nullptr ? state.GetChangedFields(*prevState) : ActorSnapshotFields::All);
+			if (fields == ActorSnapshotFields::None) {
+				continue;
+			}
+
+			writer.WriteBool(true);
+			writer.WriteVariableUint32(state.ActorID - lastActorId, ActorIdGroupBits);
+			writer.Write((std::uint32_t)fields, FieldCount);
+			lastActorId = state.ActorID;
+
+			if ((fields & ActorSnapshotFields::Position) == ActorSnapshotFields::Position) {
+				if (prevState != nullptr) {
+					writer.WriteVariableInt32(state.PosX - prevState->PosX, PositionDeltaGroupBits);
+					writer.WriteVariableInt32(state.PosY - prevState->PosY, PositionDeltaGroupBits);
+				} else {
+					writer.WriteVariableInt32(state.PosX, PositionGroupBits);
+					writer.WriteVariableInt32(state.PosY, PositionGroupBits);
+				}
+			}
+			if ((fields & ActorSnapshotFields::Animation) == ActorSnapshotFields::Animation) {
+				writer.WriteVariableUint32(state.Animation, AnimationGroupBits);
+			}
+			if ((fields & ActorSnapshotFields::Rotation) == ActorSnapshotFields::Rotation) {
+				writer.Write(state.Rotation, ActorSnapshotState::RotationBits);
+			}
+			if ((fields & ActorSnapshotFields::Scale) == ActorSnapshotFields::Scale) {
+				writer.Write(state.ScaleX, 16);
+				writer.Write(state.ScaleY, 16);
+			}
+			if ((fields & ActorSnapshotFields::Misc) == ActorSnapshotFields::Misc) {
+				writer.Write(state.Flags >> 2, MiscFlagsBits);
+				writer.Write(state.RendererType, RendererTypeBits);
+			}
+
+			writtenCount++;
+		}
+		writer.WriteBool(false);
+
+		return writtenCount;
+	}
+
+	bool ActorSnapshot::ReadDelta(BitReader& reader, const ActorSnapshot* baseline)
+	{
+		DEATH_DEBUG_ASSERT(baseline != this);
+
+		SmallVector<std::uint32_t, 0> removedActorIds;
+		std::uint32_t lastActorId = 0;
+		while (reader.ReadBool() && reader.IsValid()) {
+			lastActorId += reader.ReadVariableUint32(ActorIdGroupBits);
+			removedActorIds.push_back(lastActorId);
+		}
+
+		States.clear();
+		if (baseline != nullptr) {
+			States.reserve(baseline->States.size());
+		}
+
+		std::size_t i = 0, j = 0;
+		auto copyBaselineUntil = [&](std::uint32_t actorId) {
+			if (baseline == nullptr) {
+				return;
+			}
+			while (i < baseline->States.size() && baseline->States[i].ActorID < actorId) {
+				const auto& prevState = baseline->States[i++];
+				while (j < removedActorIds.size() && removedActorIds[j] < prevState.ActorID) {
+					j++;
+				}
+				if (j < removedActorIds.size() && removedActorIds[j] == prevState.ActorID) {
+					continue;
+				}
+				States.push_back(prevState);
+			}
+		};
+
+		lastActorId = 0;
+		while (reader.ReadBool() && reader.IsValid()) {
+			std::uint32_t actorId = lastActorId + reader.ReadVariableUint32(ActorIdGroupBits);
+			ActorSnapshotFields fields = (ActorSnapshotFields)reader.Read(FieldCount);
+			lastActorId = actorId;
+
+			copyBaselineUntil(actorId);
+
+			const ActorSnapshotState* prevState = nullptr;
+			if (baseline != nullptr && i < baseline->States.size() && baseline->States[i].ActorID == actorId) {
+				prevState = &baseline->States[i++];
+			}
+
+			ActorSnapshotState& state = States.emplace_back();
+			if (prevState != nullptr) {
+				state = *prevState;
+			} else if (fields != ActorSnapshotFields::All) {
+				// New state must contain all fields
+				return false;
+			}
+			state.ActorID = actorId;
+
+			if ((fields & ActorSnapshotFields::Position) == ActorSnapshotFields::Position) {
+				if (prevState != nullptr) {
+					state.PosX += reader.ReadVariableInt32(PositionDeltaGroupBits);
+					state.PosY += reader.ReadVariableInt32(PositionDeltaGroupBits);
+				} else {
+					state.PosX = reader.ReadVariableInt32(PositionGroupBits);
+					state.PosY = reader.ReadVariableInt32(PositionGroupBits);
+				}
+			}
+			if ((fields & ActorSnapshotFields::Animation) == ActorSnapshotFields::Animation) {
+				state.Animation = reader.ReadVariableUint32(AnimationGroupBits);
+			}
+			if ((fields & ActorSnapshotFields::Rotation) == ActorSnapshotFields::Rotation) {
+				state.Rotation = (std::uint16_t)reader.Read(ActorSnapshotState::RotationBits);
+			}
+			if ((fields & ActorSnapshotFields::Scale) == ActorSnapshotFields::Scale) {
+				state.ScaleX = (std::uint16_t)reader.Read(16);
+				state.ScaleY = (std::uint16_t)reader.Read(16);
+			}
+			if ((fields & ActorSnapshotFields::Misc) == ActorSnapshotFields::Misc) {
+				state.Flags = (std::uint8_t)(reader.Read(MiscFlagsBits) << 2);
+				state.RendererType = (std::uint8_t)reader.Read(RendererTypeBits);
+			}
+		}
+
+		copyBaselineUntil(UINT32_MAX);
+
+		return reader.IsValid();
+	}
+
+	void ActorSnapshotHistory::Clear()
+	{
+		for (auto& snapshot : _snapshots) {
+			snapshot.UpdateID = 0;
+			snapshot.States.clear();
+		}
+	}
+
+	const ActorSnapshot* ActorSnapshotHistory::Find(std::uint32_t updateId) const
+	{
+		const auto& snapshot = _snapshots[updateId % Size];
+		return (updateId != 0 && snapshot.UpdateID == updateId ? &snapshot : nullptr);
+	}
+
+	ActorSnapshot& ActorSnapshotHistory::Push(std::uint32_t updateId)
+	{
+		auto& snapshot = _snapshots[updateId % Size];
+		snapshot.UpdateID = updateId;
+		snapshot.States.clear();
+		return snapshot;
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,97 @@
+﻿#pragma once
+
+#if defined(WITH_MULTIPLAYER) || defined(DOXYGEN_GENERATING_OUTPUT)
+
+#include "BitStream.h"
+
+namespace Jazz2::Multiplayer
+{
+	/** @brief Fields of @ref ActorSnapshotState, used to describe which fields changed */
+	enum class ActorSnapshotFields : std::uint8_t {
+		None = 0,
+
+		Position = 0x01,		/**< Position */
+		Animation = 0x02,		/**< Animation state */
+		Rotation = 0x04,		/**< Rotation */
+		Scale = 0x08,			/**< Scale */
+		Misc = 0x10,			/**< Misc flags and renderer type */
+
+		All = Position | Animation | Rotation | Scale | Misc
+	};
+
+	DEATH_ENUM_FLAGS(ActorSnapshotFields);
+
+	/** @brief Replicated state of a single actor in @ref ActorSnapshot */
+	struct ActorSnapshotState
+	{
+		/** @brief Number of bits used for quantized rotation */
+		static constexpr std::uint32_t RotationBits = 10;
+
+		/** @brief Actor ID */
+		std::uint32_t ActorID;
+		/** @brief Position X in 1/512 pixels */
+		std::int32_t PosX;
+		/** @brief Position Y in 1/512 pixels */
+		std::int32_t PosY;
+		/** @brief Current animation state */
+		std::uint32_t Animation;
+		/** @brief Rotation quantized to @ref RotationBits bits */
+		std::uint16_t Rotation;
+		/** @brief Scale X as half-precision float */
+		std::uint16_t ScaleX;
+		/** @brief Scale Y as half-precision float */
+		std::uint16_t ScaleY;
+		/** @brief Renderer type */
+		std::uint8_t RendererType;
+		/** @brief Misc flags, see @ref Actors::Multiplayer::RemoteActor::SyncMiscWithServer() */
+		std::uint8_t Flags;
+
+		/** @brief Returns fields that differ from the specified state */
+		ActorSnapshotFields GetChangedFields(const ActorSnapshotState& other) const;
+	};
+
+	/**
+		@brief Replicated state of all actors relevant to a peer in a specific update
+
+		Snapshots are delta-compressed against an older snapshot that was already acknowledged
+		by the client. Only changed states and IDs of removed states are serialized, positions
+		are written as differences to the baseline state if possible.
+	*/
+	struct ActorSnapshot
+	{
+		/** @brief Update ID of the snapshot, `0` if unused */
+		std::uint32_t UpdateID;
+		/** @brief Actor states sorted by actor ID */
+		SmallVector<ActorSnapshotState, 0> States;
+
+		ActorSnapshot();
+
+		/** @brief Returns state of the specified actor or @cpp nullptr @ce if the actor is not included */
+		const ActorSnapshotState* Find(std::uint32_t actorId) const;
+
+		/** @brief Writes changes against the baseline (or all states if @p baseline is @cpp nullptr @ce), returns number of written states */
+		std::uint32_t WriteDelta(BitWriter& writer, const ActorSnapshot* baseline) const;
+		/** @brief Reconstructs states from the baseline (or from scratch if @p baseline is @cpp nullptr @ce) and changes */
+		bool ReadDelta(BitReader& reader, const ActorSnapshot* baseline);
+	};
+
+	/** @brief Fixed-size history of recent actor snapshots, indexed by update ID */
+	class ActorSnapshotHistory
+	{
+	public:
+		/** @brief Number of snapshots kept in the history */
+		static constexpr std::uint32_t Size = 32;
+
+		/** @brief Removes all snapshots */
+		void Clear();
+		/** @brief Returns snapshot with the specified update ID or @cpp nullptr @ce if it's not in the history anymore */
+		const ActorSnapshot* Find(std::uint32_t updateId) const;
+		/** @brief Returns an empty snapshot for the specified update ID, the oldest snapshot in the same slot is overwritten */
+		ActorSnapshot& Push(std::uint32_t updateId);
+
+	private:
+		ActorSnapshot _snapshots[Size];
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,235 @@
+﻿#include "AssetStreamer.h"
+
+#if defined(WITH_MULTIPLAYER)
+
+#include "PacketCodec.h"
+#include "PacketTypes.h"
+
+#include <IO/FileSystem.h>
+#include <IO/MemoryStream.h>
+
+using namespace Death::IO;
+
+namespace Jazz2::Multiplayer
+{
+	AssetStreamer::AssetStreamer(NetworkManager* networkManager, std::uint32_t bytesPerSecond, Function<void(const Peer&)>&& onFinished)
+		: _networkManager(networkManager), _bytesPerSecond(bytesPerSecond), _onFinished(std::move(onFinished))
+#if defined(WITH_THREADS)
+			, _shouldExit(false)
+#endif
+	{
+#if defined(WITH_THREADS)
+		_thread = Thread(AssetStreamer::OnWorkerThread, this);
+#endif
+	}
+
+	AssetStreamer::~AssetStreamer()
+	{
+#if defined(WITH_THREADS)
+		_mutex.Lock();
+		_shouldExit = true;
+		_cv.Broadcast();
+		_mutex.Unlock();
+		_thread.Join();
+#endif
+	}
+
+	void AssetStreamer::Start(const Peer& peer, SmallVector<AssetStreamRequest, 0>&& assets)
+	{
+		auto transfer = std::make_unique<Transfer>();
+		transfer->Target = peer;
+		transfer->Assets = std::move(assets);
+		transfer->AssetIndex = 0;
+		transfer->ChunksInFlight = 0;
+		transfer->Budget = 0.0f;
+		transfer->LastRefill = TimeStamp::now();
+		transfer->StartTime = transfer->LastRefill;
+		transfer->BytesSent = 0;
+
+		LOGI("[MP] Started streaming {} assets to peer [{}]", transfer->Assets.size(), peer);
+
+#if defined(WITH_THREADS)
+		_mutex.Lock();
+#endif
+		for (std::size_t i = 0; i < _transfers.size(); i++) {
+			if (_transfers[i]->Target == peer) {
+				_transfers.erase(_transfers.begin() + i);
+				break;
+			}
+		}
+		_transfers.push_back(std::move(transfer));
+#if defined(WITH_THREADS)
+		_cv.Signal();
+		_mutex.Unlock();
+#endif
+	}
+
+	void AssetStreamer::Cancel(const Peer& peer)
+	{
+#if defined(WITH_THREADS)
+		_mutex.Lock();
+#endif
+		for (std::size_t i = 0; i < _transfers.size(); i++) {
+			if (_transfers[i]->Target == peer) {
+				LOGI("[MP] Cancelled streaming of assets to peer [{}]", peer);
+				_transfers.erase(_transfers.begin() + i);
+				break;
+			}
+		}
+#if defined(WITH_THREADS)
+		_mutex.Unlock();
+#endif
+	}
+
+	void AssetStreamer::OnChunksAcknowledged(const Peer& peer, std::uint32_t count)
+	{
+#if defined(WITH_THREADS)
+		_mutex.Lock();
+#endif
+		for (auto& transfer : _transfers) {
+			if (transfer->Target == peer) {
+				transfer->ChunksInFlight = (count < transfer->ChunksInFlight ? transfer->ChunksInFlight - count : 0);
+				break;
+			}
+		}
+#if defined(WITH_THREADS)
+		_mutex.Unlock();
+#endif
+	}
+
+	bool AssetStreamer::ProcessTransfers()
+	{
+		bool anythingSent = false;
+		SmallVector<Peer, 4> finishedPeers;
+
+#if defined(WITH_THREADS)
+		_mutex.Lock();
+#endif
+		for (std::size_t i = 0; i < _transfers.size(); i++) {
+			Transfer& transfer = *_transfers[i];
+
+			if (_bytesPerSecond > 0) {
+				// Allow short bursts, but never more than a few chunks at once
+				float maxBudget = std::max((float)_bytesPerSecond * 0.25f, (float)ChunkSize * 2.0f);
+				transfer.Budget = std::min(transfer.Budget + transfer.LastRefill.secondsSince() * (float)_bytesPerSecond, maxBudget);
+				transfer.LastRefill = TimeStamp::now();
+			}
+
+			// Only one chunk per peer is sent in each pass, so all transfers progress evenly
+			if (transfer.ChunksInFlight < WindowSize && (_bytesPerSecond == 0 || transfer.Budget > 0.0f)) {
+				if (SendNextChunk(transfer)) {
+					anythingSent = true;
+				} else if (transfer.AssetIndex >= transfer.Assets.size() && transfer.ChunksInFlight == 0) {
+					LOGI("[MP] Finished streaming {} assets to peer [{}] - {} bytes took {:.1f} ms", transfer.Assets.size(),
+						transfer.Target, transfer.BytesSent, transfer.StartTime.millisecondsSince());
+					finishedPeers.push_back(transfer.Target);
+					_transfers.erase(_transfers.begin() + i);
+					i--;
+				}
+			}
+		}
+#if defined(WITH_THREADS)
+		_mutex.Unlock();
+#endif
+
+		for (const Peer& peer : finishedPeers) {
+			_onFinished(peer);
+		}
+
+		return anythingSent;
+	}
+
+	std::uint32_t AssetStreamer::GetActiveTransferCount()
+	{
+#if defined(WITH_THREADS)
+		_mutex.Lock();
+#endif
+		std::uint32_t count = (std::uint32_t)_transfers.size();
+#if defined(WITH_THREADS)
+		_mutex.Unlock();
+#endif
+		return count;
+	}
+
+	bool AssetStreamer::SendNextChunk(Transfer& transfer)
+	{
+		if (transfer.AssetIndex >= transfer.Assets.size()) {
+			return false;
+		}
+
+		const AssetStreamRequest& asset = transfer.Assets[transfer.AssetIndex];
+
+		if (transfer.File == nullptr) {
+			transfer.File = fs::Open(asset.FullPath, FileAccess::Read);
+			if (transfer.File->IsValid() && asset.Offset > 0) {
+				transfer.File->Seek(asset.Offset, SeekOrigin::Begin);
+			}
+
+			MemoryStream packet(22 + asset.Path.size());
+			packet.WriteValue<std::uint8_t>(asset.Type);
+			packet.WriteVariableUint32((std::uint32_t)asset.Path.size());
+			packet.Write(asset.Path.data(), (std::int64_t)asset.Path.size());
+			packet.WriteVariableInt64(asset.Size);
+			packet.WriteValue<std::uint32_t>(asset.Crc32);
+			packet.WriteVariableInt64(transfer.File->IsValid() ? asset.Offset : 0);
+			SendPacket(transfer.Target, PacketType::Begin, arrayView(packet.GetBuffer(), (std::size_t)packet.GetSize()));
+		}
+
+		std::uint8_t buffer[ChunkSize];
+		std::int64_t bytesRead = (transfer.File->IsValid() ? transfer.File->Read(buffer, sizeof(buffer)) : 0);
+		if (bytesRead <= 0) {
+			SendPacket(transfer.Target, PacketType::End, {});
+			transfer.File = nullptr;
+			transfer.AssetIndex++;
+		} else {
+			MemoryStream packet(bytesRead + 8);
+			PacketCodec::Compress(arrayView(buffer, (std::size_t)bytesRead), packet);
+			SendPacket(transfer.Target, PacketType::Chunk, arrayView(packet.GetBuffer(), (std::size_t)packet.GetSize()));
+			transfer.Budget -= (float)packet.GetSize();
+			transfer.BytesSent += (std::uint64_t)packet.GetSize();
+		}
+
+		// Both chunks and the end of asset are acknowledged by the peer
+		transfer.ChunksInFlight++;
+		return true;
+	}
+
+	void AssetStreamer::SendPacket(const Peer& peer, PacketType type, ArrayView<const std::uint8_t> data)
+	{
+		MemoryStream packet(1 + data.size());
+		packet.WriteValue<std::uint8_t>((std::uint8_t)type);
+		if (!data.empty()) {
+			packet.Write(data.data(), (std::int64_t)data.size());
+		}
+		_networkManager->SendTo(peer, NetworkChannel::AssetStreaming, (std::uint8_t)ServerPacketType::StreamAsset, packet);
+	}
+
+#if defined(WITH_THREADS)
+	void AssetStreamer::OnWorkerThread(void* param)
+	{
+		Thread::SetCurrentName("Asset streaming");
+
+		AssetStreamer* _this = static_cast<AssetStreamer*>(param);
+
+		while (true) {
+			_this->_mutex.Lock();
+			while (_this->_transfers.empty() && !_this->_shouldExit) {
+				_this->_cv.Wait(_this->_mutex);
+			}
+			bool shouldExit = _this->_shouldExit;
+			_this->_mutex.Unlock();
+
+			if (shouldExit) {
+				break;
+			}
+
+			if (!_this->ProcessTransfers()) {
+				// All transfers are waiting for acknowledgements or budget
+				Thread::Sleep(5);
+			}
+		}
+	}
+#endif
+}
+
+#endif
@@ -0,0 +1,134 @@
+﻿#pragma once
+
+#if defined(WITH_MULTIPLAYER) || defined(DOXYGEN_GENERATING_OUTPUT)
+
+#include "../../Main.h"
+#include "NetworkManager.h"
+#include "Peer.h"
+
+#include "../../nCine/Base/TimeStamp.h"
+#if defined(WITH_THREADS)
+#	include "../../nCine/Threading/Thread.h"
+#	include "../../nCine/Threading/ThreadSync.h"
+#endif
+
+#include <Containers/Function.h>
+#include <Containers/SmallVector.h>
+#include <Containers/String.h>
+#include <IO/Stream.h>
+
+#include <memory>
+
+using namespace Death::Containers;
+using namespace Death::IO;
+using namespace nCine;
+
+namespace Jazz2::Multiplayer
+{
+	/** @brief Asset requested to be streamed by @ref AssetStreamer */
+	struct AssetStreamRequest
+	{
+		/** @brief Asset type, see @ref MpLevelHandler::AssetType */
+		std::uint8_t Type;
+		/** @brief CRC32 checksum of the whole asset */
+		std::uint32_t Crc32;
+		/** @brief Path of the asset as known by the client */
+		String Path;
+		/** @brief Full path of the asset on the server */
+		String FullPath;
+		/** @brief Size of the asset in bytes */
+		std::int64_t Size;
+		/** @brief Offset in bytes from which the transfer is resumed */
+		std::int64_t Offset;
+	};
+
+	/**
+		@brief Streams missing assets to connected peers
+
+		All transfers are served by a single shared worker in round-robin order. Each peer can have at most
+		@ref WindowSize unacknowledged chunks in flight and is limited by a bandwidth budget, so joining peers
+		don't flood the reliable queue and don't add latency to other players. Chunks are sent on
+		@ref NetworkChannel::AssetStreaming and compressed by @ref PacketCodec if it pays off.
+
+		@experimental
+	*/
+	class AssetStreamer
+	{
+	public:
+		/** @brief Maximum size of asset data in one chunk */
+		static constexpr std::int32_t ChunkSize = 16 * 1024;
+		/** @brief Maximum number of unacknowledged chunks per peer */
+		static constexpr std::uint32_t WindowSize = 8;
+
+		/** @brief Type of @ref ServerPacketType::StreamAsset packet, stored in the first byte of the payload */
+		enum class PacketType : std::uint8_t {
+			Begin = 1,		/**< Asset transfer begins */
+			Chunk,			/**< Chunk of asset data */
+			End				/**< Asset transfer ends */
+		};
+
+		/**
+		 * @brief Creates the streamer
+		 *
+		 * @param networkManager    Network manager used to send chunks
+		 * @param bytesPerSecond    Bandwidth budget per peer, `0` for unlimited
+		 * @param onFinished        Called when all assets were acknowledged by the peer, it may be called from the worker thread
+		 */
+		AssetStreamer(NetworkManager* networkManager, std::uint32_t bytesPerSecond, Function<void(const Peer&)>&& onFinished);
+		~AssetStreamer();
+
+		AssetStreamer(const AssetStreamer&) = delete;
+		AssetStreamer& operator=(const AssetStreamer&) = delete;
+
+		/** @brief Starts streaming of specified assets to the peer, previous transfer to the same peer is cancelled */
+		void Start(const Peer& peer, SmallVector<AssetStreamRequest, 0>&& assets);
+		/** @brief Cancels transfer to the peer */
+		void Cancel(const Peer& peer);
+		/** @brief Should be called when the peer acknowledges received chunks */
+		void OnChunksAcknowledged(const Peer& peer, std::uint32_t count);
+		/**
+		 * @brief Sends chunks of all transfers within their window and budget, returns `true` if anything was sent
+		 *
+		 * It's called by the worker thread, it should be called once per frame only if threads are not available.
+		 */
+		bool ProcessTransfers();
+
+		/** @brief Returns number of peers that are currently receiving assets */
+		std::uint32_t GetActiveTransferCount();
+
+	private:
+#ifndef DOXYGEN_GENERATING_OUTPUT
+		// Doxygen 1.12.0 outputs also private structs/unions even if it shouldn't
+		struct Transfer
+		{
+			Peer Target;
+			SmallVector<AssetStreamRequest, 0> Assets;
+			std::uint32_t AssetIndex;
+			std::unique_ptr<Stream> File;
+			std::uint32_t ChunksInFlight;
+			float Budget;
+			TimeStamp LastRefill;
+			TimeStamp StartTime;
+			std::uint64_t BytesSent;
+		};
+#endif
+
+		NetworkManager* _networkManager;
+		std::uint32_t _bytesPerSecond;
+		Function<void(const Peer&)> _onFinished;
+		SmallVector<std::unique_ptr<Transfer>, 0> _transfers;
+#if defined(WITH_THREADS)
+		Mutex _mutex;
+		CondVariable _cv;
+		Thread _thread;
+		bool _shouldExit;
+
+		static void OnWorkerThread(void* param);
+#endif
+
+		bool SendNextChunk(Transfer& transfer);
+		void SendPacket(const Peer& peer, PacketType type, ArrayView<const std::uint8_t> data);
+	};
+}
+
+#endif
@@ -0,0 +1,181 @@
+﻿#pragma once
+
+#if defined(WITH_MULTIPLAYER) || defined(DOXYGEN_GENERATING_OUTPUT)
+
+#include "../../Main.h"
+
+#include <Containers/ArrayView.h>
+#include <Containers/SmallVector.h>
+
+using namespace Death::Containers;
+
+namespace Jazz2::Multiplayer
+{
+	/**
+		@brief Writes values of arbitrary bit width to a byte buffer
+
+		Bits are written from the least significant bit of each value, the last byte is zero-padded
+		by @ref Flush(). Variable-length values are split into groups of the specified bit width,
+		each group is followed by a continuation bit.
+	*/
+	class BitWriter
+	{
+	public:
+		BitWriter(std::size_t initialCapacity = 0)
+			: _pending(0), _pendingBits(0)
+		{
+			if (initialCapacity > 0) {
+				_buffer.reserve(initialCapacity);
+			}
+		}
+
+		/** @brief Writes lowest @p bitCount bits of the value, @p bitCount must be at most 32 */
+		void Write(std::uint32_t value, std::uint32_t bitCount)
+		{
+			DEATH_DEBUG_ASSERT(bitCount <= 32);
+			if (bitCount < 32) {
+				value &= (1u << bitCount) - 1;
+			}
+			_pending |= (std::uint64_t)value << _pendingBits;
+			_pendingBits += bitCount;
+			while (_pendingBits >= 8) {
+				_buffer.push_back((std::uint8_t)_pending);
+				_pending >>= 8;
+				_pendingBits -= 8;
+			}
+		}
+
+		/** @brief Writes a single bit */
+		void WriteBool(bool value)
+		{
+			Write(value ? 1 : 0, 1);
+		}
+
+		/** @brief Writes an unsigned value as groups of @p groupBits bits with continuation bits */
+		void WriteVariableUint32(std::uint32_t value, std::uint32_t groupBits)
+		{
+			while (true) {
+				std::uint32_t group = value & ((1u << groupBits) - 1);
+				value >>= groupBits;
+				Write(group, groupBits);
+				if (value == 0) {
+					WriteBool(false);
+					break;
+				}
+				WriteBool(true);
+			}
+		}
+
+		/** @brief Writes a signed value using zig-zag encoding, so small negative values stay short */
+		void WriteVariableInt32(std::int32_t value, std::uint32_t groupBits)
+		{
+			WriteVariableUint32(((std::uint32_t)value << 1) ^ (std::uint32_t)(value >> 31), groupBits);
+		}
+
+		/** @brief Writes remaining bits to the buffer */
+		void Flush()
+		{
+			if (_pendingBits > 0) {
+				_buffer.push_back((std::uint8_t)_pending);
+				_pending = 0;
+				_pendingBits = 0;
+			}
+		}
+
+		/** @brief Returns written bytes, @ref Flush() should be called first */
+		ArrayView<const std::uint8_t> GetBuffer() const
+		{
+			return _buffer;
+		}
+
+		/** @brief Returns number of written bytes, @ref Flush() should be called first */
+		std::size_t GetSize() const
+		{
+			return _buffer.size();
+		}
+
+	private:
+		SmallVector<std::uint8_t, 0> _buffer;
+		std::uint64_t _pending;
+		std::uint32_t _pendingBits;
+	};
+
+	/**
+		@brief Reads values written by @ref BitWriter
+
+		Reading past the end of the buffer returns zero bits and marks the reader as invalid.
+	*/
+	class BitReader
+	{
+	public:
+		BitReader(ArrayView<const std::uint8_t> buffer)
+			: _buffer(buffer), _offset(0), _pending(0), _pendingBits(0), _isValid(true)
+		{
+		}
+
+		/** @brief Reads @p bitCount bits, @p bitCount must be at most 32 */
+		std::uint32_t Read(std::uint32_t bitCount)
+		{
+			DEATH_DEBUG_ASSERT(bitCount <= 32);
+			while (_pendingBits < bitCount) {
+				if DEATH_UNLIKELY(_offset >= _buffer.size()) {
+					_isValid = false;
+					_pendingBits = bitCount;
+					break;
+				}
+				_pending |= (std::uint64_t)_buffer[_offset++] << _pendingBits;
+				_pendingBits += 8;
+			}
+			std::uint32_t value = (std::uint32_t)(bitCount < 32 ? (_pending & ((1ull << bitCount) - 1)) : _pending);
+			_pending >>= bitCount;
+			_pendingBits -= bitCount;
+			return value;
+		}
+
+		/** @brief Reads a single bit */
+		bool ReadBool()
+		{
+			return (Read(1) != 0);
+		}
+
+		/** @brief Reads an unsigned value written by @ref BitWriter::WriteVariableUint32() */
+		std::uint32_t ReadVariableUint32(std::uint32_t groupBits)
+		{
+			std::uint32_t value = 0;
+			std::uint32_t shift = 0;
+			while (true) {
+				std::uint32_t group = Read(groupBits);
+				if (shift < 32) {
+					value |= group << shift;
+				}
+				shift += groupBits;
+				if (!ReadBool() || !_isValid) {
+					break;
+				}
+			}
+			return value;
+		}
+
+		/** @brief Reads a signed value written by @ref BitWriter::WriteVariableInt32() */
+		std::int32_t ReadVariableInt32(std::uint32_t groupBits)
+		{
+			std::uint32_t value = ReadVariableUint32(groupBits);
+			return (std::int32_t)(value >> 1) ^ -(std::int32_t)(value & 1);
+		}
+
+		/** @brief Returns `false` if the reader tried to read past the end of the buffer */
+		bool IsValid() const
+		{
+			return _isValid;
+		}
+
+	private:
+		ArrayView<const std::uint8_t> _buffer;
+		std::size_t _offset;
+		std::uint64_t _pending;
+		std::uint32_t _pendingBits;
+		bool _isValid;
+	};
+}
+
+#endif
\ No newline at end of file
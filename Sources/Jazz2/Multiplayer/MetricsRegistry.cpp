@@ -0,0 +1,219 @@
+﻿#include "MetricsRegistry.h"
+
+#if defined(WITH_MULTIPLAYER)
+
+#include "../../nCine/Base/Algorithms.h"
+
+#include <mutex>
+
+#include <Containers/StringConcatenable.h>
+#include <IO/FileSystem.h>
+
+using namespace Death::Containers::Literals;
+using namespace nCine;
+
+namespace Jazz2::Multiplayer
+{
+	static void WriteText(Stream& dest, StringView text)
+	{
+		if (!text.empty()) {
+			dest.Write(text.data(), (std::int64_t)text.size());
+		}
+	}
+
+	static void WriteNumber(Stream& dest, double value)
+	{
+		char buffer[32];
+		std::int32_t length = formatString(buffer, "%.15g", value);
+		dest.Write(buffer, length);
+	}
+
+	static void WriteSample(Stream& dest, StringView name, StringView suffix, StringView labels, StringView extraLabel, double value)
+	{
+		WriteText(dest, name);
+		WriteText(dest, suffix);
+		if (!labels.empty() || !extraLabel.empty()) {
+			WriteText(dest, "{"_s);
+			WriteText(dest, labels);
+			if (!labels.empty() && !extraLabel.empty()) {
+				WriteText(dest, ","_s);
+			}
+			WriteText(dest, extraLabel);
+			WriteText(dest, "}"_s);
+		}
+		WriteText(dest, " "_s);
+		WriteNumber(dest, value);
+		WriteText(dest, "\n"_s);
+	}
+
+	MetricsRegistry::MetricsRegistry()
+	{
+	}
+
+	void MetricsRegistry::Register(StringView name, MetricType type, StringView help, ArrayView<const double> buckets)
+	{
+		std::unique_lock lock(_lock);
+		if (FindFamily(name) != nullptr) {
+			return;
+		}
+
+		auto& family = _families.emplace_back();
+		family.Name = name;
+		family.Help = help;
+		family.Type = type;
+		if (type == MetricType::Histogram) {
+			family.Buckets.append(buckets.begin(), buckets.end());
+		}
+	}
+
+	void MetricsRegistry::Increment(StringView name, double value, StringView labels)
+	{
+		std::unique_lock lock(_lock);
+		Family* family = FindFamily(name);
+		DEATH_DEBUG_ASSERT(family != nullptr && family->Type != MetricType::Histogram, "Metric is not registered or has wrong type", );
+		if (family != nullptr) {
+			FindOrCreateSeries(*family, labels).Value += value;
+		}
+	}
+
+	void MetricsRegistry::Set(StringView name, double value, StringView labels)
+	{
+		std::unique_lock lock(_lock);
+		Family* family = FindFamily(name);
+		DEATH_DEBUG_ASSERT(family != nullptr && family->Type != MetricType::Histogram, "Metric is not registered or has wrong type", );
+		if (family != nullptr) {
+			FindOrCreateSeries(*family, labels).Value = value;
+		}
+	}
+
+	void MetricsRegistry::Observe(StringView name, double value, StringView labels)
+	{
+		std::unique_lock lock(_lock);
+		Family* family = FindFamily(name);
+		DEATH_DEBUG_ASSERT(family != nullptr && family->Type == MetricType::Histogram, "Metric is not registered or has wrong type", );
+		if (family == nullptr) {
+			return;
+		}
+
+		Series& series = FindOrCreateSeries(*family, labels);
+		series.Sum += value;
+		series.Count++;
+		// Buckets are stored non-cumulative, they are summed up only when exported
+		for (std::size_t i = 0; i < family->Buckets.size(); i++) {
+			if (value <= family->Buckets[i]) {
+				series.BucketCounts[i]++;
+				break;
+			}
+		}
+	}
+
+	void MetricsRegistry::Clear(StringView name)
+	{
+		std::unique_lock lock(_lock);
+		if (Family* family = FindFamily(name)) {
+			family->Values.clear();
+		}
+	}
+
+	void MetricsRegistry::WriteTo(Stream& dest)
+	{
+		std::unique_lock lock(_lock);
+		for (const auto& family : _families) {
+			WriteText(dest, "# HELP "_s);
+			WriteText(dest, family.Name);
+			WriteText(dest, " "_s);
+			WriteText(dest, family.Help);
+			WriteText(dest, "\n# TYPE "_s);
+			WriteText(dest, family.Name);
+			switch (family.Type) {
+				case MetricType::Counter: WriteText(dest, " counter\n"_s); break;
+				case MetricType::Gauge: WriteText(dest, " gauge\n"_s); break;
+				case MetricType::Histogram: WriteText(dest, " histogram\n"_s); break;
+			}
+
+			for (const auto& series : family.Values) {
+				if (family.Type != MetricType::Histogram) {
+					WriteSample(dest, family.Name, {}, series.Labels, {}, series.Value);
+					continue;
+				}
+
+				std::uint64_t cumulativeCount = 0;
+				for (std::size_t i = 0; i < family.Buckets.size(); i++) {
+					cumulativeCount += series.BucketCounts[i];
+					char le[48];
+					formatString(le, "le=\"%g\"", family.Buckets[i]);
+					WriteSample(dest, family.Name, "_bucket"_s, series.Labels, le, (double)cumulativeCount);
+				}
+				WriteSample(dest, family.Name, "_bucket"_s, series.Labels, "le=\"+Inf\""_s, (double)series.Count);
+				WriteSample(dest, family.Name, "_sum"_s, series.Labels, {}, series.Sum);
+				WriteSample(dest, family.Name, "_count"_s, series.Labels, {}, (double)series.Count);
+			}
+		}
+	}
+
+	bool MetricsRegistry::WriteToFile(StringView path)
+	{
+		String tempPath = path + ".tmp"_s;
+		{
+			auto s = fs::Open(tempPath, FileAccess::Write);
+			if (!s->IsValid()) {
+				return false;
+			}
+			WriteTo(*s);
+		}
+
+		// Scrapers may read the file at any time, so it's written aside and then atomically moved over the old one
+		if (!fs::Move(tempPath, path)) {
+			fs::RemoveFile(tempPath);
+			return false;
+		}
+		return true;
+	}
+
+	String MetricsRegistry::EscapeLabelValue(StringView value)
+	{
+		String result{NoInit, value.size() * 2};
+		std::size_t length = 0;
+		for (char c : value) {
+			if (c == '\\' || c == '"') {
+				result[length++] = '\\';
+				result[length++] = c;
+			} else if (c == '\n') {
+				result[length++] = '\\';
+				result[length++] = 'n';
+			} else {
+				result[length++] = c;
+			}
+		}
+		return result.prefix(length);
+	}
+
+	MetricsRegistry::Family* MetricsRegistry::FindFamily(StringView name)
+	{
+		for (auto& family : _families) {
+			if (family.Name == name) {
+				return &family;
+			}
+		}
+		return nullptr;
+	}
+
+	MetricsRegistry::Series& MetricsRegistry::FindOrCreateSeries(Family& family, StringView labels)
+	{
+		for (auto& series : family.Values) {
+			if (series.Labels == labels) {
+				return series;
+			}
+		}
+
+		auto& series = family.Values.emplace_back();
+		series.Labels = labels;
+		series.Value = 0.0;
+		series.Sum = 0.0;
+		series.Count = 0;
+		series.BucketCounts.resize(family.Buckets.size());
+		return series;
+	}
+}
+
+#endif
@@ -0,0 +1,93 @@
+﻿#pragma once
+
+#if defined(WITH_MULTIPLAYER) || defined(DOXYGEN_GENERATING_OUTPUT)
+
+#include "../../Main.h"
+
+#include <Containers/ArrayView.h>
+#include <Containers/SmallVector.h>
+#include <Containers/String.h>
+#include <Containers/StringView.h>
+#include <IO/Stream.h>
+#include <Threading/Spinlock.h>
+
+using namespace Death::Containers;
+using namespace Death::IO;
+using namespace Death::Threading;
+
+namespace Jazz2::Multiplayer
+{
+	/** @brief Type of metric in @ref MetricsRegistry */
+	enum class MetricType : std::uint8_t {
+		Counter,		/**< Monotonically increasing value */
+		Gauge,			/**< Value that can go up and down */
+		Histogram		/**< Distribution of observed values in cumulative buckets */
+	};
+
+	/**
+		@brief Collects counters, gauges and histograms of the server and exports them in Prometheus text format
+
+		Each metric family is identified by its name and can contain multiple series distinguished by a label set,
+		which is passed already formatted (e.g. @cpp "peer=\"1\",type=\"2\"" @ce). Families are expected to be few,
+		so values should be recorded at most a few times per frame, not per packet. All functions are thread-safe.
+
+		@experimental
+	*/
+	class MetricsRegistry
+	{
+	public:
+		MetricsRegistry();
+
+		MetricsRegistry(const MetricsRegistry&) = delete;
+		MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+		/** @brief Registers a metric family, it does nothing if the family is already registered */
+		void Register(StringView name, MetricType type, StringView help, ArrayView<const double> buckets = {});
+		/** @brief Increases value of a counter or a gauge */
+		void Increment(StringView name, double value = 1.0, StringView labels = {});
+		/** @brief Sets value of a gauge, or an absolute value of a counter that is tracked elsewhere */
+		void Set(StringView name, double value, StringView labels = {});
+		/** @brief Records an observed value in a histogram */
+		void Observe(StringView name, double value, StringView labels = {});
+		/** @brief Removes all series of a metric family, e.g. to drop labels of disconnected peers */
+		void Clear(StringView name);
+
+		/** @brief Writes all metrics to the stream in Prometheus text format */
+		void WriteTo(Stream& dest);
+		/** @brief Replaces the specified file with all metrics in Prometheus text format, so it's never read partially written */
+		bool WriteToFile(StringView path);
+
+		/** @brief Escapes a label value according to Prometheus text format */
+		static String EscapeLabelValue(StringView value);
+
+	private:
+#ifndef DOXYGEN_GENERATING_OUTPUT
+		// Doxygen 1.12.0 outputs also private structs/unions even if it shouldn't
+		struct Series
+		{
+			String Labels;
+			double Value;
+			double Sum;
+			std::uint64_t Count;
+			SmallVector<std::uint64_t, 0> BucketCounts;
+		};
+
+		struct Family
+		{
+			String Name;
+			String Help;
+			MetricType Type;
+			SmallVector<double, 0> Buckets;
+			SmallVector<Series, 1> Values;
+		};
+#endif
+
+		SmallVector<Family, 0> _families;
+		Spinlock _lock;
+
+		Family* FindFamily(StringView name);
+		static Series& FindOrCreateSeries(Family& family, StringView labels);
+	};
+}
+
+#endif
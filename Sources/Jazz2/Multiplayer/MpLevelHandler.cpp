@@ -2,6 +2,7 @@
 
 #if defined(WITH_MULTIPLAYER)
 
+#include "PacketCodec.h"
 #include "PacketTypes.h"
 #include "../ContentResolver.h"
 #include "../PreferencesCache.h"
@@ -47,10 +48,8 @@
 #include <Containers/StringConcatenable.h>
 #include <Containers/StringUtils.h>
 #include <IO/MemoryStream.h>
-#include <IO/Compression/DeflateStream.h>
 #include <Utf8.h>
 
-using namespace Death::IO::Compression;
 using namespace nCine;
 using namespace Jazz2::Actors::Multiplayer;
 
@@ -64,8 +63,8 @@ namespace Jazz2::Multiplayer
 	// TODO: levelState is unused, it needs to be set after LevelState::InitialUpdatePending is processed
 	MpLevelHandler::MpLevelHandler(IRootController* root, NetworkManager* networkManager, MpLevelHandler::LevelState levelState, bool enableLedgeClimb)
 		: LevelHandler(root), _networkManager(networkManager), _updateTimeLeft(1.0f), _gameTimeLeft(0.0f),
-			_levelState(LevelState::InitialUpdatePending), _forceResyncPending(true), _enableSpawning(true), _lastSpawnedActorId(-1), _waitingForPlayerCount(0),
-			_lastUpdated(0), _seqNumWarped(0), _suppressRemoting(false), _ignorePackets(false), _enableLedgeClimb(enableLedgeClimb),
+			_levelState(LevelState::InitialUpdatePending), _enableSpawning(true), _lastSpawnedActorId(-1), _waitingForPlayerCount(0),
+			_lastUpdated(0), _seqNumWarped(0), _suppressRemoting(false), _resyncRequested(false), _ignorePackets(false), _enableLedgeClimb(enableLedgeClimb),
 			_controllableExternal(true), _autoWeightTreasure(false), _activePoll(VoteType::None), _activePollTimeLeft(0.0f), _recalcPositionInRoundTime(0.0f),
 			_overtimeTimeLeft(0.0f), _overtimeStarted(false), _overtimeFinishers(0),
 			_limitCameraLeft(0), _limitCameraWidth(0), _totalTreasureCount(0)
@@ -78,10 +77,15 @@ namespace Jazz2::Multiplayer
 #endif
 	{
 		_isServer = (networkManager->GetState() == NetworkState::Listening);
+		if (_isServer) {
+			RegisterMetrics();
+		}
 	}
 
 	MpLevelHandler::~MpLevelHandler()
 	{
+		// Stop the worker thread first, it can still access the handler
+		_assetStreamer = nullptr;
 	}
 
 	bool MpLevelHandler::Initialize(const LevelInitialization& levelInit)
@@ -106,6 +110,10 @@ namespace Jazz2::Multiplayer
 			for (auto& [peer, peerDesc] : *_networkManager->GetPeers()) {
 				peerDesc->LevelState = PeerLevelState::ValidatingAssets;
 				peerDesc->LastUpdated = 0;
+				peerDesc->RelevantActors.clear();
+				peerDesc->ActorSyncBytesSent = 0;
+				peerDesc->ActorSnapshots.Clear();
+				peerDesc->LastAckedActorUpdate = 0;
 				if (peerDesc->RemotePeer) {
 					peerDesc->Player = nullptr;
 				}
@@ -185,9 +193,19 @@ namespace Jazz2::Multiplayer
 
 	void MpLevelHandler::OnBeginFrame()
 	{
+		if (_isServer) {
+			_frameStartTime = TimeStamp::now();
+		}
+
 		LevelHandler::OnBeginFrame();
 
 		if (_isServer) {
+#if !defined(WITH_THREADS)
+			if (_assetStreamer != nullptr) {
+				_assetStreamer->ProcessTransfers();
+			}
+#endif
+
 			// Send pending SFX
 			for (const auto& sfx : _pendingSfx) {
 				std::uint32_t actorId;
@@ -464,175 +482,7 @@ namespace Jazz2::Multiplayer
 
 			if (_isServer) {
 				if (_networkManager->HasInboundConnections()) {
-					std::uint32_t playerCount = GetNonSpectatePlayerCount();
-					std::uint32_t actorCount = playerCount + (std::uint32_t)_remotingActors.size();
-
-					MemoryStream packet(8 + actorCount * 24);
-					packet.WriteVariableUint32(_lastUpdated);
-					packet.WriteVariableUint64((std::uint64_t)_elapsedFrames);
-					packet.WriteVariableUint32((actorCount << 1) | (_forceResyncPending ? 1 : 0));
-
-					for (Actors::Player* player : _players) {
-						auto* mpPlayer = static_cast<PlayerOnServer*>(player);
-
-						// Skip spectate players - don't send their position to other clients
-						if (mpPlayer->_playerType == PlayerType::Spectate) {
-							continue;
-						}
-
-						/*Vector2f pos;
-						auto it = _playerStates.find(player->_playerIndex);
-						if (it != _playerStates.end()) {
-							// Remote players
-							pos = player->_pos;
-
-							// TODO: This should be WarpUpdatesLeft
-							if (it->second.WarpTimeLeft > 0.0f) {
-								it->second.WarpTimeLeft -= timeMult;
-								if (it->second.WarpTimeLeft <= 0.0f) {
-									it->second.WarpTimeLeft = 0.0f;
-									LOGW("Player warped without permission (possible cheating attempt)");
-								}
-							} else if (it->second.WarpTimeLeft < 0.0f) {
-								it->second.WarpTimeLeft += timeMult;
-								if (it->second.WarpTimeLeft >= 0.0f) {
-									it->second.WarpTimeLeft = 0.0f;
-									LOGW("Player failed to warp in time (possible cheating attempt)");
-								}
-							}
-						} else {
-							// Local players
-							pos = player->_pos;
-						}*/
-						Vector2f pos = player->_pos;
-
-						packet.WriteVariableUint32(player->_playerIndex);
-
-						std::uint8_t flags = 0x01 | 0x02; // PositionChanged | AnimationChanged
-						if (player->_renderer.isDrawEnabled()) {
-							flags |= 0x04;
-						}
-						if (player->_renderer.AnimPaused) {
-							flags |= 0x08;
-						}
-						if (player->_renderer.isFlippedX()) {
-							flags |= 0x10;
-						}
-						if (player->_renderer.isFlippedY()) {
-							flags |= 0x20;
-						}
-						if (mpPlayer->_justWarped) {
-							mpPlayer->_justWarped = false;
-							flags |= 0x40;
-						}
-						packet.WriteValue<std::uint8_t>(flags);
-
-						packet.WriteValue<std::int32_t>((std::int32_t)(pos.X * 512.0f));
-						packet.WriteValue<std::int32_t>((std::int32_t)(pos.Y * 512.0f));
-						packet.WriteVariableUint32((std::uint32_t)(player->_currentTransition != nullptr ? player->_currentTransition->State : player->_currentAnimation->State));
-
-						float rotation = player->_renderer.rotation();
-						if (rotation < 0.0f) rotation += fRadAngle360;
-						packet.WriteValue<std::uint16_t>((std::uint16_t)(rotation * UINT16_MAX / fRadAngle360));
-						Vector2f scale = player->_renderer.scale();
-						packet.WriteValue<std::uint16_t>((std::uint16_t)Half{scale.X});
-						packet.WriteValue<std::uint16_t>((std::uint16_t)Half{scale.Y});
-						Actors::ActorRendererType rendererType = player->_renderer.GetRendererType();
-						if (rendererType == Actors::ActorRendererType::Outline) {
-							// Outline renderer type is local-only
-							rendererType = Actors::ActorRendererType::Default;
-						}
-						packet.WriteValue<std::uint8_t>((std::uint8_t)rendererType);
-					}
-
-					// TODO: Does this need to be locked?
-					{
-						std::unique_lock lock(_lock);
-						for (auto& [remotingActor, remotingActorInfo] : _remotingActors) {
-							packet.WriteVariableUint32(remotingActorInfo.ActorID);
-
-							std::int32_t newPosX = (std::int32_t)(remotingActor->_pos.X * 512.0f);
-							std::int32_t newPosY = (std::int32_t)(remotingActor->_pos.Y * 512.0f);
-							bool positionChanged = (_forceResyncPending || newPosX != remotingActorInfo.LastPosX || newPosY != remotingActorInfo.LastPosY);
-
-							std::uint32_t newAnimation = (std::uint32_t)(remotingActor->_currentTransition != nullptr ? remotingActor->_currentTransition->State : (remotingActor->_currentAnimation != nullptr ? remotingActor->_currentAnimation->State : AnimState::Idle));
-							float rotation = remotingActor->_renderer.rotation();
-							if (rotation < 0.0f) rotation += fRadAngle360;
-							std::uint16_t newRotation = (std::uint16_t)(rotation * UINT16_MAX / fRadAngle360);
-							Vector2f newScale = remotingActor->_renderer.scale();
-							std::uint16_t newScaleX = (std::uint16_t)Half{newScale.X};
-							std::uint16_t newScaleY = (std::uint16_t)Half{newScale.Y};
-							std::uint8_t newRendererType = (std::uint8_t)remotingActor->_renderer.GetRendererType();
-							bool animationChanged = (_forceResyncPending || newAnimation != remotingActorInfo.LastAnimation || newRotation != remotingActorInfo.LastRotation ||
-								newScaleX != remotingActorInfo.LastScaleX || newScaleY != remotingActorInfo.LastScaleY || newRendererType != remotingActorInfo.LastRendererType);
-
-							std::uint8_t flags = 0;
-							if (positionChanged) {
-								flags |= 0x01;
-							}
-							if (animationChanged) {
-								flags |= 0x02;
-							}
-							if (remotingActor->_renderer.isDrawEnabled()) {
-								flags |= 0x04;
-							}
-							if (remotingActor->_renderer.AnimPaused) {
-								flags |= 0x08;
-							}
-							if (remotingActor->_renderer.isFlippedX()) {
-								flags |= 0x10;
-							}
-							if (remotingActor->_renderer.isFlippedY()) {
-								flags |= 0x20;
-							}
-							packet.WriteValue<std::uint8_t>(flags);
-
-							if (positionChanged) {
-								packet.WriteValue<std::int32_t>(newPosX);
-								packet.WriteValue<std::int32_t>(newPosY);
-
-								remotingActorInfo.LastPosX = newPosX;
-								remotingActorInfo.LastPosY = newPosY;
-							}
-							if (animationChanged) {
-								packet.WriteVariableUint32(newAnimation);
-								packet.WriteValue<std::uint16_t>(newRotation);
-								packet.WriteValue<std::uint16_t>(newScaleX);
-								packet.WriteValue<std::uint16_t>(newScaleY);
-								packet.WriteValue<std::uint8_t>(newRendererType);
-
-								remotingActorInfo.LastAnimation = newAnimation;
-								remotingActorInfo.LastRotation = newRotation;
-								remotingActorInfo.LastScaleX = newScaleX;
-								remotingActorInfo.LastScaleY = newScaleY;
-								remotingActorInfo.LastRendererType = newRendererType;
-							}
-						}
-					}
-
-					MemoryStream packetCompressed(1024);
-					{
-						DeflateWriter dw(packetCompressed);
-						dw.Write(packet.GetBuffer(), packet.GetSize());
-					}
-
-#if defined(DEATH_DEBUG)
-					_debugAverageUpdatePacketSize = lerp(_debugAverageUpdatePacketSize, (std::int32_t)(packet.GetSize() * UpdatesPerSecond), 0.04f * timeMult);
-#endif
-#if defined(DEATH_DEBUG) && defined(WITH_IMGUI)
-					_updatePacketSize[_plotIndex] = packet.GetSize();
-					_updatePacketMaxSize = std::max(_updatePacketMaxSize, _updatePacketSize[_plotIndex]);
-					_compressedUpdatePacketSize[_plotIndex] = packetCompressed.GetSize();
-#endif
-
-					_networkManager->SendTo([this](const Peer& peer) {
-						auto peerDesc = _networkManager->GetPeerDescriptor(peer);
-						return (peerDesc && peerDesc->LevelState >= PeerLevelState::LevelSynchronized);
-					}, _forceResyncPending ? NetworkChannel::Main : NetworkChannel::UnreliableUpdates, (std::uint8_t)ServerPacketType::UpdateAllActors, packetCompressed);
-
-					_lastUpdated++;
-					_forceResyncPending = false;
-
+					SendUpdateAllActors(timeMult);
 					SynchronizePeers(timeMult);
 				} else {
 #if defined(DEATH_DEBUG)
@@ -669,7 +519,7 @@ namespace Jazz2::Multiplayer
 						flags |= RemotePlayerOnServer::PlayerFlags::InConsole;
 					}
 
-					MemoryStream packet(20);
+					MemoryStream packet(24);
 					packet.WriteVariableUint32(_lastSpawnedActorId);
 					packet.WriteVariableUint64(now);
 					packet.WriteValue<std::int32_t>((std::int32_t)(player->_pos.X * 512.0f));
@@ -677,6 +527,8 @@ namespace Jazz2::Multiplayer
 					packet.WriteValue<std::int16_t>((std::int16_t)(player->_speed.X * 512.0f));
 					packet.WriteValue<std::int16_t>((std::int16_t)(player->_speed.Y * 512.0f));
 					packet.WriteVariableUint32((std::uint32_t)flags);
+					// Acknowledge the last applied update, so the server can use it as baseline for delta compression
+					packet.WriteVariableUint32(_lastUpdated);
 
 					if (_seqNumWarped != 0) {
 						packet.WriteVariableUint64(_seqNumWarped);
@@ -766,9 +618,16 @@ namespace Jazz2::Multiplayer
 		}
 #endif
 
-		if (_isServer && _players.empty()) {
-			// If no players are connected, slow the server down to save resources
+		if (_isServer) {
+			UpdateMetrics();
+		}
+
+		if (_isServer && _players.empty() && _networkManager->GetPeers()->empty() &&
+			(_root->GetFlags() & IRootController::Flags::HasMultipleSessions) != IRootController::Flags::HasMultipleSessions) {
+			// If no players are connected, slow the server down to save resources (but not if other sessions run in the same process)
 			Thread::Sleep(500);
+			// Ticks missed during the pause shouldn't be considered as overload
+			theApplication().RestartTickSchedule();
 		}
 	}
 
@@ -869,10 +728,14 @@ namespace Jazz2::Multiplayer
 				MemoryStream packet;
 				InitializeCreateRemoteActorPacket(packet, actorId, actorPtr);
 
-				_networkManager->SendTo([this](const Peer& peer) {
-					auto peerDesc = _networkManager->GetPeerDescriptor(peer);
-					return (peerDesc && peerDesc->LevelState >= PeerLevelState::LevelSynchronized);
-				}, NetworkChannel::Main, (std::uint8_t)ServerPacketType::CreateRemoteActor, packet);
+				// Send the actor only to peers that are interested in it, the rest will receive it when it enters their area
+				for (auto& [peer, peerDesc] : *_networkManager->GetPeers()) {
+					if (peerDesc->RemotePeer && peerDesc->LevelState >= PeerLevelState::LevelSynchronized && IsActorRelevantToPeer(*peerDesc, actorPtr)) {
+						peerDesc->RelevantActors.emplace(actorId, _lastUpdated);
+						peerDesc->ActorSyncBytesSent += packet.GetSize();
+						_networkManager->SendTo(peer, NetworkChannel::Main, (std::uint8_t)ServerPacketType::CreateRemoteActor, packet);
+					}
+				}
 			}
 		}
 	}
@@ -2453,6 +2316,81 @@ namespace Jazz2::Multiplayer
 				SendMessage(peer, UI::MessageLevel::Confirm, { infoBuffer, length });
 			}
 			return true;
+		} else if (line == "/netstats"_s) {
+			if (isAdmin) {
+				SendMessage(peer, UI::MessageLevel::Confirm, "Actor synchronization per player:"_s);
+
+				for (auto& [playerPeer, peerDesc] : *_networkManager->GetPeers()) {
+					if (!peerDesc->RemotePeer) {
+						continue;
+					}
+
+					std::size_t length = formatInto(infoBuffer, "{}\t │ {} ms\t │ {} actors\t │ {:.1f} kB/s\t │ {} kB total",
+						peerDesc->PlayerName, _networkManager->GetRoundTripTimeMs(peerDesc->RemotePeer), (std::uint32_t)peerDesc->RelevantActors.size(),
+						peerDesc->ActorSyncBytesPerSecond / 1024.0f, (std::uint32_t)(peerDesc->ActorSyncBytesSent / 1024));
+					SendMessage(peer, UI::MessageLevel::Confirm, { infoBuffer, length });
+				}
+
+				SendMessage(peer, UI::MessageLevel::Confirm, "Compression of actor updates:"_s);
+
+				for (std::int32_t i = 0; i < (std::int32_t)PacketCodecType::Count; i++) {
+					std::uint64_t packetCount = _updateCodecStats.PacketCount[i];
+					if (packetCount == 0) {
+						continue;
+					}
+
+					std::size_t length = formatInto(infoBuffer, "{}\t │ {} packets\t │ {:.1f} % ratio\t │ {:.1f} µs avg.",
+						PacketCodec::GetCodecName((PacketCodecType)i), packetCount,
+						_updateCodecStats.CompressedBytes[i] * 100.0f / std::max(_updateCodecStats.UncompressedBytes[i], (std::uint64_t)1),
+						(float)_updateCodecStats.CompressTimeUs[i] / packetCount);
+					SendMessage(peer, UI::MessageLevel::Confirm, { infoBuffer, length });
+				}
+
+				std::size_t length = formatInto(infoBuffer, "Packet dispatch latency: {} µs avg.\t │ {} µs max.",
+					_networkManager->GetPacketDispatchLatencyUs(), _networkManager->GetMaxPacketDispatchLatencyUs());
+				SendMessage(peer, UI::MessageLevel::Confirm, { infoBuffer, length });
+				return true;
+			}
+		} else if (line == "/tickstats"_s) {
+			if (isAdmin) {
+				std::uint32_t tickRate = theApplication().GetAppConfiguration().fixedTickRate;
+				if (tickRate == 0) {
+					SendMessage(peer, UI::MessageLevel::Confirm, "Fixed-rate simulation is not enabled"_s);
+					return true;
+				}
+
+				const TickHistogram& histogram = theApplication().GetTickHistogram();
+				std::uint64_t tickCount = histogram.GetTotalCount();
+				std::size_t length = formatInto(infoBuffer, "Simulation: {} ticks/s\t │ {} ticks\t │ {:.2f} ms avg.\t │ {:.2f} ms max.",
+					tickRate, tickCount, histogram.GetTotalDurationUs() / (1000.0f * std::max(tickCount, (std::uint64_t)1)),
+					histogram.GetMaxDurationUs() / 1000.0f);
+				SendMessage(peer, UI::MessageLevel::Confirm, { infoBuffer, length });
+
+				length = formatInto(infoBuffer, "Percentiles: {} µs p50\t │ {} µs p99\t │ {} µs p99.9",
+					histogram.GetPercentileUs(0.5f), histogram.GetPercentileUs(0.99f), histogram.GetPercentileUs(0.999f));
+				SendMessage(peer, UI::MessageLevel::Confirm, { infoBuffer, length });
+
+				length = formatInto(infoBuffer, "Over budget: {} ticks\t │ Dropped: {} ticks",
+					histogram.GetOverrunCount(), histogram.GetDroppedCount());
+				SendMessage(peer, UI::MessageLevel::Confirm, { infoBuffer, length });
+
+				for (std::int32_t i = 0; i < TickHistogram::BucketCount; i++) {
+					std::uint64_t bucketCount = histogram.GetBucketCount(i);
+					if (bucketCount == 0) {
+						continue;
+					}
+
+					if (i < TickHistogram::BucketCount - 1) {
+						length = formatInto(infoBuffer, "≤ {} µs\t │ {} ticks\t │ {:.1f} %",
+							TickHistogram::GetBucketUpperBoundUs(i), bucketCount, bucketCount * 100.0f / tickCount);
+					} else {
+						length = formatInto(infoBuffer, "> {} µs\t │ {} ticks\t │ {:.1f} %",
+							TickHistogram::GetBucketUpperBoundUs(i - 1), bucketCount, bucketCount * 100.0f / tickCount);
+					}
+					SendMessage(peer, UI::MessageLevel::Confirm, { infoBuffer, length });
+				}
+				return true;
+			}
 		} else if (line.hasPrefix("/set "_s)) {
 			if (isAdmin) {
 				auto [variableName, sep, value] = line.exceptPrefix("/set "_s).trimmedPrefix().partition(' ');
@@ -2834,6 +2772,10 @@ namespace Jazz2::Multiplayer
 				peerDesc->IsAuthenticated = false;
 				peerDesc->LevelState = PeerLevelState::Unknown;
 
+				if (_assetStreamer != nullptr) {
+					_assetStreamer->Cancel(peer);
+				}
+
 				InvokeAsync([this, peerDesc]() mutable {
 					_console->WriteLine(UI::MessageLevel::Info, _f("\f[c:#d0705d]{}\f[/c] disconnected", peerDesc->PlayerName));
 				});
@@ -3099,7 +3041,7 @@ namespace Jazz2::Multiplayer
 					peerDesc->LevelState = PeerLevelState::StreamingMissingAssets;
 
 					bool success = true;
-					SmallVector<RequiredAsset*> missingAssets;
+					SmallVector<AssetStreamRequest, 0> missingAssets;
 
 					MemoryStream packet(data);
 					std::uint32_t assetCount = packet.ReadVariableUint32();
@@ -3114,6 +3056,8 @@ namespace Jazz2::Multiplayer
 							packet.Read(path.data(), pathLength);
 							std::int64_t size = packet.ReadVariableInt64();
 							std::uint32_t crc32 = packet.ReadValue<std::uint32_t>();
+							// Size of partially downloaded asset, the transfer is resumed from there
+							std::int64_t resumeOffset = packet.ReadVariableInt64();
 
 							bool found = false;
 							for (std::size_t j = 0; j < _requiredAssets.size(); j++) {
@@ -3122,7 +3066,14 @@ namespace Jazz2::Multiplayer
 									if (size != _requiredAssets[j].Size || crc32 != _requiredAssets[j].Crc32) {
 										LOGD("[MP] ClientPacketType::ValidateAssetsResponse [{}] - \"{}\":{:.8x} is missing",
 											peer, _requiredAssets[j].Path, _requiredAssets[j].Crc32);
-										missingAssets.push_back(&_requiredAssets[j]);
+										const auto& asset = _requiredAssets[j];
+										auto& request = missingAssets.emplace_back();
+										request.Type = (std::uint8_t)asset.Type;
+										request.Crc32 = asset.Crc32;
+										request.Path = asset.Path;
+										request.FullPath = asset.FullPath;
+										request.Size = asset.Size;
+										request.Offset = (resumeOffset > 0 && resumeOffset < asset.Size ? resumeOffset : 0);
 									}
 									break;
 								}
@@ -3161,69 +3112,32 @@ namespace Jazz2::Multiplayer
 						_networkManager->Kick(peer, Reason::AssetStreamingNotAllowed);
 						return true;
 					}
-					
-#if defined(WITH_THREADS)
-					Thread streamingThread([_this = runtime_cast<MpLevelHandler>(shared_from_this()), peer, peerDesc = std::move(peerDesc), missingAssets = std::move(missingAssets)]() {
-#else
-					auto* _this = this;
-#endif
-						LOGI("[MP] Started streaming {} assets to peer [{}]", missingAssets.size(), peer);
-						TimeStamp begin = TimeStamp::now();
-
-						for (std::uint32_t i = 0; i < (std::uint32_t)missingAssets.size(); i++) {
-							if (!peerDesc->IsAuthenticated || _this->_ignorePackets) {
-								// Stop streaming if peer disconnects or handler has changed
-								break;
-							}
-
-							const RequiredAsset& asset = *missingAssets[i];
-
-							MemoryStream packetBegin(14 + asset.Path.size());
-							packetBegin.WriteValue<std::uint8_t>(1);	// Begin
-							packetBegin.WriteValue<std::uint8_t>((std::uint8_t)asset.Type);
-							packetBegin.WriteVariableUint32((std::uint32_t)asset.Path.size());
-							packetBegin.Write(asset.Path.data(), (std::int64_t)asset.Path.size());
-							packetBegin.WriteVariableInt64(asset.Size);
-							_this->_networkManager->SendTo(peer, NetworkChannel::Main, (std::uint8_t)ServerPacketType::StreamAsset, packetBegin);
-
-							auto s = fs::Open(asset.FullPath, FileAccess::Read);
-							if (s->IsValid()) {
-								char buffer[8192];
-								while (true) {
-									if (!peerDesc->IsAuthenticated || _this->_ignorePackets) {
-										// Stop streaming if peer disconnects or handler has changed
-										break;
-									}
 
-									std::int64_t bytesRead = s->Read(buffer, sizeof(buffer));
-									if (bytesRead <= 0) {
-										break;
-									}
-
-									MemoryStream packetChunk(9 + bytesRead);
-									packetChunk.WriteValue<std::uint8_t>(2);	// Chunk
-									packetChunk.WriteVariableInt64(bytesRead);
-									packetChunk.Write(buffer, bytesRead);
-									_this->_networkManager->SendTo(peer, NetworkChannel::Main, (std::uint8_t)ServerPacketType::StreamAsset, packetChunk);
+					if (_assetStreamer == nullptr) {
+						_assetStreamer = std::make_unique<AssetStreamer>(_networkManager, serverConfig.AssetStreamingBytesPerSecond, [this](const Peer& peer) {
+							// Called from the worker thread, the level must be loaded on the main thread
+							InvokeAsync([this, peer]() {
+								auto peerDesc = _networkManager->GetPeerDescriptor(peer);
+								if (peerDesc && peerDesc->IsAuthenticated && peerDesc->LevelState == PeerLevelState::StreamingMissingAssets) {
+									MemoryStream packet;
+									InitializeLoadLevelPacket(packet);
+									_networkManager->SendTo(peer, NetworkChannel::Main, (std::uint8_t)ServerPacketType::LoadLevel, packet);
 								}
-							}
+							});
+						});
+					}
 
-							MemoryStream packetEnd(1);
-							packetEnd.WriteValue<std::uint8_t>(3);	// End
-							_this->_networkManager->SendTo(peer, NetworkChannel::Main, (std::uint8_t)ServerPacketType::StreamAsset, packetEnd);
-						}
+					_assetStreamer->Start(peer, std::move(missingAssets));
 
-						LOGI("[MP] Finished streaming {} assets to peer [{}] - took {:.1f} ms",
-						missingAssets.size(), peer, begin.millisecondsSince());
-						if (peerDesc->IsAuthenticated && !_this->_ignorePackets) {
-							MemoryStream packet;
-							_this->InitializeLoadLevelPacket(packet);
-							_this->_networkManager->SendTo(peer, NetworkChannel::Main, (std::uint8_t)ServerPacketType::LoadLevel, packet);
-						}
-#if defined(WITH_THREADS)
-					});
-#endif
+					return true;
+				}
+				case ClientPacketType::StreamAssetAck: {
+					MemoryStream packet(data);
+					std::uint32_t chunkCount = packet.ReadVariableUint32();
 
+					if (_assetStreamer != nullptr) {
+						_assetStreamer->OnChunksAcknowledged(peer, chunkCount);
+					}
 					return true;
 				}
 				case ClientPacketType::PlayerReady: {
@@ -3260,7 +3174,10 @@ namespace Jazz2::Multiplayer
 				}
 				case ClientPacketType::ForceResyncActors: {
 					LOGD("[MP] ClientPacketType::ForceResyncActors [{}] - update: {}", peer, _lastUpdated);
-					_forceResyncPending = true;
+					// Drop the acknowledged baseline, so the next update contains full state of all relevant actors
+					if (auto peerDesc = _networkManager->GetPeerDescriptor(peer)) {
+						peerDesc->LastAckedActorUpdate = 0;
+					}
 					return true;
 				}
 				case ClientPacketType::PlayerUpdate: {
@@ -3285,6 +3202,10 @@ namespace Jazz2::Multiplayer
 					float speedX = packet.ReadValue<std::int16_t>() / 512.0f;
 					float speedY = packet.ReadValue<std::int16_t>() / 512.0f;
 					RemotePlayerOnServer::PlayerFlags flags = (RemotePlayerOnServer::PlayerFlags)packet.ReadVariableUint32();
+					std::uint32_t lastAckedActorUpdate = packet.ReadVariableUint32();
+					if (lastAckedActorUpdate > peerDesc->LastAckedActorUpdate && lastAckedActorUpdate <= _lastUpdated) {
+						peerDesc->LastAckedActorUpdate = lastAckedActorUpdate;
+					}
 
 					/*bool justWarped = (flags & PlayerFlags::JustWarped) == PlayerFlags::JustWarped;
 					if (justWarped) {
@@ -3785,12 +3706,17 @@ namespace Jazz2::Multiplayer
 					return true;
 				}
 				case ServerPacketType::SyncTileMap: {
-					MemoryStream packet(data);
+					MemoryStream packet(data.size() * 4);
+					if (!PacketCodec::Decompress(data, packet, MaxSyncTileMapSize)) {
+						LOGW("[MP] ServerPacketType::SyncTileMap - cannot decompress packet ({} bytes)", data.size());
+						return true;
+					}
+					packet.Seek(0, SeekOrigin::Begin);
 
-					LOGD("[MP] ServerPacketType::SyncTileMap");
+					LOGD("[MP] ServerPacketType::SyncTileMap - {} bytes", data.size());
 
 					// TODO: No lock here ???
-					TileMap()->InitializeFromStream(packet);
+					TileMap()->InitializeFromSparseStream(packet);
 					return true;
 				}
 				case ServerPacketType::SetTrigger: {
@@ -3936,6 +3862,13 @@ namespace Jazz2::Multiplayer
 						{
 							std::unique_lock lock(_lock);
 							_remoteActors[actorId] = remoteActor;
+
+							// Updates may have been received before the actor was created, so apply the latest known state
+							if (const auto* snapshot = _receivedActorSnapshots.Find(_lastUpdated)) {
+								if (const auto* state = snapshot->Find(actorId)) {
+									SyncRemoteActorWithSnapshot(remoteActor.get(), *state, ActorSnapshotFields::All);
+								}
+							}
 						}
 						AddActor(remoteActor);
 					});
@@ -4010,80 +3943,78 @@ namespace Jazz2::Multiplayer
 					return true;
 				}
 				case ServerPacketType::UpdateAllActors: {
-					MemoryStream packetCompressed(data);
-					DeflateStream packet(packetCompressed);
+					MemoryStream packet(data.size() * 2);
+					if (!PacketCodec::Decompress(data, packet)) {
+						LOGW("[MP] ServerPacketType::UpdateAllActors - cannot decompress packet ({} bytes)", data.size());
+						return true;
+					}
+					packet.Seek(0, SeekOrigin::Begin);
+
 					std::uint32_t now = packet.ReadVariableUint32();
 					float elapsedFrames = (float)packet.ReadVariableUint64();
-					std::uint32_t actorCount = packet.ReadVariableUint32();
+					std::uint32_t baselineDistance = packet.ReadVariableUint32();
+					std::uint32_t deltaSize = packet.ReadVariableUint32();
 
-					bool forceResyncInvoked = (actorCount & 1) == 1;
-					if DEATH_UNLIKELY(!forceResyncInvoked && _lastUpdated >= now) {
+					if DEATH_UNLIKELY(_lastUpdated >= now) {
 						return true;
 					}
-
-					bool forceResyncRequired = (!forceResyncInvoked && _lastUpdated + 1 < now);
-					if (forceResyncRequired) {
-						LOGD("[MP] ServerPacketType::UpdateAllActors - FORCE RESYNC REQUIRED ({} -> {})", _lastUpdated, now);
-					} else if (forceResyncInvoked) {
-						LOGD("[MP] ServerPacketType::UpdateAllActors - FORCE RESYNC INVOKED ({} -> {})", _lastUpdated, now);
+					if DEATH_UNLIKELY(deltaSize > packet.GetSize() - packet.GetPosition()) {
+						LOGW("[MP] ServerPacketType::UpdateAllActors - invalid delta size ({} bytes)", deltaSize);
+						return true;
 					}
 
-					std::unique_lock lock(_lock);
-
-					_lastUpdated = now;
-					_elapsedFrames = lerp(_elapsedFrames, elapsedFrames + _networkManager->GetRoundTripTimeMs() * FrameTimer::FramesPerSecond * 0.002f, 0.05f);
+					SmallVector<std::uint8_t, 0> delta(ValueInit, deltaSize);
+					packet.Read(delta.data(), deltaSize);
 
-					actorCount >>= 1;
+					std::unique_lock lock(_lock);
 
-					for (std::uint32_t i = 0; i < actorCount; i++) {
-						std::uint32_t actorId = packet.ReadVariableUint32();
-						std::uint8_t flags = packet.ReadValue<std::uint8_t>();
+					const ActorSnapshot* baseline = nullptr;
+					if (baselineDistance != 0) {
+						baseline = _receivedActorSnapshots.Find(now - baselineDistance);
+						if (baseline == nullptr) {
+							// Request the full state only once, until an update without baseline arrives
+							if (!_resyncRequested) {
+								LOGD("[MP] ServerPacketType::UpdateAllActors - FORCE RESYNC REQUIRED (missing baseline {} for {})", now - baselineDistance, now);
+								_resyncRequested = true;
+								_networkManager->SendTo(AllPeers, NetworkChannel::Main, (std::uint8_t)ClientPacketType::ForceResyncActors, {});
+							}
+							return true;
+						}
+					} else {
+						_resyncRequested = false;
+					}
 
-						bool positionChanged = (flags & 0x01) != 0;
-						bool animationChanged = (flags & 0x02) != 0;
+					ActorSnapshot snapshot;
+					BitReader deltaReader(delta);
+					if (!snapshot.ReadDelta(deltaReader, baseline)) {
+						LOGW("[MP] ServerPacketType::UpdateAllActors - invalid delta ({} bytes)", deltaSize);
+						return true;
+					}
 
-						float posX, posY, rotation, scaleX, scaleY;
-						AnimState anim; Actors::ActorRendererType rendererType;
+					// Changes are applied against the last applied snapshot, which may differ from the baseline
+					const ActorSnapshot* prevSnapshot = _receivedActorSnapshots.Find(_lastUpdated);
 
-						if (positionChanged) {
-							posX = packet.ReadValue<std::int32_t>() / 512.0f;
-							posY = packet.ReadValue<std::int32_t>() / 512.0f;
-						} else {
-							posX = 0.0f;
-							posY = 0.0f;
-						}
+					_lastUpdated = now;
+					_elapsedFrames = lerp(_elapsedFrames, elapsedFrames + _networkManager->GetRoundTripTimeMs() * FrameTimer::FramesPerSecond * 0.002f, 0.05f);
 
-						if (animationChanged) {
-							anim = (AnimState)packet.ReadVariableUint32();
-							rotation = packet.ReadValue<std::uint16_t>() * fRadAngle360 / UINT16_MAX;
-							scaleX = (float)Half{packet.ReadValue<std::uint16_t>()};
-							scaleY = (float)Half{packet.ReadValue<std::uint16_t>()};
-							rendererType = (Actors::ActorRendererType)packet.ReadValue<std::uint8_t>();
-						} else {
-							anim = AnimState::Idle;
-							rotation = 0.0f;
-							scaleX = 0.0f;
-							scaleY = 0.0f;
-							rendererType = Actors::ActorRendererType::Default;
+					for (const auto& state : snapshot.States) {
+						ActorSnapshotFields fields = ActorSnapshotFields::All;
+						if (prevSnapshot != nullptr) {
+							if (const auto* prevState = prevSnapshot->Find(state.ActorID)) {
+								fields = state.GetChangedFields(*prevState);
+								if (fields == ActorSnapshotFields::None) {
+									continue;
+								}
+							}
 						}
 
-						auto it = _remoteActors.find(actorId);
+						auto it = _remoteActors.find(state.ActorID);
 						if (it != _remoteActors.end()) {
-							if (auto* remoteActor = runtime_cast<Actors::Multiplayer::RemoteActor>(it->second.get())) {
-								if (positionChanged) {
-									remoteActor->SyncPositionWithServer(Vector2f(posX, posY));
-								}
-								if (animationChanged) {
-									remoteActor->SyncAnimationWithServer(anim, rotation, scaleX, scaleY, rendererType);
-								}
-								remoteActor->SyncMiscWithServer(flags);
-							}
+							SyncRemoteActorWithSnapshot(it->second.get(), state, fields);
 						}
 					}
 
-					if (forceResyncRequired) {
-						_networkManager->SendTo(AllPeers, NetworkChannel::Main, (std::uint8_t)ClientPacketType::ForceResyncActors, {});
-					}
+					_receivedActorSnapshots.Push(now).States = std::move(snapshot.States);
 					return true;
 				}
 				case ServerPacketType::ChangeRemoteActorMetadata: {
@@ -4794,10 +4725,20 @@ namespace Jazz2::Multiplayer
 		MemoryStream packet(4);
 		packet.WriteVariableUint32(actorId);
 
-		_networkManager->SendTo([this](const Peer& peer) {
-			auto peerDesc = _networkManager->GetPeerDescriptor(peer);
-			return (peerDesc && peerDesc->LevelState >= PeerLevelState::LevelSynchronized);
-		}, NetworkChannel::Main, (std::uint8_t)ServerPacketType::DestroyRemoteActor, packet);
+		if DEATH_UNLIKELY(ActorShouldBeMirrored(actor)) {
+			_networkManager->SendTo([this](const Peer& peer) {
+				auto peerDesc = _networkManager->GetPeerDescriptor(peer);
+				return (peerDesc && peerDesc->LevelState >= PeerLevelState::LevelSynchronized);
+			}, NetworkChannel::Main, (std::uint8_t)ServerPacketType::DestroyRemoteActor, packet);
+		} else {
+			// Only peers that received the actor need to destroy it
+			for (auto& [peer, peerDesc] : *_networkManager->GetPeers()) {
+				if (peerDesc->RelevantActors.erase(actorId) > 0) {
+					peerDesc->ActorSyncBytesSent += packet.GetSize();
+					_networkManager->SendTo(peer, NetworkChannel::Main, (std::uint8_t)ServerPacketType::DestroyRemoteActor, packet);
+				}
+			}
+		}
 	}
 
 	void MpLevelHandler::ProcessEvents(float timeMult)
@@ -4864,6 +4805,210 @@ namespace Jazz2::Multiplayer
 		}
 	}
 
+	void MpLevelHandler::SendUpdateAllActors(float timeMult)
+	{
+		// Current state of players and remoting actors is computed only once per update, sorted by actor ID,
+		// so each peer receives only relevant ones and snapshots can be delta-compressed in a single pass
+		_remotingActorUpdates.clear();
+		_remotingActorUpdates.reserve(_players.size() + _remotingActors.size());
+
+		for (Actors::Player* player : _players) {
+			auto* mpPlayer = static_cast<PlayerOnServer*>(player);
+
+			// Skip spectate players - don't send their position to other clients
+			if (mpPlayer->_playerType == PlayerType::Spectate) {
+				continue;
+			}
+
+			auto& update = _remotingActorUpdates.emplace_back();
+			update.Actor = player;
+			update.State = GetActorSnapshotState(player->_playerIndex, player);
+			update.IsMirrored = false;
+			update.IsPlayer = true;
+
+			if (update.State.RendererType == (std::uint8_t)Actors::ActorRendererType::Outline) {
+				// Outline renderer type is local-only
+				update.State.RendererType = (std::uint8_t)Actors::ActorRendererType::Default;
+			}
+			if (mpPlayer->_justWarped) {
+				mpPlayer->_justWarped = false;
+				update.State.Flags |= 0x40;
+			}
+		}
+
+		{
+			std::unique_lock lock(_lock);
+			for (auto& [remotingActor, remotingActorInfo] : _remotingActors) {
+				auto& update = _remotingActorUpdates.emplace_back();
+				update.Actor = remotingActor;
+				update.State = GetActorSnapshotState(remotingActorInfo.ActorID, remotingActor);
+				update.IsMirrored = ActorShouldBeMirrored(remotingActor);
+				update.IsPlayer = false;
+			}
+		}
+
+		nCine::sort(_remotingActorUpdates.begin(), _remotingActorUpdates.end(), [](const RemotingActorUpdate& a, const RemotingActorUpdate& b) {
+			return a.State.ActorID < b.State.ActorID;
+		});
+
+		SmallVector<std::pair<Peer, std::shared_ptr<PeerDescriptor>>, 0> targetPeers;
+		for (auto& [peer, peerDesc] : *_networkManager->GetPeers()) {
+			if (peerDesc->RemotePeer && peerDesc->LevelState >= PeerLevelState::LevelSynchronized) {
+				targetPeers.emplace_back(peer, peerDesc);
+			}
+		}
+
+		std::uint32_t updateId = _lastUpdated + 1;
+		std::int32_t totalPacketSize = 0;
+		std::int32_t totalCompressedPacketSize = 0;
+
+		for (auto& [peer, peerDesc] : targetPeers) {
+			AABBf interestArea, interestAreaRelevant;
+			bool cullActors = GetPeerInterestArea(*peerDesc, interestArea);
+			if (cullActors) {
+				interestAreaRelevant = AABBf(interestArea.L - InterestAreaHysteresis, interestArea.T - InterestAreaHysteresis,
+					interestArea.R + InterestAreaHysteresis, interestArea.B + InterestAreaHysteresis);
+			}
+
+			// The last acknowledged snapshot is used as baseline, it must be looked up before its slot can be reused
+			const ActorSnapshot* baseline = nullptr;
+			std::uint32_t lastAckedUpdate = peerDesc->LastAckedActorUpdate;
+			if (lastAckedUpdate != 0 && updateId - lastAckedUpdate < ActorSnapshotHistory::Size) {
+				baseline = peerDesc->ActorSnapshots.Find(lastAckedUpdate);
+			}
+
+			ActorSnapshot& snapshot = peerDesc->ActorSnapshots.Push(updateId);
+			snapshot.States.reserve(_remotingActorUpdates.size());
+
+			std::uint32_t actorSyncBytes = 0;
+
+			for (const auto& update : _remotingActorUpdates) {
+				if (update.IsPlayer) {
+					snapshot.States.push_back(update.State);
+					continue;
+				}
+
+				if DEATH_UNLIKELY(update.IsMirrored) {
+					// Mirrored actors are created and destroyed together with their events, so they are only filtered
+					if (!cullActors || IsInInterestArea(interestArea, update.Actor->_pos)) {
+						snapshot.States.push_back(update.State);
+					}
+					continue;
+				}
+
+				auto it = peerDesc->RelevantActors.find(update.State.ActorID);
+				bool wasRelevant = (it != peerDesc->RelevantActors.end());
+				if (cullActors) {
+					const AABBf& area = (wasRelevant ? interestAreaRelevant : interestArea);
+					if (!IsInInterestArea(area, update.Actor->_pos)) {
+						continue;
+					}
+				}
+
+				if (wasRelevant) {
+					it->second = updateId;
+				} else {
+					// Actor entered the area of interest of the peer
+					peerDesc->RelevantActors.emplace(update.State.ActorID, updateId);
+
+					MemoryStream packet;
+					InitializeCreateRemoteActorPacket(packet, update.State.ActorID, update.Actor);
+					_networkManager->SendTo(peer, NetworkChannel::Main, (std::uint8_t)ServerPacketType::CreateRemoteActor, packet);
+					actorSyncBytes += (std::uint32_t)packet.GetSize();
+				}
+
+				snapshot.States.push_back(update.State);
+			}
+
+			// Destroy actors that left the area of interest of the peer
+			for (auto it = peerDesc->RelevantActors.begin(); it != peerDesc->RelevantActors.end(); ) {
+				if (it->second == updateId) {
+					++it;
+					continue;
+				}
+
+				MemoryStream packet(4);
+				packet.WriteVariableUint32(it->first);
+				_networkManager->SendTo(peer, NetworkChannel::Main, (std::uint8_t)ServerPacketType::DestroyRemoteActor, packet);
+				actorSyncBytes += (std::uint32_t)packet.GetSize();
+
+				peerDesc->RelevantActors.erase(it++);
+			}
+
+			BitWriter deltaWriter(snapshot.States.size() * 4);
+			snapshot.WriteDelta(deltaWriter, baseline);
+			deltaWriter.Flush();
+
+			MemoryStream packet(20 + deltaWriter.GetSize());
+			packet.WriteVariableUint32(updateId);
+			packet.WriteVariableUint64((std::uint64_t)_elapsedFrames);
+			packet.WriteVariableUint32(baseline != nullptr ? updateId - baseline->UpdateID : 0);
+			packet.WriteVariableUint32((std::uint32_t)deltaWriter.GetSize());
+			packet.Write(deltaWriter.GetBuffer().data(), (std::int64_t)deltaWriter.GetSize());
+
+			MemoryStream packetCompressed(packet.GetSize() + 8);
+			PacketCodec::Compress(arrayView(packet.GetBuffer(), (std::size_t)packet.GetSize()), packetCompressed, &_updateCodecStats);
+
+			// Lost updates are not retransmitted, the next update is always encoded against acknowledged state
+			_networkManager->SendTo(peer, NetworkChannel::UnreliableUpdates, (std::uint8_t)ServerPacketType::UpdateAllActors, packetCompressed);
+
+			actorSyncBytes += (std::uint32_t)packetCompressed.GetSize();
+			peerDesc->ActorSyncBytesSent += actorSyncBytes;
+			peerDesc->ActorSyncBytesPerSecond = lerp(peerDesc->ActorSyncBytesPerSecond, actorSyncBytes * UpdatesPerSecond, 0.04f * timeMult);
+
+			totalPacketSize += (std::int32_t)packet.GetSize();
+			totalCompressedPacketSize += (std::int32_t)packetCompressed.GetSize();
+		}
+
+#if defined(DEATH_DEBUG)
+		_debugAverageUpdatePacketSize = lerp(_debugAverageUpdatePacketSize, (std::int32_t)(totalPacketSize * UpdatesPerSecond), 0.04f * timeMult);
+#endif
+#if defined(DEATH_DEBUG) && defined(WITH_IMGUI)
+		_updatePacketSize[_plotIndex] = totalPacketSize;
+		_updatePacketMaxSize = std::max(_updatePacketMaxSize, _updatePacketSize[_plotIndex]);
+		_compressedUpdatePacketSize[_plotIndex] = totalCompressedPacketSize;
+#endif
+
+		_lastUpdated = updateId;
+	}
+
+	bool MpLevelHandler::GetPeerInterestArea(const PeerDescriptor& peerDesc, AABBf& result)
+	{
+		const auto& serverConfig = _networkManager->GetServerConfiguration();
+		if (serverConfig.InterestAreaMargin < 0) {
+			return false;
+		}
+
+		// Peers without spawned player have no view to cull against (e.g., spectators)
+		auto* player = peerDesc.Player;
+		if (player == nullptr || player->_playerType == PlayerType::Spectate) {
+			return false;
+		}
+
+		// Viewport of clients is never larger than the default size, the margin also covers camera look-ahead
+		Vector2f pos = player->_pos;
+		float halfWidth = DefaultWidth * 0.5f + serverConfig.InterestAreaMargin;
+		float halfHeight = DefaultHeight * 0.5f + serverConfig.InterestAreaMargin;
+		result = AABBf(pos.X - halfWidth, pos.Y - halfHeight, pos.X + halfWidth, pos.Y + halfHeight);
+		return true;
+	}
+
+	bool MpLevelHandler::IsActorRelevantToPeer(const PeerDescriptor& peerDesc, const Actors::ActorBase* actor)
+	{
+		AABBf interestArea;
+		if (!GetPeerInterestArea(peerDesc, interestArea)) {
+			return true;
+		}
+
+		return IsInInterestArea(interestArea, actor->_pos);
+	}
+
+	bool MpLevelHandler::IsInInterestArea(const AABBf& area, Vector2f pos)
+	{
+		// AABB of actors without collisions is not updated, so only position is checked, the margin covers size of sprites
+		return (pos.X >= area.L && pos.X <= area.R && pos.Y >= area.T && pos.Y <= area.B);
+	}
+
 	void MpLevelHandler::SynchronizePeers(float timeMult)
 	{
 		for (auto& [peer, peerDesc] : *_networkManager->GetPeers()) {
@@ -4890,12 +5035,13 @@ namespace Jazz2::Multiplayer
 					_networkManager->SendTo(peer, NetworkChannel::Main, (std::uint8_t)ServerPacketType::LevelSetProperty, packet);
 				}
 
-				// Synchronize tilemap
+				// Synchronize tilemap, only tiles that differ from the initial state are sent
 				{
-					// TODO: Use deflate compression here?
-					MemoryStream packet(40 * 1024);
-					_tileMap->SerializeResumableToStream(packet);
-					_networkManager->SendTo(peer, NetworkChannel::Main, (std::uint8_t)ServerPacketType::SyncTileMap, packet);
+					MemoryStream packet(1024);
+					_tileMap->SerializeSparseToStream(packet);
+					MemoryStream packetCompressed(packet.GetSize() + 8);
+					PacketCodec::Compress(arrayView(packet.GetBuffer(), (std::size_t)packet.GetSize()), packetCompressed);
+					_networkManager->SendTo(peer, NetworkChannel::Main, (std::uint8_t)ServerPacketType::SyncTileMap, packetCompressed);
 				}
 
 				// Synchronize music
@@ -4932,6 +5078,9 @@ namespace Jazz2::Multiplayer
 
 				// TODO: Does this need to be locked?
 				std::unique_lock lock(_lock);
+				peerDesc->RelevantActors.clear();
+				peerDesc->ActorSnapshots.Clear();
+				peerDesc->LastAckedActorUpdate = 0;
 				for (const auto& [remotingActor, remotingActorInfo] : _remotingActors) {
 					if DEATH_UNLIKELY(ActorShouldBeMirrored(remotingActor)) {
 						Vector2i originTile = remotingActor->_originTile;
@@ -4948,11 +5097,12 @@ namespace Jazz2::Multiplayer
 
 							_networkManager->SendTo(peer, NetworkChannel::Main, (std::uint8_t)ServerPacketType::CreateMirroredActor, packet);
 						}
-					} else {
+					} else if (IsActorRelevantToPeer(*peerDesc, remotingActor)) {
 						MemoryStream packet;
 						InitializeCreateRemoteActorPacket(packet, remotingActorInfo.ActorID, remotingActor);
 
 						_networkManager->SendTo(peer, NetworkChannel::Main, (std::uint8_t)ServerPacketType::CreateRemoteActor, packet);
+						peerDesc->RelevantActors.emplace(remotingActorInfo.ActorID, _lastUpdated);
 					}
 				}
 			} else if (peerDesc->LevelState == PeerLevelState::PlayerReady) {
@@ -5171,6 +5321,95 @@ namespace Jazz2::Multiplayer
 		}
 	}
 
+	void MpLevelHandler::RegisterMetrics()
+	{
+		static const double TickDurationBuckets[] = { 0.001, 0.002, 0.004, 0.008, 0.012, 0.016, 0.025, 0.05, 0.1, 0.25 };
+
+		auto& metrics = _networkManager->GetMetrics();
+		metrics.Register("jazz2_tick_duration_seconds"_s, MetricType::Histogram, "Time spent in one server tick"_s, TickDurationBuckets);
+		metrics.Register("jazz2_actors"_s, MetricType::Gauge, "Number of actors in the level"_s);
+		metrics.Register("jazz2_remoting_actors"_s, MetricType::Gauge, "Number of actors synchronized to peers"_s);
+		metrics.Register("jazz2_peers"_s, MetricType::Gauge, "Number of connected peers"_s);
+		metrics.Register("jazz2_peer_round_trip_time_seconds"_s, MetricType::Gauge, "Mean round trip time to the peer"_s);
+		metrics.Register("jazz2_packets_sent_total"_s, MetricType::Counter, "Number of sent packets by server packet type"_s);
+		metrics.Register("jazz2_packet_bytes_sent_total"_s, MetricType::Counter, "Size of sent packets by server packet type"_s);
+		metrics.Register("jazz2_packets_received_total"_s, MetricType::Counter, "Number of received packets by client packet type"_s);
+		metrics.Register("jazz2_packet_bytes_received_total"_s, MetricType::Counter, "Size of received packets by client packet type"_s);
+		metrics.Register("jazz2_update_compression_ratio"_s, MetricType::Gauge, "Compressed to uncompressed size of actor updates in the current level"_s);
+		metrics.Register("jazz2_asset_streaming_bytes_sent_total"_s, MetricType::Counter, "Size of sent asset streaming packets"_s);
+		metrics.Register("jazz2_asset_streaming_transfers"_s, MetricType::Gauge, "Number of peers that are currently receiving assets"_s);
+	}
+
+	void MpLevelHandler::UpdateMetrics()
+	{
+		auto& serverConfig = _networkManager->GetServerConfiguration();
+		if (serverConfig.MetricsPath.empty()) {
+			return;
+		}
+
+		auto& metrics = _networkManager->GetMetrics();
+		metrics.Observe("jazz2_tick_duration_seconds"_s, _frameStartTime.secondsSince());
+
+		if (_lastMetricsExportTime.secondsSince() < MetricsExportIntervalSecs) {
+			return;
+		}
+		_lastMetricsExportTime = TimeStamp::now();
+
+		metrics.Set("jazz2_actors"_s, (double)_actors.size());
+		{
+			std::unique_lock lock(_lock);
+			metrics.Set("jazz2_remoting_actors"_s, (double)_remotingActors.size());
+		}
+
+		// Labels of disconnected peers must not be exported anymore
+		metrics.Clear("jazz2_peer_round_trip_time_seconds"_s);
+		std::uint32_t peerCount = 0;
+		for (auto& [peer, peerDesc] : *_networkManager->GetPeers()) {
+			if (!peerDesc->RemotePeer) {
+				continue;
+			}
+
+			String labels = "peer=\""_s + MetricsRegistry::EscapeLabelValue(_networkManager->AddressToString(peerDesc->RemotePeer))
+				+ "\",player=\""_s + MetricsRegistry::EscapeLabelValue(peerDesc->PlayerName) + "\""_s;
+			metrics.Set("jazz2_peer_round_trip_time_seconds"_s, _networkManager->GetRoundTripTimeMs(peerDesc->RemotePeer) / 1000.0, labels);
+			peerCount++;
+		}
+		metrics.Set("jazz2_peers"_s, (double)peerCount);
+
+		// Counters are tracked by the network manager, so only their current values are copied
+		for (std::uint32_t i = 0; i < 256; i++) {
+			PacketTrafficStats stats = _networkManager->GetPacketTrafficStats((std::uint8_t)i);
+			char labels[16];
+			std::size_t length = formatInto(labels, "type=\"{}\"", i);
+			if (stats.PacketsSent > 0) {
+				metrics.Set("jazz2_packets_sent_total"_s, (double)stats.PacketsSent, { labels, length });
+				metrics.Set("jazz2_packet_bytes_sent_total"_s, (double)stats.BytesSent, { labels, length });
+			}
+			if (stats.PacketsReceived > 0) {
+				metrics.Set("jazz2_packets_received_total"_s, (double)stats.PacketsReceived, { labels, length });
+				metrics.Set("jazz2_packet_bytes_received_total"_s, (double)stats.BytesReceived, { labels, length });
+			}
+		}
+
+		metrics.Clear("jazz2_update_compression_ratio"_s);
+		for (std::int32_t i = 0; i < (std::int32_t)PacketCodecType::Count; i++) {
+			if (_updateCodecStats.UncompressedBytes[i] == 0) {
+				continue;
+			}
+
+			String labels = "codec=\""_s + PacketCodec::GetCodecName((PacketCodecType)i) + "\""_s;
+			metrics.Set("jazz2_update_compression_ratio"_s, (double)_updateCodecStats.CompressedBytes[i] / _updateCodecStats.UncompressedBytes[i], labels);
+		}
+
+		PacketTrafficStats assetStats = _networkManager->GetPacketTrafficStats((std::uint8_t)ServerPacketType::StreamAsset);
+		metrics.Set("jazz2_asset_streaming_bytes_sent_total"_s, (double)assetStats.BytesSent);
+		metrics.Set("jazz2_asset_streaming_transfers"_s, _assetStreamer != nullptr ? (double)_assetStreamer->GetActiveTransferCount() : 0.0);
+
+		if (!metrics.WriteToFile(serverConfig.MetricsPath)) {
+			LOGW("[MP] Failed to write metrics to \"{}\"", serverConfig.MetricsPath);
+		}
+	}
+
 	std::uint32_t MpLevelHandler::FindFreeActorId()
 	{
 		for (std::uint32_t i = UINT8_MAX + 1; i < UINT32_MAX - 1; i++) {
@@ -5491,18 +5730,21 @@ namespace Jazz2::Multiplayer
 
 	void MpLevelHandler::RollbackLevelState()
 	{
+		// Synchronized peers already have the current state, so only tiles changed by the rollback are sent
+		MemoryStream packet(1024);
+		_tileMap->SerializeCheckpointDeltaToStream(packet);
+
 		_eventMap->RollbackToCheckpoint();
 		_tileMap->RollbackToCheckpoint();
 
 		// Synchronize tilemap
 		{
-			// TODO: Use deflate compression here?
-			MemoryStream packet(40 * 1024);
-			_tileMap->SerializeResumableToStream(packet);
+			MemoryStream packetCompressed(packet.GetSize() + 8);
+			PacketCodec::Compress(arrayView(packet.GetBuffer(), (std::size_t)packet.GetSize()), packetCompressed);
 			_networkManager->SendTo([this](const Peer& peer) {
 				auto peerDesc = _networkManager->GetPeerDescriptor(peer);
 				return (peerDesc && peerDesc->LevelState >= PeerLevelState::LevelSynchronized);
-			}, NetworkChannel::Main, (std::uint8_t)ServerPacketType::SyncTileMap, packet);
+			}, NetworkChannel::Main, (std::uint8_t)ServerPacketType::SyncTileMap, packetCompressed);
 		}
 
 		for (auto& actor : _actors) {
@@ -6340,6 +6582,8 @@ namespace Jazz2::Multiplayer
 			packet.WriteValue<std::uint8_t>((std::uint8_t)asset.Type);
 			packet.WriteVariableUint32((std::uint32_t)asset.Path.size());
 			packet.Write(asset.Path.data(), (std::int64_t)asset.Path.size());
+			packet.WriteVariableInt64(asset.Size);
+			packet.WriteValue<std::uint32_t>(asset.Crc32);
 		}
 	}
 
@@ -6411,6 +6655,60 @@ namespace Jazz2::Multiplayer
 		packet.WriteValue<std::uint8_t>((std::uint8_t)actor->_renderer.GetRendererType());
 	}
 
+	ActorSnapshotState MpLevelHandler::GetActorSnapshotState(std::uint32_t actorId, const Actors::ActorBase* actor)
+	{
+		ActorSnapshotState state;
+		state.ActorID = actorId;
+		state.PosX = (std::int32_t)(actor->_pos.X * 512.0f);
+		state.PosY = (std::int32_t)(actor->_pos.Y * 512.0f);
+		state.Animation = (std::uint32_t)(actor->_currentTransition != nullptr ? actor->_currentTransition->State : (actor->_currentAnimation != nullptr ? actor->_currentAnimation->State : AnimState::Idle));
+
+		constexpr std::uint32_t RotationSteps = (1u << ActorSnapshotState::RotationBits);
+		float rotation = actor->_renderer.rotation();
+		if (rotation < 0.0f) rotation += fRadAngle360;
+		state.Rotation = (std::uint16_t)((std::uint32_t)(rotation * RotationSteps / fRadAngle360 + 0.5f) & (RotationSteps - 1));
+
+		Vector2f scale = actor->_renderer.scale();
+		state.ScaleX = (std::uint16_t)Half{scale.X};
+		state.ScaleY = (std::uint16_t)Half{scale.Y};
+		state.RendererType = (std::uint8_t)actor->_renderer.GetRendererType();
+
+		state.Flags = 0;
+		if (actor->_renderer.isDrawEnabled()) {
+			state.Flags |= 0x04;
+		}
+		if (actor->_renderer.AnimPaused) {
+			state.Flags |= 0x08;
+		}
+		if (actor->_renderer.isFlippedX()) {
+			state.Flags |= 0x10;
+		}
+		if (actor->_renderer.isFlippedY()) {
+			state.Flags |= 0x20;
+		}
+		return state;
+	}
+
+	void MpLevelHandler::SyncRemoteActorWithSnapshot(Actors::ActorBase* actor, const ActorSnapshotState& state, ActorSnapshotFields fields)
+	{
+		auto* remoteActor = runtime_cast<Actors::Multiplayer::RemoteActor>(actor);
+		if (remoteActor == nullptr) {
+			return;
+		}
+
+		if ((fields & ActorSnapshotFields::Position) == ActorSnapshotFields::Position) {
+			remoteActor->SyncPositionWithServer(Vector2f(state.PosX / 512.0f, state.PosY / 512.0f));
+		}
+		if ((fields & (ActorSnapshotFields::Animation | ActorSnapshotFields::Rotation | ActorSnapshotFields::Scale | ActorSnapshotFields::Misc)) != ActorSnapshotFields::None) {
+			float rotation = state.Rotation * fRadAngle360 / (1u << ActorSnapshotState::RotationBits);
+			remoteActor->SyncAnimationWithServer((AnimState)state.Animation, rotation, (float)Half{state.ScaleX}, (float)Half{state.ScaleY},
+				(Actors::ActorRendererType)state.RendererType);
+		}
+		if ((fields & ActorSnapshotFields::Misc) == ActorSnapshotFields::Misc) {
+			remoteActor->SyncMiscWithServer(state.Flags);
+		}
+	}
+
 	String MpLevelHandler::GetAssetFullPath(AssetType type, StringView path, StaticArrayView<Uuid::Size, Uuid::Type> remoteServerId, bool forWrite)
 	{
 		const auto& resolver = ContentResolver::Get();
@@ -6481,6 +6779,13 @@ namespace Jazz2::Multiplayer
 		}
 	}
 
+	String MpLevelHandler::GetCachedAssetPath(std::uint32_t crc32)
+	{
+		char fileName[9];
+		std::size_t fileNameLength = formatInto(fileName, "{:.8x}", crc32);
+		return fs::CombinePath({ ContentResolver::Get().GetCachePath(), "Downloads"_s, "Cache"_s, { fileName, fileNameLength } });
+	}
+
 	/*void MpLevelHandler::UpdatePlayerLocalPos(Actors::Player* player, PlayerState& playerState, float timeMult)
 	{
 		if (playerState.WarpTimeLeft > 0.0f || !player->_controllable || !player->GetState(Actors::ActorState::CollideWithTileset)) {
@@ -3,7 +3,10 @@
 #if defined(WITH_MULTIPLAYER) || defined(DOXYGEN_GENERATING_OUTPUT)
 
 #include "../LevelHandler.h"
+#include "ActorSnapshot.h"
+#include "AssetStreamer.h"
 #include "MpGameMode.h"
+#include "PacketCodec.h"
 #include "NetworkManager.h"
 #include "../Actors/Player.h"
 #include "../UI/InGameConsole.h"
@@ -171,6 +174,8 @@ namespace Jazz2::Multiplayer
 
 		/** @brief Returns full path of the specified asset */
 		static String GetAssetFullPath(AssetType type, StringView path, StaticArrayView<Uuid::Size, Uuid::Type> remoteServerId = {}, bool forWrite = false);
+		/** @brief Returns full path of a downloaded asset in the cache shared by all servers, the asset is identified by its CRC32 checksum */
+		static String GetCachedAssetPath(std::uint32_t crc32);
 
 	protected:
 		void AttachComponents(LevelDescriptor&& descriptor) override;
@@ -228,13 +233,13 @@ namespace Jazz2::Multiplayer
 		// Doxygen 1.12.0 outputs also private structs/unions even if it shouldn't
 		struct RemotingActorInfo {
 			std::uint32_t ActorID;
-			std::int32_t LastPosX;
-			std::int32_t LastPosY;
-			std::uint32_t LastAnimation;
-			std::uint16_t LastRotation;
-			std::uint16_t LastScaleX;
-			std::uint16_t LastScaleY;
-			std::uint8_t LastRendererType;
+		};
+
+		struct RemotingActorUpdate {
+			Actors::ActorBase* Actor;
+			ActorSnapshotState State;
+			bool IsMirrored;
+			bool IsPlayer;
 		};
 
 		struct PlayerName {
@@ -290,16 +295,22 @@ namespace Jazz2::Multiplayer
 		static constexpr float UpdatesPerSecond = 30.0f; // ~33 ms interval
 		static constexpr std::int64_t ServerDelay = 64;
 		static constexpr float EndingDuration = 10 * FrameTimer::FramesPerSecond;
+		// Actors already relevant to a peer are kept a bit longer to avoid creating and destroying them repeatedly
+		static constexpr float InterestAreaHysteresis = 64.0f;
+		static constexpr float MetricsExportIntervalSecs = 5.0f;
+		static constexpr std::uint32_t MaxSyncTileMapSize = 8 * 1024 * 1024;
 
 		NetworkManager* _networkManager;
 		float _updateTimeLeft;
 		float _gameTimeLeft;
 		LevelState _levelState;
 		bool _isServer;
-		bool _forceResyncPending;
 		bool _enableSpawning;
 		HashMap<std::uint32_t, std::shared_ptr<Actors::ActorBase>> _remoteActors; // Client: Actor ID -> Remote Actor created by server
 		HashMap<Actors::ActorBase*, RemotingActorInfo> _remotingActors; // Server: Local Actor created by server -> Info
+		SmallVector<RemotingActorUpdate, 0> _remotingActorUpdates; // Server: Current state of players and remoting actors sorted by ID
+		PacketCodecStats _updateCodecStats; // Server: Compression statistics of actor updates
+		ActorSnapshotHistory _receivedActorSnapshots; // Client: Recently applied actor snapshots, used as baselines for delta compression
 		HashMap<std::uint32_t, PlayerName> _playerNames; // Client: Actor ID -> Player name (and flags)
 		SmallVector<PlayerPositionInRound, 0> _positionsInRound; // Client: Actor ID -> Position In Round
 		SmallVector<MultiplayerSpawnPoint, 0> _multiplayerSpawnPoints;
@@ -311,6 +322,7 @@ namespace Jazz2::Multiplayer
 		std::uint64_t _seqNumWarped; // Client: set to _seqNum from HandlePlayerWarped() when warped
 		Threading::Spinlock _lock;
 		bool _suppressRemoting; // Server: if true, actor will not be automatically remoted to other players
+		bool _resyncRequested; // Client: ForceResyncActors was sent, waiting for an update without baseline
 		bool _ignorePackets;
 		bool _enableLedgeClimb;
 		bool _controllableExternal;
@@ -328,6 +340,9 @@ namespace Jazz2::Multiplayer
 		std::int32_t _totalTreasureCount;
 
 		SmallVector<RequiredAsset, 0> _requiredAssets;
+		std::unique_ptr<AssetStreamer> _assetStreamer; // Server: Streams missing assets to peers, created on demand
+		TimeStamp _frameStartTime; // Server: Start of the current frame, used to measure tick duration
+		TimeStamp _lastMetricsExportTime; // Server: Last time metrics were written to file
 
 #if defined(DEATH_DEBUG)
 		std::int32_t _debugAverageUpdatePacketSize;
@@ -338,6 +353,11 @@ namespace Jazz2::Multiplayer
 
 		void InitializeRequiredAssets();
 		void SynchronizePeers(float timeMult);
+		void RegisterMetrics();
+		void UpdateMetrics();
+		void SendUpdateAllActors(float timeMult);
+		bool GetPeerInterestArea(const PeerDescriptor& peerDesc, AABBf& result);
+		bool IsActorRelevantToPeer(const PeerDescriptor& peerDesc, const Actors::ActorBase* actor);
 		std::uint32_t FindFreeActorId();
 		std::uint8_t FindFreePlayerId();
 		std::int32_t GetNonSpectatePlayerCount();
@@ -374,6 +394,9 @@ namespace Jazz2::Multiplayer
 		void InitializeValidateAssetsPacket(MemoryStream& packet);
 		void InitializeLoadLevelPacket(MemoryStream& packet);
 		static void InitializeCreateRemoteActorPacket(MemoryStream& packet, std::uint32_t actorId, const Actors::ActorBase* actor);
+		static bool IsInInterestArea(const AABBf& area, Vector2f pos);
+		static ActorSnapshotState GetActorSnapshotState(std::uint32_t actorId, const Actors::ActorBase* actor);
+		static void SyncRemoteActorWithSnapshot(Actors::ActorBase* actor, const ActorSnapshotState& state, ActorSnapshotFields fields);
 
 #if defined(DEATH_DEBUG) && defined(WITH_IMGUI)
 		static constexpr std::int32_t PlotValueCount = 512;
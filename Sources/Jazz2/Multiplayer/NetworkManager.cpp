@@ -6,6 +6,7 @@
 #include "../ContentResolver.h"
 #include "../PreferencesCache.h"
 #include "../../nCine/I18n.h"
+#include "../../nCine/Base/FrameTimer.h"
 
 #include <jsoncpp/json.h>
 
@@ -27,7 +28,8 @@ namespace Jazz2::Multiplayer
 		: IsAuthenticated(false), IsAdmin(false), EnableLedgeClimb(false), Team(0), PreferredPlayerType(PlayerType::None),
 			Points(0), PointsInRound(0), PositionInRound(0), LevelState(PeerLevelState::Unknown), Player(nullptr),
 			LastUpdated(0), Deaths(0), Kills(0), Laps(0), LapStarted{}, TreasureCollected(0), IdleElapsedFrames(0.0f),
-			DeathElapsedFrames(FLT_MAX), LapsElapsedFrames(0.0f), JoinCooldownFrames(0.0f), IsSpectating(SpectateMode::None)
+			DeathElapsedFrames(FLT_MAX), LapsElapsedFrames(0.0f), JoinCooldownFrames(0.0f), IsSpectating(SpectateMode::None),
+			ActorSyncBytesSent(0), ActorSyncBytesPerSecond(0.0f), LastAckedActorUpdate(0)
 	{
 	}
 
@@ -133,6 +135,11 @@ namespace Jazz2::Multiplayer
 		return (it != _peerDesc.end() ? it->second : nullptr);
 	}
 
+	MetricsRegistry& NetworkManager::GetMetrics()
+	{
+		return _metrics;
+	}
+
 	bool NetworkManager::HasInboundConnections() const
 	{
 		// Local peer is always present
@@ -189,9 +196,12 @@ namespace Jazz2::Multiplayer
 
 		ServerConfiguration serverConfig{};
 		serverConfig.AllowAssetStreaming = true;
+		serverConfig.AssetStreamingBytesPerSecond = 512 * 1024;
 		serverConfig.GameMode = MpGameMode::Cooperation;
 		serverConfig.AllowedPlayerTypes = 0x01 | 0x02 | 0x04;
 		serverConfig.IdleKickTimeSecs = -1;
+		serverConfig.InterestAreaMargin = 200;
+		serverConfig.TickRate = (std::uint32_t)FrameTimer::FramesPerSecond;
 		serverConfig.MinPlayerCount = 1;
 		serverConfig.ReforgedGameplay = PreferencesCache::EnableReforgedGameplay;
 		serverConfig.PreGameSecs = 60;
@@ -349,6 +359,11 @@ namespace Jazz2::Multiplayer
 				if (doc["AllowAssetStreaming"].get(allowAssetStreaming) == Json::SUCCESS) {
 					serverConfig.AllowAssetStreaming = allowAssetStreaming;
 				}
+
+				std::int64_t assetStreamingBytesPerSecond;
+				if (doc["AssetStreamingBytesPerSecond"].get(assetStreamingBytesPerSecond) == Json::SUCCESS && assetStreamingBytesPerSecond >= 0 && assetStreamingBytesPerSecond <= UINT32_MAX) {
+					serverConfig.AssetStreamingBytesPerSecond = std::uint32_t(assetStreamingBytesPerSecond);
+				}
 				
 				bool requiresDiscordAuth;
 				if (doc["RequiresDiscordAuth"].get(requiresDiscordAuth) == Json::SUCCESS) {
@@ -365,6 +380,21 @@ namespace Jazz2::Multiplayer
 					serverConfig.IdleKickTimeSecs = std::int16_t(idleKickTimeSecs);
 				}
 
+				std::int64_t interestAreaMargin;
+				if (doc["InterestAreaMargin"].get(interestAreaMargin) == Json::SUCCESS && interestAreaMargin >= INT32_MIN && interestAreaMargin <= INT32_MAX) {
+					serverConfig.InterestAreaMargin = std::int32_t(interestAreaMargin);
+				}
+
+				std::int64_t tickRate;
+				if (doc["TickRate"].get(tickRate) == Json::SUCCESS && tickRate >= 10 && tickRate <= 240) {
+					serverConfig.TickRate = std::uint32_t(tickRate);
+				}
+
+				std::string_view metricsPath;
+				if (doc["MetricsPath"].get(metricsPath) == Json::SUCCESS) {
+					serverConfig.MetricsPath = metricsPath;
+				}
+
 				Json::Value& adminUniquePlayerIDs = doc["AdminUniquePlayerIDs"];
 				for (auto it = adminUniquePlayerIDs.begin(); it != adminUniquePlayerIDs.end(); ++it) {
 					std::string_view key = it.name();
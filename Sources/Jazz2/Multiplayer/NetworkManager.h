@@ -3,6 +3,7 @@
 #if defined(WITH_MULTIPLAYER) || defined(DOXYGEN_GENERATING_OUTPUT)
 
 #include "NetworkManagerBase.h"
+#include "MetricsRegistry.h"
 #include "MpGameMode.h"
 #include "ServerInitialization.h"
 #include "PeerDescriptor.h"
@@ -51,6 +52,9 @@ namespace Jazz2::Multiplayer
 		/** @brief Returns session peer descriptor for the specified connected remote peer */
 		std::shared_ptr<PeerDescriptor> GetPeerDescriptor(const Peer& peer);
 
+		/** @brief Returns metrics of the server, they're kept for the whole lifetime of the server */
+		MetricsRegistry& GetMetrics();
+
 		/** @brief Returns `true` if there are any inbound connections */
 		bool HasInboundConnections() const;
 
@@ -96,6 +100,7 @@ namespace Jazz2::Multiplayer
 		std::unique_ptr<ServerDiscovery> _discovery;
 		HashMap<Peer, std::shared_ptr<PeerDescriptor>> _peerDesc;
 		Spinlock _lock;
+		MetricsRegistry _metrics;
 
 		String OnOverrideContentPath(StringView path);
 
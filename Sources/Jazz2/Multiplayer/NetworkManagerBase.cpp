@@ -6,6 +6,7 @@
 #include "INetworkHandler.h"
 #include "PacketTypes.h"
 #include "../../nCine/Base/Algorithms.h"
+#include "../../nCine/Base/Clock.h"
 #include "../../nCine/Threading/Thread.h"
 
 #include <atomic>
@@ -161,16 +162,32 @@ namespace Jazz2::Multiplayer
 	NetworkManagerBase::NetworkManagerBase()
 		:
 #if !defined(DEATH_TARGET_EMSCRIPTEN)
-		_host(nullptr),
+		_host(nullptr), _wakeSocket(ENET_SOCKET_NULL), _wakeAddress{}, _wakePending(false),
+		_dispatchLatencyUs(0), _maxDispatchLatencyUs(0), _networkThreadId(0), _networkThreadExited(false), _peerConnectIds{},
+		_outgoingQueue(OutgoingQueueCapacity), _incomingQueue(IncomingQueueCapacity),
 #endif
 		_state(NetworkState::None), _handler(nullptr)
 	{
 		InitializeBackend();
+#if !defined(DEATH_TARGET_EMSCRIPTEN)
+		CreateWakeSocket();
+#endif
 	}
 
 	NetworkManagerBase::~NetworkManagerBase()
 	{
 		Dispose();
+#if !defined(DEATH_TARGET_EMSCRIPTEN)
+		// Release packets that were queued after the network thread exited
+		ProcessOutgoingCommands(true);
+		DiscardIncomingPackets();
+		DestroyHosts();
+
+		if (_wakeSocket != ENET_SOCKET_NULL) {
+			enet_socket_destroy(_wakeSocket);
+			_wakeSocket = ENET_SOCKET_NULL;
+		}
+#endif
 		ReleaseBackend();
 	}
 
@@ -267,6 +284,7 @@ namespace Jazz2::Multiplayer
 				}
 			});
 			_wsClient->start();
+			_networkThreadExited = false;
 			_thread = Thread(NetworkManagerBase::OnClientWsThread, this);
 			return;
 		}
@@ -333,6 +351,7 @@ namespace Jazz2::Multiplayer
 			endpoints = p[2];
 		}
 
+		_networkThreadExited = false;
 		_thread = Thread(NetworkManagerBase::OnClientThread, this);
 #endif
 	}
@@ -356,6 +375,7 @@ namespace Jazz2::Multiplayer
 
 		_handler = handler;
 		_state = NetworkState::Listening;
+		_networkThreadExited = false;
 		_thread = Thread(NetworkManagerBase::OnServerThread, this);
 		return true;
 #endif
@@ -392,9 +412,19 @@ namespace Jazz2::Multiplayer
 		}
 
 		_state = NetworkState::None;
+		WakeNetworkThread();
 		_thread.Join();
 
-		_host = nullptr;
+		// The network thread exited, so remaining disconnections can be dispatched here, then no event references peers of the hosts
+		DispatchRemainingEvents();
+		DestroyHosts();
+		{
+			std::unique_lock lock(_lock);
+			_connectedPeers.clear();
+		}
+		_capture.Close();
+		// Virtual peers of the replay could be referenced by the network thread until now
+		_replay = nullptr;
 #endif
 
 		_handler = nullptr;
@@ -441,6 +471,36 @@ namespace Jazz2::Multiplayer
 #endif
 	}
 
+	std::uint32_t NetworkManagerBase::GetPacketDispatchLatencyUs() const
+	{
+#if defined(DEATH_TARGET_EMSCRIPTEN)
+		return 0;
+#else
+		return _dispatchLatencyUs.load(std::memory_order_relaxed);
+#endif
+	}
+
+	std::uint32_t NetworkManagerBase::GetMaxPacketDispatchLatencyUs() const
+	{
+#if defined(DEATH_TARGET_EMSCRIPTEN)
+		return 0;
+#else
+		return _maxDispatchLatencyUs.load(std::memory_order_relaxed);
+#endif
+	}
+
+	PacketTrafficStats NetworkManagerBase::GetPacketTrafficStats(std::uint8_t packetType) const
+	{
+		const auto& counters = _trafficCounters[packetType];
+
+		PacketTrafficStats stats;
+		stats.PacketsSent = counters.PacketsSent.load(std::memory_order_relaxed);
+		stats.BytesSent = counters.BytesSent.load(std::memory_order_relaxed);
+		stats.PacketsReceived = counters.PacketsReceived.load(std::memory_order_relaxed);
+		stats.BytesReceived = counters.BytesReceived.load(std::memory_order_relaxed);
+		return stats;
+	}
+
 	Array<String> NetworkManagerBase::GetServerEndpoints() const
 	{
 #if defined(DEATH_TARGET_EMSCRIPTEN)
@@ -600,7 +660,9 @@ namespace Jazz2::Multiplayer
 #else
 #	if defined(WITH_WEBSOCKET)
 		if DEATH_UNLIKELY(peer.IsWebSocket()) {
-			SendToWsPeer(peer._ws, packetType, data);
+			if (SendToWsPeer(peer._ws, packetType, data)) {
+				OnPacketsSent(packetType, channel, data.size(), 1);
+			}
 			return;
 		}
 #	endif
@@ -620,23 +682,19 @@ namespace Jazz2::Multiplayer
 		}
 
 		enet_uint32 flags;
-		if (channel == NetworkChannel::Main) {
+		if (channel != NetworkChannel::UnreliableUpdates) {
 			flags = ENET_PACKET_FLAG_RELIABLE;
 		} else {
 			flags = ENET_PACKET_FLAG_UNSEQUENCED;
 		}
 
 		ENetPacket* packet = enet_packet_create(packetType, data.data(), data.size(), flags);
+		// The reference is held by the queue until the command is processed
+		packet->referenceCount = 1;
 
-		bool success;
-		{
-			std::unique_lock lock(_lock);
-			success = enet_peer_send(target, std::uint8_t(channel), packet) >= 0;
-		}
-
-		if DEATH_UNLIKELY(!success) {
-			enet_packet_destroy(packet);
-		}
+		OutgoingCommand command{OutgoingCommand::Type::Send, std::uint8_t(channel), true, 0, GetKnownConnectId(target), target, packet};
+		EnqueueOutgoing(arrayView(&command, 1));
+		OnPacketsSent(packetType, channel, data.size(), 1);
 #endif
 	}
 
@@ -656,14 +714,14 @@ namespace Jazz2::Multiplayer
 		}
 #else
 		enet_uint32 flags;
-		if (channel == NetworkChannel::Main) {
+		if (channel != NetworkChannel::UnreliableUpdates) {
 			flags = ENET_PACKET_FLAG_RELIABLE;
 		} else {
 			flags = ENET_PACKET_FLAG_UNSEQUENCED;
 		}
 
 		ENetPacket* enetPacket = nullptr;
-		bool enetPacketSent = false;
+		SmallVector<OutgoingCommand, 16> commands;
 #	if defined(WITH_WEBSOCKET)
 		SmallVector<ix::WebSocket*, 16> wsTargets;
 #	endif
@@ -680,17 +738,19 @@ namespace Jazz2::Multiplayer
 					{
 						if DEATH_UNLIKELY(enetPacket == nullptr) {
 							enetPacket = enet_packet_create(packetType, data.data(), data.size(), flags);
+							// The reference is held by the queue until the last command is processed
+							enetPacket->referenceCount = 1;
 						}
-						if DEATH_LIKELY(enet_peer_send(p._enet, std::uint8_t(channel), enetPacket) >= 0) {
-							enetPacketSent = true;
-						}
+						commands.push_back({OutgoingCommand::Type::Send, std::uint8_t(channel), false, 0, GetKnownConnectId(p), p._enet, enetPacket});
 					}
 				}
 			}
 		}
 
-		if (enetPacket != nullptr && !enetPacketSent) {
-			enet_packet_destroy(enetPacket);
+		if (!commands.empty()) {
+			commands.back().ReleasePacket = true;
+			EnqueueOutgoing(commands);
+			OnPacketsSent(packetType, channel, data.size(), commands.size());
 		}
 
 #	if defined(WITH_WEBSOCKET)
@@ -708,6 +768,7 @@ namespace Jazz2::Multiplayer
 					}
 				}
 				ws->sendBinary(wsPacket);
+				OnPacketsSent(packetType, channel, data.size(), 1);
 			}
 		}
 #	endif
@@ -727,14 +788,14 @@ namespace Jazz2::Multiplayer
 		}
 #else
 		enet_uint32 flags;
-		if (channel == NetworkChannel::Main) {
+		if (channel != NetworkChannel::UnreliableUpdates) {
 			flags = ENET_PACKET_FLAG_RELIABLE;
 		} else {
 			flags = ENET_PACKET_FLAG_UNSEQUENCED;
 		}
 
 		ENetPacket* enetPacket = nullptr;
-		bool enetPacketSent = false;
+		SmallVector<OutgoingCommand, 16> commands;
 #	if defined(WITH_WEBSOCKET)
 		SmallVector<ix::WebSocket*, 16> wsTargets;
 #	endif
@@ -750,16 +811,18 @@ namespace Jazz2::Multiplayer
 				{
 					if DEATH_UNLIKELY(enetPacket == nullptr) {
 						enetPacket = enet_packet_create(packetType, data.data(), data.size(), flags);
+						// The reference is held by the queue until the last command is processed
+						enetPacket->referenceCount = 1;
 					}
-					if DEATH_LIKELY(enet_peer_send(p._enet, std::uint8_t(channel), enetPacket) >= 0) {
-						enetPacketSent = true;
-					}
+					commands.push_back({OutgoingCommand::Type::Send, std::uint8_t(channel), false, 0, GetKnownConnectId(p), p._enet, enetPacket});
 				}
 			}
 		}
 
-		if (enetPacket != nullptr && !enetPacketSent) {
-			enet_packet_destroy(enetPacket);
+		if (!commands.empty()) {
+			commands.back().ReleasePacket = true;
+			EnqueueOutgoing(commands);
+			OnPacketsSent(packetType, channel, data.size(), commands.size());
 		}
 
 #	if defined(WITH_WEBSOCKET)
@@ -777,6 +840,7 @@ namespace Jazz2::Multiplayer
 					}
 				}
 				ws->sendBinary(wsPacket);
+				OnPacketsSent(packetType, channel, data.size(), 1);
 			}
 		}
 #	endif
@@ -799,12 +863,63 @@ namespace Jazz2::Multiplayer
 #endif
 #if !defined(DEATH_TARGET_EMSCRIPTEN)
 		if DEATH_LIKELY(peer != nullptr) {
-			std::unique_lock lock(_lock);
-			enet_peer_disconnect(peer._enet, std::uint32_t(reason));
+			OutgoingCommand command{OutgoingCommand::Type::Disconnect, 0, false, std::uint32_t(reason), GetKnownConnectId(peer), peer._enet, nullptr};
+			EnqueueOutgoing(arrayView(&command, 1));
 		}
 #endif
 	}
 
+	void NetworkManagerBase::ProcessReceivedPackets()
+	{
+#if !defined(DEATH_TARGET_EMSCRIPTEN)
+		while (const std::uint8_t* ptr = _incomingQueue.prepareRead()) {
+			IncomingEvent ev;
+			std::memcpy(&ev, ptr, sizeof(IncomingEvent));
+			_incomingQueue.finishRead(sizeof(IncomingEvent));
+			DispatchIncoming(ev, false);
+		}
+		_incomingQueue.commitRead();
+
+		if DEATH_UNLIKELY(!_incomingOverflow.empty() && _networkThreadExited.load(std::memory_order_acquire)) {
+			// The network thread exited before it moved all events to the queue, so the overflow is owned by this thread now
+			for (const IncomingEvent& ev : _incomingOverflow) {
+				DispatchIncoming(ev, false);
+			}
+			_incomingOverflow.clear();
+		}
+
+		if (_replay != nullptr && _handler != nullptr && _state == NetworkState::Listening) {
+			_replay->ProcessFrame();
+		}
+#endif
+	}
+
+#if !defined(DEATH_TARGET_EMSCRIPTEN)
+	bool NetworkManagerBase::StartCapture(StringView path)
+	{
+		return _capture.Open(path, _state == NetworkState::Listening);
+	}
+
+	void NetworkManagerBase::StopCapture()
+	{
+		_capture.Close();
+	}
+
+	bool NetworkManagerBase::StartReplay(StringView path, Function<void()>&& onFinished)
+	{
+		if (_state != NetworkState::Listening) {
+			LOGE("[MP] Packet capture can be replayed only on the server");
+			return false;
+		}
+
+		auto replay = std::make_unique<PacketCaptureReplay>(this, std::move(onFinished));
+		if (!replay->Open(path)) {
+			return false;
+		}
+		_replay = std::move(replay);
+		return true;
+	}
+#endif
 
 	String NetworkManagerBase::AddressToString(const struct in_addr& address, std::uint16_t port)
 	{
@@ -1025,12 +1140,23 @@ namespace Jazz2::Multiplayer
 
 	ConnectionResult NetworkManagerBase::OnPeerConnected(const Peer& peer, std::uint32_t clientData)
 	{
-		return _handler->OnPeerConnected(peer, clientData);
+		ConnectionResult result = _handler->OnPeerConnected(peer, clientData);
+#if !defined(DEATH_TARGET_EMSCRIPTEN)
+		if (result.IsSuccessful() && _capture.IsOpen()) {
+			_capture.WriteConnected(peer, clientData);
+		}
+#endif
+		return result;
 	}
 
 	void NetworkManagerBase::OnPeerDisconnected(const Peer& peer, Reason reason)
 	{
 		_handler->OnPeerDisconnected(peer, reason);
+#if !defined(DEATH_TARGET_EMSCRIPTEN)
+		if (peer && _capture.IsOpen()) {
+			_capture.WriteDisconnected(peer, reason);
+		}
+#endif
 
 #if !defined(DEATH_TARGET_EMSCRIPTEN)
 		if (peer && _state == NetworkState::Listening) {
@@ -1230,6 +1356,7 @@ namespace Jazz2::Multiplayer
 					_wsPeers.emplace(&ws, WsPeerInfo{String(remoteIp.data(), remoteIp.size()), 0});
 					_wsPendingEvents.push_back({WsQueuedEvent::Type::Open, &ws, {}, peerClientData, 0});
 				}
+				WakeNetworkThread();
 				LOGD("[MP] WebSocket client connected [{}] from {}", Peer::FromWebSocket(&ws), StringView{remoteIp});
 
 			} else if (msg->type == ix::WebSocketMessageType::Close) {
@@ -1238,11 +1365,15 @@ namespace Jazz2::Multiplayer
 					_wsPeers.erase(&ws);
 					_wsPendingEvents.push_back({WsQueuedEvent::Type::Close, &ws, {}, 0, std::uint16_t(msg->closeInfo.code)});
 				}
+				WakeNetworkThread();
 				LOGD("[MP] WebSocket client disconnected [{}]", Peer::FromWebSocket(&ws));
 			} else if (msg->type == ix::WebSocketMessageType::Message && msg->binary) {
 				if (!msg->str.empty()) {
-					std::unique_lock<Spinlock> lock(_wsLock);
-					_wsPendingEvents.push_back({WsQueuedEvent::Type::Message, &ws, msg->str});
+					{
+						std::unique_lock<Spinlock> lock(_wsLock);
+						_wsPendingEvents.push_back({WsQueuedEvent::Type::Message, &ws, msg->str});
+					}
+					WakeNetworkThread();
 				}
 
 			} else if (msg->type == ix::WebSocketMessageType::Error) {
@@ -1261,7 +1392,7 @@ namespace Jazz2::Multiplayer
 		return true;
 	}
 
-	void NetworkManagerBase::ProcessWsQueue(INetworkHandler* handler)
+	void NetworkManagerBase::ProcessWsQueue()
 	{
 		SmallVector<WsQueuedEvent, 0> pending;
 		{
@@ -1272,19 +1403,12 @@ namespace Jazz2::Multiplayer
 		for (auto& ev : pending) {
 			switch (ev.type) {
 				case WsQueuedEvent::Type::Open: {
-					Peer wsPeer = Peer::FromWebSocket(ev.peer);
-					ConnectionResult result = OnPeerConnected(wsPeer, ev.clientData);
-					if (result.IsSuccessful()) {
-						std::unique_lock lock(_lock);
-						_connectedPeers.push_back(wsPeer);
-					} else {
-						// Reject the connection
-						ev.peer->close(ReasonToWsCloseCode(result.FailureReason), ReasonToString(result.FailureReason));
-					}
+					// The connection is accepted or rejected on the game thread
+					EnqueueConnected(Peer::FromWebSocket(ev.peer), ev.clientData);
 					break;
 				}
 				case WsQueuedEvent::Type::Close: {
-					OnPeerDisconnected(Peer::FromWebSocket(ev.peer), WsCloseCodeToReason(ev.closeCode, true));
+					EnqueueDisconnected(Peer::FromWebSocket(ev.peer), WsCloseCodeToReason(ev.closeCode, true));
 					break;
 				}
 				case WsQueuedEvent::Type::Message: {
@@ -1309,8 +1433,8 @@ namespace Jazz2::Multiplayer
 							std::memcpy(pong + 1, &timestamp, 8);
 							ev.peer->sendBinary(std::string(reinterpret_cast<const char*>(pong), sizeof(pong)));
 						} else {
-							handler->OnPacketReceived(Peer::FromWebSocket(ev.peer), 0,
-								pktType, arrayView((const std::uint8_t*)ev.data.data() + 1, ev.data.size() - 1));
+							ENetPacket* packet = enet_packet_create_raw(ev.data.data(), ev.data.size(), 0);
+							EnqueueIncoming({Peer::FromWebSocket(ev.peer), packet, 0, 0, 0, IncomingEvent::Type::Packet, 0});
 						}
 					}
 					break;
@@ -1342,7 +1466,7 @@ namespace Jazz2::Multiplayer
 		Thread::SetCurrentName("Multiplayer WebSocket client");
 
 		NetworkManagerBase* _this = static_cast<NetworkManagerBase*>(param);
-		INetworkHandler* handler = _this->_handler;
+		_this->_networkThreadId = Thread::GetCurrentId();
 
 		bool wasConnected = false;
 		ix::WebSocket* serverPeer = nullptr;
@@ -1351,6 +1475,7 @@ namespace Jazz2::Multiplayer
 
 		while (_this->_state != NetworkState::None) {
 			Thread::Sleep(ProcessingIntervalMs);
+			_this->FlushIncomingOverflow();
 
 			SmallVector<WsQueuedEvent, 0> pending;
 			{
@@ -1371,10 +1496,7 @@ namespace Jazz2::Multiplayer
 							std::unique_lock lock(_this->_lock);
 							_this->_connectedPeers.push_back(connectedPeer);
 						}
-						ConnectionResult result = _this->OnPeerConnected(connectedPeer, ev.clientData);
-						if (!result.IsSuccessful()) {
-							ev.peer->close(ReasonToWsCloseCode(result.FailureReason), ReasonToString(result.FailureReason));
-						}
+						_this->EnqueueConnected(connectedPeer, ev.clientData);
 						break;
 					}
 					case WsQueuedEvent::Type::Close: {
@@ -1392,8 +1514,8 @@ namespace Jazz2::Multiplayer
 								std::uint64_t rtt = GetCurrentTimeMs() - sentTime;
 								_this->_wsRtt.store((std::uint32_t)rtt, std::memory_order_relaxed);
 							} else {
-								handler->OnPacketReceived(Peer::FromWebSocket(ev.peer), 0,
-									pktType, arrayView((const std::uint8_t*)ev.data.data() + 1, ev.data.size() - 1));
+								ENetPacket* packet = enet_packet_create_raw(ev.data.data(), ev.data.size(), 0);
+								_this->EnqueueIncoming({Peer::FromWebSocket(ev.peer), packet, 0, 0, 0, IncomingEvent::Type::Packet, 0});
 							}
 						}
 						break;
@@ -1422,25 +1544,396 @@ namespace Jazz2::Multiplayer
 		}
 
 		if (wasConnected) {
-			_this->OnPeerDisconnected(Peer::FromWebSocket(serverPeer), disconnectReason);
+			_this->EnqueueDisconnected(Peer::FromWebSocket(serverPeer), disconnectReason);
 		} else {
-			_this->OnPeerDisconnected({}, disconnectReason);
+			_this->EnqueueDisconnected({}, disconnectReason);
 		}
 
 		_this->_wsRtt.store(0, std::memory_order_relaxed);
-		_this->_handler = nullptr;
+		_this->FlushIncomingOverflow();
+		_this->_networkThreadId = 0;
+		_this->_networkThreadExited.store(true, std::memory_order_release);
 		_this->_thread.Detach();
 
 		LOGD("[MP] WebSocket client thread exited");
 	}
 #	endif
 
+	void NetworkManagerBase::CreateWakeSocket()
+	{
+		_wakeSocket = enet_socket_create(ENET_SOCKET_TYPE_DATAGRAM);
+		if (_wakeSocket == ENET_SOCKET_NULL) {
+			LOGW("[MP] Failed to create wake-up socket, falling back to periodic polling");
+			return;
+		}
+
+		ENetAddress addr{};
+#if ENET_IPV6
+		addr.host = enet_v6_localhost;
+#else
+		addr.host = ENET_HOST_TO_NET_32(0x7F000001);
+#endif
+		addr.port = ENET_PORT_ANY;
+
+		if (enet_socket_bind(_wakeSocket, &addr) < 0 || enet_socket_get_address(_wakeSocket, &_wakeAddress) < 0) {
+			LOGW("[MP] Failed to bind wake-up socket, falling back to periodic polling");
+			enet_socket_destroy(_wakeSocket);
+			_wakeSocket = ENET_SOCKET_NULL;
+			return;
+		}
+
+		enet_socket_set_option(_wakeSocket, ENET_SOCKOPT_NONBLOCK, 1);
+	}
+
+	void NetworkManagerBase::WakeNetworkThread()
+	{
+		// Only one wake-up datagram is needed until the network thread drains it
+		if (_wakeSocket == ENET_SOCKET_NULL || _wakePending.exchange(true, std::memory_order_acq_rel)) {
+			return;
+		}
+
+		std::uint8_t signal = 0;
+		ENetBuffer buffer;
+		buffer.data = &signal;
+		buffer.dataLength = sizeof(signal);
+		if DEATH_UNLIKELY(enet_socket_send(_wakeSocket, &_wakeAddress, &buffer, 1) <= 0) {
+			_wakePending.store(false, std::memory_order_release);
+		}
+	}
+
+	bool NetworkManagerBase::WaitForEvents(ENetHost* host, std::uint32_t timeoutMs)
+	{
+		ENetSocketSet set;
+		ENET_SOCKETSET_EMPTY(set);
+		ENET_SOCKETSET_ADD(set, host->socket);
+		ENetSocket maxSocket = host->socket;
+		if (_wakeSocket != ENET_SOCKET_NULL) {
+			ENET_SOCKETSET_ADD(set, _wakeSocket);
+			if (maxSocket < _wakeSocket) {
+				maxSocket = _wakeSocket;
+			}
+		}
+
+		if (enet_socketset_select(maxSocket, &set, nullptr, timeoutMs) <= 0) {
+			return false;
+		}
+
+		if (_wakeSocket != ENET_SOCKET_NULL && ENET_SOCKETSET_CHECK(set, _wakeSocket)) {
+			// Clear the flag first, so any send issued while draining schedules another wake-up
+			_wakePending.store(false, std::memory_order_release);
+
+			ENetAddress from;
+			std::uint8_t buffer[16];
+			ENetBuffer recvbuf;
+			recvbuf.data = buffer;
+			recvbuf.dataLength = sizeof(buffer);
+			while (enet_socket_receive(_wakeSocket, &from, &recvbuf, 1) > 0) {
+				// Drain all pending wake-up datagrams
+			}
+		}
+
+		return ENET_SOCKETSET_CHECK(set, host->socket);
+	}
+
+	void NetworkManagerBase::OnPacketsSent(std::uint8_t packetType, NetworkChannel channel, std::size_t dataSize, std::size_t peerCount)
+	{
+		auto& counters = _trafficCounters[packetType];
+		counters.PacketsSent.fetch_add(peerCount, std::memory_order_relaxed);
+		counters.BytesSent.fetch_add((1 + dataSize) * peerCount, std::memory_order_relaxed);
+
+		if DEATH_UNLIKELY(_capture.IsOpen()) {
+			_capture.WriteSent((std::uint32_t)peerCount, std::uint8_t(channel), packetType, (std::uint32_t)dataSize);
+		}
+	}
+
+	std::uint32_t NetworkManagerBase::DispatchPacket(const Peer& source, std::uint8_t channelId, std::uint8_t packetType, ArrayView<const std::uint8_t> data)
+	{
+		auto& counters = _trafficCounters[packetType];
+		counters.PacketsReceived.fetch_add(1, std::memory_order_relaxed);
+		counters.BytesReceived.fetch_add(1 + data.size(), std::memory_order_relaxed);
+
+		if DEATH_LIKELY(_replay == nullptr && !_capture.IsOpen()) {
+			_handler->OnPacketReceived(source, channelId, packetType, data);
+			return 0;
+		}
+
+		// Time spent in the handler is measured only for capture and replay
+		Clock& c = nCine::clock();
+		std::uint64_t startTime = c.now();
+		_handler->OnPacketReceived(source, channelId, packetType, data);
+		std::uint32_t handlerTimeUs = std::uint32_t((c.now() - startTime) * 1000000 / c.frequency());
+
+		if (_capture.IsOpen()) {
+			_capture.WriteReceived(source, channelId, packetType, data, handlerTimeUs);
+		}
+		return handlerTimeUs;
+	}
+
+	void NetworkManagerBase::ReportDispatchLatency(std::uint64_t arrivalTime)
+	{
+		if (arrivalTime == 0) {
+			return;
+		}
+
+		Clock& c = nCine::clock();
+		std::uint64_t elapsed = c.now() - arrivalTime;
+		std::uint32_t latencyUs = std::uint32_t(elapsed * 1000000 / c.frequency());
+
+		// Exponential moving average, only the thread that dispatches packets writes these values
+		std::uint32_t prevLatencyUs = _dispatchLatencyUs.load(std::memory_order_relaxed);
+		_dispatchLatencyUs.store(prevLatencyUs == 0 ? latencyUs : (prevLatencyUs * 15 + latencyUs) / 16, std::memory_order_relaxed);
+		if (_maxDispatchLatencyUs.load(std::memory_order_relaxed) < latencyUs) {
+			_maxDispatchLatencyUs.store(latencyUs, std::memory_order_relaxed);
+		}
+	}
+
+	std::uint32_t NetworkManagerBase::GetKnownConnectId(const Peer& peer) const
+	{
+		// Index of the peer slot never changes, so it can be read from any thread
+		std::uint32_t slot = peer._enet->incomingPeerID;
+		return (slot < MaxPeerCount ? _peerConnectIds[slot].load(std::memory_order_acquire) : 0);
+	}
+
+	void NetworkManagerBase::EnqueueOutgoing(ArrayView<const OutgoingCommand> commands)
+	{
+		{
+			// Only producers are serialized, the network thread consumes the queue without any lock
+			std::unique_lock lock(_outgoingLock);
+			for (const OutgoingCommand& command : commands) {
+				std::uint8_t* ptr;
+				while DEATH_UNLIKELY((ptr = _outgoingQueue.prepareWrite(sizeof(OutgoingCommand))) == nullptr) {
+					// The queue is full, publish already written commands and let the network thread catch up
+					_outgoingQueue.commitWrite();
+					if (_networkThreadId.load(std::memory_order_relaxed) == Thread::GetCurrentId()) {
+						ProcessOutgoingCommands();
+					} else if (_state == NetworkState::None) {
+						ProcessOutgoingCommands(true);
+					} else {
+						WakeNetworkThread();
+						Thread::YieldExecution();
+					}
+				}
+				std::memcpy(ptr, &command, sizeof(OutgoingCommand));
+				_outgoingQueue.finishWrite(sizeof(OutgoingCommand));
+			}
+			_outgoingQueue.commitWrite();
+		}
+
+		WakeNetworkThread();
+	}
+
+	void NetworkManagerBase::ProcessOutgoingCommands(bool discard)
+	{
+		while (const std::uint8_t* ptr = _outgoingQueue.prepareRead()) {
+			OutgoingCommand command;
+			std::memcpy(&command, ptr, sizeof(OutgoingCommand));
+			_outgoingQueue.finishRead(sizeof(OutgoingCommand));
+
+			// Commands for a peer that disconnected before the game thread noticed it are dropped,
+			// because the peer slot could be already reused by another connection
+			bool isStale = (command.Target->connectID != command.ConnectId);
+
+			switch (command.CommandType) {
+				case OutgoingCommand::Type::Send: {
+					if DEATH_LIKELY(!discard && !isStale) {
+						// ENet holds its own reference to the packet until it's sent
+						enet_peer_send(command.Target, command.ChannelId, command.Packet);
+					}
+					if (command.ReleasePacket && --command.Packet->referenceCount == 0) {
+						enet_packet_destroy(command.Packet);
+					}
+					break;
+				}
+				case OutgoingCommand::Type::Disconnect: {
+					if DEATH_LIKELY(!discard && !isStale) {
+						enet_peer_disconnect(command.Target, command.DisconnectReason);
+					}
+					break;
+				}
+			}
+		}
+		_outgoingQueue.commitRead();
+	}
+
+	void NetworkManagerBase::EnqueueIncoming(const IncomingEvent& ev)
+	{
+		if DEATH_LIKELY(_incomingOverflow.empty()) {
+			if (std::uint8_t* ptr = _incomingQueue.prepareWrite(sizeof(IncomingEvent))) {
+				std::memcpy(ptr, &ev, sizeof(IncomingEvent));
+				_incomingQueue.finishAndCommitWrite(sizeof(IncomingEvent));
+				return;
+			}
+			LOGW("[MP] Incoming packet queue is full, packets will be dispatched with delay");
+		}
+
+		// Keep the order of events, the overflow is moved to the queue as soon as there is free space
+		_incomingOverflow.push_back(ev);
+	}
+
+	void NetworkManagerBase::EnqueueConnected(const Peer& peer, std::uint32_t clientData)
+	{
+		std::uint32_t connectId = (peer._enet != nullptr ? peer._enet->connectID : 0);
+		EnqueueIncoming({peer, nullptr, 0, connectId, clientData, IncomingEvent::Type::Connected, 0});
+	}
+
+	void NetworkManagerBase::EnqueueDisconnected(const Peer& peer, Reason reason)
+	{
+		// ENet keeps the connection ID of a peer after it's reset, so it still identifies the connection
+		std::uint32_t connectId = (peer._enet != nullptr ? peer._enet->connectID : 0);
+		EnqueueIncoming({peer, nullptr, 0, connectId, std::uint32_t(reason), IncomingEvent::Type::Disconnected, 0});
+	}
+
+	void NetworkManagerBase::DispatchIncoming(const IncomingEvent& ev, bool disconnectsOnly)
+	{
+		std::uint32_t slot = (ev.Source._enet != nullptr ? ev.Source._enet->incomingPeerID : 0);
+
+		switch (ev.EventType) {
+			case IncomingEvent::Type::Connected: {
+				if (disconnectsOnly || _handler == nullptr) {
+					break;
+				}
+				if (ev.Source._enet != nullptr) {
+					if DEATH_UNLIKELY(slot >= MaxPeerCount) {
+						break;
+					}
+					_peerConnectIds[slot].store(ev.ConnectId, std::memory_order_release);
+				}
+
+				ConnectionResult result = OnPeerConnected(ev.Source, ev.Data);
+				if DEATH_LIKELY(result.IsSuccessful()) {
+					if (_state == NetworkState::Listening) {
+						std::unique_lock lock(_lock);
+						bool alreadyExists = false;
+						for (std::size_t i = 0; i < _connectedPeers.size(); i++) {
+							if (ev.Source == _connectedPeers[i]) {
+								alreadyExists = true;
+								break;
+							}
+						}
+						if DEATH_UNLIKELY(alreadyExists) {
+							LOGW("Peer is already connected [{}]", ev.Source);
+						} else {
+							_connectedPeers.push_back(ev.Source);
+						}
+					}
+				} else {
+					Kick(ev.Source, result.FailureReason);
+					// Rejected peer is forgotten immediately, so its remaining packets and disconnection are dropped
+					if (ev.Source._enet != nullptr) {
+						_peerConnectIds[slot].store(0, std::memory_order_release);
+					}
+				}
+				break;
+			}
+			case IncomingEvent::Type::Disconnected: {
+				if (ev.Source._enet != nullptr) {
+					// The handler is notified only about peers it knows about
+					if (slot >= MaxPeerCount || _peerConnectIds[slot].load(std::memory_order_relaxed) != ev.ConnectId) {
+						break;
+					}
+					_peerConnectIds[slot].store(0, std::memory_order_release);
+				}
+				if DEATH_LIKELY(_handler != nullptr) {
+					OnPeerDisconnected(ev.Source, Reason(ev.Data));
+				}
+				break;
+			}
+			case IncomingEvent::Type::Packet: {
+				// Packets that arrived shortly before disconnection and packets of unknown peers are dropped
+				bool isKnownPeer = (ev.Source._enet == nullptr || (slot < MaxPeerCount &&
+					_peerConnectIds[slot].load(std::memory_order_relaxed) == ev.ConnectId));
+				if DEATH_LIKELY(!disconnectsOnly && isKnownPeer && _handler != nullptr &&
+					_state != NetworkState::None && ev.Packet->dataLength > 0) {
+					ReportDispatchLatency(ev.ArrivalTime);
+					auto data = arrayView(ev.Packet->data, ev.Packet->dataLength);
+					DispatchPacket(ev.Source, ev.ChannelId, data[0], data.exceptPrefix(1));
+				}
+				enet_packet_destroy(ev.Packet);
+				break;
+			}
+		}
+	}
+
+	void NetworkManagerBase::FlushIncomingOverflow()
+	{
+		if DEATH_LIKELY(_incomingOverflow.empty()) {
+			return;
+		}
+
+		std::size_t i = 0;
+		while (i < _incomingOverflow.size()) {
+			std::uint8_t* ptr = _incomingQueue.prepareWrite(sizeof(IncomingEvent));
+			if (ptr == nullptr) {
+				break;
+			}
+			std::memcpy(ptr, &_incomingOverflow[i], sizeof(IncomingEvent));
+			_incomingQueue.finishWrite(sizeof(IncomingEvent));
+			i++;
+		}
+		_incomingQueue.commitWrite();
+		_incomingOverflow.erase(_incomingOverflow.begin(), _incomingOverflow.begin() + i);
+	}
+
+	void NetworkManagerBase::DispatchRemainingEvents()
+	{
+		// Only disconnections of peers that the handler already knows about are dispatched
+		while (const std::uint8_t* ptr = _incomingQueue.prepareRead()) {
+			IncomingEvent ev;
+			std::memcpy(&ev, ptr, sizeof(IncomingEvent));
+			_incomingQueue.finishRead(sizeof(IncomingEvent));
+			DispatchIncoming(ev, true);
+		}
+		_incomingQueue.commitRead();
+
+		for (const IncomingEvent& ev : _incomingOverflow) {
+			DispatchIncoming(ev, true);
+		}
+		_incomingOverflow.clear();
+	}
+
+	void NetworkManagerBase::DiscardIncomingPackets()
+	{
+		while (const std::uint8_t* ptr = _incomingQueue.prepareRead()) {
+			IncomingEvent ev;
+			std::memcpy(&ev, ptr, sizeof(IncomingEvent));
+			_incomingQueue.finishRead(sizeof(IncomingEvent));
+			if (ev.Packet != nullptr) {
+				enet_packet_destroy(ev.Packet);
+			}
+		}
+		_incomingQueue.commitRead();
+
+		for (const IncomingEvent& ev : _incomingOverflow) {
+			if (ev.Packet != nullptr) {
+				enet_packet_destroy(ev.Packet);
+			}
+		}
+		_incomingOverflow.clear();
+	}
+
+	void NetworkManagerBase::DestroyHosts()
+	{
+		for (ENetHost* host : _retiredHosts) {
+			enet_host_destroy(host);
+		}
+		_retiredHosts.clear();
+
+		if (_host != nullptr) {
+			enet_host_destroy(_host);
+			_host = nullptr;
+		}
+
+		for (auto& connectId : _peerConnectIds) {
+			connectId.store(0, std::memory_order_relaxed);
+		}
+	}
+
 	void NetworkManagerBase::OnClientThread(void* param)
 	{
 		Thread::SetCurrentName("Multiplayer client");
 
 		NetworkManagerBase* _this = static_cast<NetworkManagerBase*>(param);
-		INetworkHandler* handler = _this->_handler;
+		_this->_networkThreadId = Thread::GetCurrentId();
 
 		ENetHost* host = nullptr;
 		_this->_host = host;
@@ -1459,7 +1952,9 @@ namespace Jazz2::Multiplayer
 			_this->_host = host;
 			if (host == nullptr) {
 				LOGE("[MP] Failed to create client");
-				_this->OnPeerDisconnected({}, Reason::InvalidParameter);
+				_this->EnqueueDisconnected({}, Reason::InvalidParameter);
+				_this->_networkThreadId = 0;
+				_this->_networkThreadExited.store(true, std::memory_order_release);
 				return;
 			}
 
@@ -1496,15 +1991,16 @@ namespace Jazz2::Multiplayer
 			reason = Reason::ConnectionTimedOut;
 		} else {
 			_this->_state = NetworkState::Connected;
-			_this->OnPeerConnected(ev.peer, ev.data);
+			_this->EnqueueConnected(ev.peer, ev.data);
 			reason = Reason::Unknown;
 
+			std::uint64_t arrivalTime = 0;
 			while DEATH_LIKELY(_this->_state != NetworkState::None) {
-				std::int32_t result;
-				{
-					std::unique_lock lock(_this->_lock);
-					result = enet_host_service(host, &ev, 0);
-				}
+				// The host is accessed only by this thread, other threads use the queues
+				_this->ProcessOutgoingCommands();
+				_this->FlushIncomingOverflow();
+
+				std::int32_t result = enet_host_service(host, &ev, 0);
 
 				if DEATH_UNLIKELY(result <= 0) {
 					if DEATH_UNLIKELY(result < 0) {
@@ -1512,15 +2008,15 @@ namespace Jazz2::Multiplayer
 						reason = Reason::ConnectionLost;
 						break;
 					}
-					Thread::Sleep(ProcessingIntervalMs);
+					// Block until a datagram arrives, a packet is queued for sending or ENet timers need servicing
+					arrivalTime = (_this->WaitForEvents(host, MaxServiceWaitTimeMs) ? nCine::clock().now() : 0);
 					continue;
 				}
 
 				switch (ev.type) {
 					case ENET_EVENT_TYPE_RECEIVE: {
-						auto data = arrayView(ev.packet->data, ev.packet->dataLength);
-						handler->OnPacketReceived(ev.peer, ev.channelID, data[0], data.exceptPrefix(1));
-						enet_packet_destroy(ev.packet);
+						// Ownership of the packet is transferred to the queue
+						_this->EnqueueIncoming({ev.peer, ev.packet, arrivalTime, ev.peer->connectID, 0, IncomingEvent::Type::Packet, ev.channelID});
 						break;
 					}
 					case ENET_EVENT_TYPE_DISCONNECT:
@@ -1536,19 +2032,22 @@ namespace Jazz2::Multiplayer
 		}
 
 		if DEATH_UNLIKELY(!_this->_connectedPeers.empty()) {
-			_this->OnPeerDisconnected(_this->_connectedPeers[0], reason);
+			_this->EnqueueDisconnected(_this->_connectedPeers[0], reason);
 
 			for (const Peer& p : _this->_connectedPeers) {
 				enet_peer_disconnect_now(p._enet, (std::uint32_t)Reason::Disconnected);
 			}
 			_this->_connectedPeers.clear();
 		} else {
-			_this->OnPeerDisconnected({}, reason);
+			_this->EnqueueDisconnected({}, reason);
 		}
 
-		enet_host_destroy(_this->_host);
-		_this->_host = nullptr;
-		_this->_handler = nullptr;
+		_this->ProcessOutgoingCommands(true);
+		_this->FlushIncomingOverflow();
+
+		// The host is destroyed in Dispose(), because queued events still reference its peer
+		_this->_networkThreadId = 0;
+		_this->_networkThreadExited.store(true, std::memory_order_release);
 
 		_this->_thread.Detach();
 
@@ -1560,41 +2059,37 @@ namespace Jazz2::Multiplayer
 		Thread::SetCurrentName("Multiplayer server");
 
 		NetworkManagerBase* _this = static_cast<NetworkManagerBase*>(param);
-		INetworkHandler* handler = _this->_handler;
+		_this->_networkThreadId = Thread::GetCurrentId();
 		ENetHost* host = _this->_host;
 
 		_this->_connectedPeers.reserve(16);
 
 		ENetEvent ev{};
+		std::uint64_t arrivalTime = 0;
 		while DEATH_LIKELY(_this->_state != NetworkState::None) {
-			std::int32_t result;
-			{
-				std::unique_lock lock(_this->_lock);
-				result = enet_host_service(host, &ev, 0);
-			}
+			// The host is accessed only by this thread, other threads use the queues
+			_this->ProcessOutgoingCommands();
+			_this->FlushIncomingOverflow();
+
+			std::int32_t result = enet_host_service(host, &ev, 0);
 
 			if DEATH_UNLIKELY(result <= 0) {
 				if DEATH_UNLIKELY(result < 0) {
 					LOGE("[MP] enet_host_service() returned {}", result);
 
-					// Server failed, try to recreate it
-					SmallVector<Peer, 1> peersSnapshot;
-					{
-						std::unique_lock lock(_this->_lock);
-						std::swap(peersSnapshot, _this->_connectedPeers);
-					}
-					for (const Peer& p : peersSnapshot) {
-#if defined(WITH_WEBSOCKET)
-						if DEATH_LIKELY(!p.IsWebSocket())
-#endif
-						{
-							_this->OnPeerDisconnected(p, Reason::ConnectionLost);
+					// Server failed, try to recreate it, the game thread drops only peers it knows about
+					for (ENetPeer* p = host->peers; p < &host->peers[host->peerCount]; p++) {
+						if (p->state != ENET_PEER_STATE_DISCONNECTED) {
+							_this->EnqueueDisconnected(p, Reason::ConnectionLost);
 						}
 					}
+					// The old host is kept until queued events can't reference its peers, only its socket is released
 					ENetAddress addr = host->address;
+					enet_socket_destroy(host->socket);
+					host->socket = ENET_SOCKET_NULL;
+					_this->_retiredHosts.push_back(host);
 					{
 						std::unique_lock lock(_this->_lock);
-						enet_host_destroy(host);
 						host = enet_host_create(&addr, MaxPeerCount, std::size_t(NetworkChannel::Count), 0, 0);
 						_this->_host = host;
 					}
@@ -1605,67 +2100,51 @@ namespace Jazz2::Multiplayer
 					}
 				}
 #	if defined(WITH_WEBSOCKET)
-				_this->ProcessWsQueue(handler);
+				_this->ProcessWsQueue();
 #	endif
-				Thread::Sleep(ProcessingIntervalMs);
+				// Block until a datagram arrives, a packet is queued for sending or ENet timers need servicing
+				arrivalTime = (_this->WaitForEvents(host, MaxServiceWaitTimeMs) ? nCine::clock().now() : 0);
 				continue;
 			}
 
 			switch (ev.type) {
 				case ENET_EVENT_TYPE_CONNECT: {
-					ConnectionResult result = _this->OnPeerConnected(ev.peer, ev.data);
-					if DEATH_LIKELY(result.IsSuccessful()) {
-						std::unique_lock lock(_this->_lock);
-						bool alreadyExists = false;
-						for (std::size_t i = 0; i < _this->_connectedPeers.size(); i++) {
-							if (Peer(ev.peer) == _this->_connectedPeers[i]) {
-								alreadyExists = true;
-								break;
-							}
-						}
-						if DEATH_UNLIKELY(alreadyExists) {
-							LOGW("Peer is already connected [{:.8x}]", std::uint64_t(ev.peer));
-						} else {
-							_this->_connectedPeers.push_back(Peer(ev.peer));
-						}
-					} else {
-						std::unique_lock lock(_this->_lock);
-						enet_peer_disconnect(ev.peer, std::uint32_t(result.FailureReason));
-					}
+					// The connection is accepted or rejected on the game thread, in order with received packets
+					_this->EnqueueConnected(ev.peer, ev.data);
 					break;
 				}
 				case ENET_EVENT_TYPE_RECEIVE: {
-					auto data = arrayView(ev.packet->data, ev.packet->dataLength);
-					handler->OnPacketReceived(ev.peer, ev.channelID, data[0], data.exceptPrefix(1));
-					enet_packet_destroy(ev.packet);
+					// Ownership of the packet is transferred to the queue
+					_this->EnqueueIncoming({ev.peer, ev.packet, arrivalTime, ev.peer->connectID, 0, IncomingEvent::Type::Packet, ev.channelID});
 					break;
 				}
 				case ENET_EVENT_TYPE_DISCONNECT:
-					_this->OnPeerDisconnected(ev.peer, Reason(ev.data));
+					_this->EnqueueDisconnected(ev.peer, Reason(ev.data));
 					break;
 				case ENET_EVENT_TYPE_DISCONNECT_TIMEOUT:
-					_this->OnPeerDisconnected(ev.peer, Reason::ConnectionLost);
+					_this->EnqueueDisconnected(ev.peer, Reason::ConnectionLost);
 					break;
 			}
 
 #	if defined(WITH_WEBSOCKET)
-			_this->ProcessWsQueue(handler);
+			_this->ProcessWsQueue();
 #	endif
 		}
 
-		for (const Peer& p : _this->_connectedPeers) {
-#	if defined(WITH_WEBSOCKET)
-			if DEATH_LIKELY(!p.IsWebSocket())
-#	endif
-			{
-				enet_peer_disconnect_now(p._enet, std::uint32_t(Reason::ServerStopped));
+		if (host != nullptr) {
+			for (ENetPeer* p = host->peers; p < &host->peers[host->peerCount]; p++) {
+				if (p->state == ENET_PEER_STATE_CONNECTED) {
+					enet_peer_disconnect_now(p, std::uint32_t(Reason::ServerStopped));
+				}
 			}
 		}
-		_this->_connectedPeers.clear();
 
-		enet_host_destroy(_this->_host);
-		_this->_host = nullptr;
-		_this->_handler = nullptr;
+		_this->ProcessOutgoingCommands(true);
+		_this->FlushIncomingOverflow();
+
+		// Hosts are destroyed in Dispose(), because queued events still reference their peers
+		_this->_networkThreadId = 0;
+		_this->_networkThreadExited.store(true, std::memory_order_release);
 
 #	if defined(WITH_WEBSOCKET)
 		if (_this->_wsServer != nullptr) {
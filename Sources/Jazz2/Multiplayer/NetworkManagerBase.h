@@ -3,6 +3,7 @@
 #if defined(WITH_MULTIPLAYER) || defined(DOXYGEN_GENERATING_OUTPUT)
 
 #include "ConnectionResult.h"
+#include "PacketCapture.h"
 #include "Peer.h"
 #include "Reason.h"
 #include "ServerDiscovery.h"
@@ -10,12 +11,15 @@
 #include "../../nCine/Threading/ThreadSync.h"
 
 #include <Base/IDisposable.h>
+#include <Containers/BoundedSPSCQueue.h>
 #include <Containers/Function.h>
 #include <Containers/SmallVector.h>
 #include <Containers/StringView.h>
 #include <IO/MemoryStream.h>
 #include <Threading/Spinlock.h>
 
+#include <atomic>
+
 #if defined(WITH_WEBSOCKET)
 #	if defined(DEATH_TARGET_EMSCRIPTEN)
 #		include <emscripten/websocket.h>
@@ -43,6 +47,7 @@ namespace Jazz2::Multiplayer
 	{
 		Main,				/**< Main */
 		UnreliableUpdates,	/**< Unreliable updates */
+		AssetStreaming,		/**< Reliable asset streaming, separated from @ref Main to avoid blocking it */
 		Count				/**< Count of supported channels */
 	};
 
@@ -89,12 +94,30 @@ namespace Jazz2::Multiplayer
 	*/
 	constexpr LocalPeerT LocalPeer{LocalPeerT::Init{}};
 
+	/**
+		@brief Cumulative traffic statistics of a single packet type
+
+		Sizes include the packet type byte, but not the transport headers.
+	*/
+	struct PacketTrafficStats
+	{
+		/** @brief Number of sent packets, a packet sent to multiple peers is counted once per peer */
+		std::uint64_t PacketsSent;
+		/** @brief Total size of sent packets in bytes */
+		std::uint64_t BytesSent;
+		/** @brief Number of received packets */
+		std::uint64_t PacketsReceived;
+		/** @brief Total size of received packets in bytes */
+		std::uint64_t BytesReceived;
+	};
+
 	/**
 		@brief Allows to create generic network clients and servers
 	*/
 	class NetworkManagerBase : public Death::IDisposable
 	{
 		friend class ServerDiscovery;
+		friend class PacketCaptureReplay;
 
 	public:
 		/** @{ @name Constants */
@@ -123,6 +146,12 @@ namespace Jazz2::Multiplayer
 		std::uint32_t GetRoundTripTimeMs() const;
 		/** @brief Returns mean round trip time to the server for specified peer, in milliseconds */
 		std::uint32_t GetRoundTripTimeMs(const Peer& peer) const;
+		/** @brief Returns mean latency between arrival of a packet and its dispatch to the handler, in microseconds */
+		std::uint32_t GetPacketDispatchLatencyUs() const;
+		/** @brief Returns maximum latency between arrival of a packet and its dispatch to the handler, in microseconds */
+		std::uint32_t GetMaxPacketDispatchLatencyUs() const;
+		/** @brief Returns cumulative traffic statistics of the specified packet type since the connection was created */
+		PacketTrafficStats GetPacketTrafficStats(std::uint8_t packetType) const;
 		/** @brief Returns all IPv4 and IPv6 addresses along with ports of the server */
 		Array<String> GetServerEndpoints() const;
 		/** @brief Returns port of the server */
@@ -136,6 +165,27 @@ namespace Jazz2::Multiplayer
 		void SendTo(AllPeersT, NetworkChannel channel, std::uint8_t packetType, ArrayView<const std::uint8_t> data);
 		/** @brief Kicks a given peer from the server */
 		void Kick(const Peer& peer, Reason reason);
+		/**
+			@brief Dispatches all connections, disconnections and packets received since the last call to the handler
+
+			Events are received on the network thread, but they are dispatched on the calling thread in the same order.
+			This function should be called once per frame from the main thread to process events in a deterministic order.
+		*/
+		void ProcessReceivedPackets();
+
+#if !defined(DEATH_TARGET_EMSCRIPTEN) || defined(DOXYGEN_GENERATING_OUTPUT)
+		/** @brief Starts recording of all sent and received packets to the specified file, see @ref PacketCaptureWriter */
+		bool StartCapture(StringView path);
+		/** @brief Stops recording of packets */
+		void StopCapture();
+		/**
+			@brief Starts replaying of the specified capture against the local server, see @ref PacketCaptureReplay
+
+			Captured packets are dispatched by @ref ProcessReceivedPackets() in addition to packets of real peers.
+			The function @p onFinished is called when the whole capture was replayed.
+		*/
+		bool StartReplay(StringView path, Function<void()>&& onFinished);
+#endif
 
 		/** @brief Converts the specified IPv4 endpoint to the string representation */
 		static String AddressToString(const struct in_addr& address, std::uint16_t port = 0);
@@ -160,9 +210,13 @@ namespace Jazz2::Multiplayer
 		static const char* ReasonToString(Reason reason);
 
 	protected:
-		/** @brief Called when a peer connects to the local server or the local client connects to a server */
+		/**
+			@brief Called when a peer connects to the local server or the local client connects to a server
+
+			It's called from @ref ProcessReceivedPackets() in order with received packets, a rejected peer is kicked.
+		*/
 		virtual ConnectionResult OnPeerConnected(const Peer& peer, std::uint32_t clientData);
-		/** @brief Called when a peer disconnects from the local server or the local client disconnects from a server */
+		/** @brief Called from @ref ProcessReceivedPackets() when a peer disconnects from the local server or the local client disconnects from a server */
 		virtual void OnPeerDisconnected(const Peer& peer, Reason reason);
 
 #if defined(WITH_WEBSOCKET) && !defined(DEATH_TARGET_EMSCRIPTEN)
@@ -172,18 +226,74 @@ namespace Jazz2::Multiplayer
 
 	private:
 		static constexpr std::uint32_t ProcessingIntervalMs = 4;
+		// Maximum time the network thread waits for incoming packets, so ENet timers are still serviced regularly
+		static constexpr std::uint32_t MaxServiceWaitTimeMs = 10;
 
 #if !defined(DEATH_TARGET_EMSCRIPTEN)
+		static constexpr std::size_t OutgoingQueueCapacity = 64 * 1024;
+		static constexpr std::size_t IncomingQueueCapacity = 256 * 1024;
+
+		/** @brief Command queued by the game thread to be executed on the network thread */
+		struct OutgoingCommand {
+			enum class Type : std::uint8_t { Send, Disconnect };
+			Type CommandType;
+			std::uint8_t ChannelId;
+			bool ReleasePacket;			/**< Last command referencing the packet, releases the reference held by the queue */
+			std::uint32_t DisconnectReason;
+			std::uint32_t ConnectId;	/**< Connection of the target known to the game thread, the command is dropped if the peer slot was reused */
+			ENetPeer* Target;
+			ENetPacket* Packet;
+		};
+
+		/** @brief Event received on the network thread to be dispatched on the game thread */
+		struct IncomingEvent {
+			enum class Type : std::uint8_t { Connected, Disconnected, Packet };
+			Peer Source;
+			ENetPacket* Packet;			/**< Packet type is stored in the first byte, `nullptr` for other events */
+			std::uint64_t ArrivalTime;
+			std::uint32_t ConnectId;	/**< Connection of the ENet peer, so events of a reused peer slot can be told apart */
+			std::uint32_t Data;			/**< Client data for @ref Type::Connected, reason for @ref Type::Disconnected */
+			Type EventType;
+			std::uint8_t ChannelId;
+		};
+
 		_ENetHost* _host;
+		SmallVector<_ENetHost*, 0> _retiredHosts;	// Failed hosts are kept until queued events can't reference their peers
 		Thread _thread;
 		SmallVector<Peer, 1> _connectedPeers;
 		SmallVector<ENetAddress, 0> _desiredEndpoints;
+		ENetSocket _wakeSocket;		// Loopback socket used to wake up the network thread when packets are queued
+		ENetAddress _wakeAddress;
+		std::atomic_bool _wakePending;
+		std::atomic<std::uint32_t> _dispatchLatencyUs;
+		std::atomic<std::uint32_t> _maxDispatchLatencyUs;
+		std::atomic<std::uintptr_t> _networkThreadId;
+		std::atomic_bool _networkThreadExited;		// The game thread takes over the overflow once the network thread exited
+		std::atomic<std::uint32_t> _peerConnectIds[MaxPeerCount];	// Connection of each ENet peer slot as seen by the game thread, zero if free
+		BoundedSPSCQueue _outgoingQueue;			// Game thread → network thread
+		BoundedSPSCQueue _incomingQueue;			// Network thread → game thread
+		SmallVector<IncomingEvent, 0> _incomingOverflow;	// Accessed only by the network thread while it's running
+		Spinlock _outgoingLock;						// Serializes producers of the outgoing queue, never taken by the consumer
+		PacketCaptureWriter _capture;
+		std::unique_ptr<PacketCaptureReplay> _replay;
 #endif
 		NetworkState _state;
 		std::uint32_t _clientData;
 		INetworkHandler* _handler;
 		Spinlock _lock;
 
+#ifndef DOXYGEN_GENERATING_OUTPUT
+		// Doxygen 1.12.0 outputs also private structs/unions even if it shouldn't
+		struct PacketTrafficCounters {
+			std::atomic<std::uint64_t> PacketsSent{0};
+			std::atomic<std::uint64_t> BytesSent{0};
+			std::atomic<std::uint64_t> PacketsReceived{0};
+			std::atomic<std::uint64_t> BytesReceived{0};
+		};
+#endif
+
+		PacketTrafficCounters _trafficCounters[256];		// Indexed by packet type
+
 #if defined(WITH_WEBSOCKET) && !defined(DEATH_TARGET_EMSCRIPTEN)
 		/** @brief Queued event from WebSocket callbacks to the main processing thread */
 		struct WsQueuedEvent {
@@ -209,7 +319,7 @@ namespace Jazz2::Multiplayer
 		std::atomic<std::uint32_t> _wsRtt{0};	/**< Client-side measured RTT for the WebSocket server connection */
 		mutable Spinlock _wsLock;
 
-		void ProcessWsQueue(INetworkHandler* handler);
+		void ProcessWsQueue();
 		bool SendToWsPeer(ix::WebSocket* ws, std::uint8_t packetType, ArrayView<const std::uint8_t> data);
 #elif defined(WITH_WEBSOCKET) && defined(DEATH_TARGET_EMSCRIPTEN)
 		/** @brief Emscripten WebSocket handle (0 = not connected) */
@@ -232,6 +342,24 @@ namespace Jazz2::Multiplayer
 		static void ReleaseBackend();
 
 #if !defined(DEATH_TARGET_EMSCRIPTEN)
+		void CreateWakeSocket();
+		void WakeNetworkThread();
+		bool WaitForEvents(_ENetHost* host, std::uint32_t timeoutMs);
+		void ReportDispatchLatency(std::uint64_t arrivalTime);
+		void OnPacketsSent(std::uint8_t packetType, NetworkChannel channel, std::size_t dataSize, std::size_t peerCount);
+		std::uint32_t DispatchPacket(const Peer& source, std::uint8_t channelId, std::uint8_t packetType, ArrayView<const std::uint8_t> data);
+		std::uint32_t GetKnownConnectId(const Peer& peer) const;
+		void EnqueueOutgoing(ArrayView<const OutgoingCommand> commands);
+		void ProcessOutgoingCommands(bool discard = false);
+		void EnqueueIncoming(const IncomingEvent& ev);
+		void EnqueueConnected(const Peer& peer, std::uint32_t clientData);
+		void EnqueueDisconnected(const Peer& peer, Reason reason);
+		void DispatchIncoming(const IncomingEvent& ev, bool disconnectsOnly);
+		void FlushIncomingOverflow();
+		void DispatchRemainingEvents();
+		void DiscardIncomingPackets();
+		void DestroyHosts();
+
 		static void OnClientThread(void* param);
 		static void OnServerThread(void* param);
 #	if defined(WITH_WEBSOCKET)
@@ -0,0 +1,557 @@
+﻿#include "PacketCapture.h"
+
+#if defined(WITH_MULTIPLAYER)
+
+#include "NetworkManagerBase.h"
+#include "PacketTypes.h"
+#include "../../nCine/Application.h"
+#include "../../nCine/Base/Clock.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include <Containers/DateTime.h>
+#include <IO/FileSystem.h>
+
+using namespace Death::Containers::Literals;
+
+namespace Jazz2::Multiplayer
+{
+	static constexpr std::uint32_t CaptureSignature = 0x4350324A;	// "J2PC"
+	static constexpr std::uint8_t CaptureVersion = 1;
+	static constexpr std::uint8_t CaptureFlagIsServer = 0x01;
+
+	static std::uint64_t GetCaptureTimeUs(std::uint64_t startTime)
+	{
+		// Split to avoid overflow of long captures with high-frequency clocks
+		Clock& c = nCine::clock();
+		std::uint64_t elapsed = c.now() - startTime;
+		return (elapsed / c.frequency()) * 1000000 + (elapsed % c.frequency()) * 1000000 / c.frequency();
+	}
+
+	PacketCaptureWriter::PacketCaptureWriter()
+		: _startTime(0), _lastTimeUs(0), _startFrame(0), _lastFrame(0), _nextPeerIndex(0), _isOpen(false)
+	{
+	}
+
+	PacketCaptureWriter::~PacketCaptureWriter()
+	{
+		Close();
+	}
+
+	bool PacketCaptureWriter::Open(StringView path, bool isServer)
+	{
+		std::unique_lock lock(_lock);
+		_isOpen = false;
+		_file = fs::Open(path, FileAccess::Write, 64 * 1024);
+		if (!_file->IsValid()) {
+			LOGE("[MP] Failed to create packet capture \"{}\"", path);
+			_file = nullptr;
+			return false;
+		}
+
+		_file->WriteValue<std::uint32_t>(CaptureSignature);
+		_file->WriteValue<std::uint8_t>(CaptureVersion);
+		_file->WriteValue<std::uint8_t>(isServer ? CaptureFlagIsServer : 0);
+		_file->WriteValue<std::uint64_t>(DateTime::UtcNow().ToUnixMilliseconds());
+
+		_peerIndices.clear();
+		_nextPeerIndex = 0;
+		_startTime = nCine::clock().now();
+		_lastTimeUs = 0;
+		_startFrame = theApplication().GetFrameCount();
+		_lastFrame = 0;
+		_isOpen = true;
+
+		LOGI("[MP] Started packet capture to \"{}\"", path);
+		return true;
+	}
+
+	void PacketCaptureWriter::Close()
+	{
+		std::unique_lock lock(_lock);
+		if (_file != nullptr) {
+			_isOpen = false;
+			_file = nullptr;
+			LOGI("[MP] Packet capture stopped");
+		}
+	}
+
+	void PacketCaptureWriter::WriteConnected(const Peer& peer, std::uint32_t clientData)
+	{
+		std::unique_lock lock(_lock);
+		if (_file == nullptr) {
+			return;
+		}
+
+		WriteRecordHeader(PacketCaptureRecordType::Connected);
+		_file->WriteVariableUint32(GetPeerIndex(peer));
+		_file->WriteVariableUint32(clientData);
+	}
+
+	void PacketCaptureWriter::WriteDisconnected(const Peer& peer, Reason reason)
+	{
+		std::unique_lock lock(_lock);
+		if (_file == nullptr) {
+			return;
+		}
+
+		WriteRecordHeader(PacketCaptureRecordType::Disconnected);
+		_file->WriteVariableUint32(GetPeerIndex(peer));
+		_file->WriteVariableUint32((std::uint32_t)reason);
+		_peerIndices.erase(peer);
+	}
+
+	void PacketCaptureWriter::WriteReceived(const Peer& peer, std::uint8_t channel, std::uint8_t packetType, ArrayView<const std::uint8_t> data, std::uint32_t handlerTimeUs)
+	{
+		std::unique_lock lock(_lock);
+		if (_file == nullptr) {
+			return;
+		}
+
+		WriteRecordHeader(PacketCaptureRecordType::Received);
+		_file->WriteVariableUint32(GetPeerIndex(peer));
+		_file->WriteValue<std::uint8_t>(channel);
+		_file->WriteValue<std::uint8_t>(packetType);
+		_file->WriteVariableUint32((std::uint32_t)data.size());
+		_file->WriteVariableUint32(handlerTimeUs);
+		if (!data.empty()) {
+			_file->Write(data.data(), (std::int64_t)data.size());
+		}
+	}
+
+	void PacketCaptureWriter::WriteSent(std::uint32_t targetCount, std::uint8_t channel, std::uint8_t packetType, std::uint32_t size)
+	{
+		std::unique_lock lock(_lock);
+		if (_file == nullptr) {
+			return;
+		}
+
+		WriteRecordHeader(PacketCaptureRecordType::Sent);
+		_file->WriteVariableUint32(targetCount);
+		_file->WriteValue<std::uint8_t>(channel);
+		_file->WriteValue<std::uint8_t>(packetType);
+		_file->WriteVariableUint32(size);
+	}
+
+	void PacketCaptureWriter::WriteRecordHeader(PacketCaptureRecordType type)
+	{
+		// Records are written under the lock, so time never goes backwards, but frame count can be read by other threads
+		std::uint64_t timeUs = std::max(GetCaptureTimeUs(_startTime), _lastTimeUs);
+		std::int64_t frame = (std::int64_t)theApplication().GetFrameCount() - _startFrame;
+
+		_file->WriteValue<std::uint8_t>((std::uint8_t)type);
+		_file->WriteVariableInt64(frame - _lastFrame);
+		_file->WriteVariableUint64(timeUs - _lastTimeUs);
+
+		_lastFrame = frame;
+		_lastTimeUs = timeUs;
+	}
+
+	std::uint32_t PacketCaptureWriter::GetPeerIndex(const Peer& peer)
+	{
+		// Indices are never reused, so reconnected peers can be distinguished
+		auto it = _peerIndices.find(peer);
+		if (it != _peerIndices.end()) {
+			return it->second;
+		}
+
+		std::uint32_t index = _nextPeerIndex++;
+		_peerIndices.emplace(peer, index);
+		return index;
+	}
+
+	PacketCaptureReader::PacketCaptureReader()
+		: _fileSize(0), _lastFrame(0), _lastTimeUs(0), _isServer(false)
+	{
+	}
+
+	bool PacketCaptureReader::Open(StringView path)
+	{
+		_file = fs::Open(path, FileAccess::Read, 64 * 1024);
+		if (!_file->IsValid()) {
+			LOGE("[MP] Packet capture \"{}\" cannot be opened", path);
+			return false;
+		}
+
+		std::uint32_t signature = _file->ReadValue<std::uint32_t>();
+		std::uint8_t version = _file->ReadValue<std::uint8_t>();
+		if (signature != CaptureSignature || version != CaptureVersion) {
+			LOGE("[MP] File \"{}\" is not a supported packet capture", path);
+			_file = nullptr;
+			return false;
+		}
+
+		std::uint8_t flags = _file->ReadValue<std::uint8_t>();
+		/*std::uint64_t startTime =*/ _file->ReadValue<std::uint64_t>();
+
+		_isServer = (flags & CaptureFlagIsServer) != 0;
+		_fileSize = _file->GetSize();
+		_lastFrame = 0;
+		_lastTimeUs = 0;
+		return true;
+	}
+
+	bool PacketCaptureReader::ReadNext(PacketCaptureRecord& record)
+	{
+		if (_file == nullptr || _file->GetPosition() >= _fileSize) {
+			return false;
+		}
+
+		record.Type = (PacketCaptureRecordType)_file->ReadValue<std::uint8_t>();
+		_lastFrame += _file->ReadVariableInt64();
+		_lastTimeUs += _file->ReadVariableUint64();
+		record.Frame = _lastFrame;
+		record.TimeUs = _lastTimeUs;
+		record.PeerIndex = 0;
+		record.Value = 0;
+		record.Channel = 0;
+		record.PacketType = 0;
+		record.Size = 0;
+		record.HandlerTimeUs = 0;
+		record.Data.clear();
+
+		switch (record.Type) {
+			case PacketCaptureRecordType::Connected:
+			case PacketCaptureRecordType::Disconnected: {
+				record.PeerIndex = _file->ReadVariableUint32();
+				record.Value = _file->ReadVariableUint32();
+				break;
+			}
+			case PacketCaptureRecordType::Received: {
+				record.PeerIndex = _file->ReadVariableUint32();
+				record.Channel = _file->ReadValue<std::uint8_t>();
+				record.PacketType = _file->ReadValue<std::uint8_t>();
+				record.Size = _file->ReadVariableUint32();
+				record.HandlerTimeUs = _file->ReadVariableUint32();
+				if (record.Size > _fileSize - _file->GetPosition()) {
+					LOGW("[MP] Packet capture is truncated");
+					return false;
+				}
+				record.Data.resize_for_overwrite(record.Size);
+				_file->Read(record.Data.data(), record.Size);
+				break;
+			}
+			case PacketCaptureRecordType::Sent: {
+				record.Value = _file->ReadVariableUint32();
+				record.Channel = _file->ReadValue<std::uint8_t>();
+				record.PacketType = _file->ReadValue<std::uint8_t>();
+				record.Size = _file->ReadVariableUint32();
+				break;
+			}
+			default: {
+				LOGW("[MP] Packet capture contains unknown record type {}", (std::uint32_t)record.Type);
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool PacketCaptureReader::Summarize(StringView path)
+	{
+		struct Stats {
+			std::uint64_t Count;
+			std::uint64_t Bytes;
+			std::uint64_t HandlerTimeUs;
+			std::uint8_t PacketType;
+		};
+
+		PacketCaptureReader reader;
+		if (!reader.Open(path)) {
+			return false;
+		}
+
+		Stats received[256] {};
+		Stats sent[256] {};
+		std::uint32_t peerCount = 0;
+		PacketCaptureRecord record;
+		PacketCaptureRecord lastRecord {};
+		while (reader.ReadNext(record)) {
+			switch (record.Type) {
+				case PacketCaptureRecordType::Connected: {
+					peerCount++;
+					break;
+				}
+				case PacketCaptureRecordType::Received: {
+					auto& stats = received[record.PacketType];
+					stats.Count++;
+					stats.Bytes += 1 + record.Size;
+					stats.HandlerTimeUs += record.HandlerTimeUs;
+					break;
+				}
+				case PacketCaptureRecordType::Sent: {
+					auto& stats = sent[record.PacketType];
+					stats.Count += record.Value;
+					stats.Bytes += (1 + (std::uint64_t)record.Size) * record.Value;
+					break;
+				}
+				default: break;
+			}
+			lastRecord.Frame = record.Frame;
+			lastRecord.TimeUs = record.TimeUs;
+		}
+
+		float durationSecs = lastRecord.TimeUs / 1000000.0f;
+		LOGI("Packet capture \"{}\" recorded on {} - {:.1f} seconds, {} frames, {} peers", path,
+			reader.IsServer() ? "server"_s : "client"_s, durationSecs, lastRecord.Frame, peerCount);
+
+		for (std::int32_t direction = 0; direction < 2; direction++) {
+			Stats* stats = (direction == 0 ? received : sent);
+			bool fromServer = (direction == 0 ? !reader.IsServer() : reader.IsServer());
+
+			SmallVector<Stats, 0> sorted;
+			for (std::int32_t i = 0; i < 256; i++) {
+				if (stats[i].Count > 0) {
+					auto& item = sorted.emplace_back(stats[i]);
+					item.PacketType = (std::uint8_t)i;
+				}
+			}
+			// Packet types that use the most bandwidth go first
+			std::sort(sorted.begin(), sorted.end(), [](const Stats& a, const Stats& b) {
+				return a.Bytes > b.Bytes;
+			});
+
+			LOGI("{} packets:", direction == 0 ? "Received"_s : "Sent"_s);
+			for (const auto& item : sorted) {
+				StringView name = GetPacketTypeName(item.PacketType, fromServer);
+				if (direction == 0) {
+					LOGI("  {} ({})\t │ {} packets\t │ {} kB\t │ {:.1f} kB/s\t │ {:.1f} µs avg. handler time", name.empty() ? "Unknown"_s : name,
+						item.PacketType, item.Count, item.Bytes / 1024, item.Bytes / 1024.0f / std::max(durationSecs, 1.0f),
+						(float)item.HandlerTimeUs / item.Count);
+				} else {
+					LOGI("  {} ({})\t │ {} packets\t │ {} kB\t │ {:.1f} kB/s", name.empty() ? "Unknown"_s : name,
+						item.PacketType, item.Count, item.Bytes / 1024, item.Bytes / 1024.0f / std::max(durationSecs, 1.0f));
+				}
+			}
+		}
+
+		return true;
+	}
+
+	StringView PacketCaptureReader::GetPacketTypeName(std::uint8_t packetType, bool fromServer)
+	{
+		if (fromServer) {
+			switch ((ServerPacketType)packetType) {
+				case ServerPacketType::Pong: return "Pong"_s;
+				case ServerPacketType::Rpc: return "Rpc"_s;
+				case ServerPacketType::AuthResponse: return "AuthResponse"_s;
+				case ServerPacketType::PeerSetProperty: return "PeerSetProperty"_s;
+				case ServerPacketType::ValidateAssets: return "ValidateAssets"_s;
+				case ServerPacketType::StreamAsset: return "StreamAsset"_s;
+				case ServerPacketType::LoadLevel: return "LoadLevel"_s;
+				case ServerPacketType::LevelSetProperty: return "LevelSetProperty"_s;
+				case ServerPacketType::LevelResetProperties: return "LevelResetProperties"_s;
+				case ServerPacketType::ShowInGameLobby: return "ShowInGameLobby"_s;
+				case ServerPacketType::FadeOut: return "FadeOut"_s;
+				case ServerPacketType::PlaySfx: return "PlaySfx"_s;
+				case ServerPacketType::PlayCommonSfx: return "PlayCommonSfx"_s;
+				case ServerPacketType::ShowAlert: return "ShowAlert"_s;
+				case ServerPacketType::ChatMessage: return "ChatMessage"_s;
+				case ServerPacketType::SyncTileMap: return "SyncTileMap"_s;
+				case ServerPacketType::SetTrigger: return "SetTrigger"_s;
+				case ServerPacketType::AdvanceTileAnimation: return "AdvanceTileAnimation"_s;
+				case ServerPacketType::RevertTileAnimation: return "RevertTileAnimation"_s;
+				case ServerPacketType::CreateDebris: return "CreateDebris"_s;
+				case ServerPacketType::CreateControllablePlayer: return "CreateControllablePlayer"_s;
+				case ServerPacketType::CreateRemoteActor: return "CreateRemoteActor"_s;
+				case ServerPacketType::CreateMirroredActor: return "CreateMirroredActor"_s;
+				case ServerPacketType::DestroyRemoteActor: return "DestroyRemoteActor"_s;
+				case ServerPacketType::UpdateAllActors: return "UpdateAllActors"_s;
+				case ServerPacketType::ChangeRemoteActorMetadata: return "ChangeRemoteActorMetadata"_s;
+				case ServerPacketType::MarkRemoteActorAsPlayer: return "MarkRemoteActorAsPlayer"_s;
+				case ServerPacketType::UpdatePositionsInRound: return "UpdatePositionsInRound"_s;
+				case ServerPacketType::PlayerSetProperty: return "PlayerSetProperty"_s;
+				case ServerPacketType::PlayerResetProperties: return "PlayerResetProperties"_s;
+				case ServerPacketType::PlayerRespawn: return "PlayerRespawn"_s;
+				case ServerPacketType::PlayerMoveInstantly: return "PlayerMoveInstantly"_s;
+				case ServerPacketType::PlayerAckWarped: return "PlayerAckWarped"_s;
+				case ServerPacketType::PlayerActivateForce: return "PlayerActivateForce"_s;
+				case ServerPacketType::PlayerEmitWeaponFlare: return "PlayerEmitWeaponFlare"_s;
+				case ServerPacketType::PlayerChangeWeapon: return "PlayerChangeWeapon"_s;
+				case ServerPacketType::PlayerTakeDamage: return "PlayerTakeDamage"_s;
+				case ServerPacketType::PlayerPush: return "PlayerPush"_s;
+				case ServerPacketType::PlayerActivateSpring: return "PlayerActivateSpring"_s;
+				case ServerPacketType::PlayerWarpIn: return "PlayerWarpIn"_s;
+				default: return {};
+			}
+		} else {
+			switch ((ClientPacketType)packetType) {
+				case ClientPacketType::Ping: return "Ping"_s;
+				case ClientPacketType::Rpc: return "Rpc"_s;
+				case ClientPacketType::Auth: return "Auth"_s;
+				case ClientPacketType::LevelReady: return "LevelReady"_s;
+				case ClientPacketType::ChatMessage: return "ChatMessage"_s;
+				case ClientPacketType::ValidateAssetsResponse: return "ValidateAssetsResponse"_s;
+				case ClientPacketType::StreamAssetAck: return "StreamAssetAck"_s;
+				case ClientPacketType::ForceResyncActors: return "ForceResyncActors"_s;
+				case ClientPacketType::PlayerReady: return "PlayerReady"_s;
+				case ClientPacketType::PlayerUpdate: return "PlayerUpdate"_s;
+				case ClientPacketType::PlayerKeyPress: return "PlayerKeyPress"_s;
+				case ClientPacketType::PlayerChangeWeaponRequest: return "PlayerChangeWeaponRequest"_s;
+				case ClientPacketType::PlayerSpectateRequest: return "PlayerSpectateRequest"_s;
+				case ClientPacketType::PlayerAckWarped: return "PlayerAckWarped"_s;
+				default: return {};
+			}
+		}
+	}
+
+#if !defined(DEATH_TARGET_EMSCRIPTEN)
+	PacketCaptureReplay::PacketCaptureReplay(NetworkManagerBase* networkManager, Function<void()>&& onFinished)
+		: _networkManager(networkManager), _onFinished(std::move(onFinished)), _hasNextRecord(false), _finished(false),
+			_frame(0), _peerIndexCount(0), _stats{}, _skippedPackets(0)
+	{
+	}
+
+	PacketCaptureReplay::~PacketCaptureReplay()
+	{
+	}
+
+	bool PacketCaptureReplay::Open(StringView path)
+	{
+		if (!_reader.Open(path)) {
+			return false;
+		}
+		if (!_reader.IsServer()) {
+			LOGE("[MP] Packet capture \"{}\" was not recorded on the server", path);
+			return false;
+		}
+
+		_hasNextRecord = _reader.ReadNext(_nextRecord);
+		LOGI("[MP] Started replay of packet capture \"{}\"", path);
+		return true;
+	}
+
+	void PacketCaptureReplay::ProcessFrame()
+	{
+		if (_finished) {
+			return;
+		}
+		if (_frame == 0) {
+			_startTime = TimeStamp::now();
+		}
+
+		while (_hasNextRecord && _nextRecord.Frame <= _frame) {
+			if (_nextRecord.Type != PacketCaptureRecordType::Sent) {
+				// Peer indices are assigned sequentially by the writer, so any index can be at most one above the indices seen so far
+				if (_nextRecord.PeerIndex > _peerIndexCount) {
+					LOGE("[MP] Packet capture contains invalid peer #{}", _nextRecord.PeerIndex);
+					Finish();
+					return;
+				}
+				if (_nextRecord.PeerIndex == _peerIndexCount) {
+					_peerIndexCount++;
+				}
+			}
+
+			switch (_nextRecord.Type) {
+				case PacketCaptureRecordType::Connected: {
+					Peer peer = GetPeer(_nextRecord.PeerIndex, true);
+					ConnectionResult result = _networkManager->OnPeerConnected(peer, _nextRecord.Value);
+					if (result.IsSuccessful()) {
+						_peers[_nextRecord.PeerIndex].IsConnected = true;
+						std::unique_lock lock(_networkManager->_lock);
+						_networkManager->_connectedPeers.push_back(peer);
+					} else {
+						LOGW("[MP] Replayed peer #{} was rejected with reason {}", _nextRecord.PeerIndex, (std::uint32_t)result.FailureReason);
+					}
+					break;
+				}
+				case PacketCaptureRecordType::Disconnected: {
+					Peer peer = GetPeer(_nextRecord.PeerIndex, false);
+					if (peer) {
+						_peers[_nextRecord.PeerIndex].IsConnected = false;
+						_networkManager->OnPeerDisconnected(peer, (Reason)_nextRecord.Value);
+					}
+					break;
+				}
+				case PacketCaptureRecordType::Received: {
+					Peer peer = GetPeer(_nextRecord.PeerIndex, false);
+					if (!peer) {
+						// Peer connected before the capture was started or it was rejected
+						_skippedPackets++;
+						break;
+					}
+
+					std::uint32_t timeUs = _networkManager->DispatchPacket(peer, _nextRecord.Channel, _nextRecord.PacketType, _nextRecord.Data);
+					auto& stats = _stats[_nextRecord.PacketType];
+					stats.Count++;
+					stats.Bytes += 1 + _nextRecord.Size;
+					stats.CapturedTimeUs += _nextRecord.HandlerTimeUs;
+					stats.ReplayTimeUs += timeUs;
+					break;
+				}
+				default: {
+					// Outgoing packets are produced again by the handler
+					break;
+				}
+			}
+
+			_hasNextRecord = _reader.ReadNext(_nextRecord);
+		}
+
+		_frame++;
+
+		if (!_hasNextRecord) {
+			Finish();
+		}
+	}
+
+	Peer PacketCaptureReplay::GetPeer(std::uint32_t index, bool create)
+	{
+		if (index >= _peers.size()) {
+			if (!create) {
+				return {};
+			}
+			_peers.resize(index + 1);
+		}
+
+		auto& virtualPeer = _peers[index];
+		if (create && virtualPeer.Handle == nullptr) {
+			// Virtual peer is never connected from ENet point of view, so all packets sent to it are dropped
+			virtualPeer.Handle = std::make_unique<_ENetPeer>();
+			virtualPeer.Handle->state = ENET_PEER_STATE_DISCONNECTED;
+			virtualPeer.IsConnected = false;
+		}
+		if (!create && !virtualPeer.IsConnected) {
+			return {};
+		}
+		return Peer(virtualPeer.Handle.get());
+	}
+
+	void PacketCaptureReplay::Finish()
+	{
+		_finished = true;
+
+		for (auto& virtualPeer : _peers) {
+			if (virtualPeer.IsConnected) {
+				virtualPeer.IsConnected = false;
+				_networkManager->OnPeerDisconnected(Peer(virtualPeer.Handle.get()), Reason::ServerStopped);
+			}
+		}
+
+		std::uint64_t totalCapturedUs = 0, totalReplayUs = 0;
+		LOGI("[MP] Replay of packet capture finished - {} frames took {:.1f} seconds, {} packets were skipped",
+			_frame, _startTime.secondsSince(), _skippedPackets);
+		for (std::int32_t i = 0; i < 256; i++) {
+			const auto& stats = _stats[i];
+			if (stats.Count == 0) {
+				continue;
+			}
+
+			StringView name = PacketCaptureReader::GetPacketTypeName((std::uint8_t)i, false);
+			LOGI("  {} ({})\t │ {} packets\t │ {} kB\t │ {:.1f} µs avg. captured\t │ {:.1f} µs avg. replayed", name.empty() ? "Unknown"_s : name,
+				i, stats.Count, stats.Bytes / 1024, (float)stats.CapturedTimeUs / stats.Count, (float)stats.ReplayTimeUs / stats.Count);
+			totalCapturedUs += stats.CapturedTimeUs;
+			totalReplayUs += stats.ReplayTimeUs;
+		}
+		LOGI("[MP] Total handler time - {:.1f} ms captured, {:.1f} ms replayed", totalCapturedUs / 1000.0f, totalReplayUs / 1000.0f);
+
+		if (_onFinished) {
+			_onFinished();
+		}
+	}
+#endif
+}
+
+#endif
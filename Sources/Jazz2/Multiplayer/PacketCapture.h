@@ -0,0 +1,214 @@
+﻿#pragma once
+
+#if defined(WITH_MULTIPLAYER) || defined(DOXYGEN_GENERATING_OUTPUT)
+
+#include "../../Main.h"
+#include "Peer.h"
+#include "Reason.h"
+#include "../../nCine/Base/HashMap.h"
+#include "../../nCine/Base/TimeStamp.h"
+
+#include <Containers/ArrayView.h>
+#include <Containers/Function.h>
+#include <Containers/SmallVector.h>
+#include <Containers/StringView.h>
+#include <IO/Stream.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+using namespace Death::Containers;
+using namespace Death::IO;
+using namespace nCine;
+
+namespace Jazz2::Multiplayer
+{
+	class NetworkManagerBase;
+
+	/** @brief Type of record in packet capture file */
+	enum class PacketCaptureRecordType : std::uint8_t {
+		Unknown,
+		Connected,			/**< Peer connected */
+		Disconnected,		/**< Peer disconnected */
+		Received,			/**< Packet was received and dispatched to the handler */
+		Sent				/**< Packet was sent to one or more peers */
+	};
+
+	/** @brief Record read from packet capture file by @ref PacketCaptureReader */
+	struct PacketCaptureRecord
+	{
+		/** @brief Record type */
+		PacketCaptureRecordType Type;
+		/** @brief Frame number relative to the start of the capture */
+		std::int64_t Frame;
+		/** @brief Time relative to the start of the capture in microseconds */
+		std::uint64_t TimeUs;
+		/** @brief Index of the peer assigned by the capture, not used by @ref PacketCaptureRecordType::Sent */
+		std::uint32_t PeerIndex;
+		/** @brief Client data of @ref PacketCaptureRecordType::Connected, reason of @ref PacketCaptureRecordType::Disconnected or number of target peers of @ref PacketCaptureRecordType::Sent */
+		std::uint32_t Value;
+		/** @brief Channel of the packet */
+		std::uint8_t Channel;
+		/** @brief Type of the packet */
+		std::uint8_t PacketType;
+		/** @brief Size of the packet without the packet type */
+		std::uint32_t Size;
+		/** @brief Time spent in the handler in microseconds, only for @ref PacketCaptureRecordType::Received */
+		std::uint32_t HandlerTimeUs;
+		/** @brief Payload of the packet without the packet type, only for @ref PacketCaptureRecordType::Received */
+		SmallVector<std::uint8_t, 0> Data;
+	};
+
+	/**
+		@brief Records timestamped incoming and outgoing packets to a compact binary file
+
+		Incoming packets are stored including their payload, so the capture can be replayed by @ref PacketCaptureReplay.
+		Outgoing packets are stored only as type, channel, size and number of target peers. Note that the payload
+		of incoming packets contains also credentials sent by clients, so capture files should be handled with care.
+		All functions are thread-safe.
+
+		@experimental
+	*/
+	class PacketCaptureWriter
+	{
+	public:
+		PacketCaptureWriter();
+		~PacketCaptureWriter();
+
+		PacketCaptureWriter(const PacketCaptureWriter&) = delete;
+		PacketCaptureWriter& operator=(const PacketCaptureWriter&) = delete;
+
+		/** @brief Creates a new capture file, previous capture is closed */
+		bool Open(StringView path, bool isServer);
+		/** @brief Flushes and closes the capture file */
+		void Close();
+		/** @brief Returns `true` if the capture is in progress */
+		bool IsOpen() const {
+			return _isOpen.load(std::memory_order_relaxed);
+		}
+
+		/** @brief Records a connected peer */
+		void WriteConnected(const Peer& peer, std::uint32_t clientData);
+		/** @brief Records a disconnected peer */
+		void WriteDisconnected(const Peer& peer, Reason reason);
+		/** @brief Records a received packet including its payload */
+		void WriteReceived(const Peer& peer, std::uint8_t channel, std::uint8_t packetType, ArrayView<const std::uint8_t> data, std::uint32_t handlerTimeUs);
+		/** @brief Records a packet sent to the specified number of peers */
+		void WriteSent(std::uint32_t targetCount, std::uint8_t channel, std::uint8_t packetType, std::uint32_t size);
+
+	private:
+		std::unique_ptr<Stream> _file;
+		HashMap<Peer, std::uint32_t> _peerIndices;
+		std::uint64_t _startTime;
+		std::uint64_t _lastTimeUs;
+		std::uint32_t _startFrame;
+		std::int64_t _lastFrame;
+		std::uint32_t _nextPeerIndex;
+		std::atomic_bool _isOpen;
+		// Records are written to the file under the lock, so a spinlock would waste time of other threads
+		std::mutex _lock;
+
+		void WriteRecordHeader(PacketCaptureRecordType type);
+		std::uint32_t GetPeerIndex(const Peer& peer);
+	};
+
+	/**
+		@brief Reads packet capture file created by @ref PacketCaptureWriter
+
+		@experimental
+	*/
+	class PacketCaptureReader
+	{
+	public:
+		PacketCaptureReader();
+
+		PacketCaptureReader(const PacketCaptureReader&) = delete;
+		PacketCaptureReader& operator=(const PacketCaptureReader&) = delete;
+
+		/** @brief Opens the capture file */
+		bool Open(StringView path);
+		/** @brief Reads the next record, returns `false` at the end of the file */
+		bool ReadNext(PacketCaptureRecord& record);
+		/** @brief Returns `true` if the capture was recorded on the server */
+		bool IsServer() const {
+			return _isServer;
+		}
+
+		/** @brief Prints bandwidth and handler time of each packet type in the capture file to the log */
+		static bool Summarize(StringView path);
+		/** @brief Returns name of the packet type, or empty string if unknown */
+		static StringView GetPacketTypeName(std::uint8_t packetType, bool fromServer);
+
+	private:
+		std::unique_ptr<Stream> _file;
+		std::int64_t _fileSize;
+		std::int64_t _lastFrame;
+		std::uint64_t _lastTimeUs;
+		bool _isServer;
+	};
+
+#if !defined(DEATH_TARGET_EMSCRIPTEN) || defined(DOXYGEN_GENERATING_OUTPUT)
+	/**
+		@brief Replays a capture recorded on the server against the local server
+
+		Captured peers are replaced by virtual peers and captured incoming packets are dispatched to the handler
+		in the same frames as they were originally, so the replay is deterministic and it doesn't need any real
+		clients. Packets sent to virtual peers are dropped. When the capture ends, time spent in handlers
+		is compared to the original capture in the log. The capture should be recorded from the start of the server.
+
+		@experimental
+	*/
+	class PacketCaptureReplay
+	{
+	public:
+		/** @brief Creates the replay, @p onFinished is called when all records were replayed */
+		PacketCaptureReplay(NetworkManagerBase* networkManager, Function<void()>&& onFinished);
+		~PacketCaptureReplay();
+
+		PacketCaptureReplay(const PacketCaptureReplay&) = delete;
+		PacketCaptureReplay& operator=(const PacketCaptureReplay&) = delete;
+
+		/** @brief Opens the capture file */
+		bool Open(StringView path);
+		/** @brief Dispatches all captured events of the current frame, it's called by @ref NetworkManagerBase::ProcessReceivedPackets() */
+		void ProcessFrame();
+
+	private:
+#ifndef DOXYGEN_GENERATING_OUTPUT
+		// Doxygen 1.12.0 outputs also private structs/unions even if it shouldn't
+		struct VirtualPeer
+		{
+			std::unique_ptr<_ENetPeer> Handle;
+			bool IsConnected;
+		};
+
+		struct PacketTypeStats
+		{
+			std::uint64_t Count;
+			std::uint64_t Bytes;
+			std::uint64_t CapturedTimeUs;
+			std::uint64_t ReplayTimeUs;
+		};
+#endif
+
+		NetworkManagerBase* _networkManager;
+		Function<void()> _onFinished;
+		PacketCaptureReader _reader;
+		PacketCaptureRecord _nextRecord;
+		bool _hasNextRecord;
+		bool _finished;
+		std::int64_t _frame;
+		SmallVector<VirtualPeer, 0> _peers;
+		std::uint32_t _peerIndexCount;
+		PacketTypeStats _stats[256];
+		std::uint64_t _skippedPackets;
+		TimeStamp _startTime;
+
+		Peer GetPeer(std::uint32_t index, bool create);
+		void Finish();
+	};
+#endif
+}
+
+#endif
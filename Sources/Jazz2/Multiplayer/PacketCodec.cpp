@@ -0,0 +1,176 @@
+﻿#include "PacketCodec.h"
+
+#if defined(WITH_MULTIPLAYER)
+
+#include "../../nCine/Base/Clock.h"
+
+#include <IO/Compression/DeflateStream.h>
+#if defined(WITH_LZ4)
+#	include <IO/Compression/Lz4Stream.h>
+#endif
+#if defined(WITH_ZSTD)
+#	include <IO/Compression/ZstdStream.h>
+#endif
+
+using namespace Death::Containers::Literals;
+using namespace Death::IO::Compression;
+using namespace nCine;
+
+namespace Jazz2::Multiplayer
+{
+	PacketCodecStats::PacketCodecStats()
+		: PacketCount{}, UncompressedBytes{}, CompressedBytes{}, CompressTimeUs{}
+	{
+	}
+
+	PacketCodecType PacketCodec::GetPreferredCodec()
+	{
+#if defined(WITH_ZSTD)
+		return PacketCodecType::Zstd;
+#elif defined(WITH_LZ4)
+		return PacketCodecType::Lz4;
+#elif defined(WITH_ZLIB) || defined(WITH_MINIZ)
+		return PacketCodecType::Deflate;
+#else
+		return PacketCodecType::Raw;
+#endif
+	}
+
+	StringView PacketCodec::GetCodecName(PacketCodecType codec)
+	{
+		switch (codec) {
+			case PacketCodecType::Raw: return "Raw"_s;
+			case PacketCodecType::Deflate: return "Deflate"_s;
+			case PacketCodecType::Lz4: return "LZ4"_s;
+			case PacketCodecType::Zstd: return "Zstd"_s;
+			default: return "Unknown"_s;
+		}
+	}
+
+	PacketCodecType PacketCodec::Compress(ArrayView<const std::uint8_t> data, MemoryStream& output, PacketCodecStats* stats)
+	{
+		return Compress(data, output, data.size() < MinCompressibleSize ? PacketCodecType::Raw : GetPreferredCodec(), stats);
+	}
+
+	PacketCodecType PacketCodec::Compress(ArrayView<const std::uint8_t> data, MemoryStream& output, PacketCodecType codec, PacketCodecStats* stats)
+	{
+		Clock& c = nCine::clock();
+		std::uint64_t startTime = c.now();
+		std::int64_t startPos = output.GetPosition();
+
+		if (codec != PacketCodecType::Raw) {
+			output.WriteValue<std::uint8_t>((std::uint8_t)codec);
+			output.WriteVariableUint32((std::uint32_t)data.size());
+
+			switch (codec) {
+#if defined(WITH_ZLIB) || defined(WITH_MINIZ)
+				case PacketCodecType::Deflate: {
+					// The fastest level is used, payloads are small and already bit-packed, higher levels don't pay off
+					DeflateWriter dw(output, 1);
+					dw.Write(data.data(), (std::int64_t)data.size());
+					break;
+				}
+#endif
+#if defined(WITH_LZ4)
+				case PacketCodecType::Lz4: {
+					Lz4Writer lw(output);
+					lw.Write(data.data(), (std::int64_t)data.size());
+					break;
+				}
+#endif
+#if defined(WITH_ZSTD)
+				case PacketCodecType::Zstd: {
+					ZstdWriter zw(output, 1);
+					zw.Write(data.data(), (std::int64_t)data.size());
+					break;
+				}
+#endif
+				default: {
+					// Codec is not supported in this build
+					output.Seek(startPos, SeekOrigin::Begin);
+					output.SetSize(startPos);
+					codec = PacketCodecType::Raw;
+					break;
+				}
+			}
+
+			if (codec != PacketCodecType::Raw && output.GetPosition() - startPos >= (std::int64_t)data.size() + 1) {
+				// Compression doesn't pay off, rewrite the payload uncompressed
+				output.Seek(startPos, SeekOrigin::Begin);
+				output.SetSize(startPos);
+				codec = PacketCodecType::Raw;
+			}
+		}
+
+		if (codec == PacketCodecType::Raw) {
+			output.WriteValue<std::uint8_t>((std::uint8_t)PacketCodecType::Raw);
+			output.Write(data.data(), (std::int64_t)data.size());
+		}
+
+		if (stats != nullptr) {
+			std::int32_t index = (std::int32_t)codec;
+			stats->PacketCount[index]++;
+			stats->UncompressedBytes[index] += data.size();
+			stats->CompressedBytes[index] += (std::uint64_t)(output.GetPosition() - startPos);
+			stats->CompressTimeUs[index] += (c.now() - startTime) * 1000000 / c.frequency();
+		}
+
+		return codec;
+	}
+
+	bool PacketCodec::Decompress(ArrayView<const std::uint8_t> data, MemoryStream& output, std::uint32_t maxSize)
+	{
+		if (data.empty()) {
+			return false;
+		}
+
+		PacketCodecType codec = (PacketCodecType)data[0];
+		if (codec == PacketCodecType::Raw) {
+			if (data.size() - 1 > maxSize) {
+				LOGW("Packet is too large ({} bytes, max. {} bytes)", data.size() - 1, maxSize);
+				return false;
+			}
+			output.Write(data.data() + 1, (std::int64_t)data.size() - 1);
+			return true;
+		}
+
+		MemoryStream input(data.exceptPrefix(1));
+		std::uint32_t uncompressedSize = input.ReadVariableUint32();
+		std::int32_t compressedSize = (std::int32_t)(input.GetSize() - input.GetPosition());
+		if (compressedSize <= 0) {
+			return false;
+		}
+		// The declared size comes from the network, so it must be checked before the output is resized
+		if (uncompressedSize > maxSize) {
+			LOGW("Packet is too large ({} bytes, max. {} bytes)", uncompressedSize, maxSize);
+			return false;
+		}
+
+		switch (codec) {
+#if defined(WITH_ZLIB) || defined(WITH_MINIZ)
+			case PacketCodecType::Deflate: {
+				DeflateStream ds(input, compressedSize);
+				return (output.FetchFromStream(ds, uncompressedSize) == uncompressedSize);
+			}
+#endif
+#if defined(WITH_LZ4)
+			case PacketCodecType::Lz4: {
+				Lz4Stream ls(input, compressedSize);
+				return (output.FetchFromStream(ls, uncompressedSize) == uncompressedSize);
+			}
+#endif
+#if defined(WITH_ZSTD)
+			case PacketCodecType::Zstd: {
+				ZstdStream zs(input, compressedSize);
+				return (output.FetchFromStream(zs, uncompressedSize) == uncompressedSize);
+			}
+#endif
+			default: {
+				LOGW("Packet compressed with unsupported codec ({})", (std::uint32_t)codec);
+				return false;
+			}
+		}
+	}
+}
+
+#endif
\ No newline at end of file
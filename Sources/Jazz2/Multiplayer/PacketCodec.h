@@ -0,0 +1,76 @@
+﻿#pragma once
+
+#if defined(WITH_MULTIPLAYER) || defined(DOXYGEN_GENERATING_OUTPUT)
+
+#include "../../Main.h"
+
+#include <Containers/ArrayView.h>
+#include <Containers/StringView.h>
+#include <IO/MemoryStream.h>
+
+using namespace Death::Containers;
+using namespace Death::IO;
+
+namespace Jazz2::Multiplayer
+{
+	/** @brief Compression codec of a packet payload, stored in the first byte of the payload */
+	enum class PacketCodecType : std::uint8_t {
+		Raw,			/**< Uncompressed */
+		Deflate,		/**< Deflate (fastest level) */
+		Lz4,			/**< LZ4 */
+		Zstd,			/**< Zstd */
+
+		Count
+	};
+
+	/** @brief Compression statistics of @ref PacketCodec, collected per codec */
+	struct PacketCodecStats
+	{
+		/** @brief Number of compressed packets */
+		std::uint64_t PacketCount[(std::int32_t)PacketCodecType::Count];
+		/** @brief Total size of payloads before compression */
+		std::uint64_t UncompressedBytes[(std::int32_t)PacketCodecType::Count];
+		/** @brief Total size of payloads after compression */
+		std::uint64_t CompressedBytes[(std::int32_t)PacketCodecType::Count];
+		/** @brief Total time spent in compression in microseconds */
+		std::uint64_t CompressTimeUs[(std::int32_t)PacketCodecType::Count];
+
+		PacketCodecStats();
+	};
+
+	/**
+		@brief Compresses packet payloads with a codec selected per packet
+
+		Payloads smaller than @ref MinCompressibleSize are sent uncompressed, larger payloads are compressed
+		by the preferred codec and sent uncompressed if the compression doesn't pay off.
+	*/
+	class PacketCodec
+	{
+	public:
+		/** @brief Payloads smaller than this size are never compressed */
+		static constexpr std::int32_t MinCompressibleSize = 96;
+		/** @brief Default maximum size of a decompressed payload */
+		static constexpr std::uint32_t DefaultMaxDecompressedSize = 1024 * 1024;
+
+		PacketCodec() = delete;
+
+		/** @brief Returns the preferred codec for compressible payloads depending on available libraries */
+		static PacketCodecType GetPreferredCodec();
+		/** @brief Returns name of the codec */
+		static StringView GetCodecName(PacketCodecType codec);
+
+		/** @brief Compresses the payload to the output stream, returns the used codec */
+		static PacketCodecType Compress(ArrayView<const std::uint8_t> data, MemoryStream& output, PacketCodecStats* stats = nullptr);
+		/** @brief Compresses the payload to the output stream by the specified codec, returns the used codec */
+		static PacketCodecType Compress(ArrayView<const std::uint8_t> data, MemoryStream& output, PacketCodecType codec, PacketCodecStats* stats = nullptr);
+		/**
+		 * @brief Decompresses the payload to the output stream
+		 *
+		 * The payload is rejected without allocating if the declared size exceeds @p maxSize, or if
+		 * the compressed stream ends before the declared size is decompressed.
+		 */
+		static bool Decompress(ArrayView<const std::uint8_t> data, MemoryStream& output, std::uint32_t maxSize = DefaultMaxDecompressedSize);
+	};
+}
+
+#endif
\ No newline at end of file
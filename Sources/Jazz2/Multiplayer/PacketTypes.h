@@ -26,6 +26,7 @@ namespace Jazz2::Multiplayer
 		LevelReady,
 		ChatMessage,
 		ValidateAssetsResponse,
+		StreamAssetAck,
 
 		ForceResyncActors = 20,
 
@@ -2,9 +2,11 @@
 
 #if defined(WITH_MULTIPLAYER) || defined(DOXYGEN_GENERATING_OUTPUT)
 
+#include "ActorSnapshot.h"
 #include "Peer.h"
 #include "../PlayerType.h"
 #include "../PreferencesCache.h"
+#include "../../nCine/Base/HashMap.h"
 #include "../../nCine/Base/TimeStamp.h"
 
 #include <Containers/String.h>
@@ -103,6 +105,17 @@ namespace Jazz2::Multiplayer
 		/** @brief Whether the player is in spectate mode */
 		SpectateMode IsSpectating;
 
+		/** @brief Remote actors currently replicated to the peer (area of interest), actor ID → last update they were relevant */
+		HashMap<std::uint32_t, std::uint32_t> RelevantActors;
+		/** @brief Total bytes of actor synchronization sent to the peer in the current level */
+		std::uint64_t ActorSyncBytesSent;
+		/** @brief Average bytes per second of actor synchronization sent to the peer */
+		float ActorSyncBytesPerSecond;
+		/** @brief Actor snapshots recently sent to the peer, used as baselines for delta compression */
+		ActorSnapshotHistory ActorSnapshots;
+		/** @brief Last actor update acknowledged by the peer, `0` if none */
+		std::uint32_t LastAckedActorUpdate;
+
 		PeerDescriptor();
 	};
 }
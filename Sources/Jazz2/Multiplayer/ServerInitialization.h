@@ -75,11 +75,22 @@ namespace Jazz2::Multiplayer
 			-   If specified, the WebSocket server will use secure connections (wss://) and require clients to support TLS
 		-   @cpp "IsPrivate" @ce : @m_span{m-label m-default m-flat} bool @m_endspan Whether the server is private and hidden in the server list (default is **false**)
 		-   @cpp "AllowAssetStreaming" @ce : @m_span{m-label m-default m-flat} bool @m_endspan Whether clients are allowed to download assets from the server (default is **true**)
+		-   @cpp "AssetStreamingBytesPerSecond" @ce : @m_span{m-label m-warning m-flat} integer @m_endspan Maximum download speed of assets per client in bytes per second, `0` for unlimited (default is **524288**)
 		-   @cpp "RequiresDiscordAuth" @ce : @m_span{m-label m-default m-flat} bool @m_endspan If `true`, the server requires Discord authentication (default is **false**)
 			-   Discord authentication requires a running Discord client
 			-   Supported platforms are Linux, macOS and Windows, players from other platforms won't be able to join
 		-   @cpp "AllowedPlayerTypes" @ce : @m_span{m-label m-warning m-flat} integer @m_endspan Bitmask for allowed player types (@cpp 1 @ce - Jazz, @cpp 2 @ce - Spaz, @cpp 4 @ce - Lori)
 		-   @cpp "IdleKickTimeSecs" @ce : @m_span{m-label m-warning m-flat} integer @m_endspan Time in seconds after idle players are kicked (default is **never**)
+		-   @cpp "InterestAreaMargin" @ce : @m_span{m-label m-warning m-flat} integer @m_endspan Margin in pixels around the view of each player in which actors are synchronized (default is **200** pixels)
+			-   Actors outside of the area are not sent to the player at all, which reduces bandwidth on crowded servers
+			-   Negative value disables the culling, so all actors are always sent to all players
+		-   @cpp "TickRate" @ce : @m_span{m-label m-warning m-flat} integer @m_endspan Number of simulation ticks per second on dedicated server (default is **60**)
+			-   The simulation runs with fixed time step, higher values increase CPU usage, lower values increase latency
+			-   Allowed range is **10** to **240**
+			-   If multiple sessions are hosted in one process, the tick rate of the first session is used for all of them
+		-   @cpp "MetricsPath" @ce : @m_span{m-label m-danger m-flat} string @m_endspan Path to file to which server metrics are periodically written (default is **disabled**)
+			-   The file uses Prometheus text format, so it can be collected by node_exporter's textfile collector or similar tools
+			-   If multiple sessions are hosted in one process, each session should use a different file
 		-   @cpp "AdminUniquePlayerIDs" @ce : @m_span{m-label m-primary m-flat} object @m_endspan Map of admin player IDs
 			-   Key specifies player ID, value contains privileges
 		-   @cpp "WhitelistedUniquePlayerIDs" @ce : @m_span{m-label m-primary m-flat} object @m_endspan Map of whitelisted player IDs
@@ -143,6 +154,12 @@ namespace Jazz2::Multiplayer
 		If a property is missing in the root configuration, the default value is used. `{PlayerName}` and
 		`{ServerName}` variables can be used in @cpp "ServerName" @ce and @cpp "WelcomeMessage" @ce properties.
 		Both properties also support @ref Jazz2-UI-Font-format "text formatting" using the @cpp "\f[…]" @ce notation.
+
+		Dedicated server accepts multiple configuration files on the command line. Each of them starts an independent
+		session with its own port and playlist, but all sessions share the cached content, so hosting many sessions
+		in one process requires much less memory than running a separate process for each of them. Commands entered
+		to the server console are processed by the first session, @cpp "/session <index> <command>" @ce can be used
+		to target another session.
 		
 		@subsection Multiplayer-ServerConfiguration-format-example Example server configuration
 		
@@ -180,12 +197,20 @@ namespace Jazz2::Multiplayer
 		bool IsPrivate;
 		/** @brief Whether clients are allowed to automatically download missing assets from the server */
 		bool AllowAssetStreaming;
+		/** @brief Maximum download speed of assets per client in bytes per second, `0` for unlimited */
+		std::uint32_t AssetStreamingBytesPerSecond;
 		/** @brief Whether Discord authentication is required to join the server */
 		bool RequiresDiscordAuth;
 		/** @brief Allowed player types as bitmask of @ref PlayerType */
 		std::uint8_t AllowedPlayerTypes;
 		/** @brief Time after which inactive players will be kicked, in seconds, -1 to disable */
 		std::int32_t IdleKickTimeSecs;
+		/** @brief Margin around the view of each player in which actors are synchronized, negative to disable culling */
+		std::int32_t InterestAreaMargin;
+		/** @brief Number of simulation ticks per second on dedicated server */
+		std::uint32_t TickRate;
+		/** @brief Path to file to which server metrics are periodically written, empty to disable */
+		String MetricsPath;
 		/** @brief List of unique player IDs with admin rights, value contains list of privileges, or `*` for all privileges */
 		HashMap<String, String> AdminUniquePlayerIDs;
 		/** @brief List of whitelisted unique player IDs, value can contain user-defined comment */
@@ -1,30 +1,37 @@
 ﻿#include "LightingRenderer.h"
 #include "PlayerViewport.h"
+#include "../ContentResolver.h"
 
 #include "../../nCine/Graphics/RenderQueue.h"
 
 namespace Jazz2::Rendering
 {
 	LightingRenderer::LightingRenderer(PlayerViewport* owner)
-		: _owner(owner), _renderCommandsCount(0)
+		: _owner(owner), _renderCommandsCount(0), _instancedCommandsCount(0)
 	{
-		_emittedLightsCache.reserve(32);
 		setVisitOrderState(SceneNode::VisitOrderState::Disabled);
 	}
 		
 	bool LightingRenderer::OnDraw(RenderQueue& renderQueue)
 	{
 		_renderCommandsCount = 0;
-		_emittedLightsCache.clear();
+		_instancedCommandsCount = 0;
 
-		// Collect all active light emitters
-		auto actors = _owner->_levelHandler->GetActors();
-		std::size_t actorsCount = actors.size();
-		for (std::size_t i = 0; i < actorsCount; i++) {
-			actors[i]->OnEmitLights(_emittedLightsCache);
+		// Lights are collected only once per frame, each viewport then draws only lights that intersect its view
+		auto lights = _owner->_levelHandler->GetEmittedLights();
+		Rectf cullingRect = _owner->_lightingView->GetCullingRect();
+
+		Shader* instancedShader = ContentResolver::Get().GetShader(PrecompiledShader::InstancedLighting);
+		if (instancedShader != nullptr && instancedShader->IsLinked()) {
+			DrawInstanced(renderQueue, lights, cullingRect, instancedShader);
+			return true;
 		}
 
-		for (auto& light : _emittedLightsCache) {
+		for (auto& light : lights) {
+			if (!IsLightVisible(light, cullingRect)) {
+				continue;
+			}
+
 			auto command = RentRenderCommand();
 			auto instanceBlock = command->GetMaterial().UniformBlock(Material::InstanceBlockName);
 			instanceBlock->GetUniform(Material::TexRectUniformName)->SetFloatValue(light.Pos.X, light.Pos.Y, light.RadiusNear / light.RadiusFar, 0.0f);
@@ -38,6 +45,44 @@ namespace Jazz2::Rendering
 		return true;
 	}
 
+	void LightingRenderer::DrawInstanced(RenderQueue& renderQueue, ArrayView<const LightEmitter> lights, const Rectf& cullingRect, Shader* shader)
+	{
+		RenderCommand* command = nullptr;
+		GLUniformBlockCache* instancesBlock = nullptr;
+		std::int32_t count = 0, capacity = 0;
+
+		for (auto& light : lights) {
+			if (!IsLightVisible(light, cullingRect)) {
+				continue;
+			}
+
+			if (command == nullptr || count >= capacity) {
+				if (command != nullptr) {
+					instancesBlock->SetUsedSize(GLint(count * sizeof(LightInstance)));
+					command->GetGeometry().SetDrawParameters(GL_TRIANGLES, 0, 6 * count);
+				}
+
+				command = RentInstancedCommand(shader);
+				instancesBlock = command->GetMaterial().UniformBlock(Material::InstancesBlockName);
+				DEATH_DEBUG_ASSERT(instancesBlock != nullptr);
+				count = 0;
+				capacity = (instancesBlock->GetSize() - instancesBlock->GetAlignAmount()) / std::int32_t(sizeof(LightInstance));
+				command->SetTransformation(Matrix4x4f::Identity);
+				renderQueue.AddCommand(command);
+			}
+
+			LightInstance* target = reinterpret_cast<LightInstance*>(instancesBlock->GetDataPointer()) + count;
+			target->Light = Vector4f(light.Pos.X, light.Pos.Y, light.RadiusFar, light.RadiusNear / light.RadiusFar);
+			target->Color = Vector4f(light.Intensity, light.Brightness, 0.0f, 0.0f);
+			count++;
+		}
+
+		if (command != nullptr) {
+			instancesBlock->SetUsedSize(GLint(count * sizeof(LightInstance)));
+			command->GetGeometry().SetDrawParameters(GL_TRIANGLES, 0, 6 * count);
+		}
+	}
+
 	RenderCommand* LightingRenderer::RentRenderCommand()
 	{
 		if (_renderCommandsCount < _renderCommands.size()) {
@@ -60,4 +105,34 @@ namespace Jazz2::Rendering
 			return command.get();
 		}
 	}
+	RenderCommand* LightingRenderer::RentInstancedCommand(Shader* shader)
+	{
+		RenderCommand* command;
+		if (_instancedCommandsCount < _instancedCommands.size()) {
+			command = _instancedCommands[_instancedCommandsCount].get();
+			_instancedCommandsCount++;
+		} else {
+			command = _instancedCommands.emplace_back(std::make_unique<RenderCommand>(RenderCommand::Type::Lighting)).get();
+			_instancedCommandsCount++;
+			command->GetMaterial().SetBlendingEnabled(true);
+			command->GetMaterial().SetBlendingFactors(GL_SRC_ALPHA, GL_ONE);
+		}
+
+		if (command->GetMaterial().SetShader(shader)) {
+			command->GetMaterial().ReserveUniformsDataMemory();
+
+			auto* textureUniform = command->GetMaterial().Uniform(Material::TextureUniformName);
+			if (textureUniform && textureUniform->GetIntValue(0) != 0) {
+				textureUniform->SetIntValue(0); // GL_TEXTURE0
+			}
+		}
+
+		return command;
+	}
+
+	bool LightingRenderer::IsLightVisible(const LightEmitter& light, const Rectf& cullingRect)
+	{
+		return (light.Pos.X + light.RadiusFar >= cullingRect.X && light.Pos.X - light.RadiusFar <= cullingRect.X + cullingRect.W &&
+				light.Pos.Y + light.RadiusFar >= cullingRect.Y && light.Pos.Y - light.RadiusFar <= cullingRect.Y + cullingRect.H);
+	}
 }
\ No newline at end of file
@@ -6,6 +6,9 @@
 #include "../../nCine/Graphics/RenderCommand.h"
 #include "../../nCine/Graphics/RenderQueue.h"
 #include "../../nCine/Graphics/SceneNode.h"
+#include "../../nCine/Graphics/Shader.h"
+#include "../../nCine/Primitives/Rect.h"
+#include "../../nCine/Primitives/Vector4.h"
 
 #include <memory>
 
@@ -24,11 +27,26 @@ namespace Jazz2::Rendering
 		bool OnDraw(RenderQueue& renderQueue) override;
 
 	private:
+#ifndef DOXYGEN_GENERATING_OUTPUT
+		// Doxygen 1.12.0 outputs also private structs/unions even if it shouldn't
+		struct LightInstance {
+			Vector4f Light;
+			Vector4f Color;
+		};
+
+		static_assert(sizeof(LightInstance) == 32, "LightInstance must match std140 layout of the shader");
+#endif
+
 		PlayerViewport* _owner;
 		SmallVector<std::unique_ptr<RenderCommand>, 0> _renderCommands;
 		std::int32_t _renderCommandsCount;
-		SmallVector<LightEmitter, 0> _emittedLightsCache;
+		SmallVector<std::unique_ptr<RenderCommand>, 0> _instancedCommands;
+		std::int32_t _instancedCommandsCount;
 
+		void DrawInstanced(RenderQueue& renderQueue, ArrayView<const LightEmitter> lights, const Rectf& cullingRect, Shader* shader);
 		RenderCommand* RentRenderCommand();
+		RenderCommand* RentInstancedCommand(Shader* shader);
+
+		static bool IsLightVisible(const LightEmitter& light, const Rectf& cullingRect);
 	};
 }
\ No newline at end of file
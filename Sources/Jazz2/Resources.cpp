@@ -3,7 +3,7 @@
 namespace Jazz2::Resources
 {
 	GenericGraphicResource::GenericGraphicResource() noexcept
-		: Flags(GenericGraphicResourceFlags::None)
+		: Flags(GenericGraphicResourceFlags::None), Owners(0), Mask(nullptr)
 	{
 	}
 
@@ -17,7 +17,7 @@ namespace Jazz2::Resources
 	}
 
 	GenericSoundResource::GenericSoundResource(std::unique_ptr<Stream> stream, StringView filename) noexcept
-		: Buffer(std::move(stream), filename), Flags(GenericSoundResourceFlags::None)
+		: Buffer(std::move(stream), filename), Flags(GenericSoundResourceFlags::None), Owners(0)
 	{
 	}
 
@@ -26,7 +26,7 @@ namespace Jazz2::Resources
 	}
 
 	Metadata::Metadata() noexcept
-		: Flags(MetadataFlags::None)
+		: Flags(MetadataFlags::None), Owners(0)
 	{
 	}
 
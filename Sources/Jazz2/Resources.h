@@ -35,11 +35,17 @@ namespace Jazz2::Resources
 	{
 		/** @brief Resource flags */
 		GenericGraphicResourceFlags Flags;
+		/** @brief Bitmask of loading owners that reference the resource, used only if the cache is shared */
+		std::uint32_t Owners;
 		/** @brief Diffuse texture */
 		std::unique_ptr<Texture> TextureDiffuse;
 		//std::unique_ptr<Texture> TextureNormal;
-		/** @brief Collision mask */
-		std::unique_ptr<uint8_t[]> Mask;
+		/** @brief Collision mask, it points either to @ref MaskStorage or to a shared collision mask cache */
+		const std::uint8_t* Mask;
+		/** @brief Owned collision mask storage, it's empty if the mask is shared */
+		std::unique_ptr<std::uint8_t[]> MaskStorage;
+		/** @brief Shared collision mask, it keeps the collision mask cache mapped while the resource exists */
+		std::shared_ptr<const void> SharedMask;
 		/** @brief Frame dimensions */
 		Vector2i FrameDimensions;
 		/** @brief Frame configuration */
@@ -96,6 +102,8 @@ namespace Jazz2::Resources
 		AudioBuffer Buffer;
 		/** @brief Resource flags */
 		GenericSoundResourceFlags Flags;
+		/** @brief Bitmask of loading owners that reference the resource, used only if the cache is shared */
+		std::uint32_t Owners;
 
 		GenericSoundResource(std::unique_ptr<Stream> stream, StringView filename) noexcept;
 	};
@@ -126,6 +134,8 @@ namespace Jazz2::Resources
 		String Path;
 		/** @brief Metadata flags */
 		MetadataFlags Flags;
+		/** @brief Bitmask of loading owners that reference the metadata, used only if the cache is shared */
+		std::uint32_t Owners;
 		/** @brief Animations */
 		SmallVector<GraphicResource, 0> Animations;
 		/** @brief Sounds */
@@ -205,6 +215,11 @@ namespace Jazz2::Resources
 		ShieldLightning,
 		BatchedShieldLightning,
 
+		TileLayer,
+		TileLayerTinted,
+		InstancedLighting,
+		Debris,
+
 #if !defined(DISABLE_RESCALE_SHADERS)
 		ResizeHQ2x,
 		Resize3xBrz,
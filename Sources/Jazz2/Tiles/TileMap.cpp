@@ -13,7 +13,8 @@
 namespace Jazz2::Tiles
 {
 	TileMap::TileMap(StringView tileSetPath, std::uint16_t captionTileId, bool applyPalette)
-		: _owner(nullptr), _sprLayerIndex(-1), _pitType(PitType::FallForever), _renderCommandsCount(0), _collapsingTimer(0.0f),
+		: _owner(nullptr), _sprLayerIndex(-1), _pitType(PitType::FallForever), _dirtyChunksStride(0), _debrisCommandsCount(0), _renderCommandsCount(0), _tileLayerCommandsCount(0),
+			_drawnTilesCount(0), _layoutVersion(0), _animationVersion(0), _collapsingTimer(0.0f),
 			_animatedTilesOffset(0), _triggerState(ValueInit, TriggerCount), _triggerStateForRollback(ValueInit, TriggerCount),
 			_texturedBackgroundLayer(-1), _texturedBackgroundPass(this)
 	{
@@ -30,6 +31,7 @@ namespace Jazz2::Tiles
 	TileMap::~TileMap()
 	{
 		TracyPlot("TileMap Render Commands", 0LL);
+		TracyPlot("TileMap Tiles", 0LL);
 	}
 
 	bool TileMap::IsValid() const
@@ -92,6 +94,7 @@ namespace Jazz2::Tiles
 				continue;
 			}
 
+			std::int32_t prevTileIdx = animTile.CurrentTileIdx;
 			animTile.FramesLeft -= timeMult;
 			while (animTile.FramesLeft <= 0.0f) {
 				if (animTile.Forwards) {
@@ -126,6 +129,10 @@ namespace Jazz2::Tiles
 					}
 				}
 			}
+
+			if (animTile.CurrentTileIdx != prevTileIdx) {
+				_animationVersion++;
+			}
 		}
 
 		// Update layer scrolling
@@ -169,6 +176,9 @@ namespace Jazz2::Tiles
 		// The command cache must be reset every frame,
 		// OnDraw() is called multiple times if multiple viewports are active
 		_renderCommandsCount = 0;
+		_tileLayerCommandsCount = 0;
+		_debrisCommandsCount = 0;
+		_drawnTilesCount = 0;
 	}
 
 	bool TileMap::OnDraw(RenderQueue& renderQueue)
@@ -222,7 +232,9 @@ namespace Jazz2::Tiles
 
 		DrawDebris(renderQueue);
 
-		TracyPlot("TileMap Render Commands", static_cast<std::int64_t>(_renderCommandsCount));
+		// Number of tiles is the number of commands that would be needed without instancing
+		TracyPlot("TileMap Render Commands", static_cast<std::int64_t>(_renderCommandsCount + _tileLayerCommandsCount));
+		TracyPlot("TileMap Tiles", static_cast<std::int64_t>(_drawnTilesCount));
 
 		return true;
 	}
@@ -362,16 +374,8 @@ namespace Jazz2::Tiles
 						bottom = (TileSet::DefaultTileSize - 1 - top2);
 					}
 
-					top *= TileSet::DefaultTileSize;
-					bottom *= TileSet::DefaultTileSize;
-
-					std::uint8_t* mask = tileSet->GetTileMask(tileId);
-					for (std::int32_t ry = top; ry <= bottom; ry += TileSet::DefaultTileSize) {
-						for (std::int32_t rx = left; rx <= right; rx++) {
-							if (mask[ry | rx]) {
-								return false;
-							}
-						}
+					if (tileSet->IsTileMaskSolidInRect(tileId, left, top, right, bottom)) {
+						return false;
 					}
 				}
 			}
@@ -473,16 +477,8 @@ namespace Jazz2::Tiles
 						bottom = (TileSet::DefaultTileSize - 1 - top2);
 					}
 
-					top *= TileSet::DefaultTileSize;
-					bottom *= TileSet::DefaultTileSize;
-
-					std::uint8_t* mask = tileSet->GetTileMask(tileId);
-					for (std::int32_t ry = top; ry <= bottom; ry += TileSet::DefaultTileSize) {
-						for (std::int32_t rx = left; rx <= right; rx++) {
-							if (mask[ry | rx]) {
-								return false;
-							}
-						}
+					if (tileSet->IsTileMaskSolidInRect(tileId, left, top, right, bottom)) {
+						return false;
 					}
 				}
 			}
@@ -491,6 +487,158 @@ namespace Jazz2::Tiles
 		return false;
 	}
 
+	float TileMap::FindFirstEmptyOffsetY(const AABBf& aabb, float offsetX, float startY, float endY, float step, const TileCollisionParams& params, bool reducedHitbox)
+	{
+		if (_sprLayerIndex == -1 || startY < endY) {
+			return startY;
+		}
+
+		Vector2i layoutSize = _layers[_sprLayerIndex].LayoutSize;
+
+		std::int32_t limitRightPx = layoutSize.X * TileSet::DefaultTileSize;
+		std::int32_t limitBottomPx = layoutSize.Y * TileSet::DefaultTileSize;
+
+		// Horizontal range is the same for all offsets, out-of-level coordinates are considered as solid walls
+		AABBf firstAabb = aabb + Vector2f(offsetX, startY);
+		if (firstAabb.L < 0 || firstAabb.R >= limitRightPx) {
+			return endY - step;
+		}
+
+		std::int32_t hx1 = std::max((std::int32_t)firstAabb.L, 0);
+		std::int32_t hx2 = std::min((std::int32_t)std::ceil(firstAabb.R), limitRightPx - 1);
+		std::int32_t hx1t = hx1 / TileSet::DefaultTileSize;
+		std::int32_t hx2t = hx2 / TileSet::DefaultTileSize;
+
+		// Vertical range covered by all offsets, with a pixel of tolerance for rounding
+		std::int32_t spanTop = std::clamp((std::int32_t)(aabb.T + endY) - 1, 0, limitBottomPx - 2);
+		std::int32_t spanBottom = std::clamp((std::int32_t)std::ceil(aabb.B + startY) + 1, 1, limitBottomPx - 1);
+		std::int32_t spanTopTile = spanTop / TileSet::DefaultTileSize;
+		std::int32_t spanBottomTile = spanBottom / TileSet::DefaultTileSize;
+
+		// Collapse all covered columns into a single profile with the number of solid pixel rows above each row,
+		// tiles that could be destroyed or otherwise affected by the check are marked, so they are never skipped
+		SmallVector<std::uint16_t, 256> solidRowsAbove(ValueInit, (spanBottomTile - spanTopTile + 1) * TileSet::DefaultTileSize + 1);
+		SmallVector<bool, 16> tileRowAffected(ValueInit, spanBottomTile - spanTopTile + 1);
+
+		auto* sprLayerLayout = _layers[_sprLayerIndex].Layout.get();
+
+		for (std::int32_t y = spanTopTile; y <= spanBottomTile; y++) {
+			std::uint32_t tileRowMask[TileSet::DefaultTileSize] = {};
+
+			for (std::int32_t x = hx1t; x <= hx2t; x++) {
+				LayerTile& tile = sprLayerLayout[y * layoutSize.X + x];
+
+				if (tile.DestructType != TileDestructType::None && (params.DestructType & tile.DestructType) == tile.DestructType) {
+					tileRowAffected[y - spanTopTile] = true;
+					break;
+				}
+
+				if ((params.DestructType & TileDestructType::IgnoreSolidTiles) == TileDestructType::IgnoreSolidTiles ||
+					tile.HasSuspendType != SuspendType::None || ((tile.Flags & LayerTileFlags::OneWay) == LayerTileFlags::OneWay && !params.Downwards)) {
+					continue;
+				}
+
+				std::int32_t tileId = ResolveTileID(tile);
+				TileSet* tileSet = ResolveTileSet(tileId);
+				if (tileSet == nullptr || tileSet->IsTileMaskEmpty(tileId)) {
+					continue;
+				}
+
+				std::int32_t tx = x * TileSet::DefaultTileSize;
+				std::int32_t left = std::max(hx1 - tx, 0);
+				std::int32_t right = std::min(hx2 - tx, TileSet::DefaultTileSize - 1);
+
+				if ((tile.Flags & LayerTileFlags::FlipX) == LayerTileFlags::FlipX) {
+					std::int32_t left2 = left;
+					left = (TileSet::DefaultTileSize - 1 - right);
+					right = (TileSet::DefaultTileSize - 1 - left2);
+				}
+
+				std::uint32_t columnMask = (0xFFFFFFFFu >> (TileSet::DefaultTileSize - 1 - right)) & (0xFFFFFFFFu << left);
+				const std::uint32_t* maskRows = tileSet->GetTileMaskRows(tileId);
+				bool flipY = ((tile.Flags & LayerTileFlags::FlipY) == LayerTileFlags::FlipY);
+				for (std::int32_t ry = 0; ry < TileSet::DefaultTileSize; ry++) {
+					tileRowMask[ry] |= maskRows[flipY ? TileSet::DefaultTileSize - 1 - ry : ry] & columnMask;
+				}
+			}
+
+			std::int32_t offset = (y - spanTopTile) * TileSet::DefaultTileSize;
+			for (std::int32_t ry = 0; ry < TileSet::DefaultTileSize; ry++) {
+				solidRowsAbove[offset + ry + 1] = solidRowsAbove[offset + ry] + (tileRowMask[ry] != 0 ? 1 : 0);
+			}
+		}
+
+		enum class ProbeResult {
+			Empty,
+			Blocked,
+			Unknown
+		};
+
+		auto probe = [&](const AABBf& box) -> ProbeResult {
+			if (box.B >= limitBottomPx && _pitType == PitType::StandOnPlatform) {
+				return ProbeResult::Blocked;
+			}
+
+			// Computed the same way as in IsTileEmpty()
+			std::int32_t hy1 = std::clamp((std::int32_t)box.T, 0, limitBottomPx - 2);
+			std::int32_t hy2 = std::clamp((std::int32_t)std::ceil(box.B), 1, limitBottomPx - 1);
+			if (hy1 < spanTopTile * TileSet::DefaultTileSize || hy2 >= (spanBottomTile + 1) * TileSet::DefaultTileSize) {
+				return ProbeResult::Unknown;
+			}
+
+			for (std::int32_t y = hy1 / TileSet::DefaultTileSize; y <= hy2 / TileSet::DefaultTileSize; y++) {
+				if (tileRowAffected[y - spanTopTile]) {
+					return ProbeResult::Unknown;
+				}
+			}
+
+			std::int32_t base = spanTopTile * TileSet::DefaultTileSize;
+			return (solidRowsAbove[hy2 - base + 1] != solidRowsAbove[hy1 - base] ? ProbeResult::Blocked : ProbeResult::Empty);
+		};
+
+		float y = startY;
+		for (; y >= endY; y -= step) {
+			if (offsetX == 0.0f && y == 0.0f) {
+				// Zero offset means no movement at all, which is never blocked
+				break;
+			}
+
+			AABBf candidate = aabb + Vector2f(offsetX, y);
+			AABBf top, bottom;
+			if (reducedHitbox && SplitReducedHitbox(candidate, top, bottom)) {
+				// The same order as in LevelHandler::IsPositionEmpty()
+				ProbeResult result = probe(bottom);
+				if (result == ProbeResult::Blocked) {
+					continue;
+				}
+				if (result == ProbeResult::Empty && !params.Downwards) {
+					result = probe(top);
+					if (result == ProbeResult::Blocked) {
+						continue;
+					}
+				}
+				break;
+			} else if (probe(candidate) != ProbeResult::Blocked) {
+				break;
+			}
+		}
+		return y;
+	}
+
+	bool TileMap::SplitReducedHitbox(const AABBf& aabb, AABBf& top, AABBf& bottom)
+	{
+		// If hitbox height is larger than 20px, check bottom and top separately
+		if (aabb.B - aabb.T < 20.0f) {
+			return false;
+		}
+
+		top = aabb;
+		top.B = top.T + 6.0f;
+		bottom = aabb;
+		bottom.T = bottom.B - std::max(14.0f, (aabb.B - aabb.T) - 10.0f);
+		return true;
+	}
+
 	SuspendType TileMap::GetTileSuspendState(float x, float y)
 	{
 		constexpr std::int32_t Tolerance = 4;
@@ -519,8 +667,6 @@ namespace Jazz2::Tiles
 			return SuspendType::None;
 		}
 
-		std::uint8_t* mask = tileSet->GetTileMask(tileId);
-
 		std::int32_t rx = (std::int32_t)x & 31;
 		std::int32_t ry = (std::int32_t)y & 31;
 
@@ -531,16 +677,10 @@ namespace Jazz2::Tiles
 			ry = (TileSet::DefaultTileSize - 1 - ry);
 		}
 
-		std::int32_t top = std::max(ry - Tolerance, 0) << 5;
-		std::int32_t bottom = std::min(ry + Tolerance, TileSet::DefaultTileSize - 1) << 5;
+		std::int32_t top = std::max(ry - Tolerance, 0);
+		std::int32_t bottom = std::min(ry + Tolerance, TileSet::DefaultTileSize - 1);
 
-		for (std::int32_t ti = bottom | rx; ti >= top; ti -= TileSet::DefaultTileSize) {
-			if (mask[ti]) {
-				return tile.HasSuspendType;
-			}
-		}
-
-		return SuspendType::None;
+		return (tileSet->IsTileMaskSolidInRect(tileId, rx, top, rx, bottom) ? tile.HasSuspendType : SuspendType::None);
 	}
 
 	bool TileMap::AdvanceDestructibleTileAnimation(std::int32_t tx, std::int32_t ty, std::int32_t amount)
@@ -565,6 +705,7 @@ namespace Jazz2::Tiles
 
 				tile.DestructFrameIndex += frameCount;
 				tile.TileID = anim.Tiles[tile.DestructFrameIndex].TileID;
+				InvalidateLayerChunk(_sprLayerIndex, tx, ty);
 				if (tile.DestructFrameIndex >= max) {
 					if (!soundName.empty()) {
 						_owner->PlayCommonSfx(soundName, Vector3f(tx * TileSet::DefaultTileSize + (TileSet::DefaultTileSize / 2),
@@ -583,6 +724,7 @@ namespace Jazz2::Tiles
 				std::int32_t frameCount = 1;
 				tile.DestructFrameIndex += frameCount;
 				tile.TileID = 0; // Set to empty tile
+				InvalidateLayerChunk(_sprLayerIndex, tx, ty);
 
 				if (!soundName.empty()) {
 					_owner->PlayCommonSfx(soundName, Vector3f(tx * TileSet::DefaultTileSize + (TileSet::DefaultTileSize / 2),
@@ -616,6 +758,8 @@ namespace Jazz2::Tiles
 		while (it != _activeCollapsingTiles.end()) {
 			Vector2i tilePos = *it;
 			auto& tile = _layers[_sprLayerIndex].Layout[tilePos.X + tilePos.Y * layoutSize.X];
+			// Countdown is stored in the tile itself, so it has to be restored by rollback even if nothing visible changed
+			MarkTileDirtyForRollback(tilePos.X, tilePos.Y);
 			if (tile.TileParams == 0) {
 				std::int32_t amount = 1;
 				if (!AdvanceDestructibleTileAnimation(tile, tilePos.X, tilePos.Y, amount, "SceneryCollapse"_s)) {
@@ -754,6 +898,12 @@ namespace Jazz2::Tiles
 			float x3 = x1 + (TileSet::DefaultTileSize * 2) + cullingRect.W;
 			float y3 = y1 + (TileSet::DefaultTileSize * 2) + cullingRect.H;
 
+			if (DrawLayerInstanced(renderQueue, layer, x1, y1, x3, y3, tileAbsX, tileAbsY)) {
+				return;
+			}
+
+			// Fallback for renderer types that don't support instancing, each tile is drawn with its own command
+
 			std::int32_t tile_xo = -1;
 			for (float x2 = x1; x2 <= x3; x2 += TileSet::DefaultTileSize) {
 				tileX = (tileX + 1) % tileCount.X;
@@ -826,11 +976,246 @@ namespace Jazz2::Tiles
 					command->GetMaterial().SetTexture(*tileSet->TextureDiffuse);
 
 					renderQueue.AddCommand(command);
+					_drawnTilesCount++;
 				}
 			}
 		}
 	}
 
+	bool TileMap::DrawLayerInstanced(RenderQueue& renderQueue, TileMapLayer& layer, float x1, float y1, float x3, float y3, std::int32_t tileAbsX, std::int32_t tileAbsY)
+	{
+		PrecompiledShader shaderType;
+		switch (layer.Description.RendererType) {
+			case LayerRendererType::Default: shaderType = PrecompiledShader::TileLayer; break;
+			case LayerRendererType::Tinted: shaderType = PrecompiledShader::TileLayerTinted; break;
+			default: return false;
+		}
+
+		Shader* shader = ContentResolver::Get().GetShader(shaderType);
+		if (shader == nullptr || !shader->IsLinked()) {
+			return false;
+		}
+
+		std::int32_t columns = 0, rows = 0;
+		for (float x2 = x1; x2 <= x3; x2 += TileSet::DefaultTileSize) {
+			columns++;
+		}
+		for (float y2 = y1; y2 <= y3; y2 += TileSet::DefaultTileSize) {
+			rows++;
+		}
+
+		// Chunks are shared by all viewports, only their visibility is resolved per viewport
+		std::int32_t layerIndex = std::int32_t(&layer - _layers.data());
+		if (layerIndex >= std::int32_t(_layerChunks.size())) {
+			_layerChunks.resize(_layers.size());
+		}
+		TileLayerChunks& chunks = _layerChunks[layerIndex];
+		Vector2i tileCount = layer.LayoutSize;
+		if (chunks.Chunks.empty()) {
+			chunks.ChunkCount = Vector2i((tileCount.X + LayerChunkSize - 1) / LayerChunkSize, (tileCount.Y + LayerChunkSize - 1) / LayerChunkSize);
+			chunks.Color = layer.Description.Color;
+			chunks.Chunks.resize(chunks.ChunkCount.X * chunks.ChunkCount.Y);
+			for (auto& chunk : chunks.Chunks) {
+				chunk.IsValid = false;
+			}
+		} else if (chunks.Color != layer.Description.Color) {
+			chunks.Color = layer.Description.Color;
+			for (auto& chunk : chunks.Chunks) {
+				chunk.IsValid = false;
+			}
+		}
+
+		float x = x1, y = y1;
+		if (!PreferencesCache::UnalignedViewport) {
+			x = std::floor(x); y = std::floor(y);
+		}
+
+		// Find all visible chunks in each repetition of the layer, offsets are relative to the first visible tile
+		SmallVector<Pair<std::int32_t, float>, 8> visibleColumns;
+		SmallVector<Pair<std::int32_t, float>, 8> visibleRows;
+		GetVisibleLayerChunks(tileAbsX + 1, columns, tileCount.X, layer.Description.RepeatX, x, visibleColumns);
+		GetVisibleLayerChunks(tileAbsY + 1, rows, tileCount.Y, layer.Description.RepeatY, y, visibleRows);
+
+		SmallVector<PendingTileLayerCommand, 2> pendingCommands;
+		for (auto& [chunkY, offsetY] : visibleRows) {
+			for (auto& [chunkX, offsetX] : visibleColumns) {
+				TileLayerChunk& chunk = chunks.Chunks[chunkX + chunkY * chunks.ChunkCount.X];
+				if (!chunk.IsValid || chunk.LayoutVersion != _layoutVersion ||
+					(chunk.HasAnimatedTiles && chunk.AnimationVersion != _animationVersion)) {
+					BuildLayerChunk(layer, chunk, chunkX, chunkY);
+				}
+
+				for (auto& batch : chunk.Batches) {
+					PendingTileLayerCommand* pending = nullptr;
+					for (auto& item : pendingCommands) {
+						if (item.Source == batch.Source) {
+							pending = &item;
+							break;
+						}
+					}
+
+					// Cached instances are only shifted by the chunk offset while copying them to the uniform block
+					for (const TileInstance& instance : batch.Instances) {
+						if (pending == nullptr || pending->Count >= pending->Capacity) {
+							if (pending == nullptr) {
+								pending = &pendingCommands.emplace_back();
+								pending->Source = batch.Source;
+							} else {
+								FinishTileLayerCommand(*pending);
+							}
+
+							pending->Command = RentTileLayerCommand(shader);
+							pending->InstancesBlock = pending->Command->GetMaterial().UniformBlock(Material::InstancesBlockName);
+							DEATH_DEBUG_ASSERT(pending->InstancesBlock != nullptr);
+							pending->Count = 0;
+							pending->Capacity = (pending->InstancesBlock->GetSize() - pending->InstancesBlock->GetAlignAmount()) / std::int32_t(sizeof(TileInstance));
+
+							pending->Command->SetTransformation(Matrix4x4f::Translation(x, y, 0.0f));
+							pending->Command->SetLayer(layer.Description.Depth);
+							pending->Command->GetMaterial().SetTexture(*batch.Source->TextureDiffuse);
+							renderQueue.AddCommand(pending->Command);
+						}
+
+						TileInstance* target = reinterpret_cast<TileInstance*>(pending->InstancesBlock->GetDataPointer()) + pending->Count;
+						*target = instance;
+						target->Position.X += offsetX;
+						target->Position.Y += offsetY;
+						pending->Count++;
+					}
+					_drawnTilesCount += std::int32_t(batch.Instances.size());
+				}
+			}
+		}
+
+		for (auto& pending : pendingCommands) {
+			FinishTileLayerCommand(pending);
+		}
+
+		return true;
+	}
+
+	void TileMap::FinishTileLayerCommand(PendingTileLayerCommand& pending)
+	{
+		pending.InstancesBlock->SetUsedSize(GLint(pending.Count * sizeof(TileInstance)));
+		pending.Command->GetGeometry().SetDrawParameters(GL_TRIANGLES, 0, 6 * pending.Count);
+	}
+
+	void TileMap::GetVisibleLayerChunks(std::int32_t first, std::int32_t count, std::int32_t size, bool repeat, float origin, SmallVector<Pair<std::int32_t, float>, 8>& result)
+	{
+		std::int32_t last = first + count - 1;
+		if (!repeat) {
+			// Only the first iteration of the layer is drawn
+			first = std::max(first, 0);
+			last = std::min(last, size - 1);
+		}
+		if (first > last) {
+			return;
+		}
+
+		std::int32_t firstRepetition = (first >= 0 ? first / size : (first - size + 1) / size);
+		std::int32_t lastRepetition = (last >= 0 ? last / size : (last - size + 1) / size);
+		for (std::int32_t r = firstRepetition; r <= lastRepetition; r++) {
+			std::int32_t from = std::max(first - r * size, 0);
+			std::int32_t to = std::min(last - r * size, size - 1);
+			for (std::int32_t c = from / LayerChunkSize; c <= to / LayerChunkSize; c++) {
+				std::int32_t offset = r * size + c * LayerChunkSize - first;
+				result.emplace_back(c, origin + float(offset * TileSet::DefaultTileSize));
+			}
+		}
+	}
+
+	void TileMap::BuildLayerChunk(TileMapLayer& layer, TileLayerChunk& chunk, std::int32_t chunkX, std::int32_t chunkY)
+	{
+		ZoneScopedNC("Build Layer Chunk", 0xA09359);
+
+		chunk.IsValid = true;
+		chunk.HasAnimatedTiles = false;
+		chunk.LayoutVersion = _layoutVersion;
+		chunk.AnimationVersion = _animationVersion;
+		for (auto& batch : chunk.Batches) {
+			batch.Instances.clear();
+		}
+
+		std::int32_t x0 = chunkX * LayerChunkSize;
+		std::int32_t y0 = chunkY * LayerChunkSize;
+		std::int32_t x1 = std::min(x0 + LayerChunkSize, layer.LayoutSize.X);
+		std::int32_t y1 = std::min(y0 + LayerChunkSize, layer.LayoutSize.Y);
+
+		for (std::int32_t tileY = y0; tileY < y1; tileY++) {
+			for (std::int32_t tileX = x0; tileX < x1; tileX++) {
+				LayerTile& tile = layer.Layout[tileX + tileY * layer.LayoutSize.X];
+				if (tile.TileID >= std::int32_t(_animatedTilesOffset)) {
+					chunk.HasAnimatedTiles = true;
+				}
+
+				std::int32_t tileId = ResolveTileID(tile);
+				if (tileId == 0 || tile.Alpha == 0) {
+					continue;
+				}
+				TileSet* tileSet = ResolveTileSet(tileId);
+				if (tileSet == nullptr) {
+					continue;
+				}
+
+				TileLayerBatch* batch = nullptr;
+				for (auto& item : chunk.Batches) {
+					if (item.Source == tileSet) {
+						batch = &item;
+						break;
+					}
+				}
+				if (batch == nullptr) {
+					batch = &chunk.Batches.emplace_back();
+					batch->Source = tileSet;
+				}
+
+				Vector2i texSize = tileSet->TextureDiffuse->GetSize();
+				float texScaleX = TileSet::DefaultTileSize / float(texSize.X);
+				float texBiasX = ((tileId % tileSet->TilesPerRow) * (TileSet::DefaultTileSize + 2.0f) + 1.0f) / float(texSize.X);
+				float texScaleY = TileSet::DefaultTileSize / float(texSize.Y);
+				float texBiasY = ((tileId / tileSet->TilesPerRow) * (TileSet::DefaultTileSize + 2.0f) + 1.0f) / float(texSize.Y);
+
+				if ((tile.Flags & LayerTileFlags::FlipX) == LayerTileFlags::FlipX) {
+					texBiasX += texScaleX;
+					texScaleX *= -1;
+				}
+				if ((tile.Flags & LayerTileFlags::FlipY) == LayerTileFlags::FlipY) {
+					texBiasY += texScaleY;
+					texScaleY *= -1;
+				}
+
+				TileInstance& instance = batch->Instances.emplace_back();
+				instance.TexRect = Vector4f(texScaleX, texBiasX, texScaleY, texBiasY);
+				instance.Color = layer.Description.Color;
+				instance.Color.W *= tile.Alpha / 255.0f;
+				instance.Position = Vector2f(float((tileX - x0) * TileSet::DefaultTileSize), float((tileY - y0) * TileSet::DefaultTileSize));
+				instance.Padding[0] = 0.0f;
+				instance.Padding[1] = 0.0f;
+			}
+		}
+	}
+
+	void TileMap::InvalidateLayerChunk(std::int32_t layerIndex, std::int32_t tx, std::int32_t ty)
+	{
+		if (layerIndex == _sprLayerIndex) {
+			// Every visible change of the sprite layer has to be reverted by rollback too
+			MarkTileDirtyForRollback(tx, ty);
+		}
+
+		if (layerIndex < 0 || layerIndex >= std::int32_t(_layerChunks.size())) {
+			return;
+		}
+
+		TileLayerChunks& chunks = _layerChunks[layerIndex];
+		std::int32_t chunkX = tx / LayerChunkSize;
+		std::int32_t chunkY = ty / LayerChunkSize;
+		if (chunkX < 0 || chunkY < 0 || chunkX >= chunks.ChunkCount.X || chunkY >= chunks.ChunkCount.Y || chunks.Chunks.empty()) {
+			return;
+		}
+
+		chunks.Chunks[chunkX + chunkY * chunks.ChunkCount.X].IsValid = false;
+	}
+
 	float TileMap::TranslateCoordinate(float coordinate, float speed, float offset, std::int32_t viewSize, bool isY)
 	{
 		std::int32_t alignment = ((isY ? (viewSize - 200) : (viewSize - 320)) / 2) + HardcodedOffset;
@@ -870,12 +1255,38 @@ namespace Jazz2::Tiles
 		return command;
 	}
 
+	RenderCommand* TileMap::RentTileLayerCommand(Shader* shader)
+	{
+		RenderCommand* command;
+		if (_tileLayerCommandsCount < _tileLayerCommands.size()) {
+			command = _tileLayerCommands[_tileLayerCommandsCount].get();
+			_tileLayerCommandsCount++;
+		} else {
+			command = _tileLayerCommands.emplace_back(std::make_unique<RenderCommand>(RenderCommand::Type::TileMap)).get();
+			_tileLayerCommandsCount++;
+			command->GetMaterial().SetBlendingEnabled(true);
+			command->GetMaterial().SetBlendingFactors(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		}
+
+		if (command->GetMaterial().SetShader(shader)) {
+			command->GetMaterial().ReserveUniformsDataMemory();
+
+			auto* textureUniform = command->GetMaterial().Uniform(Material::TextureUniformName);
+			if (textureUniform && textureUniform->GetIntValue(0) != 0) {
+				textureUniform->SetIntValue(0); // GL_TEXTURE0
+			}
+		}
+
+		return command;
+	}
+
 	void TileMap::AddTileSet(StringView tileSetPath, std::uint16_t offset, std::uint16_t count, const std::uint8_t* paletteRemapping)
 	{
 		auto& tileSetPart = _tileSets.emplace_back();
 		tileSetPart.Data = ContentResolver::Get().RequestTileSet(tileSetPath, 0, false, paletteRemapping);
 		tileSetPart.Offset = offset;
 		tileSetPart.Count = count;
+		_layoutVersion++;
 
 		if (tileSetPart.Data == nullptr) {
 			LOGE("Cannot load extra tileset \"{}\"", tileSetPath);
@@ -892,6 +1303,7 @@ namespace Jazz2::Tiles
 		}
 
 		TileMapLayer& newLayer = _layers.emplace_back();
+		_layoutVersion++;
 
 		std::int32_t width = s.ReadValueAsLE<std::int32_t>();
 		std::int32_t height = s.ReadValueAsLE<std::int32_t>();
@@ -978,6 +1390,7 @@ namespace Jazz2::Tiles
 	void TileMap::ReadAnimatedTiles(Stream& s)
 	{
 		_animatedTilesOffset = s.ReadValueAsLE<std::uint16_t>();
+		_layoutVersion++;
 
 		std::int32_t count = s.ReadValueAsLE<std::uint16_t>();
 
@@ -1011,6 +1424,7 @@ namespace Jazz2::Tiles
 	void TileMap::SetTileEventFlags(std::int32_t x, std::int32_t y, EventType tileEvent, std::uint8_t* tileParams)
 	{
 		auto& tile = _layers[_sprLayerIndex].Layout[x + y * _layers[_sprLayerIndex].LayoutSize.X];
+		InvalidateLayerChunk(_sprLayerIndex, x, y);
 
 		switch (tileEvent) {
 			case EventType::ModifierOneWay:
@@ -1122,7 +1536,7 @@ namespace Jazz2::Tiles
 			}
 		}
 
-		_debrisList.push_back(debris);
+		_debrisList.Add(debris);
 	}
 
 	void TileMap::CreateTileDebris(std::int32_t tileId, std::int32_t x, std::int32_t y)
@@ -1159,7 +1573,7 @@ namespace Jazz2::Tiles
 		}*/
 
 		for (std::int32_t i = 0; i < 4; i++) {
-			DestructibleDebris& debris = _debrisList.emplace_back();
+			DestructibleDebris debris;
 			debris.Pos = Vector2f(x * TileSet::DefaultTileSize + (i % 2) * QuarterSize, y * TileSet::DefaultTileSize + (i / 2) * QuarterSize);
 			debris.Depth = z;
 			debris.Size = Vector2f(QuarterSize, QuarterSize);
@@ -1183,6 +1597,7 @@ namespace Jazz2::Tiles
 
 			debris.DiffuseTexture = tileSet->TextureDiffuse.get();
 			debris.Flags = DebrisFlags::None;
+			_debrisList.Add(debris);
 		}
 	}
 
@@ -1202,7 +1617,7 @@ namespace Jazz2::Tiles
 			for (std::int32_t fx = 0; fx < res->Base->FrameDimensions.X; fx += DebrisSize + 1) {
 				float currentSize = DebrisSize * Random().FastFloat(0.2f, 1.1f);
 
-				DestructibleDebris& debris = _debrisList.emplace_back();
+				DestructibleDebris debris;
 				debris.Pos = Vector2f(x + (isFacingLeft ? res->Base->FrameDimensions.X - fx : fx), y + fy);
 				debris.Depth = (std::uint16_t)pos.Z;
 				debris.Size = Vector2f(currentSize, currentSize);
@@ -1227,6 +1642,7 @@ namespace Jazz2::Tiles
 
 				debris.DiffuseTexture = res->Base->TextureDiffuse.get();
 				debris.Flags = DebrisFlags::Bounce;
+				_debrisList.Add(debris);
 			}
 		}
 	}
@@ -1244,7 +1660,7 @@ namespace Jazz2::Tiles
 		for (std::int32_t i = 0; i < count; i++) {
 			float speedX = Random().FastFloat(-1.0f, 1.0f) * Random().FastFloat(0.2f, 0.8f) * count;
 
-			DestructibleDebris& debris = _debrisList.emplace_back();
+			DestructibleDebris debris;
 			debris.Pos = Vector2f(x, y);
 			debris.Depth = (std::uint16_t)pos.Z;
 			debris.Size = Vector2f((float)res->Base->FrameDimensions.X, (float)res->Base->FrameDimensions.Y);
@@ -1271,6 +1687,7 @@ namespace Jazz2::Tiles
 
 			debris.DiffuseTexture = res->Base->TextureDiffuse.get();
 			debris.Flags = DebrisFlags::Bounce;
+			_debrisList.Add(debris);
 		}
 	}
 
@@ -1278,77 +1695,97 @@ namespace Jazz2::Tiles
 	{
 		ZoneScopedC(0xA09359);
 
-		std::int32_t size = (std::int32_t)_debrisList.size();
-		for (std::int32_t i = 0; i < size; i++) {
-			DestructibleDebris& debris = _debrisList[i];
+		_debrisList.RemoveDead();
 
-			if (debris.Scale <= 0.0f || debris.Alpha <= 0.0f) {
-				std::swap(debris, _debrisList[size - 1]);
-				_debrisList.pop_back();
-				i--;
-				size--;
-				continue;
-			}
+		std::int32_t count = _debrisList.GetCount();
+		TracyPlot("TileMap Debris", static_cast<std::int64_t>(count));
+		if (count == 0) {
+			return;
+		}
 
-			debris.Time -= timeMult;
-			if (debris.Time <= 0.0f) {
-				debris.Alpha = -std::min(0.02f, debris.Alpha);
-			}
-
-			if ((debris.Flags & (DebrisFlags::Disappear | DebrisFlags::Bounce)) != DebrisFlags::None) {
-				// Debris should collide with tilemap
-				float nx = debris.Pos.X + debris.Speed.X * timeMult;
-				float ny = debris.Pos.Y + debris.Speed.Y * timeMult;
-				AABB aabb = AABBf(nx - 1, ny - 1, nx + 1, ny + 1);
-				TileCollisionParams params = { TileDestructType::None, true };
-				if (IsTileEmpty(aabb, params)) {
-					// Nothing...
-				} else if ((debris.Flags & DebrisFlags::Disappear) == DebrisFlags::Disappear) {
-					debris.ScaleSpeed = -0.02f;
-					debris.AlphaSpeed = -0.006f;
-					debris.Speed = Vector2f::Zero;
-					debris.Acceleration = Vector2f::Zero;
-				} else {
-					// Place us to the ground only if no horizontal movement was
-					// involved (this prevents speeds resetting if the actor
-					// collides with a wall from the side while in the air)
-					aabb.T = debris.Pos.Y - 1;
-					aabb.B = debris.Pos.Y + 1;
-
-					if (IsTileEmpty(aabb, params)) {
-						if (debris.Speed.Y > 0.0f) {
-							debris.Speed.Y = -(0.8f/*elasticity*/ * debris.Speed.Y);
-							//OnHitFloorHook();
-						} else {
-							debris.Speed.Y = 0;
-							//OnHitCeilingHook();
-						}
-					}
+		float* time = _debrisList.Time.data();
+		float* alpha = _debrisList.Alpha.data();
+		for (std::int32_t i = 0; i < count; i++) {
+			time[i] -= timeMult;
+			alpha[i] = (time[i] <= 0.0f ? -std::min(0.02f, alpha[i]) : alpha[i]);
+		}
 
-					// If the actor didn't move all the way horizontally,
-					// it hit a wall (or was already touching it)
-					aabb = AABBf(debris.Pos.X - 1, ny - 1, debris.Pos.X + 1, ny + 1);
-					if (IsTileEmpty(aabb, params)) {
-						debris.Speed.X = -(0.8f/*elasticity*/ * debris.Speed.X);
-						debris.AngleSpeed = -(0.8f/*elasticity*/ * debris.AngleSpeed);
-						//OnHitWallHook();
-					}
-				}
+		// Only debris that collides with tile map has to be processed one by one
+		for (std::int32_t i = 0; i < count; i++) {
+			if ((_debrisList.Appearance[i].Flags & (DebrisFlags::Disappear | DebrisFlags::Bounce)) != DebrisFlags::None) {
+				CollideDebris(i, timeMult);
 			}
+		}
+
+		// The rest is branchless over contiguous arrays, so the compiler can vectorize it
+		float* posX = _debrisList.PosX.data();
+		float* posY = _debrisList.PosY.data();
+		float* speedX = _debrisList.SpeedX.data();
+		float* speedY = _debrisList.SpeedY.data();
+		const float* accelerationX = _debrisList.AccelerationX.data();
+		const float* accelerationY = _debrisList.AccelerationY.data();
+		float halfTimeMultSquared = 0.5f * timeMult * timeMult;
+		for (std::int32_t i = 0; i < count; i++) {
+			posX[i] += speedX[i] * timeMult + accelerationX[i] * halfTimeMultSquared;
+			posY[i] += speedY[i] * timeMult + accelerationY[i] * halfTimeMultSquared;
+			speedX[i] = (accelerationX[i] != 0.0f ? std::min(speedX[i] + accelerationX[i] * timeMult, 10.0f) : speedX[i]);
+			speedY[i] = (accelerationY[i] != 0.0f ? std::min(speedY[i] + accelerationY[i] * timeMult, 10.0f) : speedY[i]);
+		}
 
-			debris.Pos.X += debris.Speed.X * timeMult + 0.5f * debris.Acceleration.X * timeMult * timeMult;
-			debris.Pos.Y += debris.Speed.Y * timeMult + 0.5f * debris.Acceleration.Y * timeMult * timeMult;
+		float* scale = _debrisList.Scale.data();
+		float* angle = _debrisList.Angle.data();
+		const float* scaleSpeed = _debrisList.ScaleSpeed.data();
+		const float* angleSpeed = _debrisList.AngleSpeed.data();
+		const float* alphaSpeed = _debrisList.AlphaSpeed.data();
+		for (std::int32_t i = 0; i < count; i++) {
+			scale[i] += scaleSpeed[i] * timeMult;
+			angle[i] += angleSpeed[i] * timeMult;
+			alpha[i] += alphaSpeed[i] * timeMult;
+		}
+	}
 
-			if (debris.Acceleration.X != 0.0f) {
-				debris.Speed.X = std::min(debris.Speed.X + debris.Acceleration.X * timeMult, 10.0f);
-			}
-			if (debris.Acceleration.Y != 0.0f) {
-				debris.Speed.Y = std::min(debris.Speed.Y + debris.Acceleration.Y * timeMult, 10.0f);
+	void TileMap::CollideDebris(std::int32_t i, float timeMult)
+	{
+		auto& d = _debrisList;
+
+		float nx = d.PosX[i] + d.SpeedX[i] * timeMult;
+		float ny = d.PosY[i] + d.SpeedY[i] * timeMult;
+		AABB aabb = AABBf(nx - 1, ny - 1, nx + 1, ny + 1);
+		TileCollisionParams params = { TileDestructType::None, true };
+		if (IsTileEmpty(aabb, params)) {
+			// Nothing...
+		} else if ((d.Appearance[i].Flags & DebrisFlags::Disappear) == DebrisFlags::Disappear) {
+			d.ScaleSpeed[i] = -0.02f;
+			d.AlphaSpeed[i] = -0.006f;
+			d.SpeedX[i] = 0.0f;
+			d.SpeedY[i] = 0.0f;
+			d.AccelerationX[i] = 0.0f;
+			d.AccelerationY[i] = 0.0f;
+		} else {
+			// Place us to the ground only if no horizontal movement was
+			// involved (this prevents speeds resetting if the actor
+			// collides with a wall from the side while in the air)
+			aabb.T = d.PosY[i] - 1;
+			aabb.B = d.PosY[i] + 1;
+
+			if (IsTileEmpty(aabb, params)) {
+				if (d.SpeedY[i] > 0.0f) {
+					d.SpeedY[i] = -(0.8f/*elasticity*/ * d.SpeedY[i]);
+					//OnHitFloorHook();
+				} else {
+					d.SpeedY[i] = 0;
+					//OnHitCeilingHook();
+				}
 			}
 
-			debris.Scale += debris.ScaleSpeed * timeMult;
-			debris.Angle += debris.AngleSpeed * timeMult;
-			debris.Alpha += debris.AlphaSpeed * timeMult;
+			// If the actor didn't move all the way horizontally,
+			// it hit a wall (or was already touching it)
+			aabb = AABBf(d.PosX[i] - 1, ny - 1, d.PosX[i] + 1, ny + 1);
+			if (IsTileEmpty(aabb, params)) {
+				d.SpeedX[i] = -(0.8f/*elasticity*/ * d.SpeedX[i]);
+				d.AngleSpeed[i] = -(0.8f/*elasticity*/ * d.AngleSpeed[i]);
+				//OnHitWallHook();
+			}
 		}
 	}
 
@@ -1364,37 +1801,202 @@ namespace Jazz2::Tiles
 		viewportRect.W += MaxDebrisSize * 2.0f;
 		viewportRect.H += MaxDebrisSize * 2.0f;
 
-		for (const auto& debris : _debrisList) {
-			if (!viewportRect.Contains(debris.Pos)) {
+		if (DrawDebrisInstanced(renderQueue, viewportRect)) {
+			return;
+		}
+
+		// Fallback for renderer types that don't support instancing, each debris is drawn with its own command
+		std::int32_t count = _debrisList.GetCount();
+		for (std::int32_t i = 0; i < count; i++) {
+			Vector2f pos = Vector2f(_debrisList.PosX[i], _debrisList.PosY[i]);
+			if (!viewportRect.Contains(pos)) {
 				continue;
 			}
 
+			const DebrisAppearance& appearance = _debrisList.Appearance[i];
+
 			auto command = RentRenderCommand(LayerRendererType::Default);
 			command->SetType(RenderCommand::Type::Particle);
 
-			if ((debris.Flags & DebrisFlags::AdditiveBlending) == DebrisFlags::AdditiveBlending) {
+			if ((appearance.Flags & DebrisFlags::AdditiveBlending) == DebrisFlags::AdditiveBlending) {
 				command->GetMaterial().SetBlendingFactors(GL_SRC_ALPHA, GL_ONE);
 			} else {
 				command->GetMaterial().SetBlendingFactors(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 			}
 
 			auto instanceBlock = command->GetMaterial().UniformBlock(Material::InstanceBlockName);
-			instanceBlock->GetUniform(Material::TexRectUniformName)->SetFloatValue(debris.TexScaleX, debris.TexBiasX, debris.TexScaleY, debris.TexBiasY);
-			instanceBlock->GetUniform(Material::SpriteSizeUniformName)->SetFloatValue(debris.Size.X, debris.Size.Y);
-			instanceBlock->GetUniform(Material::ColorUniformName)->SetFloatVector(Colorf(1.0f, 1.0f, 1.0f, debris.Alpha).Data());
-
-			Matrix4x4f worldMatrix = Matrix4x4f::Translation(debris.Pos.X, debris.Pos.Y, 0.0f);
-			worldMatrix.RotateZ(debris.Angle);
-			worldMatrix.Scale(debris.Scale, debris.Scale, 1.0f);
-			worldMatrix.Translate(debris.Size.X  * -0.5f, debris.Size.Y * -0.5f, 0.0f);
+			instanceBlock->GetUniform(Material::TexRectUniformName)->SetFloatVector(appearance.TexRect.Data());
+			instanceBlock->GetUniform(Material::SpriteSizeUniformName)->SetFloatValue(appearance.Size.X, appearance.Size.Y);
+			instanceBlock->GetUniform(Material::ColorUniformName)->SetFloatVector(Colorf(1.0f, 1.0f, 1.0f, _debrisList.Alpha[i]).Data());
+
+			float scale = _debrisList.Scale[i];
+			Matrix4x4f worldMatrix = Matrix4x4f::Translation(pos.X, pos.Y, 0.0f);
+			worldMatrix.RotateZ(_debrisList.Angle[i]);
+			worldMatrix.Scale(scale, scale, 1.0f);
+			worldMatrix.Translate(appearance.Size.X * -0.5f, appearance.Size.Y * -0.5f, 0.0f);
 			command->SetTransformation(worldMatrix);
-			command->SetLayer(debris.Depth);
-			command->GetMaterial().SetTexture(*debris.DiffuseTexture);
+			command->SetLayer(appearance.Depth);
+			command->GetMaterial().SetTexture(*appearance.DiffuseTexture);
 
 			renderQueue.AddCommand(command);
 		}
 	}
 
+	bool TileMap::DrawDebrisInstanced(RenderQueue& renderQueue, const Rectf& viewportRect)
+	{
+		Shader* shader = ContentResolver::Get().GetShader(PrecompiledShader::Debris);
+		if (shader == nullptr || !shader->IsLinked()) {
+			return false;
+		}
+
+		SmallVector<PendingDebrisCommand, 4> pendingCommands;
+		std::int32_t count = _debrisList.GetCount();
+		for (std::int32_t i = 0; i < count; i++) {
+			Vector2f pos = Vector2f(_debrisList.PosX[i], _debrisList.PosY[i]);
+			if (!viewportRect.Contains(pos)) {
+				continue;
+			}
+
+			const DebrisAppearance& appearance = _debrisList.Appearance[i];
+			bool isAdditive = ((appearance.Flags & DebrisFlags::AdditiveBlending) == DebrisFlags::AdditiveBlending);
+
+			PendingDebrisCommand* pending = nullptr;
+			for (auto& item : pendingCommands) {
+				if (item.DiffuseTexture == appearance.DiffuseTexture && item.Depth == appearance.Depth && item.IsAdditive == isAdditive) {
+					pending = &item;
+					break;
+				}
+			}
+
+			if (pending == nullptr || pending->Count >= pending->Capacity) {
+				if (pending == nullptr) {
+					pending = &pendingCommands.emplace_back();
+					pending->DiffuseTexture = appearance.DiffuseTexture;
+					pending->Depth = appearance.Depth;
+					pending->IsAdditive = isAdditive;
+				} else {
+					pending->InstancesBlock->SetUsedSize(GLint(pending->Count * sizeof(DebrisInstance)));
+					pending->Command->GetGeometry().SetDrawParameters(GL_TRIANGLES, 0, 6 * pending->Count);
+				}
+
+				pending->Command = RentDebrisCommand(shader);
+				pending->InstancesBlock = pending->Command->GetMaterial().UniformBlock(Material::InstancesBlockName);
+				DEATH_DEBUG_ASSERT(pending->InstancesBlock != nullptr);
+				pending->Count = 0;
+				pending->Capacity = (pending->InstancesBlock->GetSize() - pending->InstancesBlock->GetAlignAmount()) / std::int32_t(sizeof(DebrisInstance));
+
+				if (isAdditive) {
+					pending->Command->GetMaterial().SetBlendingFactors(GL_SRC_ALPHA, GL_ONE);
+				} else {
+					pending->Command->GetMaterial().SetBlendingFactors(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+				}
+				pending->Command->SetTransformation(Matrix4x4f::Identity);
+				pending->Command->SetLayer(appearance.Depth);
+				pending->Command->GetMaterial().SetTexture(*appearance.DiffuseTexture);
+				renderQueue.AddCommand(pending->Command);
+			}
+
+			DebrisInstance* target = reinterpret_cast<DebrisInstance*>(pending->InstancesBlock->GetDataPointer()) + pending->Count;
+			target->Transform = Vector4f(pos.X, pos.Y, _debrisList.Angle[i], _debrisList.Scale[i]);
+			target->TexRect = appearance.TexRect;
+			target->Size = appearance.Size;
+			target->Alpha = _debrisList.Alpha[i];
+			target->Padding = 0.0f;
+			pending->Count++;
+		}
+
+		for (auto& pending : pendingCommands) {
+			pending.InstancesBlock->SetUsedSize(GLint(pending.Count * sizeof(DebrisInstance)));
+			pending.Command->GetGeometry().SetDrawParameters(GL_TRIANGLES, 0, 6 * pending.Count);
+		}
+
+		return true;
+	}
+
+	RenderCommand* TileMap::RentDebrisCommand(Shader* shader)
+	{
+		RenderCommand* command;
+		if (_debrisCommandsCount < _debrisCommands.size()) {
+			command = _debrisCommands[_debrisCommandsCount].get();
+			_debrisCommandsCount++;
+		} else {
+			command = _debrisCommands.emplace_back(std::make_unique<RenderCommand>(RenderCommand::Type::Particle)).get();
+			_debrisCommandsCount++;
+			command->GetMaterial().SetBlendingEnabled(true);
+		}
+
+		if (command->GetMaterial().SetShader(shader)) {
+			command->GetMaterial().ReserveUniformsDataMemory();
+
+			auto* textureUniform = command->GetMaterial().Uniform(Material::TextureUniformName);
+			if (textureUniform && textureUniform->GetIntValue(0) != 0) {
+				textureUniform->SetIntValue(0); // GL_TEXTURE0
+			}
+		}
+
+		return command;
+	}
+
+	void TileMap::DebrisParticles::Add(const DestructibleDebris& debris)
+	{
+		PosX.push_back(debris.Pos.X);
+		PosY.push_back(debris.Pos.Y);
+		SpeedX.push_back(debris.Speed.X);
+		SpeedY.push_back(debris.Speed.Y);
+		AccelerationX.push_back(debris.Acceleration.X);
+		AccelerationY.push_back(debris.Acceleration.Y);
+		Scale.push_back(debris.Scale);
+		ScaleSpeed.push_back(debris.ScaleSpeed);
+		Angle.push_back(debris.Angle);
+		AngleSpeed.push_back(debris.AngleSpeed);
+		Alpha.push_back(debris.Alpha);
+		AlphaSpeed.push_back(debris.AlphaSpeed);
+		Time.push_back(debris.Time);
+
+		DebrisAppearance& appearance = Appearance.emplace_back();
+		appearance.Size = debris.Size;
+		appearance.TexRect = Vector4f(debris.TexScaleX, debris.TexBiasX, debris.TexScaleY, debris.TexBiasY);
+		appearance.DiffuseTexture = debris.DiffuseTexture;
+		appearance.Depth = debris.Depth;
+		appearance.Flags = debris.Flags;
+	}
+
+	void TileMap::DebrisParticles::RemoveDead()
+	{
+		// Alive debris is moved to the front in a single pass, so the original order is preserved
+		std::int32_t count = GetCount();
+		std::int32_t j = 0;
+		for (std::int32_t i = 0; i < count; i++) {
+			if (Scale[i] <= 0.0f || Alpha[i] <= 0.0f) {
+				continue;
+			}
+			if (i != j) {
+				PosX[j] = PosX[i];
+				PosY[j] = PosY[i];
+				SpeedX[j] = SpeedX[i];
+				SpeedY[j] = SpeedY[i];
+				AccelerationX[j] = AccelerationX[i];
+				AccelerationY[j] = AccelerationY[i];
+				Scale[j] = Scale[i];
+				ScaleSpeed[j] = ScaleSpeed[i];
+				Angle[j] = Angle[i];
+				AngleSpeed[j] = AngleSpeed[i];
+				Alpha[j] = Alpha[i];
+				AlphaSpeed[j] = AlphaSpeed[i];
+				Time[j] = Time[i];
+				Appearance[j] = Appearance[i];
+			}
+			j++;
+		}
+
+		if (j != count) {
+			for (auto* values : { &PosX, &PosY, &SpeedX, &SpeedY, &AccelerationX, &AccelerationY, &Scale, &ScaleSpeed, &Angle, &AngleSpeed, &Alpha, &AlphaSpeed, &Time }) {
+				values->resize(j);
+			}
+			Appearance.resize(j);
+		}
+	}
+
 	bool TileMap::GetTrigger(std::uint8_t triggerId)
 	{
 		return _triggerState[triggerId];
@@ -1423,6 +2025,7 @@ namespace Jazz2::Tiles
 					tile.DestructFrameIndex = (newState ? 1 : 0);
 					tile.TileID = (newState ? 0 /*Empty*/ : tile.DestructAnimation);
 				}
+				InvalidateLayerChunk(_sprLayerIndex, i % layoutSize.X, i / layoutSize.X);
 			}
 		}
 	}
@@ -1430,12 +2033,34 @@ namespace Jazz2::Tiles
 	void TileMap::CreateCheckpointForRollback()
 	{
 		Vector2i layoutSize = _layers[_sprLayerIndex].LayoutSize;
+		LayerTile* layout = _layers[_sprLayerIndex].Layout.get();
+		std::memcpy(_triggerStateForRollback.data(), _triggerState.data(), _triggerState.sizeInBytes());
+
 		if (_sprLayerForRollback == nullptr) {
 			_sprLayerForRollback = std::make_unique<LayerTile[]>(layoutSize.X * layoutSize.Y);
+			std::memcpy(_sprLayerForRollback.get(), layout, layoutSize.X * layoutSize.Y * sizeof(LayerTile));
+			_dirtyChunksStride = (layoutSize.X + LayerChunkSize - 1) / LayerChunkSize;
+			_dirtyChunksForRollback.resize(ValueInit, _dirtyChunksStride * ((layoutSize.Y + LayerChunkSize - 1) / LayerChunkSize));
+			return;
 		}
 
-		std::memcpy(_sprLayerForRollback.get(), _layers[_sprLayerIndex].Layout.get(), layoutSize.X * layoutSize.Y * sizeof(LayerTile));
-		std::memcpy(_triggerStateForRollback.data(), _triggerState.data(), _triggerState.sizeInBytes());
+		// Chunks that weren't changed since the last checkpoint are already the same
+		for (std::size_t i = 0; i < _dirtyChunksForRollback.size(); i++) {
+			if (!_dirtyChunksForRollback[i]) {
+				continue;
+			}
+
+			std::int32_t x1 = std::int32_t(i % _dirtyChunksStride) * LayerChunkSize;
+			std::int32_t y1 = std::int32_t(i / _dirtyChunksStride) * LayerChunkSize;
+			std::int32_t width = std::min(LayerChunkSize, layoutSize.X - x1);
+			std::int32_t y2 = std::min(y1 + LayerChunkSize, layoutSize.Y);
+			for (std::int32_t y = y1; y < y2; y++) {
+				std::int32_t offset = y * layoutSize.X + x1;
+				std::memcpy(&_sprLayerForRollback[offset], &layout[offset], width * sizeof(LayerTile));
+			}
+		}
+
+		_dirtyChunksForRollback.resetAll();
 	}
 
 	void TileMap::RollbackToCheckpoint()
@@ -1445,8 +2070,28 @@ namespace Jazz2::Tiles
 		}
 
 		Vector2i layoutSize = _layers[_sprLayerIndex].LayoutSize;
-		std::memcpy(_layers[_sprLayerIndex].Layout.get(), _sprLayerForRollback.get(), layoutSize.X * layoutSize.Y * sizeof(LayerTile));
+		LayerTile* layout = _layers[_sprLayerIndex].Layout.get();
 		std::memcpy(_triggerState.data(), _triggerStateForRollback.data(), _triggerState.sizeInBytes());
+
+		for (std::size_t i = 0; i < _dirtyChunksForRollback.size(); i++) {
+			if (!_dirtyChunksForRollback[i]) {
+				continue;
+			}
+
+			std::int32_t x1 = std::int32_t(i % _dirtyChunksStride) * LayerChunkSize;
+			std::int32_t y1 = std::int32_t(i / _dirtyChunksStride) * LayerChunkSize;
+			std::int32_t width = std::min(LayerChunkSize, layoutSize.X - x1);
+			std::int32_t y2 = std::min(y1 + LayerChunkSize, layoutSize.Y);
+			for (std::int32_t y = y1; y < y2; y++) {
+				std::int32_t offset = y * layoutSize.X + x1;
+				std::memcpy(&layout[offset], &_sprLayerForRollback[offset], width * sizeof(LayerTile));
+			}
+
+			// Only geometry of restored chunks has to be rebuilt
+			InvalidateLayerChunk(_sprLayerIndex, x1, y1);
+		}
+
+		_dirtyChunksForRollback.resetAll();
 	}
 
 	void TileMap::InitializeFromStream(Stream& src)
@@ -1463,35 +2108,14 @@ namespace Jazz2::Tiles
 		DEATH_ASSERT(layoutSize == realLayoutSize, "Layout size mismatch", );
 
 		for (std::int32_t i = 0; i < layoutSize; i++) {
-			auto& tile = spriteLayer.Layout[i];
-			tile.DestructFrameIndex = src.ReadVariableInt32();
-			if (tile.DestructAnimation >= 0) {
-				if (tile.DestructAnimation >= _animatedTilesOffset) {
-					if (tile.DestructAnimation - _animatedTilesOffset < (std::int32_t)_animatedTiles.size()) {
-						auto& anim = _animatedTiles[tile.DestructAnimation - _animatedTilesOffset];
-						std::int32_t max = (std::int32_t)anim.Tiles.size() - 2;
-						if (tile.DestructFrameIndex > max) {
-							LOGW("Serialized tile {} with animation frame {} is out of range", i, tile.DestructFrameIndex);
-							tile.DestructFrameIndex = max;
-						}
-						if (tile.DestructFrameIndex < 0) {
-							LOGW("Serialized tile {} with animation frame {} is out of range", i, tile.DestructFrameIndex);
-							tile.DestructFrameIndex = 0;
-						}
-						tile.TileID = anim.Tiles[tile.DestructFrameIndex].TileID;
-					} else {
-						LOGW("Invalid animated tile ID {}", tile.DestructAnimation);
-					}
-				} else {
-					if (tile.DestructFrameIndex >= 1) {
-						tile.DestructFrameIndex = 1;
-						tile.TileID = 0; // Empty tile
-					}
-				}
-			}
+			ApplyDestructFrameIndex(spriteLayer.Layout[i], src.ReadVariableInt32(), i);
 		}
 
 		src.Read(_triggerState.data(), _triggerState.sizeInBytes());
+		_layoutVersion++;
+		if (!_dirtyChunksForRollback.empty()) {
+			_dirtyChunksForRollback.setAll();
+		}
 	}
 
 	void TileMap::SerializeResumableToStream(Stream& dest, bool fromCheckpoint)
@@ -1516,6 +2140,173 @@ namespace Jazz2::Tiles
 		}
 	}
 
+	void TileMap::InitializeFromSparseStream(Stream& src)
+	{
+		std::int32_t layoutSize = src.ReadVariableInt32();
+		if (layoutSize == -1) {
+			return;
+		}
+
+		DEATH_ASSERT(_sprLayerIndex != -1, "Sprite layer not defined", );
+
+		auto& spriteLayer = _layers[_sprLayerIndex];
+		std::int32_t realLayoutSize = spriteLayer.LayoutSize.X * spriteLayer.LayoutSize.Y;
+		DEATH_ASSERT(layoutSize == realLayoutSize, "Layout size mismatch", );
+
+		bool isDelta = (src.ReadValue<std::uint8_t>() != 0);
+		if (!isDelta) {
+			// Tiles that are not included are in the initial state
+			for (std::int32_t i = 0; i < layoutSize; i++) {
+				if (spriteLayer.Layout[i].DestructFrameIndex != 0) {
+					ApplyDestructFrameIndex(spriteLayer.Layout[i], 0, i);
+				}
+			}
+		}
+
+		std::uint32_t runCount = src.ReadVariableUint32();
+		std::int32_t i = 0;
+		for (std::uint32_t j = 0; j < runCount; j++) {
+			std::uint32_t gap = src.ReadVariableUint32();
+			std::uint32_t length = src.ReadVariableUint32();
+			if (gap > std::uint32_t(layoutSize - i) || length > std::uint32_t(layoutSize - i) - gap) {
+				LOGW("Serialized tile run at {} with length {} is out of range", i + gap, length);
+				break;
+			}
+
+			i += std::int32_t(gap);
+			for (std::uint32_t k = 0; k < length; k++, i++) {
+				ApplyDestructFrameIndex(spriteLayer.Layout[i], src.ReadVariableInt32(), i);
+			}
+		}
+
+		src.Read(_triggerState.data(), _triggerState.sizeInBytes());
+		_layoutVersion++;
+		if (!_dirtyChunksForRollback.empty()) {
+			_dirtyChunksForRollback.setAll();
+		}
+	}
+
+	void TileMap::SerializeSparseToStream(Stream& dest)
+	{
+		if (_sprLayerIndex == -1) {
+			dest.WriteVariableInt32(-1);
+			return;
+		}
+
+		WriteSparseTiles(dest, _layers[_sprLayerIndex].Layout.get(), nullptr, false, _triggerState);
+	}
+
+	void TileMap::SerializeCheckpointDeltaToStream(Stream& dest)
+	{
+		if (_sprLayerIndex == -1) {
+			dest.WriteVariableInt32(-1);
+			return;
+		}
+
+		if (_sprLayerForRollback == nullptr) {
+			// Nothing would be changed by the rollback
+			WriteSparseTiles(dest, _layers[_sprLayerIndex].Layout.get(), _layers[_sprLayerIndex].Layout.get(), true, _triggerState);
+		} else {
+			WriteSparseTiles(dest, _sprLayerForRollback.get(), _layers[_sprLayerIndex].Layout.get(), true, _triggerStateForRollback, &_dirtyChunksForRollback);
+		}
+	}
+
+	void TileMap::MarkTileDirtyForRollback(std::int32_t tx, std::int32_t ty)
+	{
+		if (_dirtyChunksForRollback.empty() || tx < 0 || ty < 0) {
+			return;
+		}
+
+		std::size_t chunkIdx = std::size_t((tx / LayerChunkSize) + (ty / LayerChunkSize) * _dirtyChunksStride);
+		if (tx / LayerChunkSize < _dirtyChunksStride && chunkIdx < _dirtyChunksForRollback.size()) {
+			_dirtyChunksForRollback.set(chunkIdx);
+		}
+	}
+
+	void TileMap::ApplyDestructFrameIndex(LayerTile& tile, std::int32_t frameIndex, std::int32_t index)
+	{
+		tile.DestructFrameIndex = frameIndex;
+		if (tile.DestructAnimation < 0) {
+			return;
+		}
+
+		if (tile.DestructAnimation >= _animatedTilesOffset) {
+			if (tile.DestructAnimation - _animatedTilesOffset < (std::int32_t)_animatedTiles.size()) {
+				auto& anim = _animatedTiles[tile.DestructAnimation - _animatedTilesOffset];
+				std::int32_t max = (std::int32_t)anim.Tiles.size() - 2;
+				if (tile.DestructFrameIndex > max) {
+					LOGW("Serialized tile {} with animation frame {} is out of range", index, tile.DestructFrameIndex);
+					tile.DestructFrameIndex = max;
+				}
+				if (tile.DestructFrameIndex < 0) {
+					LOGW("Serialized tile {} with animation frame {} is out of range", index, tile.DestructFrameIndex);
+					tile.DestructFrameIndex = 0;
+				}
+				tile.TileID = anim.Tiles[tile.DestructFrameIndex].TileID;
+			} else {
+				LOGW("Invalid animated tile ID {}", tile.DestructAnimation);
+			}
+		} else {
+			if (tile.DestructFrameIndex >= 1) {
+				tile.DestructFrameIndex = 1;
+				tile.TileID = 0; // Empty tile
+			} else {
+				// Tile could be destroyed before, restore the original tile
+				tile.DestructFrameIndex = 0;
+				tile.TileID = tile.DestructAnimation;
+			}
+		}
+	}
+
+	void TileMap::WriteSparseTiles(Stream& dest, const LayerTile* source, const LayerTile* baseline, bool isDelta, BitArray& triggerState, const BitArray* dirtyChunks)
+	{
+		// Tiles are written in runs of changed tiles, unchanged tiles between close runs are included,
+		// because they take less space than a new run
+		constexpr std::int32_t MaxGapInRun = 2;
+
+		auto& spriteLayer = _layers[_sprLayerIndex];
+		std::int32_t layoutSize = spriteLayer.LayoutSize.X * spriteLayer.LayoutSize.Y;
+
+		SmallVector<Pair<std::int32_t, std::int32_t>, 0> runs;
+		for (std::int32_t y = 0; y < spriteLayer.LayoutSize.Y; y++) {
+			for (std::int32_t x = 0; x < spriteLayer.LayoutSize.X; x++) {
+				if (dirtyChunks != nullptr && !(*dirtyChunks)[(x / LayerChunkSize) + (y / LayerChunkSize) * _dirtyChunksStride]) {
+					// Tiles in chunks that weren't changed are the same in both layouts
+					x += LayerChunkSize - 1 - (x % LayerChunkSize);
+					continue;
+				}
+
+				std::int32_t i = x + y * spriteLayer.LayoutSize.X;
+				std::int32_t baselineValue = (baseline != nullptr ? baseline[i].DestructFrameIndex : 0);
+				if (source[i].DestructFrameIndex == baselineValue) {
+					continue;
+				}
+
+				if (!runs.empty() && i - (runs.back().first() + runs.back().second()) <= MaxGapInRun) {
+					runs.back().second() = i - runs.back().first() + 1;
+				} else {
+					runs.emplace_back(i, 1);
+				}
+			}
+		}
+
+		dest.WriteVariableInt32(layoutSize);
+		dest.WriteValue<std::uint8_t>(isDelta ? 1 : 0);
+		dest.WriteVariableUint32(std::uint32_t(runs.size()));
+
+		std::int32_t last = 0;
+		for (const auto& run : runs) {
+			dest.WriteVariableUint32(std::uint32_t(run.first() - last));
+			dest.WriteVariableUint32(std::uint32_t(run.second()));
+			for (std::int32_t i = run.first(); i < run.first() + run.second(); i++) {
+				dest.WriteVariableInt32(source[i].DestructFrameIndex);
+			}
+			last = run.first() + run.second();
+		}
+
+		dest.Write(triggerState.data(), triggerState.sizeInBytes());
+	}
+
 	void TileMap::RenderTexturedBackground(RenderQueue& renderQueue, const Rectf& cullingRect, Vector2f viewCenter, TileMapLayer& layer, float x, float y)
 	{
 		auto target = _texturedBackgroundPass._target.get();
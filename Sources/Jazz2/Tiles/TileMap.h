@@ -168,6 +168,8 @@ namespace Jazz2::Tiles
 		static constexpr std::int32_t TriggerCount = 32;
 		/** @brief Hardcoded offset for layer positioning */
 		static constexpr std::int32_t HardcodedOffset = 70;
+		/** @brief Size of cached tile layer chunks in tiles */
+		static constexpr std::int32_t LayerChunkSize = 16;
 
 		/** @} */
 
@@ -256,6 +258,22 @@ namespace Jazz2::Tiles
 		bool IsTileEmpty(const AABBf& aabb, TileCollisionParams& params);
 		/** @brief Returns `true` if tiles on the main (sprite) layer intersecting a given AABB can be destroyed */
 		bool CanBeDestroyed(const AABBf& aabb, TileCollisionParams& params);
+		/**
+		 * @brief Returns the first vertical offset at which tiles on the main (sprite) layer may not block a given AABB
+		 *
+		 * Offsets are tried from @p startY down to @p endY in @p step decrements, all with the same horizontal offset
+		 * @p offsetX. The tiles in the probed range are scanned only once. An offset is skipped only if @ref IsTileEmpty()
+		 * would return `false` for it without any side effects (e.g., destroying tiles), so the returned offset still
+		 * has to be verified by the caller. Zero offset is never skipped. If all offsets are blocked, a value lower than
+		 * @p endY is returned. If @p reducedHitbox is `true`, tall hitboxes are checked in parts, see @ref SplitReducedHitbox().
+		 */
+		float FindFirstEmptyOffsetY(const AABBf& aabb, float offsetX, float startY, float endY, float step, const TileCollisionParams& params, bool reducedHitbox);
+		/**
+		 * @brief Splits a tall hitbox into top and bottom parts which are checked separately
+		 *
+		 * Used for actors with reduced tile collisions. Returns `false` if the hitbox is not tall enough to be split.
+		 */
+		static bool SplitReducedHitbox(const AABBf& aabb, AABBf& top, AABBf& bottom);
 		/** @brief Returns suspend state of a given position */
 		SuspendType GetTileSuspendState(float x, float y);
 		/** @brief Advances descructible animation of a given tile */
@@ -296,15 +314,26 @@ namespace Jazz2::Tiles
 		/** @brief Sets state of a given trigger */
 		void SetTrigger(std::uint8_t triggerId, bool newState);
 
-		/** @brief Creates a checkpoint for eventual rollback */
+		/** @brief Creates a checkpoint for eventual rollback, only chunks changed since the last checkpoint are copied */
 		void CreateCheckpointForRollback();
-		/** @brief Rolls back to the last checkpoint */
+		/** @brief Rolls back to the last checkpoint, only chunks changed since the last checkpoint are restored */
 		void RollbackToCheckpoint();
 
 		/** @brief Initializes tile map state from a stream */
 		void InitializeFromStream(Stream& src);
 		/** @brief Serializes tile map state to a stream */
 		void SerializeResumableToStream(Stream& dest, bool fromCheckpoint = false);
+		/** @brief Initializes tile map state from a stream in sparse format */
+		void InitializeFromSparseStream(Stream& src);
+		/** @brief Serializes tile map state to a stream in sparse format, only tiles that differ from the initial state are included */
+		void SerializeSparseToStream(Stream& dest);
+		/**
+		 * @brief Serializes changes that @ref RollbackToCheckpoint() would make to a stream in sparse format
+		 *
+		 * It must be called before @ref RollbackToCheckpoint(), the stream can be then applied by @ref InitializeFromSparseStream()
+		 * to a tile map with the same state as this one had before the rollback.
+		 */
+		void SerializeCheckpointDeltaToStream(Stream& dest);
 
 		/** @brief Called when the viewport needs to be initialized (e.g., when the resolution is changed) */
 		void OnInitializeViewport();
@@ -346,6 +375,95 @@ namespace Jazz2::Tiles
 			SmallVector<std::unique_ptr<RenderCommand>, 0> _renderCommands;
 			bool _alreadyRendered;
 		};
+
+		// Layout must match `Instance` struct of `TileLayerVs` shader (std140)
+		struct TileInstance {
+			Vector4f TexRect;
+			Vector4f Color;
+			Vector2f Position;
+			float Padding[2];
+		};
+
+		static_assert(sizeof(TileInstance) == 48, "TileInstance must match std140 layout");
+
+		struct TileLayerBatch {
+			TileSet* Source;
+			SmallVector<TileInstance, 0> Instances;
+		};
+
+		// Prebuilt tile instances of a fixed-size part of a layer relative to its top-left corner, it's rebuilt only
+		// if any of its tiles changes, so static layers don't need to resolve any tile again
+		struct TileLayerChunk {
+			std::uint32_t LayoutVersion;
+			std::uint32_t AnimationVersion;
+			bool IsValid;
+			bool HasAnimatedTiles;
+			SmallVector<TileLayerBatch, 1> Batches;
+		};
+
+		struct TileLayerChunks {
+			Vector2i ChunkCount;
+			Vector4f Color;
+			SmallVector<TileLayerChunk, 0> Chunks;
+		};
+
+		// Instanced command that is being filled with chunks of a layer
+		struct PendingTileLayerCommand {
+			TileSet* Source;
+			RenderCommand* Command;
+			GLUniformBlockCache* InstancesBlock;
+			std::int32_t Count;
+			std::int32_t Capacity;
+		};
+
+		// Properties of debris that don't change during its lifetime
+		struct DebrisAppearance {
+			Vector2f Size;
+			Vector4f TexRect;
+			Texture* DiffuseTexture;
+			std::uint16_t Depth;
+			DebrisFlags Flags;
+		};
+
+		// Debris stored as a structure of arrays, so all particles can be integrated in tight loops
+		struct DebrisParticles {
+			SmallVector<float, 0> PosX, PosY;
+			SmallVector<float, 0> SpeedX, SpeedY;
+			SmallVector<float, 0> AccelerationX, AccelerationY;
+			SmallVector<float, 0> Scale, ScaleSpeed;
+			SmallVector<float, 0> Angle, AngleSpeed;
+			SmallVector<float, 0> Alpha, AlphaSpeed;
+			SmallVector<float, 0> Time;
+			SmallVector<DebrisAppearance, 0> Appearance;
+
+			std::int32_t GetCount() const {
+				return std::int32_t(Appearance.size());
+			}
+
+			void Add(const DestructibleDebris& debris);
+			void RemoveDead();
+		};
+
+		struct DebrisInstance {
+			Vector4f Transform;
+			Vector4f TexRect;
+			Vector2f Size;
+			float Alpha;
+			float Padding;
+		};
+
+		static_assert(sizeof(DebrisInstance) == 48, "DebrisInstance must match std140 layout of the shader");
+
+		// Instanced command that is being filled with debris of the same texture, depth and blending
+		struct PendingDebrisCommand {
+			Texture* DiffuseTexture;
+			std::uint16_t Depth;
+			bool IsAdditive;
+			RenderCommand* Command;
+			GLUniformBlockCache* InstancesBlock;
+			std::int32_t Count;
+			std::int32_t Capacity;
+		};
 #endif
 
 		ITileMapOwner* _owner;
@@ -355,6 +473,9 @@ namespace Jazz2::Tiles
 		SmallVector<TileSetPart, 2> _tileSets;
 		SmallVector<TileMapLayer, 0> _layers;
 		std::unique_ptr<LayerTile[]> _sprLayerForRollback;
+		// Chunks of sprite layer changed since the last checkpoint, empty until the first checkpoint is created
+		BitArray _dirtyChunksForRollback;
+		std::int32_t _dirtyChunksStride;
 		SmallVector<AnimatedTile, 0> _animatedTiles;
 		SmallVector<Vector2i, 0> _activeCollapsingTiles;
 		float _collapsingTimer;
@@ -362,24 +483,45 @@ namespace Jazz2::Tiles
 		BitArray _triggerState;
 		BitArray _triggerStateForRollback;
 
-		SmallVector<DestructibleDebris, 0> _debrisList;
+		DebrisParticles _debrisList;
+		SmallVector<std::unique_ptr<RenderCommand>, 0> _debrisCommands;
+		std::int32_t _debrisCommandsCount;
 		SmallVector<std::unique_ptr<RenderCommand>, 0> _renderCommands;
 		std::int32_t _renderCommandsCount;
+		SmallVector<std::unique_ptr<RenderCommand>, 0> _tileLayerCommands;
+		std::int32_t _tileLayerCommandsCount;
+		SmallVector<TileLayerChunks, 0> _layerChunks;
+		std::int32_t _drawnTilesCount;
+		// Incremented on every change of layer layouts or animated tiles, so cached tile instances can be invalidated
+		std::uint32_t _layoutVersion;
+		std::uint32_t _animationVersion;
 
 		std::int32_t _texturedBackgroundLayer;
 		TexturedBackgroundPass _texturedBackgroundPass;
 
 		void DrawLayer(RenderQueue& renderQueue, TileMapLayer& layer, const Rectf& cullingRect, Vector2f viewCenter);
+		bool DrawLayerInstanced(RenderQueue& renderQueue, TileMapLayer& layer, float x1, float y1, float x3, float y3, std::int32_t tileAbsX, std::int32_t tileAbsY);
+		static void GetVisibleLayerChunks(std::int32_t first, std::int32_t count, std::int32_t size, bool repeat, float origin, SmallVector<Pair<std::int32_t, float>, 8>& result);
+		void BuildLayerChunk(TileMapLayer& layer, TileLayerChunk& chunk, std::int32_t chunkX, std::int32_t chunkY);
+		void FinishTileLayerCommand(PendingTileLayerCommand& pending);
+		void InvalidateLayerChunk(std::int32_t layerIndex, std::int32_t tx, std::int32_t ty);
+		RenderCommand* RentTileLayerCommand(Shader* shader);
 		static float TranslateCoordinate(float coordinate, float speed, float offset, std::int32_t viewSize, bool isY);
 		RenderCommand* RentRenderCommand(LayerRendererType type);
 
 		bool AdvanceDestructibleTileAnimation(LayerTile& tile, std::int32_t tx, std::int32_t ty, std::int32_t& amount, StringView soundName);
+		void ApplyDestructFrameIndex(LayerTile& tile, std::int32_t frameIndex, std::int32_t index);
+		void WriteSparseTiles(Stream& dest, const LayerTile* source, const LayerTile* baseline, bool isDelta, BitArray& triggerState, const BitArray* dirtyChunks = nullptr);
+		void MarkTileDirtyForRollback(std::int32_t tx, std::int32_t ty);
 		void AdvanceCollapsingTileTimers(float timeMult);
 		void SetTileDestructibleEventParams(LayerTile& tile, TileDestructType type, std::uint16_t tileParams);
 		std::int32_t GetTileDestructibleFrameCount(const LayerTile& tile);
 
 		void UpdateDebris(float timeMult);
+		void CollideDebris(std::int32_t index, float timeMult);
 		void DrawDebris(RenderQueue& renderQueue);
+		bool DrawDebrisInstanced(RenderQueue& renderQueue, const Rectf& viewportRect);
+		RenderCommand* RentDebrisCommand(Shader* shader);
 
 		void RenderTexturedBackground(RenderQueue& renderQueue, const Rectf& cullingRect, Vector2f viewCenter, TileMapLayer& layer, float x, float y);
 
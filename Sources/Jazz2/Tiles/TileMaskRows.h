@@ -0,0 +1,78 @@
+﻿#pragma once
+
+#include "../../Main.h"
+
+#include <Cpu.h>
+
+#if defined(DEATH_ENABLE_AVX2)
+#	include <IntrinsicsAvx.h>
+#elif defined(DEATH_ENABLE_SSE2)
+#	include <IntrinsicsSse2.h>
+#endif
+
+namespace Jazz2::Tiles
+{
+	/** @brief Returns bit mask of columns from @p left to @p right (inclusive) in a bit-packed mask row */
+	inline std::uint32_t GetMaskRowColumns(std::int32_t left, std::int32_t right)
+	{
+		return (0xFFFFFFFFu >> (31 - right)) & (0xFFFFFFFFu << left);
+	}
+
+	/** @brief Returns `true` if any of @p count bit-packed mask rows has a bit set in @p columnMask */
+	using IsAnyMaskRowSolidFunction = bool(*)(const std::uint32_t* rows, std::int32_t count, std::uint32_t columnMask);
+
+	inline IsAnyMaskRowSolidFunction isAnyMaskRowSolidImplementation(Death::Cpu::ScalarT) {
+		return [](const std::uint32_t* rows, std::int32_t count, std::uint32_t columnMask) {
+			std::uint32_t result = 0;
+			for (std::int32_t i = 0; i < count; i++) {
+				result |= rows[i];
+			}
+			return (result & columnMask) != 0;
+		};
+	}
+
+#if defined(DEATH_ENABLE_SSE2)
+	DEATH_ENABLE_SSE2 inline IsAnyMaskRowSolidFunction isAnyMaskRowSolidImplementation(Death::Cpu::Sse2T) {
+		return [](const std::uint32_t* rows, std::int32_t count, std::uint32_t columnMask) DEATH_ENABLE_SSE2 {
+			// OR all rows together 4 at a time, only the remaining rows are processed one by one
+			__m128i result = _mm_setzero_si128();
+			std::int32_t i = 0;
+			for (; i + 4 <= count; i += 4) {
+				result = _mm_or_si128(result, _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows + i)));
+			}
+			result = _mm_and_si128(result, _mm_set1_epi32(std::int32_t(columnMask)));
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(result, _mm_setzero_si128())) != 0xFFFF) {
+				return true;
+			}
+
+			std::uint32_t rest = 0;
+			for (; i < count; i++) {
+				rest |= rows[i];
+			}
+			return (rest & columnMask) != 0;
+		};
+	}
+#endif
+
+#if defined(DEATH_ENABLE_AVX2)
+	DEATH_ENABLE_AVX2 inline IsAnyMaskRowSolidFunction isAnyMaskRowSolidImplementation(Death::Cpu::Avx2T) {
+		return [](const std::uint32_t* rows, std::int32_t count, std::uint32_t columnMask) DEATH_ENABLE_AVX2 {
+			// OR all rows together 8 at a time, only the remaining rows are processed one by one
+			__m256i result = _mm256_setzero_si256();
+			std::int32_t i = 0;
+			for (; i + 8 <= count; i += 8) {
+				result = _mm256_or_si256(result, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows + i)));
+			}
+			if (!_mm256_testz_si256(result, _mm256_set1_epi32(std::int32_t(columnMask)))) {
+				return true;
+			}
+
+			std::uint32_t rest = 0;
+			for (; i < count; i++) {
+				rest |= rows[i];
+			}
+			return (rest & columnMask) != 0;
+		};
+	}
+#endif
+}
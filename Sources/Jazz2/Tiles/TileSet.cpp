@@ -1,9 +1,21 @@
 ﻿#include "TileSet.h"
 
+#include "TileMaskRows.h"
+
+using namespace Death;
+
 namespace Jazz2::Tiles
 {
+	extern bool DEATH_CPU_DISPATCHED_DECLARATION(isAnyMaskRowSolid)(const std::uint32_t* rows, std::int32_t count, std::uint32_t columnMask);
+	DEATH_CPU_DISPATCHER_DECLARATION(isAnyMaskRowSolid)
+
+	DEATH_CPU_DISPATCHER_BASE(isAnyMaskRowSolidImplementation)
+	DEATH_CPU_DISPATCHED(isAnyMaskRowSolidImplementation, bool DEATH_CPU_DISPATCHED_DECLARATION(isAnyMaskRowSolid)(const std::uint32_t* rows, std::int32_t count, std::uint32_t columnMask))({
+		return isAnyMaskRowSolidImplementation(Cpu::DefaultBase)(rows, count, columnMask);
+	})
+
 	TileSet::TileSet(StringView path, std::uint16_t tileCount, std::unique_ptr<Texture> textureDiffuse, std::unique_ptr<uint8_t[]> mask, std::uint32_t maskSize, std::unique_ptr<Color[]> captionTile)
-		: FilePath(path), TextureDiffuse(std::move(textureDiffuse)), _mask(std::move(mask)), _captionTile(std::move(captionTile)),
+		: FilePath(path), TextureDiffuse(std::move(textureDiffuse)), _captionTile(std::move(captionTile)),
 			_isMaskEmpty(), _isMaskFilled(), _isTileFilled()
 	{
 		// TilesPerRow is used only for rendering
@@ -19,6 +31,10 @@ namespace Jazz2::Tiles
 		_isMaskFilled.resize(ValueInit, TileCount);
 		_isTileFilled.resize(ValueInit, TileCount);
 
+		// Masks are stored bit-packed, one 32-bit word per row, tiles without mask data are considered empty
+		_maskRowsStorage = std::make_unique<std::uint32_t[]>(TileCount * DefaultTileSize);
+		_maskRows = _maskRowsStorage.get();
+
 		std::uint32_t maskMaxTiles = maskSize / (DefaultTileSize * DefaultTileSize);
 
 		for (std::uint32_t i = 0; i < tileCount; i++) {
@@ -26,25 +42,31 @@ namespace Jazz2::Tiles
 			bool maskFilled = true;
 
 			if (i < maskMaxTiles) {
-				auto* maskOffset = &_mask[i * DefaultTileSize * DefaultTileSize];
-				for (std::int32_t j = 0; j < DefaultTileSize * DefaultTileSize; j++) {
-					bool masked = (maskOffset[j] > 0);
-					maskEmpty &= !masked;
-					maskFilled &= masked;
-				}
+				PackTileMask(i, &mask[i * DefaultTileSize * DefaultTileSize], maskEmpty, maskFilled);
 			}
 
-			if (maskEmpty) {
-				_isMaskEmpty.set(i);
-			}
-			if (maskFilled) {
-				_isMaskFilled.set(i);
-			}
+			UpdateTileMaskFlags(i, maskEmpty, maskFilled);
+		}
+	}
+
+	TileSet::TileSet(StringView path, std::uint16_t tileCount, std::shared_ptr<const std::uint32_t> sharedMaskRows)
+		: FilePath(path), TilesPerRow(0), _maskRows(sharedMaskRows.get()), _sharedMaskRows(std::move(sharedMaskRows)), _isMaskEmpty(), _isMaskFilled(), _isTileFilled()
+	{
+		TileCount = tileCount;
+		_isMaskEmpty.resize(ValueInit, TileCount);
+		_isMaskFilled.resize(ValueInit, TileCount);
+		_isTileFilled.resize(ValueInit, TileCount);
 
-			// TODO: _isTileFilled is not properly set
-			if (/*tileFilled ||*/ !maskEmpty) {
-				_isTileFilled.set(i);
+		for (std::int32_t i = 0; i < TileCount; i++) {
+			const std::uint32_t* rows = &_maskRows[i * DefaultTileSize];
+			std::uint32_t filledRows = 0xFFFFFFFFu;
+			std::uint32_t anyRows = 0;
+			for (std::int32_t y = 0; y < DefaultTileSize; y++) {
+				filledRows &= rows[y];
+				anyRows |= rows[y];
 			}
+
+			UpdateTileMaskFlags(i, anyRows == 0, filledRows == 0xFFFFFFFFu);
 		}
 	}
 
@@ -67,20 +89,67 @@ namespace Jazz2::Tiles
 			return false;
 		}
 
-		auto* maskOffset = &_mask[tileId * DefaultTileSize * DefaultTileSize];
-
-		bool maskEmpty = true;
-		bool maskFilled = true;
-		for (std::int32_t j = 0; j < DefaultTileSize * DefaultTileSize; j++) {
-			maskOffset[j] = tileMask[j];
-			bool masked = (tileMask[j] > 0);
-			maskEmpty &= !masked;
-			maskFilled &= masked;
+		// Shared mask rows are read-only, so they need to be copied first
+		if (_maskRowsStorage == nullptr) {
+			_maskRowsStorage = std::make_unique<std::uint32_t[]>(TileCount * DefaultTileSize);
+			std::memcpy(_maskRowsStorage.get(), _maskRows, TileCount * DefaultTileSize * sizeof(std::uint32_t));
+			_maskRows = _maskRowsStorage.get();
+			_sharedMaskRows = nullptr;
 		}
 
+		bool maskEmpty, maskFilled;
+		PackTileMask(tileId, tileMask.data(), maskEmpty, maskFilled);
+
 		_isMaskEmpty.set(tileId, maskEmpty);
 		_isMaskFilled.set(tileId, maskFilled);
 
 		return true;
 	}
+
+	bool TileSet::IsTileMaskSolidInRect(std::int32_t tileId, std::int32_t left, std::int32_t top, std::int32_t right, std::int32_t bottom) const
+	{
+		if (tileId >= TileCount || left > right || top > bottom) {
+			return false;
+		}
+
+		static_assert(DefaultTileSize == 32, "Mask rows must fit into 32-bit words");
+		DEATH_DEBUG_ASSERT(left >= 0 && right < DefaultTileSize && top >= 0 && bottom < DefaultTileSize);
+
+		return isAnyMaskRowSolid(&_maskRows[tileId * DefaultTileSize + top], bottom - top + 1, GetMaskRowColumns(left, right));
+	}
+
+	void TileSet::UpdateTileMaskFlags(std::int32_t tileId, bool maskEmpty, bool maskFilled)
+	{
+		if (maskEmpty) {
+			_isMaskEmpty.set(tileId);
+		}
+		if (maskFilled) {
+			_isMaskFilled.set(tileId);
+		}
+
+		// TODO: _isTileFilled is not properly set
+		if (/*tileFilled ||*/ !maskEmpty) {
+			_isTileFilled.set(tileId);
+		}
+	}
+
+	void TileSet::PackTileMask(std::int32_t tileId, const std::uint8_t* mask, bool& maskEmpty, bool& maskFilled)
+	{
+		std::uint32_t* rows = &_maskRowsStorage[tileId * DefaultTileSize];
+		std::uint32_t filledRows = 0xFFFFFFFFu;
+		std::uint32_t anyRows = 0;
+
+		for (std::int32_t y = 0; y < DefaultTileSize; y++) {
+			std::uint32_t row = 0;
+			for (std::int32_t x = 0; x < DefaultTileSize; x++) {
+				row |= std::uint32_t(mask[y * DefaultTileSize + x] > 0) << x;
+			}
+			rows[y] = row;
+			filledRows &= row;
+			anyRows |= row;
+		}
+
+		maskEmpty = (anyRows == 0);
+		maskFilled = (filledRows == 0xFFFFFFFFu);
+	}
 }
\ No newline at end of file
@@ -24,6 +24,8 @@ namespace Jazz2::Tiles
 		static constexpr std::int32_t DefaultTileSize = 32;
 
 		TileSet(StringView path, std::uint16_t tileCount, std::unique_ptr<Texture> textureDiffuse, std::unique_ptr<std::uint8_t[]> mask, std::uint32_t maskSize, std::unique_ptr<Color[]> captionTile);
+		/** @brief Creates a tile set without texture that uses shared bit-packed mask rows, they are kept alive by the tile set */
+		TileSet(StringView path, std::uint16_t tileCount, std::shared_ptr<const std::uint32_t> sharedMaskRows);
 
 		/** @brief Relative path to source file */
 		String FilePath;
@@ -34,16 +36,24 @@ namespace Jazz2::Tiles
 		/** @brief Number of tiles per row */
 		std::int32_t TilesPerRow;
 
-		/** @brief Returns mask for specified tile */
-		std::uint8_t* GetTileMask(std::int32_t tileId) const
+		/**
+		 * @brief Returns bit-packed mask rows for specified tile
+		 *
+		 * Each tile has @ref DefaultTileSize rows, bit @f$ x @f$ of a row is set if pixel @f$ x @f$ of the row is solid.
+		 * A tile mask takes 128 bytes, which is 1/8 of the original mask with one byte per pixel.
+		 */
+		const std::uint32_t* GetTileMaskRows(std::int32_t tileId) const
 		{
 			if (tileId >= TileCount) {
 				return nullptr;
 			}
 
-			return &_mask[tileId * DefaultTileSize * DefaultTileSize];
+			return &_maskRows[tileId * DefaultTileSize];
 		}
 
+		/** @brief Returns `true` if any pixel of the mask of a tile is solid in the specified (inclusive) rectangle */
+		bool IsTileMaskSolidInRect(std::int32_t tileId, std::int32_t left, std::int32_t top, std::int32_t right, std::int32_t bottom) const;
+
 		/** @brief Returns `true` if the mask of a tile is completely empty */
 		bool IsTileMaskEmpty(std::int32_t tileId) const
 		{
@@ -86,10 +96,15 @@ namespace Jazz2::Tiles
 		bool OverrideTileMask(std::int32_t tileId, StaticArrayView<DefaultTileSize * DefaultTileSize, std::uint8_t> tileMask);
 
 	private:
-		std::unique_ptr<uint8_t[]> _mask;
+		const std::uint32_t* _maskRows;
+		std::unique_ptr<std::uint32_t[]> _maskRowsStorage;
+		std::shared_ptr<const std::uint32_t> _sharedMaskRows;
 		std::unique_ptr<Color[]> _captionTile;
 		BitArray _isMaskEmpty;
 		BitArray _isMaskFilled;
 		BitArray _isTileFilled;
+
+		void UpdateTileMaskFlags(std::int32_t tileId, bool maskEmpty, bool maskFilled);
+		void PackTileMask(std::int32_t tileId, const std::uint8_t* mask, bool& maskEmpty, bool& maskFilled);
 	};
 }
\ No newline at end of file
@@ -16,10 +16,14 @@
 #include "nCine/IAppEventHandler.h"
 #include "nCine/tracy.h"
 #include "nCine/Base/Random.h"
+#include "nCine/Base/TimeStamp.h"
 #include "nCine/Graphics/BinaryShaderCache.h"
 #include "nCine/Graphics/RenderResources.h"
 #include "nCine/Input/IInputEventHandler.h"
 #include "nCine/Threading/Thread.h"
+#if defined(WITH_THREADS)
+#	include "nCine/Threading/ThreadPool.h"
+#endif
 
 #include "Jazz2/IRootController.h"
 #include "Jazz2/ContentResolver.h"
@@ -90,7 +94,9 @@ public:
 
 #if defined(WITH_MULTIPLAYER)
 	static constexpr std::uint16_t MultiplayerDefaultPort = 7438;
-	static constexpr std::uint32_t MultiplayerProtocolVersion = 1;
+	static constexpr std::uint32_t MultiplayerProtocolVersion = 4;
+	// Oldest client protocol version that is still compatible with the server
+	static constexpr std::uint32_t MultiplayerMinProtocolVersion = 4;
 #endif
 
 	void OnPreInitialize(AppConfiguration& config) override;
@@ -151,8 +157,25 @@ private:
 #endif
 	String _newestVersion;
 #if defined(WITH_MULTIPLAYER)
+	/** @brief Authentication request that couldn't be processed yet, because the level was not ready */
+	struct DeferredAuthPacket {
+		Peer RemotePeer;
+		std::uint8_t ChannelId;
+		std::int32_t Attempts;
+		TimeStamp LastAttempt;
+		SmallVector<std::uint8_t, 0> Data;
+	};
+
 	std::unique_ptr<NetworkManager> _networkManager;
 	std::unique_ptr<Stream> _streamedAsset;
+	String _streamedAssetPath;
+	std::int64_t _streamedAssetSize;
+	std::uint32_t _streamedAssetCrc32;
+	SmallVector<DeferredAuthPacket, 0> _deferredAuthPackets;
+#endif
+#if defined(WITH_MULTIPLAYER) && defined(WITH_THREADS) && !defined(DEATH_TARGET_EMSCRIPTEN)
+	// Additional server sessions hosted by the same process, each has its own port and level, but they share cached content
+	SmallVector<std::unique_ptr<GameEventHandler>, 0> _serverSessions;
 #endif
 
 	void OnBeginInitialize();
@@ -169,9 +192,14 @@ private:
 #if defined(DEATH_TARGET_ANDROID)
 	void ApplyActivityIcon();
 #endif
+#if defined(WITH_MULTIPLAYER)
+	void ProcessDeferredAuthPackets();
+#endif
 #if defined(WITH_MULTIPLAYER) && defined(WITH_THREADS) && !defined(DEATH_TARGET_EMSCRIPTEN)
-	void RunDedicatedServer(StringView configPath);
+	void RunDedicatedServer(ArrayView<const StringView> configPaths, StringView capturePath = {}, StringView replayPath = {});
+	void ShutdownServerSessions();
 	void StartProcessingStdin();
+	static ServerInitialization LoadServerInitialization(StringView configPath);
 #endif
 	static void WriteCacheDescriptor(StringView path, std::uint64_t currentVersion, std::int64_t animsModified);
 	static void SaveEpisodeEnd(const LevelInitialization& levelInit);
@@ -185,8 +213,15 @@ void GameEventHandler::OnPreInitialize(AppConfiguration& config)
 
 #if defined(WITH_MULTIPLAYER) && defined(DEDICATED_SERVER)
 	constexpr bool isServer = true;
+	for (std::int32_t i = 0; i < config.argc(); i++) {
+		if (config.argv(i) == "/capture-summary"_s && i + 1 < config.argc()) {
+			PacketCaptureReader::Summarize(config.argv(i + 1));
+			theApplication().Quit();
+			return;
+		}
+	}
 #elif defined(DEATH_TARGET_APPLE) || defined(DEATH_TARGET_UNIX) || (defined(DEATH_TARGET_WINDOWS) && !defined(DEATH_TARGET_WINDOWS_RT))
-	// Allow `/extract-pak` and `/server` only on PC platforms
+	// Allow `/extract-pak`, `/capture-summary` and `/server` only on PC platforms
 	bool isServer = false;
 	for (std::int32_t i = 0; i < config.argc(); i++) {
 		auto arg = config.argv(i);
@@ -205,6 +240,16 @@ void GameEventHandler::OnPreInitialize(AppConfiguration& config)
 			theApplication().Quit();
 			return;
 		}
+#	if defined(WITH_MULTIPLAYER)
+		if (arg == "/capture-summary"_s && i + 1 < config.argc()) {
+#		if defined(DEATH_TRACE) && defined(DEATH_TARGET_WINDOWS)
+			theApplication().AttachTraceTarget(Application::ConsoleTarget);
+#		endif
+			PacketCaptureReader::Summarize(config.argv(i + 1));
+			theApplication().Quit();
+			return;
+		}
+#	endif
 #	if defined(WITH_MULTIPLAYER) && (!defined(DEATH_TARGET_WINDOWS) || defined(DEATH_DEBUG))
 		if (arg == "/server"_s || arg == "--server"_s) {
 			isServer = true;
@@ -222,7 +267,8 @@ void GameEventHandler::OnPreInitialize(AppConfiguration& config)
 		config.withGraphics = false;
 		config.withAudio = false;
 		config.withVSync = false;
-		config.frameLimit = (std::uint32_t)FrameTimer::FramesPerSecond;
+		// Server runs the simulation at fixed rate, it can be changed later by the server configuration
+		config.fixedTickRate = (std::uint32_t)FrameTimer::FramesPerSecond;
 
 		auto& resolver = ContentResolver::Get();
 		resolver.SetHeadless(true);
@@ -292,12 +338,21 @@ void GameEventHandler::OnInitialize()
 #endif
 
 #if defined(WITH_MULTIPLAYER) && defined(DEDICATED_SERVER)
+	// Each specified configuration file starts an independent session in this process
 	const AppConfiguration& config = theApplication().GetAppConfiguration();
-	StringView configPath;
-	if (config.argc() > 0) {
-		configPath = config.argv(0);
+	SmallVector<StringView, 4> configPaths;
+	StringView capturePath, replayPath;
+	for (std::int32_t i = 0; i < config.argc(); i++) {
+		auto arg = config.argv(i);
+		if (arg == "/capture"_s && i + 1 < config.argc()) {
+			capturePath = config.argv(++i);
+		} else if (arg == "/replay"_s && i + 1 < config.argc()) {
+			replayPath = config.argv(++i);
+		} else {
+			configPaths.push_back(arg);
+		}
 	}
-	RunDedicatedServer(configPath);
+	RunDedicatedServer(configPaths, capturePath, replayPath);
 #else
 #	if defined(DEATH_TARGET_APPLE) || defined(DEATH_TARGET_UNIX) || (defined(DEATH_TARGET_WINDOWS) && !defined(DEATH_TARGET_WINDOWS_RT))
 	const AppConfiguration& config = theApplication().GetAppConfiguration();
@@ -354,7 +409,7 @@ void GameEventHandler::OnInitialize()
 			if (i + 1 < config.argc()) {
 				configPath = config.argv(i + 1);
 			}
-			RunDedicatedServer(configPath);
+			RunDedicatedServer(arrayView(&configPath, configPath.empty() ? 0 : 1));
 			return;
 		}
 #			endif
@@ -403,6 +458,13 @@ void GameEventHandler::OnInitialize()
 
 void GameEventHandler::OnBeginFrame()
 {
+#if defined(WITH_MULTIPLAYER)
+	if (_networkManager != nullptr) {
+		// Received events are dispatched before pending callbacks, so callbacks invoked by packet handlers run in the same frame
+		_networkManager->ProcessReceivedPackets();
+	}
+#endif
+
 	if (!_pendingCallbacks.empty()) {
 		ZoneScopedNC("Pending callbacks", 0x888888);
 
@@ -439,12 +501,38 @@ void GameEventHandler::OnBeginFrame()
 		_pendingCallbacks.clear();
 	}
 
-	_currentHandler->OnBeginFrame();
+#if defined(WITH_MULTIPLAYER)
+	if (_networkManager != nullptr && !_deferredAuthPackets.empty()) {
+		ProcessDeferredAuthPackets();
+	}
+#endif
+
+	// Upload resources preloaded on background threads
+	ContentResolver::Get().ProcessPendingLoads();
+
+	if (_currentHandler != nullptr) {
+		_currentHandler->OnBeginFrame();
+	}
+
+#if defined(WITH_MULTIPLAYER) && defined(WITH_THREADS) && !defined(DEATH_TARGET_EMSCRIPTEN)
+	// Sessions are stepped one after another, so each of them is still single-threaded
+	for (auto& session : _serverSessions) {
+		session->OnBeginFrame();
+	}
+#endif
 }
 
 void GameEventHandler::OnPostUpdate()
 {
-	_currentHandler->OnEndFrame();
+	if (_currentHandler != nullptr) {
+		_currentHandler->OnEndFrame();
+	}
+
+#if defined(WITH_MULTIPLAYER) && defined(WITH_THREADS) && !defined(DEATH_TARGET_EMSCRIPTEN)
+	for (auto& session : _serverSessions) {
+		session->OnPostUpdate();
+	}
+#endif
 
 	if (_backInvokedTimeLeft > 0) {
 		_backInvokedTimeLeft--;
@@ -482,6 +570,10 @@ void GameEventHandler::OnShutdown()
 	ApplyActivityIcon();
 #endif
 
+#if defined(WITH_MULTIPLAYER) && defined(WITH_THREADS) && !defined(DEATH_TARGET_EMSCRIPTEN)
+	ShutdownServerSessions();
+#endif
+
 	_currentHandler = nullptr;
 #if defined(WITH_MULTIPLAYER)
 	if (_networkManager != nullptr) {
@@ -850,13 +942,91 @@ void GameEventHandler::ApplyActivityIcon()
 #endif
 
 #if defined(WITH_MULTIPLAYER) && defined(WITH_THREADS) && !defined(DEATH_TARGET_EMSCRIPTEN)
-void GameEventHandler::RunDedicatedServer(StringView configPath)
+void GameEventHandler::RunDedicatedServer(ArrayView<const StringView> configPaths, StringView capturePath, StringView replayPath)
 {
 	if (PreferencesCache::FirstRun) {
 		// Save the preferences immediately if the config file doesn't exist
 		PreferencesCache::Save();
 	}
 
+	SmallVector<ServerInitialization, 1> sessionInits;
+	if (!configPaths.empty()) {
+		for (StringView configPath : configPaths) {
+			sessionInits.push_back(LoadServerInitialization(configPath));
+		}
+	} else {
+		sessionInits.push_back(LoadServerInitialization({}));
+	}
+
+	for (std::size_t i = 1; i < sessionInits.size(); i++) {
+		for (std::size_t j = 0; j < i; j++) {
+			if (sessionInits[i].Configuration.ServerPort == sessionInits[j].Configuration.ServerPort) {
+				LOGE("Server cannot be started because multiple sessions use the same port {}", sessionInits[i].Configuration.ServerPort);
+				theApplication().Quit();
+				return;
+			}
+		}
+	}
+
+	// All sessions are stepped by the same fixed-rate loop, so only the tick rate of the first session is used
+	std::uint32_t tickRate = sessionInits[0].Configuration.TickRate;
+	for (std::size_t i = 1; i < sessionInits.size(); i++) {
+		if (sessionInits[i].Configuration.TickRate != tickRate) {
+			LOGW("Session #{} has different tick rate than the first session, using {} ticks per second instead", i, tickRate);
+		}
+	}
+	theApplication().SetFixedTickRate(tickRate);
+
+	WaitForVerify();
+
+	if (sessionInits.size() > 1) {
+		// Level handlers of other sessions can still use resources released by the loading level otherwise
+		ContentResolver::Get().SetCacheShared(true);
+		_flags |= Flags::HasMultipleSessions;
+		LOGI("Hosting {} sessions in one process", sessionInits.size());
+	}
+
+	for (std::size_t i = 0; i < sessionInits.size(); i++) {
+		GameEventHandler* session = this;
+		if (i > 0) {
+			auto& additionalSession = _serverSessions.emplace_back(std::make_unique<GameEventHandler>());
+			additionalSession->_flags = _flags;
+			session = additionalSession.get();
+		}
+		if (!session->CreateServer(std::move(sessionInits[i]))) {
+			LOGE("Server cannot be started because of invalid configuration");
+			theApplication().Quit();
+			return;
+		}
+	}
+
+	// Packets are captured and replayed only in the first session
+	if (!capturePath.empty()) {
+		_networkManager->StartCapture(capturePath);
+	}
+	if (!replayPath.empty() && !_networkManager->StartReplay(replayPath, []() { theApplication().Quit(); })) {
+		theApplication().Quit();
+		return;
+	}
+
+	StartProcessingStdin();
+}
+
+void GameEventHandler::ShutdownServerSessions()
+{
+	for (auto& session : _serverSessions) {
+		session->_currentHandler = nullptr;
+		if (session->_networkManager != nullptr) {
+			session->_networkManager->Dispose();
+			session->_networkManager = nullptr;
+			session->_streamedAsset = nullptr;
+		}
+	}
+	_serverSessions.clear();
+}
+
+ServerInitialization GameEventHandler::LoadServerInitialization(StringView configPath)
+{
 	ServerInitialization serverInit;
 	if (!configPath.empty()) {
 		serverInit.Configuration = NetworkManager::LoadServerConfigurationFromFile(configPath);
@@ -874,15 +1044,7 @@ void GameEventHandler::RunDedicatedServer(StringView configPath)
 			Random().Shuffle<PlaylistEntry>(serverInit.Configuration.Playlist);
 		}
 	}
-
-	WaitForVerify();
-	if (!CreateServer(std::move(serverInit))) {
-		LOGE("Server cannot be started because of invalid configuration");
-		theApplication().Quit();
-		return;
-	} 
-
-	StartProcessingStdin();
+	return serverInit;
 }
 
 void GameEventHandler::StartProcessingStdin()
@@ -924,7 +1086,24 @@ void GameEventHandler::StartProcessingStdin()
 					}
 					theApplication().Quit();
 					break;
-				} else if (auto levelHandler = runtime_cast<MpLevelHandler>(_this->_currentHandler)) {
+				}
+
+				// Commands are processed by the first session, unless other session is specified by `/session <index> …`
+				GameEventHandler* session = _this;
+				if (line.hasPrefix("/session "_s)) {
+					auto [sessionIndex, sep, sessionLine] = line.exceptPrefix("/session "_s).trimmedPrefix().partition(' ');
+					std::uint32_t index = stou32(sessionIndex.data(), sessionIndex.size());
+					if (index > _this->_serverSessions.size() || sessionLine.empty()) {
+						LOGW("Session #{} doesn't exist, {} sessions are running", sessionIndex, _this->_serverSessions.size() + 1);
+						continue;
+					}
+					if (index > 0) {
+						session = _this->_serverSessions[index - 1].get();
+					}
+					line = sessionLine.trimmed();
+				}
+
+				if (auto levelHandler = runtime_cast<MpLevelHandler>(session->_currentHandler)) {
 					if (!levelHandler->ProcessCommand({}, line, true) && !line.hasPrefix('/')) {
 						levelHandler->SendMessageToAll(line, true);
 					}
@@ -1018,8 +1197,9 @@ ConnectionResult GameEventHandler::OnPeerConnected(const Peer& peer, std::uint32
 	LOGI("[MP] Peer connected ({}) [{}]", _networkManager->AddressToString(peer), peer);
 
 	if (_networkManager->GetState() == NetworkState::Listening) {
-		if ((clientData & 0xFFF00000) != 0xDEA00000 || (clientData & 0x000FFFFF) > MultiplayerProtocolVersion) {
-			// Connected client is newer than server, reject it
+		if ((clientData & 0xFFF00000) != 0xDEA00000 || (clientData & 0x000FFFFF) > MultiplayerProtocolVersion ||
+			(clientData & 0x000FFFFF) < MultiplayerMinProtocolVersion) {
+			// Connected client is newer or too old for the server, reject it
 			LOGI("[MP] Peer kicked ({}) [{}]: Incompatible protocol version", _networkManager->AddressToString(peer), peer);
 			return Reason::IncompatibleVersion;
 		}
@@ -1087,6 +1267,13 @@ void GameEventHandler::OnPeerDisconnected(const Peer& peer, Reason reason)
 		LOGI("[MP] Peer disconnected [{}]: {} ({})", peer, NetworkManagerBase::ReasonToString(reason), reason);
 	}
 
+	// Disconnections are dispatched in order with packets, so deferred packets of this peer can be dropped safely
+	for (std::size_t i = _deferredAuthPackets.size(); i > 0; i--) {
+		if (_deferredAuthPackets[i - 1].RemotePeer == peer) {
+			_deferredAuthPackets.erase(_deferredAuthPackets.begin() + (i - 1));
+		}
+	}
+
 	if (auto multiLevelHandler = runtime_cast<MpLevelHandler>(_currentHandler)) {
 		if (multiLevelHandler->OnPeerDisconnected(peer)) {
 			return;
@@ -1267,16 +1454,49 @@ void GameEventHandler::OnPacketReceived(const Peer& peer, std::uint8_t channelId
 					packetOut.WriteVariableUint32((std::uint32_t)path.size());
 					packetOut.Write(path.data(), (std::int64_t)path.size());
 
-					auto fullPath = MpLevelHandler::GetAssetFullPath(type, path, _networkManager->GetServerConfiguration().UniqueServerID);
+					std::int64_t size = packet.ReadVariableInt64();
+					std::uint32_t crc32 = packet.ReadValue<std::uint32_t>();
+
+					auto& serverId = _networkManager->GetServerConfiguration().UniqueServerID;
+					std::int64_t localSize = 0;
+					std::uint32_t localCrc32 = 0;
+					std::int64_t resumeOffset = 0;
+
+					auto fullPath = MpLevelHandler::GetAssetFullPath(type, path, serverId);
 					if (!fullPath.empty()) {
 						auto s = fs::Open(fullPath, FileAccess::Read);
+						localSize = s->GetSize();
+						localCrc32 = nCine::crc32(*s);
+					}
 
-						packetOut.WriteVariableInt64(s->GetSize());
-						packetOut.WriteValue<std::uint32_t>(nCine::crc32(*s));
-					} else {
-						packetOut.WriteVariableInt64(0);
-						packetOut.WriteValue<std::uint32_t>(0);
+					if (localSize != size || localCrc32 != crc32) {
+						// The same asset could be already downloaded from another server
+						String cachedPath = MpLevelHandler::GetCachedAssetPath(crc32);
+						if (fs::IsReadableFile(cachedPath) && fs::GetFileSize(cachedPath) == size) {
+							auto targetPath = MpLevelHandler::GetAssetFullPath(type, path, serverId, true);
+							if (!targetPath.empty()) {
+								fs::CreateDirectories(fs::GetDirectoryName(targetPath));
+								if (fs::Copy(cachedPath, targetPath)) {
+									LOGI("[MP] Asset \"{}\" ({}) found in download cache", path, type);
+									localSize = size;
+									localCrc32 = crc32;
+								}
+							}
+						} else {
+							// Partially downloaded asset is resumed
+							String partialPath = cachedPath + ".part"_s;
+							if (fs::IsReadableFile(partialPath)) {
+								std::int64_t partialSize = fs::GetFileSize(partialPath);
+								if (partialSize > 0 && partialSize < size) {
+									resumeOffset = partialSize;
+								}
+							}
+						}
 					}
+
+					packetOut.WriteVariableInt64(localSize);
+					packetOut.WriteValue<std::uint32_t>(localCrc32);
+					packetOut.WriteVariableInt64(resumeOffset);
 				}
 
 				_networkManager->SendTo(peer, NetworkChannel::Main, (std::uint8_t)ClientPacketType::ValidateAssetsResponse, packetOut);
@@ -1284,46 +1504,93 @@ void GameEventHandler::OnPacketReceived(const Peer& peer, std::uint8_t channelId
 			}
 			case ServerPacketType::StreamAsset: {
 				MemoryStream packet(data);
-				std::uint8_t flags = packet.ReadValue<std::uint8_t>();
+				AssetStreamer::PacketType streamPacketType = (AssetStreamer::PacketType)packet.ReadValue<std::uint8_t>();
 
-				switch (flags & 0x0f) {
-					case 1: { // Begin
+				switch (streamPacketType) {
+					case AssetStreamer::PacketType::Begin: {
 						MpLevelHandler::AssetType type = (MpLevelHandler::AssetType)packet.ReadValue<std::uint8_t>();
 						std::uint32_t pathLength = packet.ReadVariableUint32();
 						String path{NoInit, pathLength};
 						packet.Read(path.data(), pathLength);
 						std::int64_t size = packet.ReadVariableInt64();
+						std::uint32_t crc32 = packet.ReadValue<std::uint32_t>();
+						std::int64_t offset = packet.ReadVariableInt64();
 
-						LOGI("[MP] Downloading asset \"{}\" ({}) with {} bytes", path, type, size);
-
-						auto fullPath = MpLevelHandler::GetAssetFullPath(type, path, _networkManager->GetServerConfiguration().UniqueServerID, true);
-						if (!fullPath.empty()) {
-							fs::CreateDirectories(fs::GetDirectoryName(fullPath));
+						LOGI("[MP] Downloading asset \"{}\" ({}) with {} bytes from offset {}", path, type, size, offset);
 
-							_streamedAsset = fs::Open(fullPath, FileAccess::Write);
+						_streamedAsset = nullptr;
+						_streamedAssetPath = MpLevelHandler::GetAssetFullPath(type, path, _networkManager->GetServerConfiguration().UniqueServerID, true);
+						_streamedAssetSize = size;
+						_streamedAssetCrc32 = crc32;
+
+						if (!_streamedAssetPath.empty()) {
+							// Asset is downloaded to the shared cache first, so it can be resumed and reused by other servers
+							String partialPath = MpLevelHandler::GetCachedAssetPath(crc32) + ".part"_s;
+							fs::CreateDirectories(fs::GetDirectoryName(partialPath));
+
+							if (offset > 0) {
+								_streamedAsset = fs::Open(partialPath, FileAccess::ReadWrite);
+								if (_streamedAsset->IsValid()) {
+									_streamedAsset->SetSize(offset);
+									_streamedAsset->Seek(0, SeekOrigin::End);
+								}
+							} else {
+								_streamedAsset = fs::Open(partialPath, FileAccess::Write);
+							}
 							if (_streamedAsset->IsValid()) {
 								break;
 							}
 						}
 
 						LOGE("[MP] Failed to create asset \"{}\"", path);
+						_streamedAsset = nullptr;
 						break;
 					}
-					case 2: { // Chunk
-						if (_streamedAsset->IsValid()) {
-							std::int64_t size = packet.ReadVariableInt64();
-							if (const std::uint8_t* ptr = packet.GetCurrentPointer(size)) {
-								_streamedAsset->Write(ptr, size);
+					case AssetStreamer::PacketType::Chunk: {
+						if (_streamedAsset != nullptr) {
+							MemoryStream chunk(AssetStreamer::ChunkSize);
+							if (PacketCodec::Decompress(data.exceptPrefix(1), chunk, AssetStreamer::ChunkSize)) {
+								_streamedAsset->Write(chunk.GetBuffer(), chunk.GetSize());
+							} else {
+								LOGW("[MP] ServerPacketType::StreamAsset - cannot decompress chunk ({} bytes)", data.size());
 							}
 						}
+
+						MemoryStream packetOut(4);
+						packetOut.WriteVariableUint32(1);
+						_networkManager->SendTo(peer, NetworkChannel::Main, (std::uint8_t)ClientPacketType::StreamAssetAck, packetOut);
 						break;
 					}
-					case 3: { // End
-						_streamedAsset = nullptr;
+					case AssetStreamer::PacketType::End: {
+						if (_streamedAsset != nullptr) {
+							_streamedAsset = nullptr;
+
+							String cachedPath = MpLevelHandler::GetCachedAssetPath(_streamedAssetCrc32);
+							String partialPath = cachedPath + ".part"_s;
+							bool isValid;
+							{
+								auto s = fs::Open(partialPath, FileAccess::Read);
+								isValid = (s->GetSize() == _streamedAssetSize && nCine::crc32(*s) == _streamedAssetCrc32);
+							}
+
+							if (isValid) {
+								fs::RemoveFile(cachedPath);
+								fs::Move(partialPath, cachedPath);
+								fs::CreateDirectories(fs::GetDirectoryName(_streamedAssetPath));
+								fs::Copy(cachedPath, _streamedAssetPath);
+							} else {
+								LOGE("[MP] Downloaded asset \"{}\" is corrupted", _streamedAssetPath);
+								fs::RemoveFile(partialPath);
+							}
+						}
+
+						MemoryStream packetOut(4);
+						packetOut.WriteVariableUint32(1);
+						_networkManager->SendTo(peer, NetworkChannel::Main, (std::uint8_t)ClientPacketType::StreamAssetAck, packetOut);
 						break;
 					}
 					default: {
-						LOGD("[MP] ServerPacketType::StreamAsset - unsupported flags (0x{:.2x})", flags);
+						LOGD("[MP] ServerPacketType::StreamAsset - unsupported type ({})", (std::uint32_t)streamPacketType);
 						break;
 					}
 				}
@@ -1396,8 +1663,6 @@ void GameEventHandler::OnPacketReceived(const Peer& peer, std::uint8_t channelId
 		}
 	}
 
-	std::int32_t n = 0;
-Retry:
 	if (auto multiLevelHandler = runtime_cast<MpLevelHandler>(_currentHandler)) {
 		if (multiLevelHandler->OnPacketReceived(peer, channelId, packetType, data)) {
 			return;
@@ -1405,13 +1670,47 @@ Retry:
 	}
 
 	if (isServer && (ClientPacketType)packetType == ClientPacketType::Auth) {
-		// Message was not processed by level handler, kick the client if it fails for too long
-		if (++n < 10) {
-			Thread::Sleep(500);
-			goto Retry;
+		// Message was not processed by level handler, packets are dispatched on the main thread, so retry it in later frames
+		auto& deferred = _deferredAuthPackets.emplace_back();
+		deferred.RemotePeer = peer;
+		deferred.ChannelId = channelId;
+		deferred.Attempts = 1;
+		deferred.LastAttempt = TimeStamp::now();
+		deferred.Data.append(data.begin(), data.end());
+	}
+}
+
+void GameEventHandler::ProcessDeferredAuthPackets()
+{
+	constexpr float RetryIntervalMs = 500.0f;
+	constexpr std::int32_t MaxAttempts = 10;
+
+	std::size_t i = 0;
+	while (i < _deferredAuthPackets.size()) {
+		auto& deferred = _deferredAuthPackets[i];
+		if (deferred.LastAttempt.millisecondsSince() < RetryIntervalMs) {
+			i++;
+			continue;
+		}
+
+		bool processed = false;
+		if (auto multiLevelHandler = runtime_cast<MpLevelHandler>(_currentHandler)) {
+			processed = multiLevelHandler->OnPacketReceived(deferred.RemotePeer, deferred.ChannelId,
+				(std::uint8_t)ClientPacketType::Auth, deferred.Data);
 		}
 
-		_networkManager->Kick(peer, Reason::ServerNotReady);
+		if (!processed && ++deferred.Attempts >= MaxAttempts) {
+			// Kick the client if it fails for too long
+			_networkManager->Kick(deferred.RemotePeer, Reason::ServerNotReady);
+			processed = true;
+		}
+
+		if (processed) {
+			_deferredAuthPackets.erase(_deferredAuthPackets.begin() + i);
+		} else {
+			deferred.LastAttempt = TimeStamp::now();
+			i++;
+		}
 	}
 }
 #endif
@@ -1676,6 +1975,89 @@ RecreateCache:
 	_flags |= Flags::IsVerified | Flags::IsPlayable;
 }
 
+namespace
+{
+	/** @brief Runs independent content conversion jobs in parallel and waits for all of them to finish */
+	class ConversionJobQueue
+	{
+	public:
+		ConversionJobQueue()
+#if defined(WITH_THREADS)
+			: _pendingCount(0), _threadCount(std::max(Thread::GetProcessorCount(), 1u)), _threadPool(_threadCount)
+#endif
+		{
+		}
+
+		/** @brief Enqueues a job, without threading support the job is executed immediately */
+		void Enqueue(Function<void()>&& job)
+		{
+#if defined(WITH_THREADS)
+			_mutex.Lock();
+			_pendingCount++;
+			_mutex.Unlock();
+			_threadPool.EnqueueCommand(std::make_unique<JobCommand>(this, std::move(job)));
+#else
+			job();
+#endif
+		}
+
+		/** @brief Blocks until all enqueued jobs are finished */
+		void WaitForAll()
+		{
+#if defined(WITH_THREADS)
+			_mutex.Lock();
+			while (_pendingCount > 0) {
+				_finishedCV.Wait(_mutex);
+			}
+			_mutex.Unlock();
+#endif
+		}
+
+		/** @brief Returns number of worker threads */
+		std::uint32_t GetThreadCount() const
+		{
+#if defined(WITH_THREADS)
+			return _threadCount;
+#else
+			return 1;
+#endif
+		}
+
+	private:
+#if defined(WITH_THREADS)
+		class JobCommand : public IThreadCommand
+		{
+		public:
+			JobCommand(ConversionJobQueue* owner, Function<void()>&& job)
+				: _owner(owner), _job(std::move(job)) {}
+
+			void Execute() override
+			{
+				_job();
+
+				_owner->_mutex.Lock();
+				_owner->_pendingCount--;
+				if (_owner->_pendingCount == 0) {
+					_owner->_finishedCV.Broadcast();
+				}
+				_owner->_mutex.Unlock();
+			}
+
+		private:
+			ConversionJobQueue* _owner;
+			Function<void()> _job;
+		};
+
+		Mutex _mutex;
+		CondVariable _finishedCV;
+		std::size_t _pendingCount;
+		std::uint32_t _threadCount;
+		// Thread pool must be destroyed first, so worker threads don't outlive the synchronization primitives
+		ThreadPool _threadPool;
+#endif
+	};
+}
+
 void GameEventHandler::RefreshCacheLevels(bool recreateAll)
 {
 	ZoneScopedC(0x888888);
@@ -1834,7 +2216,17 @@ void GameEventHandler::RefreshCacheLevels(bool recreateAll)
 		fs::CreateDirectories(episodesPath);
 	}
 
-	HashMap<String, bool> usedTilesets;
+	// Levels and tilesets are converted in parallel, each into its own file. Source files that differ only in case
+	// would be converted into the same file, so they are grouped into a single job and converted in enumeration order.
+	struct LevelJob {
+		SmallVector<String, 1> SourcePaths;
+		SmallVector<String, 0> UsedTilesets;
+	};
+
+	TimeStamp stageStartTime = TimeStamp::now();
+	SmallVector<LevelJob, 0> levelJobs;
+	HashMap<String, std::size_t> levelJobsByName;
+	std::int32_t episodeCount = 0;
 
 	for (auto item : fs::Directory(fs::FindPathCaseInsensitive(resolver.GetSourcePath()), fs::EnumerationOptions::SkipDirectories)) {
 		auto extension = fs::GetExtension(item);
@@ -1863,14 +2255,15 @@ void GameEventHandler::RefreshCacheLevels(bool recreateAll)
 
 				String fullPath = fs::CombinePath(episodesPath, String((episode.Name == "xmas98"_s ? "xmas99"_s : StringView(episode.Name)) + ".j2e"_s));
 				episode.Convert(fullPath, std::move(LevelTokenConversion), std::move(EpisodeNameConversion), std::move(EpisodePrevNext));
+				episodeCount++;
 			}
 		} else if (extension == "j2l"_s) {
 			// Level
 			String levelName = fs::GetFileNameWithoutExtension(item);
 			if (levelName.find("-MLLE-Data-"_s) == nullptr) {
-				if (!recreateAll) {
-					StringUtils::lowercaseInPlace(levelName);
+				StringUtils::lowercaseInPlace(levelName);
 
+				if (!recreateAll) {
 					String fullPath;
 					auto it = knownLevels.find(levelName);
 					if (it != knownLevels.end()) {
@@ -1888,36 +2281,12 @@ void GameEventHandler::RefreshCacheLevels(bool recreateAll)
 					}
 				}
 
-				Compatibility::JJ2Level level;
-				if (level.Open(item, false)) {
-					String fullPath;
-					auto it = knownLevels.find(level.LevelName);
-					if (it != knownLevels.end()) {
-						if (it->second.second().empty()) {
-							fullPath = fs::CombinePath({ episodesPath, it->second.first(), String(level.LevelName + ".j2l"_s) });
-						} else {
-							fullPath = fs::CombinePath({ episodesPath, it->second.first(), String(it->second.second() + '_' + level.LevelName + ".j2l"_s) });
-						}
-					} else {
-						fullPath = fs::CombinePath({ episodesPath, "unknown"_s, String(level.LevelName + ".j2l"_s) });
-					}
-
-					fs::CreateDirectories(fs::GetDirectoryName(fullPath));
-					level.Convert(fullPath, eventConverter, LevelTokenConversion);
-
-					usedTilesets.emplace(level.Tileset, true);
-					for (auto& extraTileset : level.ExtraTilesets) {
-						usedTilesets.emplace(extraTileset.Name, true);
-					}
-
-					// Also copy level script file if exists
-					StringView foundDot = item.findLastOr('.', item.end());
-					String scriptPath = item.prefix(foundDot.begin()) + ".j2as"_s;
-					auto adjustedPath = fs::FindPathCaseInsensitive(scriptPath);
-					if (fs::IsReadableFile(adjustedPath)) {
-						foundDot = fullPath.findLastOr('.', fullPath.end());
-						fs::Copy(adjustedPath, String(fullPath.prefix(foundDot.begin()) + ".j2as"_s));
-					}
+				auto it = levelJobsByName.find(levelName);
+				if (it != levelJobsByName.end()) {
+					levelJobs[it->second].SourcePaths.emplace_back(item);
+				} else {
+					levelJobsByName.emplace(levelName, levelJobs.size());
+					levelJobs.emplace_back().SourcePaths.emplace_back(item);
 				}
 			}
 		}
@@ -1934,26 +2303,108 @@ void GameEventHandler::RefreshCacheLevels(bool recreateAll)
 #endif
 	}
 
+	float episodesTime = stageStartTime.millisecondsSince();
+
+	// Levels are opened and converted on worker threads, the event converter and the lookup tables are only read there
+	stageStartTime = TimeStamp::now();
+	ConversionJobQueue jobQueue;
+
+	for (auto& levelJob : levelJobs) {
+		jobQueue.Enqueue([&levelJob, &episodesPath, &knownLevels, &eventConverter, &LevelTokenConversion]() {
+			for (auto& item : levelJob.SourcePaths) {
+				Compatibility::JJ2Level level;
+				if (!level.Open(item, false)) {
+					continue;
+				}
+
+				String fullPath;
+				auto it = knownLevels.find(level.LevelName);
+				if (it != knownLevels.end()) {
+					if (it->second.second().empty()) {
+						fullPath = fs::CombinePath({ episodesPath, it->second.first(), String(level.LevelName + ".j2l"_s) });
+					} else {
+						fullPath = fs::CombinePath({ episodesPath, it->second.first(), String(it->second.second() + '_' + level.LevelName + ".j2l"_s) });
+					}
+				} else {
+					fullPath = fs::CombinePath({ episodesPath, "unknown"_s, String(level.LevelName + ".j2l"_s) });
+				}
+
+				fs::CreateDirectories(fs::GetDirectoryName(fullPath));
+				level.Convert(fullPath, eventConverter, LevelTokenConversion);
+
+				levelJob.UsedTilesets.emplace_back(level.Tileset);
+				for (auto& extraTileset : level.ExtraTilesets) {
+					levelJob.UsedTilesets.emplace_back(extraTileset.Name);
+				}
+
+				// Also copy level script file if exists
+				StringView foundDot = item.findLastOr('.', item.end());
+				String scriptPath = item.prefix(foundDot.begin()) + ".j2as"_s;
+				auto adjustedPath = fs::FindPathCaseInsensitive(scriptPath);
+				if (fs::IsReadableFile(adjustedPath)) {
+					foundDot = fullPath.findLastOr('.', fullPath.end());
+					fs::Copy(adjustedPath, String(fullPath.prefix(foundDot.begin()) + ".j2as"_s));
+				}
+			}
+		});
+	}
+
+	jobQueue.WaitForAll();
+	float levelsTime = stageStartTime.millisecondsSince();
+
+	// Results are merged in job order, so the list of used tilesets doesn't depend on the order in which the jobs finished
+	SmallVector<SmallVector<String, 1>, 0> tilesetJobs;
+	HashMap<String, std::size_t> tilesetJobsByName;
+	HashMap<String, bool> usedTilesets;
+	for (auto& levelJob : levelJobs) {
+		for (auto& tilesetName : levelJob.UsedTilesets) {
+			if (!usedTilesets.emplace(tilesetName, true).second) {
+				continue;
+			}
+
+			String lowercaseName = StringUtils::lowercase(tilesetName);
+			auto it = tilesetJobsByName.find(lowercaseName);
+			if (it != tilesetJobsByName.end()) {
+				tilesetJobs[it->second].emplace_back(tilesetName);
+			} else {
+				tilesetJobsByName.emplace(std::move(lowercaseName), tilesetJobs.size());
+				tilesetJobs.emplace_back().emplace_back(tilesetName);
+			}
+		}
+	}
+
+	float tilesetsTime = 0.0f;
 	if (recreateAll || !usedTilesets.empty()) {
 		// Convert only used tilesets
 		LOGI("Converting used tilesets...");
+		stageStartTime = TimeStamp::now();
 		String tilesetsPath = fs::CombinePath(resolver.GetCachePath(), "Tilesets"_s);
 		if (recreateAll) {
 			fs::RemoveDirectoryRecursive(tilesetsPath);
 			fs::CreateDirectories(tilesetsPath);
 		}
 
-		for (auto& pair : usedTilesets) {
-			String tilesetPath = fs::CombinePath(resolver.GetSourcePath(), String(pair.first + ".j2t"_s));
-			auto adjustedPath = fs::FindPathCaseInsensitive(tilesetPath);
-			if (fs::IsReadableFile(adjustedPath)) {
-				Compatibility::JJ2Tileset tileset;
-				if (tileset.Open(adjustedPath, false)) {
-					tileset.Convert(fs::CombinePath({ tilesetsPath, String(pair.first + ".j2t"_s) }));
+		for (auto& tilesetJob : tilesetJobs) {
+			jobQueue.Enqueue([&tilesetJob, &resolver, &tilesetsPath]() {
+				for (auto& tilesetName : tilesetJob) {
+					String tilesetPath = fs::CombinePath(resolver.GetSourcePath(), String(tilesetName + ".j2t"_s));
+					auto adjustedPath = fs::FindPathCaseInsensitive(tilesetPath);
+					if (fs::IsReadableFile(adjustedPath)) {
+						Compatibility::JJ2Tileset tileset;
+						if (tileset.Open(adjustedPath, false)) {
+							tileset.Convert(fs::CombinePath({ tilesetsPath, String(tilesetName + ".j2t"_s) }));
+						}
+					}
 				}
-			}
+			});
 		}
+
+		jobQueue.WaitForAll();
+		tilesetsTime = stageStartTime.millisecondsSince();
 	}
+
+	LOGI("Converted {} episodes in {:.1f} ms, {} levels in {:.1f} ms and {} tilesets in {:.1f} ms using {} threads",
+		episodeCount, episodesTime, levelJobs.size(), levelsTime, usedTilesets.size(), tilesetsTime, jobQueue.GetThreadCount());
 }
 
 void GameEventHandler::CheckUpdates()
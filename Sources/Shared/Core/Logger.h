@@ -40,6 +40,7 @@
 
 #if defined(DEATH_TRACE_ASYNC)
 #	include "../Base/Format.h"
+#	include "../Containers/BoundedSPSCQueue.h"
 #	include "../Containers/StaticArray.h"
 #	include "../Containers/StringStl.h"
 #	include "../Threading/Event.h"
@@ -51,13 +52,6 @@
 #	include <thread>
 #	include <limits>
 
-	// BoundedSPSCQueue includes
-#	if defined(DEATH_TARGET_WINDOWS) || defined(DEATH_TARGET_SWITCH) || defined(DEATH_TARGET_VITA)
-#		include <malloc.h>
-#	else
-#		include <sys/mman.h>
-#	endif
-
 #	if defined(DEATH_TARGET_X86)
 #		if defined(DEATH_TARGET_MSVC)
 #			include <intrin.h>
@@ -171,39 +165,11 @@ namespace Death { namespace Trace {
 		/** @brief Special value for level to force immediate flushing of backtrace storage */
 		static constexpr TraceLevel FlushBacktraceRequested = TraceLevel(UINT8_MAX - 2);
 
-		static constexpr std::size_t CacheLineSize = 64u;
-		static constexpr std::size_t CacheLineAligned = 2 * CacheLineSize;
-
-		constexpr bool IsPowerOfTwo(std::uint64_t number) noexcept {
-			return (number != 0) && ((number & (number - 1)) == 0);
-		}
-
-		template<typename T>
-		constexpr T MaxPowerOfTwo() noexcept {
-			return (std::numeric_limits<T>::max() >> 1) + 1;
-		}
-
-		template<typename T>
-		T NextPowerOfTwo(T n) noexcept {
-			constexpr T maxPowerOf2 = MaxPowerOfTwo<T>();
-
-			if (n >= maxPowerOf2) {
-				return maxPowerOf2;
-			}
-
-			if (IsPowerOfTwo(static_cast<std::uint64_t>(n))) {
-				return n;
-			}
-
-			T result = 1;
-			while (result < n) {
-				result <<= 1;
-			}
-
-			DEATH_DEBUG_ASSERT(IsPowerOfTwo(static_cast<std::uint64_t>(result)));
-
-			return result;
-		}
+		using Containers::Implementation::CacheLineSize;
+		using Containers::Implementation::CacheLineAligned;
+		using Containers::Implementation::IsPowerOfTwo;
+		using Containers::Implementation::MaxPowerOfTwo;
+		using Containers::Implementation::NextPowerOfTwo;
 
 		/** @brief Returns value of timestamp counter on current thread (if supported) */
 		DEATH_ALWAYS_INLINE std::uint64_t rdtsc() noexcept {
@@ -306,247 +272,8 @@ namespace Death { namespace Trace {
 			}
 		};
 
-		/**
-		 * @brief Bounded single-producer single-consumer FIFO queue (ring buffer)
-		 */
-		template<typename T>
-		class BoundedSPSCQueueImpl
-		{
-		public:
-			explicit BoundedSPSCQueueImpl(T capacity, bool hugesPagesEnabled = false, T readerStorePercent = 5)
-				: _capacity(NextPowerOfTwo(capacity)), _capacityMask(_capacity - 1),
-					_bytesPerBatch(static_cast<T>(_capacity * static_cast<double>(readerStorePercent) / 100.0)),
-					_storage(static_cast<std::uint8_t*>(allocAligned(2ULL * static_cast<std::uint64_t>(_capacity), CacheLineAligned, hugesPagesEnabled))),
-					_hugePagesEnabled(hugesPagesEnabled)
-			{
-				std::memset(_storage, 0, 2ULL * static_cast<std::uint64_t>(_capacity));
-
-				_atomicWriterPos.store(0);
-				_atomicReaderPos.store(0);
-
-#	if defined(DEATH_TARGET_X86) && defined(DEATH_TARGET_CLFLUSHOPT) && !defined(DEATH_TARGET_CLANG_CL)
-				// Remove log memory from cache
-				for (std::uint64_t i = 0; i < (2ULL * static_cast<std::uint64_t>(_capacity)); i += CacheLineSize) {
-					_mm_clflush(_storage + i);
-				}
-
-				DEATH_DEBUG_ASSERT(_capacity >= 1024);
-
-				std::uint64_t cacheLines = (_capacity >= 2048 ? 32 : 16);
-
-				for (std::uint64_t i = 0; i < cacheLines; ++i) {
-					_mm_prefetch(reinterpret_cast<char const*>(_storage + (CacheLineSize * i)), _MM_HINT_T0);
-				}
-#	endif
-			}
-
-			~BoundedSPSCQueueImpl() noexcept {
-				freeAligned(_storage);
-			}
-
-			BoundedSPSCQueueImpl(BoundedSPSCQueueImpl const&) = delete;
-			BoundedSPSCQueueImpl& operator=(BoundedSPSCQueueImpl const&) = delete;
-
-			std::uint8_t* prepareWrite(T n) noexcept {
-				if ((_capacity - static_cast<T>(_writerPos - _cachedReaderPos)) < n) {
-					// Not enough space, we need to load reader and re-check
-					_cachedReaderPos = _atomicReaderPos.load(std::memory_order_acquire);
-
-					if ((_capacity - static_cast<T>(_writerPos - _cachedReaderPos)) < n) {
-						return nullptr;
-					}
-				}
-
-				return &_storage[_writerPos & _capacityMask];
-			}
-
-			void finishWrite(T nbytes) noexcept {
-				_writerPos += nbytes;
-			}
-
-			void commitWrite() noexcept {
-				// Set the atomic flag, so the reader can see write
-				_atomicWriterPos.store(_writerPos, std::memory_order_release);
-
-#	if defined(DEATH_TARGET_X86) && defined(DEATH_TARGET_CLFLUSHOPT) && !defined(DEATH_TARGET_CLANG_CL)
-				// Flush writen cache lines
-				flushCacheLines(_lastFlushedWriterPos, _writerPos);
-
-				// Prefetch a future cache line
-				_mm_prefetch(reinterpret_cast<char const*>(_storage + (_writerPos & _capacityMask) + (CacheLineSize * 10)), _MM_HINT_T0);
-#	endif
-			}
-
-			void finishAndCommitWrite(T nbytes) noexcept {
-				finishWrite(nbytes);
-				commitWrite();
-			}
-
-			const std::uint8_t* prepareRead() noexcept {
-				if (empty()) {
-					return nullptr;
-				}
-
-				return &_storage[_readerPos & _capacityMask];
-			}
-
-			void finishRead(T nbytes) noexcept {
-				_readerPos += nbytes;
-			}
-
-			void commitRead() noexcept {
-				if (static_cast<T>(_readerPos - _atomicReaderPos.load(std::memory_order_relaxed)) >= _bytesPerBatch) {
-					_atomicReaderPos.store(_readerPos, std::memory_order_release);
-
-#	if defined(DEATH_TARGET_X86) && defined(DEATH_TARGET_CLFLUSHOPT) && !defined(DEATH_TARGET_CLANG_CL)
-					flushCacheLines(_lastFlushedReaderPos, _readerPos);
-#	endif
-				}
-			}
-
-			/** @brief Checks if the queue is empty, should be called only by the reader */
-			bool empty() const noexcept {
-				if (_writerPosCache == _readerPos) {
-					// if we think the queue is empty we also load the atomic variable to check further
-					_writerPosCache = _atomicWriterPos.load(std::memory_order_acquire);
-
-					if (_writerPosCache == _readerPos) {
-						return true;
-					}
-				}
-
-				return false;
-			}
-
-			T capacity() const noexcept {
-				return static_cast<T>(_capacity);
-			}
-
-			bool hugePagesEnabled() const noexcept {
-				return _hugePagesEnabled;
-			}
-
-		private:
-#	if defined(DEATH_TARGET_X86) && defined(DEATH_TARGET_CLFLUSHOPT) && !defined(DEATH_TARGET_CLANG_CL)
-			static constexpr T CacheLineMask{CacheLineSize - 1};
-#	endif
-
-			const T _capacity;
-			const T _capacityMask;
-			const T _bytesPerBatch;
-			std::uint8_t* _storage{nullptr};
-			const bool _hugePagesEnabled;
-
-			alignas(CacheLineAligned) std::atomic<T> _atomicWriterPos{0};
-			alignas(CacheLineAligned) T _writerPos{0};
-			T _cachedReaderPos{0};
-#	if defined(DEATH_TARGET_X86) && defined(DEATH_TARGET_CLFLUSHOPT) && !defined(DEATH_TARGET_CLANG_CL)
-			T _lastFlushedWriterPos{0};
-#	endif
-
-			alignas(CacheLineAligned) std::atomic<T> _atomicReaderPos{0};
-			alignas(CacheLineAligned) T _readerPos{0};
-			mutable T _writerPosCache{0};
-#	if defined(DEATH_TARGET_X86) && defined(DEATH_TARGET_CLFLUSHOPT) && !defined(DEATH_TARGET_CLANG_CL)
-			T _lastFlushedReaderPos{0};
-#	endif
-
-#	if defined(DEATH_TARGET_X86) && defined(DEATH_TARGET_CLFLUSHOPT) && !defined(DEATH_TARGET_CLANG_CL)
-			// _mm_clflushopt is supported only since Skylake and requires "-mclflushopt" option on GCC/clang, and is undefined on Clang-CL
-			void flushCacheLines(T& last, T offset) noexcept {
-				T lastDiff = last - (last & CacheLineMask);
-				T curDiff = offset - (offset & CacheLineMask);
-
-				if (curDiff > lastDiff) {
-					std::uint8_t* ptr = _storage + (lastDiff & _capacityMask);
-
-					do {
-						_mm_clflushopt(ptr);
-						ptr += CacheLineSize;
-						lastDiff += CacheLineSize;
-					} while (curDiff > lastDiff);
-
-					last = lastDiff;
-				}
-			}
-#	endif
-
-			static std::uint8_t* alignPointer(void* pointer, std::size_t alignment) noexcept {
-				DEATH_DEBUG_ASSERT(IsPowerOfTwo(alignment), "alignment must be a power of two", reinterpret_cast<std::uint8_t*>(pointer));
-				return reinterpret_cast<std::uint8_t*>((reinterpret_cast<std::uintptr_t>(pointer) + (alignment - 1ul)) &
-													~(alignment - 1ul));
-			}
-
-			static void* allocAligned(std::size_t size, std::size_t alignment, DEATH_UNUSED bool hugesPagesEnabled) noexcept {
-#	if defined(DEATH_TARGET_WINDOWS)
-				void* p = _aligned_malloc(size, alignment);
-				DEATH_DEBUG_ASSERT(p != nullptr);
-				return p;
-#	elif defined(DEATH_TARGET_SWITCH) || defined(DEATH_TARGET_VITA)
-				void* p = ::memalign(alignment, size);
-				DEATH_DEBUG_ASSERT(p != nullptr);
-				return p;
-#	else
-				// Calculate the total size including the metadata and alignment
-				constexpr std::size_t MetadataSize = 2u * sizeof(std::size_t);
-				std::size_t totalSize = size + MetadataSize + alignment;
-
-				// Allocate the memory
-				int flags = MAP_PRIVATE | MAP_ANONYMOUS;
-
-#		if defined(__linux__)
-				if (hugesPagesEnabled) {
-					flags |= MAP_HUGETLB;
-				}
-#		endif
-
-				void* mem = ::mmap(nullptr, totalSize, PROT_READ | PROT_WRITE, flags, -1, 0);
-
-#		if defined(__linux__)
-				if (mem == MAP_FAILED && hugesPagesEnabled) {
-					flags &= ~MAP_HUGETLB;
-					mem = ::mmap(nullptr, totalSize, PROT_READ | PROT_WRITE, flags, -1, 0);
-				}
-#		endif
-
-				DEATH_DEBUG_ASSERT(mem != MAP_FAILED, ("mmap() failed with error {} ({})", errno, strerror(errno)), nullptr);
-
-				// Calculate the aligned address after the metadata
-				std::uint8_t* alignedAddress = alignPointer(static_cast<std::uint8_t*>(mem) + MetadataSize, alignment);
-
-				// Calculate the offset from the original memory location
-				std::size_t offset = static_cast<std::size_t>(alignedAddress - static_cast<std::uint8_t*>(mem));
-
-				// Store the size and offset information in the metadata
-				std::memcpy(alignedAddress - sizeof(std::size_t), &totalSize, sizeof(totalSize));
-				std::memcpy(alignedAddress - (2u * sizeof(std::size_t)), &offset, sizeof(offset));
-
-				return alignedAddress;
-#	endif
-			}
-
-			static void freeAligned(void* ptr) noexcept {
-#	if defined(DEATH_TARGET_WINDOWS)
-				_aligned_free(ptr);
-#	elif defined(DEATH_TARGET_SWITCH) || defined(DEATH_TARGET_VITA)
-				::free(ptr);
-#	else
-				// Retrieve the size and offset information from the metadata
-				std::size_t offset;
-				std::memcpy(&offset, static_cast<std::uint8_t*>(ptr) - (2u * sizeof(std::size_t)), sizeof(offset));
-
-				std::size_t totalSize;
-				std::memcpy(&totalSize, static_cast<std::uint8_t*>(ptr) - sizeof(std::size_t), sizeof(totalSize));
-
-				// Calculate the original memory block address
-				void* mem = static_cast<std::uint8_t*>(ptr) - offset;
-
-				::munmap(mem, totalSize);
-#	endif
-			}
-		};
-
-		using BoundedSPSCQueue = BoundedSPSCQueueImpl<std::size_t>;
+		using Containers::BoundedSPSCQueueImpl;
+		using Containers::BoundedSPSCQueue;
 
 		/**
 			@brief Unbounded single-producer single-consumer FIFO queue (ring buffer)
@@ -1,6 +1,7 @@
 #include "PakFile.h"
 #include "BoundedFileStream.h"
 #include "FileSystem.h"
+#include "MemoryStream.h"
 #include "Compression/DeflateStream.h"
 #include "Compression/Lz4Stream.h"
 #include "Compression/ZstdStream.h"
@@ -240,15 +241,27 @@ namespace Death { namespace IO {
 		return -1;
 	}
 	
+	/** @brief Read-only stream over a file in memory-mapped `.pak` file, it keeps the mapping alive */
+	class MappedBoundedStream : public MemoryStream
+	{
+	public:
+		MappedBoundedStream(std::shared_ptr<const void> mapping, const char* data, std::uint32_t size)
+			: MemoryStream(data, size), _mapping(std::move(mapping)) {}
+
+	private:
+		std::shared_ptr<const void> _mapping;
+	};
+
 #if defined(WITH_ZLIB) || defined(WITH_MINIZ) || defined(WITH_LZ4) || defined(WITH_ZSTD)
 
 	using namespace Death::IO::Compression;
 
-	template<class T>
+	template<class T, class TUnderlying>
 	class CompressedBoundedStream : public Stream
 	{
 	public:
-		CompressedBoundedStream(StringView path, std::uint64_t offset, std::uint32_t uncompressedSize, std::uint32_t compressedSize, std::int32_t bufferSize);
+		template<class ...Args>
+		CompressedBoundedStream(std::uint32_t uncompressedSize, std::uint32_t compressedSize, Args&&... underlyingArgs);
 
 		CompressedBoundedStream(const CompressedBoundedStream&) = delete;
 		CompressedBoundedStream& operator=(const CompressedBoundedStream&) = delete;
@@ -264,71 +277,72 @@ namespace Death { namespace IO {
 		std::int64_t SetSize(std::int64_t size) override;
 
 	private:
-		BoundedFileStream _underlyingStream;
+		TUnderlying _underlyingStream;
 		T _compressedStream;
 		std::int64_t _uncompressedSize;
 	};
 
-	template<class T>
-	CompressedBoundedStream<T>::CompressedBoundedStream(StringView path, std::uint64_t offset, std::uint32_t uncompressedSize, std::uint32_t compressedSize, std::int32_t bufferSize)
-		: _underlyingStream(path, offset, compressedSize, bufferSize), _uncompressedSize(uncompressedSize)
+	template<class T, class TUnderlying>
+	template<class ...Args>
+	CompressedBoundedStream<T, TUnderlying>::CompressedBoundedStream(std::uint32_t uncompressedSize, std::uint32_t compressedSize, Args&&... underlyingArgs)
+		: _underlyingStream(std::forward<Args>(underlyingArgs)...), _uncompressedSize(uncompressedSize)
 	{
 		_compressedStream.Open(_underlyingStream, static_cast<std::int32_t>(compressedSize));
 	}
 
-	template<class T>
-	void CompressedBoundedStream<T>::Dispose()
+	template<class T, class TUnderlying>
+	void CompressedBoundedStream<T, TUnderlying>::Dispose()
 	{
 		_compressedStream.Dispose();
 		_underlyingStream.Dispose();
 	}
 
-	template<class T>
-	std::int64_t CompressedBoundedStream<T>::Seek(std::int64_t offset, SeekOrigin origin)
+	template<class T, class TUnderlying>
+	std::int64_t CompressedBoundedStream<T, TUnderlying>::Seek(std::int64_t offset, SeekOrigin origin)
 	{
 		return _compressedStream.Seek(offset, origin);
 	}
 
-	template<class T>
-	std::int64_t CompressedBoundedStream<T>::GetPosition() const
+	template<class T, class TUnderlying>
+	std::int64_t CompressedBoundedStream<T, TUnderlying>::GetPosition() const
 	{
 		return _compressedStream.GetPosition();
 	}
 
-	template<class T>
-	std::int64_t CompressedBoundedStream<T>::Read(void* destination, std::int64_t bytesToRead)
+	template<class T, class TUnderlying>
+	std::int64_t CompressedBoundedStream<T, TUnderlying>::Read(void* destination, std::int64_t bytesToRead)
 	{
 		return _compressedStream.Read(destination, bytesToRead);
 	}
 
-	template<class T>
-	std::int64_t CompressedBoundedStream<T>::Write(const void* source, std::int64_t bytesToWrite)
+	template<class T, class TUnderlying>
+	std::int64_t CompressedBoundedStream<T, TUnderlying>::Write(const void* source, std::int64_t bytesToWrite)
 	{
 		// Not supported
 		return Stream::Invalid;
 	}
 
-	template<class T>
-	bool CompressedBoundedStream<T>::Flush()
+	template<class T, class TUnderlying>
+	bool CompressedBoundedStream<T, TUnderlying>::Flush()
 	{
 		// Not supported
 		return true;
 	}
 
-	template<class T>
-	bool CompressedBoundedStream<T>::IsValid()
+	template<class T, class TUnderlying>
+	bool CompressedBoundedStream<T, TUnderlying>::IsValid()
 	{
 		return _underlyingStream.IsValid() && _compressedStream.IsValid();
 	}
 
-	template<class T>
-	std::int64_t CompressedBoundedStream<T>::GetSize() const
+	template<class T, class TUnderlying>
+	std::int64_t CompressedBoundedStream<T, TUnderlying>::GetSize() const
 	{
 		return _uncompressedSize;
 	}
 
-	template<class T>
-	std::int64_t CompressedBoundedStream<T>::SetSize(std::int64_t size)
+	template<class T, class TUnderlying>
+	std::int64_t CompressedBoundedStream<T, TUnderlying>::SetSize(std::int64_t size)
 	{
 		return Stream::Invalid;
 	}
@@ -356,7 +370,8 @@ namespace Death { namespace IO {
 #	endif
 #endif
 
-	PakFile::PakFile(StringView path)
+	PakFile::PakFile(StringView path, bool useMemoryMapping)
+		: _useHashIndex(false)
 	{
 		std::unique_ptr<Stream> s = std::make_unique<FileStream>(path, FileAccess::Read);
 		DEATH_ASSERT(s->GetSize() > FooterSize + 8, "Invalid .pak file", );
@@ -394,6 +409,11 @@ namespace Death { namespace IO {
 		ConstructsItemsFromIndex(*s, nullptr,
 			(fileFlags & PakFileFlags::DeflateCompressedIndex) == PakFileFlags::DeflateCompressedIndex,
 			useRelativeOffsets, 0);
+
+		if (useMemoryMapping) {
+			s = nullptr;
+			MapFile();
+		}
 	}
 
 	StringView PakFile::GetMountPoint() const
@@ -411,6 +431,11 @@ namespace Death { namespace IO {
 		return !_path.empty();
 	}
 
+	bool PakFile::IsMemoryMapped() const
+	{
+		return (_mapping != nullptr);
+	}
+
 	bool PakFile::FileExists(StringView path)
 	{
 		Item* foundItem = FindItem(path);
@@ -445,11 +470,11 @@ namespace Death { namespace IO {
 		PakPreferredCompression compression = PakPreferredCompression(std::uint32_t(foundItem->Flags & ItemFlags::CompressionFlags) >> CompressionFlagsShift);
 		switch (compression) {
 			case PakPreferredCompression::None: {
-				return std::make_unique<BoundedFileStream>(_path, foundItem->Offset, foundItem->UncompressedSize, bufferSize);
+				return OpenUncompressedItem(*foundItem, bufferSize);
 			}
 			case PakPreferredCompression::Deflate: {
 #if defined(WITH_ZLIB) || defined(WITH_MINIZ)
-				return std::make_unique<CompressedBoundedStream<DeflateStream>>(_path, foundItem->Offset, foundItem->UncompressedSize, foundItem->Size, bufferSize);
+				return OpenCompressedItem<DeflateStream>(*foundItem, bufferSize);
 #else
 #	if defined(DEATH_TRACE_VERBOSE_IO)
 				LOGE("File \"{}\" was compressed with an unsupported method (Deflate)", path);
@@ -459,7 +484,7 @@ namespace Death { namespace IO {
 			}
 			case PakPreferredCompression::Lz4: {
 #if defined(WITH_LZ4)
-				return std::make_unique<CompressedBoundedStream<Lz4Stream>>(_path, foundItem->Offset, foundItem->UncompressedSize, foundItem->Size, bufferSize);
+				return OpenCompressedItem<Lz4Stream>(*foundItem, bufferSize);
 #else
 #	if defined(DEATH_TRACE_VERBOSE_IO)
 				LOGE("File \"{}\" was compressed with an unsupported method (LZ4)", path);
@@ -469,7 +494,7 @@ namespace Death { namespace IO {
 			}
 			case PakPreferredCompression::Zstd: {
 #if defined(WITH_ZSTD)
-				return std::make_unique<CompressedBoundedStream<ZstdStream>>(_path, foundItem->Offset, foundItem->UncompressedSize, foundItem->Size, bufferSize);
+				return OpenCompressedItem<ZstdStream>(*foundItem, bufferSize);
 #else
 #	if defined(DEATH_TRACE_VERBOSE_IO)
 				LOGE("File \"{}\" was compressed with an unsupported method (Zstd)", path);
@@ -495,11 +520,11 @@ namespace Death { namespace IO {
 		PakPreferredCompression compression = PakPreferredCompression(std::uint32_t(foundItem->Flags & ItemFlags::CompressionFlags) >> CompressionFlagsShift);
 		switch (compression) {
 			case PakPreferredCompression::None: {
-				return std::make_unique<BoundedFileStream>(_path, foundItem->Offset, foundItem->UncompressedSize, bufferSize);
+				return OpenUncompressedItem(*foundItem, bufferSize);
 			}
 			case PakPreferredCompression::Deflate: {
 #if defined(WITH_ZLIB) || defined(WITH_MINIZ)
-				return std::make_unique<CompressedBoundedStream<DeflateStream>>(_path, foundItem->Offset, foundItem->UncompressedSize, foundItem->Size, bufferSize);
+				return OpenCompressedItem<DeflateStream>(*foundItem, bufferSize);
 #	else
 #		if defined(DEATH_TRACE_VERBOSE_IO)
 				LOGE("File 0x{:.16x} was compressed with an unsupported method (Deflate)", hashedPath);
@@ -509,7 +534,7 @@ namespace Death { namespace IO {
 			}
 			case PakPreferredCompression::Lz4: {
 #	if defined(WITH_LZ4)
-				return std::make_unique<CompressedBoundedStream<Lz4Stream>>(_path, foundItem->Offset, foundItem->UncompressedSize, foundItem->Size, bufferSize);
+				return OpenCompressedItem<Lz4Stream>(*foundItem, bufferSize);
 #	else
 #		if defined(DEATH_TRACE_VERBOSE_IO)
 				LOGE("File 0x{:.16x} was compressed with an unsupported method (LZ4)", hashedPath);
@@ -519,7 +544,7 @@ namespace Death { namespace IO {
 			}
 			case PakPreferredCompression::Zstd: {
 #	if defined(WITH_ZSTD)
-				return std::make_unique<CompressedBoundedStream<ZstdStream>>(_path, foundItem->Offset, foundItem->UncompressedSize, foundItem->Size, bufferSize);
+				return OpenCompressedItem<ZstdStream>(*foundItem, bufferSize);
 #	else
 #		if defined(DEATH_TRACE_VERBOSE_IO)
 				LOGE("File 0x{:.16x} was compressed with an unsupported method (Zstd)", hashedPath);
@@ -533,6 +558,99 @@ namespace Death { namespace IO {
 		}
 	}
 
+	ArrayView<const char> PakFile::GetMappedFile(StringView path)
+	{
+		if (_mapping == nullptr || path.empty() || path[path.size() - 1] == '/' || path[path.size() - 1] == '\\') {
+			return {};
+		}
+
+		return GetMappedItem(FindItem(path));
+	}
+
+	ArrayView<const char> PakFile::GetMappedFile(StringView path, bool& fileExists)
+	{
+		if (path.empty() || path[path.size() - 1] == '/' || path[path.size() - 1] == '\\') {
+			fileExists = false;
+			return {};
+		}
+
+		Item* foundItem = FindItem(path);
+		fileExists = (foundItem != nullptr && (foundItem->Flags & ItemFlags::Directory) != ItemFlags::Directory);
+		return (_mapping != nullptr ? GetMappedItem(foundItem) : ArrayView<const char>{});
+	}
+
+	ArrayView<const char> PakFile::GetMappedFile(std::uint64_t hashedPath)
+	{
+		DEATH_ASSERT(_useHashIndex, "Hashed path can only be used with hash-indexed .pak files", {});
+
+		if (_mapping == nullptr) {
+			return {};
+		}
+
+		return GetMappedItem(FindItemByHash(hashedPath));
+	}
+
+	void PakFile::MapFile()
+	{
+#if defined(DEATH_TARGET_ANDROID) || defined(DEATH_TARGET_APPLE) || defined(DEATH_TARGET_UNIX) || (defined(DEATH_TARGET_WINDOWS) && !defined(DEATH_TARGET_WINDOWS_RT))
+		auto mappedFile = FileSystem::OpenAsMemoryMapped(_path, FileAccess::Read);
+		if (!mappedFile) {
+#	if defined(DEATH_TRACE_VERBOSE_IO)
+			LOGW("Failed to map file \"{}\" into memory, falling back to file streams", _path);
+#	endif
+			return;
+		}
+
+		// The mapping is shared with all opened streams, so it's released after the last one is closed
+		auto mapping = std::make_shared<Array<char, FileSystem::MapDeleter>>(std::move(*mappedFile));
+		_mappedData = arrayView(mapping->data(), mapping->size());
+		_mapping = std::move(mapping);
+#endif
+	}
+
+	std::unique_ptr<Stream> PakFile::OpenUncompressedItem(const Item& item, std::int32_t bufferSize)
+	{
+		if (_mapping != nullptr) {
+			ArrayView<const char> data = GetMappedItem(&item);
+			if DEATH_UNLIKELY(data.size() != item.UncompressedSize) {
+				return nullptr;
+			}
+			return std::make_unique<MappedBoundedStream>(_mapping, data.data(), item.UncompressedSize);
+		}
+
+		return std::make_unique<BoundedFileStream>(_path, item.Offset, item.UncompressedSize, bufferSize);
+	}
+
+	template<class T>
+	std::unique_ptr<Stream> PakFile::OpenCompressedItem(const Item& item, std::int32_t bufferSize)
+	{
+#if defined(WITH_ZLIB) || defined(WITH_MINIZ) || defined(WITH_LZ4) || defined(WITH_ZSTD)
+		if (_mapping != nullptr) {
+			// Decompress directly from the mapped memory
+			if DEATH_UNLIKELY(item.Offset + item.Size > _mappedData.size()) {
+				return nullptr;
+			}
+			return std::make_unique<CompressedBoundedStream<T, MappedBoundedStream>>(item.UncompressedSize, item.Size,
+				_mapping, _mappedData.data() + item.Offset, item.Size);
+		}
+
+		return std::make_unique<CompressedBoundedStream<T, BoundedFileStream>>(item.UncompressedSize, item.Size,
+			_path, item.Offset, item.Size, bufferSize);
+#else
+		return nullptr;
+#endif
+	}
+
+	ArrayView<const char> PakFile::GetMappedItem(const Item* item) const
+	{
+		if (item == nullptr || (item->Flags & (ItemFlags::Directory | ItemFlags::CompressionFlags)) != ItemFlags::None ||
+			item->Offset + item->UncompressedSize > _mappedData.size()) {
+			return {};
+		}
+
+		return _mappedData.slice(std::size_t(item->Offset), std::size_t(item->Offset + item->UncompressedSize));
+	}
+
 	void PakFile::ConstructsItemsFromIndex(Stream& s, Item* parentItem, bool deflateCompressed, bool useRelativeOffsets, std::uint32_t depth)
 	{
 		DEATH_ASSERT(depth < MaxDepth, "Maximum directory structure depth reached", );
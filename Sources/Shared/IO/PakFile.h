@@ -24,13 +24,17 @@ namespace Death { namespace IO {
 
 	/**
 		@brief Provides read-only access to contents of `.pak` file
+
+		If memory mapping is requested, the whole `.pak` file is mapped once and all opened files are served directly
+		from the mapping, uncompressed files are then accessible without any copying using @ref GetMappedFile().
+		Streams opened from a memory-mapped `.pak` file keep the mapping alive even after the @ref PakFile is destroyed.
 	*/
 	class PakFile
 	{
 		friend class PakWriter;
 
 	public:
-		explicit PakFile(Containers::StringView path);
+		explicit PakFile(Containers::StringView path, bool useMemoryMapping = false);
 
 		PakFile(const PakFile&) = delete;
 		PakFile& operator=(const PakFile&) = delete;
@@ -46,6 +50,9 @@ namespace Death { namespace IO {
 		
 		bool IsValid() const;
 
+		/** @brief Returns `true` if the `.pak` file is memory-mapped */
+		bool IsMemoryMapped() const;
+
 		/** @brief Returns `true` if the specified path is a file */
 		bool FileExists(Containers::StringView path);
 		/** @overload */
@@ -58,6 +65,23 @@ namespace Death { namespace IO {
 		/** @overload */
 		std::unique_ptr<Stream> OpenFile(std::uint64_t hashedPath, std::int32_t bufferSize = FileStream::DefaultBufferSize);
 
+		/**
+		 * @brief Returns contents of an uncompressed file directly from the memory-mapped `.pak` file
+		 *
+		 * Returns an empty view if the `.pak` file is not memory-mapped, or if the file doesn't exist or is compressed.
+		 * The view is valid only as long as the @ref PakFile instance exists.
+		 */
+		Containers::ArrayView<const char> GetMappedFile(Containers::StringView path);
+		/**
+		 * @overload
+		 *
+		 * Additionally returns in @p fileExists whether the file exists, so a compressed file can be distinguished
+		 * from a missing one without another lookup.
+		 */
+		Containers::ArrayView<const char> GetMappedFile(Containers::StringView path, bool& fileExists);
+		/** @overload */
+		Containers::ArrayView<const char> GetMappedFile(std::uint64_t hashedPath);
+
 		/** @brief Handles directory traversal, should be used as iterator */
 		class Directory
 		{
@@ -148,8 +172,15 @@ namespace Death { namespace IO {
 		Containers::String _path;
 		Containers::String _mountPoint;
 		Containers::Array<Item> _rootItems;
+		std::shared_ptr<const void> _mapping;
+		Containers::ArrayView<const char> _mappedData;
 		bool _useHashIndex;
 
+		void MapFile();
+		std::unique_ptr<Stream> OpenUncompressedItem(const Item& item, std::int32_t bufferSize);
+		template<class T> std::unique_ptr<Stream> OpenCompressedItem(const Item& item, std::int32_t bufferSize);
+		Containers::ArrayView<const char> GetMappedItem(const Item* item) const;
+
 		void ConstructsItemsFromIndex(Stream& s, Item* parentItem, bool deflateCompressed, bool useRelativeOffsets, std::uint32_t depth);
 		Containers::Array<Item>* ReadIndexFromStream(Stream& s, Item* parentItem, bool useRelativeOffsets, std::int64_t indexStartPosition);
 		DEATH_NEVER_INLINE Containers::Array<Item>* ReadIndexFromStreamDeflateCompressed(Stream& s, Item* parentItem, bool useRelativeOffsets, std::int64_t indexStartPosition);
@@ -0,0 +1,295 @@
+﻿#include "Tests.h"
+#include "../Jazz2/Collisions/CollisionDispatch.h"
+
+#include "../nCine/Base/Random.h"
+
+#include <algorithm>
+#include <memory>
+
+#include <Containers/Function.h>
+#include <Containers/SmallVector.h>
+
+using namespace Death::Containers;
+using namespace Jazz2::Collisions;
+using namespace nCine;
+
+namespace
+{
+	enum class BodyState {
+		None = 0x00,
+		CollideWithOtherActors = 0x01,
+		IsDestroyed = 0x02
+	};
+
+	DEATH_ENUM_FLAGS(BodyState);
+
+	struct CollisionCall
+	{
+		const void* Self;
+		const void* Other;
+	};
+
+	// Minimal actor with the interface required by CollisionDispatch, collisions are virtual like in ActorBase
+	class Body : public std::enable_shared_from_this<Body>
+	{
+	public:
+		AABBf AABB;
+		std::int32_t ProxyId;
+		BodyState State;
+		bool HandlesCollisions;
+		SmallVector<CollisionCall, 0>* Calls;
+
+		Body() : ProxyId(NullNode), State(BodyState::CollideWithOtherActors), HandlesCollisions(false), Calls(nullptr) {}
+		virtual ~Body() {}
+
+		BodyState GetState() const {
+			return State;
+		}
+
+		bool IsCollidingWith(const AABBf& aabb) {
+			return AABB.Overlaps(aabb);
+		}
+
+		bool IsCollidingWith(Body* other) {
+			return AABB.Overlaps(other->AABB);
+		}
+
+		virtual bool OnHandleCollision(Body* other) {
+			if (Calls != nullptr) {
+				Calls->push_back({ this, other });
+			}
+			return HandlesCollisions;
+		}
+
+		// Signature used before, the other actor was passed by shared pointer
+		virtual bool OnHandleCollisionShared(std::shared_ptr<Body> other) {
+			return OnHandleCollision(other.get());
+		}
+	};
+
+	using BodyCollisions = CollisionDispatch<Body, BodyState>;
+
+	AABBf GetRandomBox(RandomGenerator& random, float maxSize)
+	{
+		float x = random.NextFloat(0.0f, 4096.0f);
+		float y = random.NextFloat(0.0f, 4096.0f);
+		return AABBf(x, y, x + random.NextFloat(1.0f, maxSize), y + random.NextFloat(1.0f, maxSize));
+	}
+
+	void CreateBodies(RandomGenerator& random, DynamicTreeBroadPhase& tree, SmallVector<std::shared_ptr<Body>, 0>& bodies, std::int32_t count)
+	{
+		for (std::int32_t i = 0; i < count; i++) {
+			auto& body = bodies.emplace_back(std::make_shared<Body>());
+			body->AABB = GetRandomBox(random, 96.0f);
+			if (random.Next(0, 8) == 0) {
+				body->State = BodyState::None;
+			} else if (random.Next(0, 16) == 0) {
+				body->State |= BodyState::IsDestroyed;
+			}
+			body->HandlesCollisions = (random.Next(0, 2) == 0);
+			body->ProxyId = tree.CreateProxy(body->AABB, body.get());
+		}
+	}
+
+	void MoveBody(DynamicTreeBroadPhase& tree, Body& body, Vector2f displacement)
+	{
+		body.AABB = AABBf(body.AABB.L + displacement.X, body.AABB.T + displacement.Y, body.AABB.R + displacement.X, body.AABB.B + displacement.Y);
+		tree.MoveProxy(body.ProxyId, body.AABB, displacement);
+	}
+
+	bool IsColliding(Body& a, Body& b)
+	{
+		return ((a.State | b.State) & (BodyState::CollideWithOtherActors | BodyState::IsDestroyed)) == BodyState::CollideWithOtherActors &&
+			a.AABB.Overlaps(b.AABB);
+	}
+
+	// Pair dispatch as it was done before, both actors were converted to shared pointers for each collision
+	void HandlePairShared(Body* actorA, Body* actorB)
+	{
+		if (((actorA->GetState() | actorB->GetState()) & (BodyState::CollideWithOtherActors | BodyState::IsDestroyed)) != BodyState::CollideWithOtherActors) {
+			return;
+		}
+
+		if (actorA->IsCollidingWith(actorB)) {
+			std::shared_ptr<Body> actorSharedA = actorA->shared_from_this();
+			std::shared_ptr<Body> actorSharedB = actorB->shared_from_this();
+			if (!actorSharedA->OnHandleCollisionShared(actorSharedB->shared_from_this())) {
+				actorSharedB->OnHandleCollisionShared(actorSharedA->shared_from_this());
+			}
+		}
+	}
+
+	struct PairCollector {
+		SmallVector<std::pair<Body*, Body*>, 0> Pairs;
+
+		void OnPairAdded(void* proxyA, void* proxyB) {
+			Pairs.emplace_back((Body*)proxyA, (Body*)proxyB);
+		}
+	};
+
+	// Bullet-heavy scene, returns duration of pair dispatch in microseconds, pairs reported by the tree are not included
+	double RunBulletScene(bool useSharedPointers, std::int32_t& callCount)
+	{
+		RandomGenerator random(0xB011, 0x1);
+		DynamicTreeBroadPhase tree;
+		SmallVector<std::shared_ptr<Body>, 0> bodies;
+		SmallVector<CollisionCall, 0> calls;
+
+		// Enemies and bullets, bullets are not destroyed on hit, so both variants handle the same collisions in every frame
+		for (std::int32_t i = 0; i < 3300; i++) {
+			auto& body = bodies.emplace_back(std::make_shared<Body>());
+			float x = random.NextFloat(0.0f, 2048.0f);
+			float y = random.NextFloat(0.0f, 1024.0f);
+			body->AABB = (i < 300 ? AABBf(x, y, x + 48.0f, y + 48.0f) : AABBf(x, y, x + 8.0f, y + 4.0f));
+			body->Calls = &calls;
+			body->ProxyId = tree.CreateProxy(body->AABB, body.get());
+		}
+
+		double totalUs = 0.0;
+		PairCollector collector;
+		for (std::int32_t frame = 0; frame < 60; frame++) {
+			for (std::size_t i = 300; i < bodies.size(); i++) {
+				MoveBody(tree, *bodies[i], Vector2f((i % 2) == 0 ? 8.0f : -8.0f, 0.0f));
+			}
+
+			collector.Pairs.clear();
+			tree.UpdatePairs(&collector);
+
+			calls.clear();
+			totalUs += Jazz2::Tests::MeasureUs(1, [&]() {
+				for (auto& pair : collector.Pairs) {
+					if (useSharedPointers) {
+						HandlePairShared(pair.first, pair.second);
+					} else {
+						BodyCollisions::HandlePair(pair.first, pair.second);
+					}
+				}
+			});
+			callCount += std::int32_t(calls.size());
+		}
+		return totalUs;
+	}
+}
+
+TEST_CASE(CollisionQueryMatchesBruteForce)
+{
+	RandomGenerator random(0xC011, 0x1);
+	DynamicTreeBroadPhase tree;
+	SmallVector<std::shared_ptr<Body>, 0> bodies;
+	CreateBodies(random, tree, bodies, 2000);
+
+	SmallVector<Body*, 0> expected;
+	SmallVector<Body*, 0> actual;
+	for (std::int32_t pass = 0; pass < 4; pass++) {
+		for (std::int32_t i = 0; i < 500; i++) {
+			const Body* self = bodies[random.Next(0, std::uint32_t(bodies.size()))].get();
+			AABBf aabb = (i % 2 == 0 ? self->AABB : GetRandomBox(random, 256.0f));
+
+			expected.clear();
+			for (auto& body : bodies) {
+				if (body.get() != self && (body->State & (BodyState::CollideWithOtherActors | BodyState::IsDestroyed)) == BodyState::CollideWithOtherActors &&
+					body->AABB.Overlaps(aabb)) {
+					expected.push_back(body.get());
+				}
+			}
+
+			actual.clear();
+			BodyCollisions::QueryActors(tree, self, aabb, [&actual](Body* body) {
+				actual.push_back(body);
+				return true;
+			});
+
+			std::sort(expected.begin(), expected.end());
+			std::sort(actual.begin(), actual.end());
+			TEST_VERIFY(actual.size() == expected.size());
+			TEST_VERIFY(std::equal(actual.begin(), actual.end(), expected.begin()));
+
+			// Returning false from the callback stops the query
+			std::int32_t calls = 0;
+			BodyCollisions::QueryActors(tree, self, aabb, [&calls](Body*) {
+				calls++;
+				return false;
+			});
+			TEST_VERIFY(calls == (expected.empty() ? 0 : 1));
+
+			// Type-erased callback used by ILevelHandler::FindCollisionActorsByAABB() finds the same actors
+			std::int32_t erasedCount = 0;
+			Function<bool(Body*)> erased = [&erasedCount](Body*) {
+				erasedCount++;
+				return true;
+			};
+			BodyCollisions::QueryActors(tree, self, aabb, erased);
+			TEST_VERIFY(erasedCount == std::int32_t(expected.size()));
+		}
+
+		for (auto& body : bodies) {
+			if (random.Next(0, 2) == 0) {
+				MoveBody(tree, *body, Vector2f(random.NextFloat(-24.0f, 24.0f), random.NextFloat(-24.0f, 24.0f)));
+			}
+		}
+	}
+	return true;
+}
+
+TEST_CASE(CollisionPairsMatchBruteForce)
+{
+	RandomGenerator random(0xC012, 0x1);
+	DynamicTreeBroadPhase tree;
+	SmallVector<std::shared_ptr<Body>, 0> bodies;
+	SmallVector<CollisionCall, 0> calls;
+	CreateBodies(random, tree, bodies, 1000);
+	for (auto& body : bodies) {
+		body->Calls = &calls;
+	}
+
+	// All proxies are moved after creation, so all colliding pairs are reported
+	BodyCollisions::ResolvePairs(tree);
+
+	std::int32_t pairCount = 0;
+	for (std::size_t i = 0; i < bodies.size(); i++) {
+		for (std::size_t j = i + 1; j < bodies.size(); j++) {
+			Body* a = bodies[i].get();
+			Body* b = bodies[j].get();
+			std::int32_t forward = 0, backward = 0, firstForward = -1;
+			for (std::size_t k = 0; k < calls.size(); k++) {
+				if (calls[k].Self == a && calls[k].Other == b) {
+					forward++;
+					if (firstForward < 0) {
+						firstForward = 1;
+					}
+				} else if (calls[k].Self == b && calls[k].Other == a) {
+					backward++;
+					if (firstForward < 0) {
+						firstForward = 0;
+					}
+				}
+			}
+
+			if (!IsColliding(*a, *b)) {
+				TEST_VERIFY(forward == 0 && backward == 0);
+				continue;
+			}
+
+			// The other actor is notified only if the first one didn't handle the collision
+			pairCount++;
+			TEST_VERIFY(forward <= 1 && backward <= 1 && firstForward >= 0);
+			Body* first = (firstForward == 1 ? a : b);
+			TEST_VERIFY(forward + backward == (first->HandlesCollisions ? 1 : 2));
+		}
+	}
+
+	TEST_VERIFY(pairCount > 0);
+	return true;
+}
+
+TEST_CASE(CollisionPairsDispatchBenchmark)
+{
+	// Only dispatch of pairs reported by UpdatePairs() is measured, so the difference is caused by shared pointers
+	std::int32_t rawCalls = 0, sharedCalls = 0;
+	double rawUs = RunBulletScene(false, rawCalls);
+	double sharedUs = RunBulletScene(true, sharedCalls);
+
+	TEST_VERIFY(rawCalls > 0 && rawCalls == sharedCalls);
+	std::printf("  Raw pointers: %.2f us, shared pointers: %.2f us per 60 frames with 3000 bullets (%i collisions)\n", rawUs, sharedUs, rawCalls);
+	return true;
+}
@@ -0,0 +1,44 @@
+﻿#include "Tests.h"
+
+#include <cstring>
+
+namespace Jazz2::Tests
+{
+	TestCase::TestCase(const char* name, bool(*function)())
+		: Name(name), Function(function), Next(GetFirst())
+	{
+		GetFirst() = this;
+	}
+
+	TestCase*& TestCase::GetFirst()
+	{
+		static TestCase* first = nullptr;
+		return first;
+	}
+}
+
+using namespace Jazz2::Tests;
+
+// Runs all registered self-checks, or only those whose name contains the first argument
+int main(int argc, char** argv)
+{
+	const char* filter = (argc > 1 ? argv[1] : nullptr);
+	std::int32_t passed = 0, failed = 0;
+
+	for (TestCase* test = TestCase::GetFirst(); test != nullptr; test = test->Next) {
+		if (filter != nullptr && std::strstr(test->Name, filter) == nullptr) {
+			continue;
+		}
+
+		std::printf("%s\n", test->Name);
+		if (test->Function()) {
+			passed++;
+		} else {
+			std::printf("  FAILED\n");
+			failed++;
+		}
+	}
+
+	std::printf("%i passed, %i failed\n", passed, failed);
+	return (failed == 0 ? 0 : 1);
+}
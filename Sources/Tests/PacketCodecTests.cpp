@@ -0,0 +1,71 @@
+﻿#include "Tests.h"
+#include "../Jazz2/Multiplayer/PacketCodec.h"
+
+#include "../nCine/Base/Random.h"
+
+#include <cstring>
+
+#include <Containers/SmallVector.h>
+
+using namespace Jazz2::Multiplayer;
+using namespace nCine;
+
+namespace
+{
+	// Packets are mostly repetitive, so only a part of the payload is random
+	void FillPacket(RandomGenerator& random, std::uint8_t* data, std::size_t size)
+	{
+		for (std::size_t i = 0; i < size; i++) {
+			data[i] = (random.Next(0, 4) == 0 ? std::uint8_t(random.Next(0, 256)) : std::uint8_t(i / 16));
+		}
+	}
+
+	bool RoundTrip(ArrayView<const std::uint8_t> data, PacketCodecType codec)
+	{
+		MemoryStream compressed(data.size() + 16);
+		PacketCodec::Compress(data, compressed, codec);
+
+		MemoryStream decompressed;
+		if (!PacketCodec::Decompress(arrayView(compressed.GetBuffer(), std::size_t(compressed.GetSize())), decompressed)) {
+			return false;
+		}
+		return (std::size_t(decompressed.GetSize()) == data.size() &&
+			(data.empty() || std::memcmp(decompressed.GetBuffer(), data.data(), data.size()) == 0));
+	}
+}
+
+TEST_CASE(PacketCodecRoundTrip)
+{
+	RandomGenerator random(0x5EED, 0x1);
+	SmallVector<std::uint8_t, 0> data(ValueInit, 64 * 1024);
+
+	for (std::size_t size : { std::size_t(0), std::size_t(1), std::size_t(95), std::size_t(96), std::size_t(1500), std::size_t(64 * 1024) }) {
+		FillPacket(random, data.data(), size);
+		for (std::int32_t codec = 0; codec < (std::int32_t)PacketCodecType::Count; codec++) {
+			TEST_VERIFY(RoundTrip(arrayView(data.data(), size), (PacketCodecType)codec));
+		}
+	}
+	return true;
+}
+
+TEST_CASE(PacketCodecRejectsOversizedPayload)
+{
+	RandomGenerator random(0x5EED, 0x2);
+	SmallVector<std::uint8_t, 0> data(ValueInit, 4096);
+	FillPacket(random, data.data(), data.size());
+
+	MemoryStream compressed(data.size() + 16);
+	PacketCodec::Compress(data, compressed, PacketCodec::GetPreferredCodec());
+	ArrayView<const std::uint8_t> payload = arrayView(compressed.GetBuffer(), std::size_t(compressed.GetSize()));
+
+	MemoryStream decompressed;
+	TEST_VERIFY(!PacketCodec::Decompress(payload, decompressed, std::uint32_t(data.size() - 1)));
+	TEST_VERIFY(PacketCodec::Decompress(payload, decompressed, std::uint32_t(data.size())));
+
+	// Truncated stream must not be accepted, even if the declared size is valid
+	if (payload[0] != (std::uint8_t)PacketCodecType::Raw) {
+		MemoryStream truncated;
+		TEST_VERIFY(!PacketCodec::Decompress(payload.prefix(payload.size() / 2), truncated));
+	}
+	return true;
+}
@@ -0,0 +1,144 @@
+﻿#include "Tests.h"
+#include "../Jazz2/ContentResolver.Pixels.h"
+
+#include "../nCine/Base/Random.h"
+
+#include <cstring>
+
+#include <Containers/SmallVector.h>
+
+using namespace Death::Containers;
+using namespace Jazz2;
+using namespace nCine;
+
+namespace
+{
+	struct PixelKernels
+	{
+		const char* Name;
+		ExtractAlphaMaskFunction ExtractAlphaMask;
+		ApplyIndexedPaletteFunction ApplyIndexedPalette;
+	};
+
+	// Returns all kernel variants that are compiled in and supported by the current CPU, scalar variant is always first
+	SmallVector<PixelKernels, 4> GetSupportedKernels()
+	{
+		SmallVector<PixelKernels, 4> kernels;
+		kernels.push_back({ "Scalar", extractAlphaMaskImplementation(Death::Cpu::Scalar), applyIndexedPaletteImplementation(Death::Cpu::Scalar) });
+
+		DEATH_UNUSED Death::Cpu::Features features = Death::Cpu::runtimeFeatures();
+#if defined(DEATH_ENABLE_SSE2)
+		if (features & Death::Cpu::Sse2) {
+			kernels.push_back({ "SSE2", extractAlphaMaskImplementation(Death::Cpu::Sse2), applyIndexedPaletteImplementation(Death::Cpu::Sse2) });
+		}
+#endif
+#if defined(DEATH_ENABLE_AVX2)
+		if (features & Death::Cpu::Avx2) {
+			kernels.push_back({ "AVX2", extractAlphaMaskImplementation(Death::Cpu::Avx2), applyIndexedPaletteImplementation(Death::Cpu::Avx2) });
+		}
+#endif
+#if defined(DEATH_ENABLE_NEON) && !defined(DEATH_TARGET_32BIT)
+		if (features & Death::Cpu::Neon) {
+			kernels.push_back({ "NEON", extractAlphaMaskImplementation(Death::Cpu::Neon), applyIndexedPaletteImplementation(Death::Cpu::Neon) });
+		}
+#endif
+		return kernels;
+	}
+
+	void FillRandom(RandomGenerator& random, std::uint8_t* data, std::size_t size)
+	{
+		for (std::size_t i = 0; i < size; i++) {
+			data[i] = std::uint8_t(random.Next(0, 256));
+		}
+	}
+}
+
+TEST_CASE(PixelExtractAlphaMask)
+{
+	RandomGenerator random(0xA1FA, 0x1);
+	SmallVector<std::uint8_t, 0> pixels(ValueInit, 4099 * 4);
+	SmallVector<std::uint8_t, 0> expected(ValueInit, 4099);
+	SmallVector<std::uint8_t, 0> actual(ValueInit, 4099);
+	FillRandom(random, pixels.data(), pixels.size());
+
+	auto kernels = GetSupportedKernels();
+	// Cover all tail lengths of 16 and 32 pixel blocks and one large image
+	for (std::size_t count = 0; count <= 4099; count = (count < 70 ? count + 1 : count + 1009)) {
+		for (std::size_t i = 0; i < count; i++) {
+			expected[i] = pixels[i * 4 + 3];
+		}
+		for (auto& kernel : kernels) {
+			std::memset(actual.data(), 0xCD, actual.size());
+			kernel.ExtractAlphaMask(pixels.data(), actual.data(), count);
+			if (std::memcmp(actual.data(), expected.data(), count) != 0 || (count < actual.size() && actual[count] != 0xCD)) {
+				std::fprintf(stderr, "  %s variant failed for %zu pixels\n", kernel.Name, count);
+				return false;
+			}
+		}
+	}
+
+	for (auto& kernel : kernels) {
+		double us = Jazz2::Tests::MeasureUs(500, [&]() {
+			kernel.ExtractAlphaMask(pixels.data(), actual.data(), 4096);
+		});
+		std::printf("  %s: %.2f us per 4096 pixels\n", kernel.Name, us);
+	}
+	return true;
+}
+
+TEST_CASE(PixelApplyIndexedPalette)
+{
+	RandomGenerator random(0x9A1E, 0x1);
+	std::uint32_t palette[256];
+	SmallVector<std::uint8_t, 0> src(ValueInit, 4099 * 4);
+	SmallVector<std::uint8_t, 0> expected(ValueInit, 4099 * 4);
+	SmallVector<std::uint8_t, 0> actual(ValueInit, 4099 * 4);
+
+	auto kernels = GetSupportedKernels();
+
+	// Every combination of palette alpha and pixel alpha must match exact integer division by 255
+	for (std::int32_t i = 0; i < 256; i++) {
+		palette[i] = 0x00563412u | (std::uint32_t(i) << 24);
+	}
+	for (std::int32_t i = 0; i < 256 * 256; i += 4096) {
+		for (std::int32_t j = 0; j < 4096; j++) {
+			src[j * 4 + 0] = std::uint8_t((i + j) >> 8);
+			src[j * 4 + 3] = std::uint8_t(i + j);
+		}
+		for (auto& kernel : kernels) {
+			kernel.ApplyIndexedPalette(src.data(), actual.data(), 4096, palette);
+			for (std::int32_t j = 0; j < 4096; j++) {
+				std::int32_t alpha = ((i + j) >> 8) * ((i + j) & 0xFF) / 255;
+				if (actual[j * 4 + 0] != 0x12 || actual[j * 4 + 1] != 0x34 || actual[j * 4 + 2] != 0x56 || actual[j * 4 + 3] != alpha) {
+					std::fprintf(stderr, "  %s variant failed for alpha %i * %i\n", kernel.Name, (i + j) >> 8, (i + j) & 0xFF);
+					return false;
+				}
+			}
+		}
+	}
+
+	// Random palette and pixels, including tails and in-place conversion
+	for (std::int32_t i = 0; i < 256; i++) {
+		palette[i] = std::uint32_t(random.Next());
+	}
+	FillRandom(random, src.data(), src.size());
+	for (std::size_t count = 0; count <= 4099; count = (count < 40 ? count + 1 : count + 1009)) {
+		applyIndexedPaletteImplementation(Death::Cpu::Scalar)(src.data(), expected.data(), count, palette);
+		for (auto& kernel : kernels) {
+			kernel.ApplyIndexedPalette(src.data(), actual.data(), count, palette);
+			TEST_VERIFY(std::memcmp(actual.data(), expected.data(), count * 4) == 0);
+
+			std::memcpy(actual.data(), src.data(), count * 4);
+			kernel.ApplyIndexedPalette(actual.data(), actual.data(), count, palette);
+			TEST_VERIFY(std::memcmp(actual.data(), expected.data(), count * 4) == 0);
+		}
+	}
+
+	for (auto& kernel : kernels) {
+		double us = Jazz2::Tests::MeasureUs(500, [&]() {
+			kernel.ApplyIndexedPalette(src.data(), actual.data(), 4096, palette);
+		});
+		std::printf("  %s: %.2f us per 4096 pixels\n", kernel.Name, us);
+	}
+	return true;
+}
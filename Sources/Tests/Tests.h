@@ -0,0 +1,52 @@
+﻿#pragma once
+
+#include "../Main.h"
+
+#include <chrono>
+#include <cstdio>
+
+namespace Jazz2::Tests
+{
+	/** @brief Self-check registered by @ref TEST_CASE(), all registered checks are run by the test executable */
+	struct TestCase
+	{
+		/** @brief Name of the check */
+		const char* Name;
+		/** @brief Function that returns `false` if the check failed */
+		bool(*Function)();
+		/** @brief Next registered check */
+		TestCase* Next;
+
+		TestCase(const char* name, bool(*function)());
+
+		/** @brief Returns the first registered check */
+		static TestCase*& GetFirst();
+	};
+
+	/** @brief Returns average duration of the specified function in microseconds, used to compare optimized code paths */
+	template<class TFunction>
+	double MeasureUs(std::int32_t iterations, TFunction&& function)
+	{
+		auto begin = std::chrono::steady_clock::now();
+		for (std::int32_t i = 0; i < iterations; i++) {
+			function();
+		}
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double, std::micro>(end - begin).count() / iterations;
+	}
+}
+
+/** @brief Defines and registers a self-check */
+#define TEST_CASE(name)																			\
+	static bool name();																			\
+	static Jazz2::Tests::TestCase name ## Registration(#name, name);								\
+	static bool name()
+
+/** @brief Fails the current self-check if the condition is not met */
+#define TEST_VERIFY(condition)																		\
+	do {																						\
+		if (!(condition)) {																		\
+			std::fprintf(stderr, "  %s:%i: Check failed: %s\n", __FILE__, __LINE__, #condition);	\
+			return false;																		\
+		}																						\
+	} while (false)
@@ -0,0 +1,129 @@
+﻿#include "Tests.h"
+#include "../Jazz2/Tiles/TileMaskRows.h"
+
+#include "../nCine/Base/Random.h"
+
+#include <cstring>
+
+#include <Containers/SmallVector.h>
+
+using namespace Death::Containers;
+using namespace Jazz2::Tiles;
+using namespace nCine;
+
+namespace
+{
+	constexpr std::int32_t TileSize = 32;
+
+	// Packs byte mask the same way as TileSet does, bit X of row Y is set if the pixel is solid
+	void PackMaskRows(const std::uint8_t* mask, std::uint32_t* rows)
+	{
+		for (std::int32_t y = 0; y < TileSize; y++) {
+			std::uint32_t row = 0;
+			for (std::int32_t x = 0; x < TileSize; x++) {
+				row |= std::uint32_t(mask[y * TileSize + x] > 0) << x;
+			}
+			rows[y] = row;
+		}
+	}
+
+	// Compares the kernel against summed-area table of the byte mask for every possible rectangle
+	bool VerifyAllRects(const std::uint8_t* mask, const std::uint32_t* rows, IsAnyMaskRowSolidFunction isAnyMaskRowSolid)
+	{
+		std::int32_t sums[TileSize + 1][TileSize + 1] = {};
+		for (std::int32_t y = 0; y < TileSize; y++) {
+			for (std::int32_t x = 0; x < TileSize; x++) {
+				sums[y + 1][x + 1] = sums[y][x + 1] + sums[y + 1][x] - sums[y][x] + (mask[y * TileSize + x] > 0 ? 1 : 0);
+			}
+		}
+
+		for (std::int32_t top = 0; top < TileSize; top++) {
+			for (std::int32_t bottom = top; bottom < TileSize; bottom++) {
+				for (std::int32_t left = 0; left < TileSize; left++) {
+					for (std::int32_t right = left; right < TileSize; right++) {
+						bool expected = (sums[bottom + 1][right + 1] - sums[top][right + 1] - sums[bottom + 1][left] + sums[top][left]) > 0;
+						if (isAnyMaskRowSolid(&rows[top], bottom - top + 1, GetMaskRowColumns(left, right)) != expected) {
+							std::fprintf(stderr, "  Mismatch in rect [%i, %i, %i, %i]\n", left, top, right, bottom);
+							return false;
+						}
+					}
+				}
+			}
+		}
+		return true;
+	}
+
+	void FillMask(RandomGenerator& random, std::uint8_t* mask, std::int32_t density)
+	{
+		for (std::int32_t i = 0; i < TileSize * TileSize; i++) {
+			mask[i] = (std::int32_t(random.Next(0, 1000)) < density ? 1 : 0);
+		}
+	}
+}
+
+TEST_CASE(TileMaskSolidInRect)
+{
+	RandomGenerator random(0x71E5, 0x1);
+	std::uint8_t mask[TileSize * TileSize];
+	std::uint32_t rows[TileSize];
+
+	Death::Cpu::Features features = Death::Cpu::runtimeFeatures();
+	std::printf("  Runtime features: %s%s\n", (features & Death::Cpu::Sse2 ? "SSE2 " : ""), (features & Death::Cpu::Avx2 ? "AVX2" : ""));
+
+	// Empty, full, single pixels in every corner, sparse and dense tiles
+	for (std::int32_t density : { 0, 1000, -1, 2, 20, 200, 800 }) {
+		if (density < 0) {
+			std::memset(mask, 0, sizeof(mask));
+			mask[0] = mask[TileSize - 1] = mask[(TileSize - 1) * TileSize] = mask[TileSize * TileSize - 1] = 1;
+		} else {
+			FillMask(random, mask, density);
+		}
+		PackMaskRows(mask, rows);
+
+		TEST_VERIFY(VerifyAllRects(mask, rows, isAnyMaskRowSolidImplementation(Death::Cpu::Scalar)));
+#if defined(DEATH_ENABLE_SSE2)
+		if (features & Death::Cpu::Sse2) {
+			TEST_VERIFY(VerifyAllRects(mask, rows, isAnyMaskRowSolidImplementation(Death::Cpu::Sse2)));
+		}
+#endif
+#if defined(DEATH_ENABLE_AVX2)
+		if (features & Death::Cpu::Avx2) {
+			TEST_VERIFY(VerifyAllRects(mask, rows, isAnyMaskRowSolidImplementation(Death::Cpu::Avx2)));
+		}
+#endif
+	}
+
+	// Full-height query of an empty column is the worst case, all rows have to be visited
+	SmallVector<std::uint32_t, 0> tiles(ValueInit, 1024 * TileSize);
+	for (std::int32_t i = 0; i < 1024 * TileSize; i++) {
+		tiles[i] = ~(1u << 7);
+	}
+	auto measure = [&tiles](IsAnyMaskRowSolidFunction isAnyMaskRowSolid) {
+		std::int32_t solidCount = 0;
+		double us = Jazz2::Tests::MeasureUs(200, [&]() {
+			for (std::int32_t i = 0; i < 1024; i++) {
+				solidCount += (isAnyMaskRowSolid(&tiles[i * TileSize], TileSize, GetMaskRowColumns(7, 7)) ? 1 : 0);
+			}
+		});
+		return (solidCount == 0 ? us : -1.0);
+	};
+
+	double scalarUs = measure(isAnyMaskRowSolidImplementation(Death::Cpu::Scalar));
+	TEST_VERIFY(scalarUs >= 0.0);
+	std::printf("  Scalar: %.2f us per 1024 tiles\n", scalarUs);
+#if defined(DEATH_ENABLE_SSE2)
+	if (features & Death::Cpu::Sse2) {
+		double sse2Us = measure(isAnyMaskRowSolidImplementation(Death::Cpu::Sse2));
+		TEST_VERIFY(sse2Us >= 0.0);
+		std::printf("  SSE2: %.2f us per 1024 tiles\n", sse2Us);
+	}
+#endif
+#if defined(DEATH_ENABLE_AVX2)
+	if (features & Death::Cpu::Avx2) {
+		double avx2Us = measure(isAnyMaskRowSolidImplementation(Death::Cpu::Avx2));
+		TEST_VERIFY(avx2Us >= 0.0);
+		std::printf("  AVX2: %.2f us per 1024 tiles\n", avx2Us);
+	}
+#endif
+	return true;
+}
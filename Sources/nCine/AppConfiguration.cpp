@@ -15,6 +15,8 @@ namespace nCine
 		resolution(0, 0),
 		windowPosition(WindowPositionIgnore, WindowPositionIgnore),
 		frameLimit(0),
+		fixedTickRate(0),
+		maxCatchUpTicks(5),
 		frameTimerLogInterval(5.0f),
 		fullscreen(false),
 		resizable(true),
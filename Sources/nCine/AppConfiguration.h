@@ -29,6 +29,10 @@ namespace nCine
 		
 		/** @brief Maximum number of frames to render per second or 0 for no limit */
 		std::uint32_t frameLimit;
+		/** @brief Number of fixed-length simulation ticks per second or 0 to use variable frame time, @ref frameLimit is ignored if enabled */
+		std::uint32_t fixedTickRate;
+		/** @brief Maximum number of missed ticks that are processed back-to-back before the rest is dropped */
+		std::uint32_t maxCatchUpTicks;
 
 		/** @brief Interval for frame timer accumulation average and log */
 		float frameTimerLogInterval;
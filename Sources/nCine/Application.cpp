@@ -649,7 +649,7 @@ static void AppendMessageColor(char* dest, std::int32_t& length, TraceLevel leve
 namespace nCine
 {
 	Application::Application()
-		: isSuspended_(false), autoSuspension_(false), hasFocus_(true), shouldQuit_(false)
+		: isSuspended_(false), autoSuspension_(false), hasFocus_(true), shouldQuit_(false), nextTickTime_(0)
 #if defined(DEATH_TRACE)
 			, _mainThreadId(Death::Trace::Implementation::GetNativeThreadId())
 #endif
@@ -685,6 +685,21 @@ namespace nCine
 		return *frameTimer_;
 	}
 
+	void Application::SetFixedTickRate(std::uint32_t tickRate)
+	{
+		if (appCfg_.fixedTickRate == tickRate) {
+			return;
+		}
+
+		appCfg_.fixedTickRate = tickRate;
+		nextTickTime_ = 0;
+		tickHistogram_.Reset();
+
+		if (tickRate > 0) {
+			LOGI("Running simulation at fixed rate of {} ticks per second", tickRate);
+		}
+	}
+
 	void Application::ResizeScreenViewport(std::int32_t width, std::int32_t height)
 	{
 		if (screenViewport_ != nullptr) {
@@ -834,7 +849,13 @@ namespace nCine
 
 	void Application::Step()
 	{
-		frameTimer_->AddFrame();
+		if (appCfg_.fixedTickRate > 0) {
+			WaitForNextTick();
+			// Time multiplier stays 1.0 at the default rate, so the simulation is advanced by the same amount of time every tick
+			frameTimer_->AddFixedFrame(FrameTimer::FramesPerSecond / float(appCfg_.fixedTickRate));
+		} else {
+			frameTimer_->AddFrame();
+		}
 
 #if defined(WITH_IMGUI)
 		if (appCfg_.withGraphics) {
@@ -973,7 +994,11 @@ namespace nCine
 			TracyGpuCollect;
 		}
 
-		if (appCfg_.frameLimit > 0) {
+		if (appCfg_.fixedTickRate > 0) {
+			const std::uint64_t frequency = clock().frequency();
+			const std::uint64_t tickDurationUs = (frameTimer_->GetFrameDurationAsTicks() * 1'000'000ULL) / frequency;
+			tickHistogram_.AddTick(tickDurationUs, 1'000'000ULL / appCfg_.fixedTickRate);
+		} else if (appCfg_.frameLimit > 0) {
 			FrameMarkStart("Frame limiting");
 			const std::int64_t frameTimeDuration = clock().frequency() / appCfg_.frameLimit;
 
@@ -1025,6 +1050,62 @@ namespace nCine
 		}
 	}
 
+	void Application::WaitForNextTick()
+	{
+		const std::uint64_t frequency = clock().frequency();
+		const std::uint64_t tickDuration = frequency / appCfg_.fixedTickRate;
+		std::uint64_t now = clock().now();
+
+		if (nextTickTime_ == 0) {
+			nextTickTime_ = now;
+		} else if (now >= nextTickTime_) {
+			// Missed ticks are processed back-to-back without sleeping, but only up to a limit,
+			// otherwise a single long stall would be followed by a burst of ticks
+			const std::uint64_t missedTicks = (now - nextTickTime_) / tickDuration;
+			if (missedTicks > appCfg_.maxCatchUpTicks) {
+				const std::uint64_t droppedTicks = missedTicks - appCfg_.maxCatchUpTicks;
+				nextTickTime_ += droppedTicks * tickDuration;
+				tickHistogram_.AddDroppedTicks(droppedTicks);
+				LOGW("Simulation is running behind, dropped {} ticks ({:.1} ms)", droppedTicks, (droppedTicks * tickDuration * 1000.0) / frequency);
+			}
+		} else {
+			FrameMarkStart("Waiting for tick");
+			// Sleep until the absolute deadline, so the error doesn't accumulate over ticks
+			do {
+				const std::int64_t remainingTimeNs = (std::int64_t)(((nextTickTime_ - now) * 1'000'000'000ULL) / frequency);
+#if defined(DEATH_TARGET_WINDOWS)
+				LARGE_INTEGER dueTime;
+				dueTime.QuadPart = -std::max(remainingTimeNs / 100, (std::int64_t)1);
+
+				::SetWaitableTimer(_waitableTimer, &dueTime, 0, NULL, NULL, FALSE);
+				::WaitForSingleObject(_waitableTimer, 1000);
+				::CancelWaitableTimer(_waitableTimer);
+#elif defined(DEATH_TARGET_APPLE)
+				timespec dueTime{};
+				dueTime.tv_sec = remainingTimeNs / 1'000'000'000LL;
+				dueTime.tv_nsec = remainingTimeNs % 1'000'000'000LL;
+				nanosleep(&dueTime, nullptr);
+#elif defined(DEATH_TARGET_UNIX)
+				timespec dueTime;
+				clock_gettime(CLOCK_MONOTONIC, &dueTime);
+				dueTime.tv_sec += remainingTimeNs / 1'000'000'000LL;
+				dueTime.tv_nsec += remainingTimeNs % 1'000'000'000LL;
+				if (dueTime.tv_nsec >= 1'000'000'000L) {
+					dueTime.tv_sec += dueTime.tv_nsec / 1'000'000'000L;
+					dueTime.tv_nsec %= 1'000'000'000L;
+				}
+				clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &dueTime, nullptr);
+#else
+				Thread::Sleep((std::uint32_t)std::max(remainingTimeNs / 1'000'000LL, (std::int64_t)1));
+#endif
+				now = clock().now();
+			} while (now < nextTickTime_);
+			FrameMarkEnd("Waiting for tick");
+		}
+
+		nextTickTime_ += tickDuration;
+	}
+
 	void Application::ShutdownCommon()
 	{
 		ZoneScopedC(0x81A861);
@@ -1335,6 +1416,8 @@ namespace nCine
 #endif
 
 		DEATH_UNUSED TimeStamp suspensionDuration = frameTimer_->Resume();
+		// Don't try to catch up with ticks missed during suspension
+		nextTickTime_ = 0;
 		LOGD("Suspended for {:.3} seconds", suspensionDuration.seconds());
 #if defined(NCINE_PROFILING)
 		profileStartTime_ += suspensionDuration;
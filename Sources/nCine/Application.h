@@ -4,6 +4,7 @@
 #include "Graphics/IGfxDevice.h"
 #include "Graphics/IDebugOverlay.h"
 #include "AppConfiguration.h"
+#include "Base/TickHistogram.h"
 #include "Base/TimeStamp.h"
 
 #include <memory>
@@ -131,6 +132,12 @@ namespace nCine
 		float GetTimeMult() const;
 		/** @brief Returns the frame timer interface */
 		const FrameTimer& GetFrameTimer() const;
+		/** @brief Sets number of fixed-length simulation ticks per second, see @ref AppConfiguration::fixedTickRate */
+		void SetFixedTickRate(std::uint32_t tickRate);
+		/** @brief Returns histogram of tick durations if fixed-rate simulation is enabled */
+		inline const TickHistogram& GetTickHistogram() const { return tickHistogram_; }
+		/** @brief Schedules the next fixed-rate tick immediately without catching up with missed ticks, e.g. after an intentional pause */
+		inline void RestartTickSchedule() { nextTickTime_ = 0; }
 
 		/** @brief Returns the drawable screen width as an integer number */
 		inline std::int32_t GetWidth() const { return gfxDevice_->drawableWidth(); }
@@ -220,6 +227,8 @@ namespace nCine
 
 		TimeStamp profileStartTime_;
 		std::unique_ptr<FrameTimer> frameTimer_;
+		std::uint64_t nextTickTime_;
+		TickHistogram tickHistogram_;
 		std::unique_ptr<IGfxDevice> gfxDevice_;
 		std::unique_ptr<SceneNode> rootNode_;
 		std::unique_ptr<ScreenViewport> screenViewport_;
@@ -243,6 +252,8 @@ namespace nCine
 		void InitCommon();
 		/** @brief Processes a single step of the game loop and renders a frame */
 		void Step();
+		/** @brief Sleeps until the deadline of the next fixed-rate tick, missed ticks are processed immediately */
+		void WaitForNextTick();
 		/** @brief Must be called before exiting to shut down the application */
 		void ShutdownCommon();
 
@@ -56,6 +56,16 @@ namespace nCine
 		}
 	}
 
+	void FrameTimer::AddFixedFrame(float timeMult)
+	{
+		AddFrame();
+
+		// Every tick advances the simulation by the same amount of time, so no smoothing is needed
+		_timeMults[0] = timeMult;
+		_timeMults[1] = timeMult;
+		_timeMults[2] = timeMult;
+	}
+
 	void FrameTimer::Suspend()
 	{
 		_suspensionStart = TimeStamp::now();
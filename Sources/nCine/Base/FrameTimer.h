@@ -18,6 +18,8 @@ namespace nCine
 
 		/// Adds a frame to the counter and calculates the interval since the previous one
 		void AddFrame();
+		/// Adds a frame of a fixed-rate simulation, the time multiplier is not derived from the measured interval
+		void AddFixedFrame(float timeMult);
 
 		/// Starts counting the suspension time
 		void Suspend();
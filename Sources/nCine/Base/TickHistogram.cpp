@@ -0,0 +1,75 @@
+#include "TickHistogram.h"
+
+#include <algorithm>
+
+namespace nCine
+{
+	namespace
+	{
+		// Upper bounds are denser around common tick budgets (16.7 ms for 60 Hz, 33.3 ms for 30 Hz)
+		static constexpr std::uint32_t BucketUpperBoundsUs[TickHistogram::BucketCount - 1] = {
+			250, 500, 1000, 2000, 4000, 8000, 12000, 16667, 25000, 33333, 50000
+		};
+	}
+
+	TickHistogram::TickHistogram()
+	{
+		Reset();
+	}
+
+	std::uint32_t TickHistogram::GetBucketUpperBoundUs(std::int32_t index)
+	{
+		return (index < BucketCount - 1 ? BucketUpperBoundsUs[index] : UINT32_MAX);
+	}
+
+	void TickHistogram::AddTick(std::uint64_t durationUs, std::uint64_t budgetUs)
+	{
+		std::int32_t index = 0;
+		while (index < BucketCount - 1 && durationUs > BucketUpperBoundsUs[index]) {
+			index++;
+		}
+
+		_buckets[index]++;
+		_totalCount++;
+		_totalDurationUs += durationUs;
+		if (_maxDurationUs < durationUs) {
+			_maxDurationUs = durationUs;
+		}
+		if (durationUs > budgetUs) {
+			_overrunCount++;
+		}
+	}
+
+	void TickHistogram::AddDroppedTicks(std::uint64_t count)
+	{
+		_droppedCount += count;
+	}
+
+	void TickHistogram::Reset()
+	{
+		std::fill_n(_buckets, BucketCount, std::uint64_t(0));
+		_totalCount = 0;
+		_totalDurationUs = 0;
+		_maxDurationUs = 0;
+		_overrunCount = 0;
+		_droppedCount = 0;
+	}
+
+	std::uint32_t TickHistogram::GetPercentileUs(float percentile) const
+	{
+		if (_totalCount == 0) {
+			return 0;
+		}
+
+		// Report the upper bound of the bucket that contains the requested rank, the last bucket is capped by the maximum
+		const std::uint64_t rank = std::uint64_t(std::clamp(percentile, 0.0f, 1.0f) * float(_totalCount - 1)) + 1;
+		std::uint64_t count = 0;
+		for (std::int32_t i = 0; i < BucketCount - 1; i++) {
+			count += _buckets[i];
+			if (count >= rank) {
+				return std::min(BucketUpperBoundsUs[i], std::uint32_t(_maxDurationUs));
+			}
+		}
+		return std::uint32_t(std::min(_maxDurationUs, std::uint64_t(UINT32_MAX)));
+	}
+}
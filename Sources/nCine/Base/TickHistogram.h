@@ -0,0 +1,62 @@
+#pragma once
+
+#include "../../Main.h"
+
+namespace nCine
+{
+	/// Histogram of fixed-rate simulation tick durations
+	class TickHistogram
+	{
+	public:
+		/// Number of histogram buckets, the last bucket has no upper bound
+		static constexpr std::int32_t BucketCount = 12;
+
+		TickHistogram();
+
+		/// Returns the upper bound of the specified bucket in microseconds or `UINT32_MAX` for the last bucket
+		static std::uint32_t GetBucketUpperBoundUs(std::int32_t index);
+
+		/// Records a tick that took the specified time to process
+		void AddTick(std::uint64_t durationUs, std::uint64_t budgetUs);
+		/// Records ticks that were dropped because the simulation couldn't keep up
+		void AddDroppedTicks(std::uint64_t count);
+		/// Clears all recorded values
+		void Reset();
+
+		/// Returns the number of ticks recorded in the specified bucket
+		inline std::uint64_t GetBucketCount(std::int32_t index) const {
+			return _buckets[index];
+		}
+		/// Returns the total number of recorded ticks
+		inline std::uint64_t GetTotalCount() const {
+			return _totalCount;
+		}
+		/// Returns the sum of all recorded tick durations in microseconds
+		inline std::uint64_t GetTotalDurationUs() const {
+			return _totalDurationUs;
+		}
+		/// Returns the longest recorded tick duration in microseconds
+		inline std::uint64_t GetMaxDurationUs() const {
+			return _maxDurationUs;
+		}
+		/// Returns the number of ticks that took longer than the tick budget
+		inline std::uint64_t GetOverrunCount() const {
+			return _overrunCount;
+		}
+		/// Returns the number of ticks dropped because the simulation couldn't keep up
+		inline std::uint64_t GetDroppedCount() const {
+			return _droppedCount;
+		}
+
+		/// Returns an estimated tick duration in microseconds below which the specified fraction of ticks falls
+		std::uint32_t GetPercentileUs(float percentile) const;
+
+	private:
+		std::uint64_t _buckets[BucketCount];
+		std::uint64_t _totalCount;
+		std::uint64_t _totalDurationUs;
+		std::uint64_t _maxDurationUs;
+		std::uint64_t _overrunCount;
+		std::uint64_t _droppedCount;
+	};
+}
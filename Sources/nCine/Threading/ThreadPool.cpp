@@ -11,15 +11,15 @@ namespace nCine
 	}
 
 	ThreadPool::ThreadPool(std::size_t numThreads)
-		: threads_(numThreads), numThreads_(numThreads)
+		: numThreads_(numThreads)
 	{
+		threads_.reserve(numThreads_);
+
 		threadStruct_.queue = &queue_;
 		threadStruct_.queueMutex = &queueMutex_;
 		threadStruct_.queueCV = &queueCV_;
 		threadStruct_.shouldQuit = false;
 
-		quitMutex_.Lock();
-
 		for (std::size_t i = 0; i < numThreads_; i++) {
 			threads_.emplace_back(WorkerFunction, &threadStruct_);
 		}
@@ -27,8 +27,11 @@ namespace nCine
 
 	ThreadPool::~ThreadPool()
 	{
+		// The flag must be set under the lock, otherwise a worker could miss the wake-up before starting to wait
+		queueMutex_.Lock();
 		threadStruct_.shouldQuit = true;
 		queueCV_.Broadcast();
+		queueMutex_.Unlock();
 
 		for (std::size_t i = 0; i < numThreads_; i++) {
 			threads_[i].Join();
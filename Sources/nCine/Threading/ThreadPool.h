@@ -41,7 +41,6 @@ namespace nCine
 		SmallVector<Thread, 0> threads_;
 		Mutex queueMutex_;
 		CondVariable queueCV_;
-		Mutex quitMutex_;
 		std::size_t numThreads_;
 
 		ThreadStruct threadStruct_;
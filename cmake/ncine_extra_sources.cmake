@@ -715,12 +715,18 @@ if(WITH_MULTIPLAYER)
 		${NCINE_SOURCE_DIR}/Jazz2/Actors/Multiplayer/RemotablePlayer.h
 		${NCINE_SOURCE_DIR}/Jazz2/Actors/Multiplayer/RemoteActor.h
 		${NCINE_SOURCE_DIR}/Jazz2/Actors/Multiplayer/RemotePlayerOnServer.h
+		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/ActorSnapshot.h
+		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/AssetStreamer.h
+		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/BitStream.h
 		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/ConnectionResult.h
 		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/INetworkHandler.h
+		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/MetricsRegistry.h
 		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/MpGameMode.h
 		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/MpLevelHandler.h
 		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/NetworkManager.h
 		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/NetworkManagerBase.h
+		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/PacketCapture.h
+		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/PacketCodec.h
 		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/PacketTypes.h
 		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/Peer.h
 		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/PeerDescriptor.h
@@ -743,10 +749,15 @@ if(WITH_MULTIPLAYER)
 		${NCINE_SOURCE_DIR}/Jazz2/Actors/Multiplayer/RemotablePlayer.cpp
 		${NCINE_SOURCE_DIR}/Jazz2/Actors/Multiplayer/RemoteActor.cpp
 		${NCINE_SOURCE_DIR}/Jazz2/Actors/Multiplayer/RemotePlayerOnServer.cpp
+		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/ActorSnapshot.cpp
+		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/AssetStreamer.cpp
 		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/ConnectionResult.cpp
+		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/MetricsRegistry.cpp
 		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/MpLevelHandler.cpp
 		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/NetworkManager.cpp
 		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/NetworkManagerBase.cpp
+		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/PacketCapture.cpp
+		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/PacketCodec.cpp
 		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/Peer.cpp
 		${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/ServerDiscovery.cpp
 		${NCINE_SOURCE_DIR}/Jazz2/UI/Menu/CreateServerOptionsSection.cpp
@@ -18,6 +18,7 @@ set(HEADERS
 	${NCINE_SOURCE_DIR}/Shared/Base/TypeInfo.h
 	${NCINE_SOURCE_DIR}/Shared/Containers/Array.h
 	${NCINE_SOURCE_DIR}/Shared/Containers/ArrayView.h
+	${NCINE_SOURCE_DIR}/Shared/Containers/BoundedSPSCQueue.h
 	${NCINE_SOURCE_DIR}/Shared/Containers/Containers.h
 	${NCINE_SOURCE_DIR}/Shared/Containers/DateTime.h
 	${NCINE_SOURCE_DIR}/Shared/Containers/Function.h
@@ -105,6 +106,7 @@ list(APPEND HEADERS
 	${NCINE_SOURCE_DIR}/nCine/Base/StaticHashMap.h
 	${NCINE_SOURCE_DIR}/nCine/Base/StaticHashMapIterator.h
 	${NCINE_SOURCE_DIR}/nCine/Base/Task.h
+	${NCINE_SOURCE_DIR}/nCine/Base/TickHistogram.h
 	${NCINE_SOURCE_DIR}/nCine/Base/Timer.h
 	${NCINE_SOURCE_DIR}/nCine/Base/TimeStamp.h
 	${NCINE_SOURCE_DIR}/nCine/Graphics/AnimatedSprite.h
@@ -201,7 +203,9 @@ list(APPEND HEADERS
 	${NCINE_SOURCE_DIR}/TermLogo.h
 	${NCINE_SOURCE_DIR}/Jazz2/AnimationLoopMode.h
 	${NCINE_SOURCE_DIR}/Jazz2/AnimState.h
+	${NCINE_SOURCE_DIR}/Jazz2/CollisionMaskCache.h
 	${NCINE_SOURCE_DIR}/Jazz2/ContentResolver.h
+	${NCINE_SOURCE_DIR}/Jazz2/ContentResolver.Pixels.h
 	${NCINE_SOURCE_DIR}/Jazz2/ContentResolver.Shaders.h
 	${NCINE_SOURCE_DIR}/Jazz2/Direction.h
 	${NCINE_SOURCE_DIR}/Jazz2/EventType.h
@@ -335,6 +339,7 @@ list(APPEND HEADERS
 	${NCINE_SOURCE_DIR}/Jazz2/Actors/Weapons/Thunderbolt.h
 	${NCINE_SOURCE_DIR}/Jazz2/Actors/Weapons/ToasterShot.h
 	${NCINE_SOURCE_DIR}/Jazz2/Actors/Weapons/TNT.h
+	${NCINE_SOURCE_DIR}/Jazz2/Collisions/CollisionDispatch.h
 	${NCINE_SOURCE_DIR}/Jazz2/Collisions/DynamicTree.h
 	${NCINE_SOURCE_DIR}/Jazz2/Collisions/DynamicTreeBroadPhase.h
 	${NCINE_SOURCE_DIR}/Jazz2/Compatibility/AnimSetMapping.h
@@ -375,6 +380,7 @@ list(APPEND HEADERS
 	${NCINE_SOURCE_DIR}/Jazz2/Tiles/TileCollisionParams.h
 	${NCINE_SOURCE_DIR}/Jazz2/Tiles/TileDestructType.h
 	${NCINE_SOURCE_DIR}/Jazz2/Tiles/TileMap.h
+	${NCINE_SOURCE_DIR}/Jazz2/Tiles/TileMaskRows.h
 	${NCINE_SOURCE_DIR}/Jazz2/Tiles/TileSet.h
 	${NCINE_SOURCE_DIR}/Jazz2/UI/Canvas.h
 	${NCINE_SOURCE_DIR}/Jazz2/UI/Cinematics.h
@@ -8,6 +8,7 @@ option(NCINE_LINKTIME_OPTIMIZATION "Compile the game with link time optimization
 option(NCINE_AUTOVECTORIZATION_REPORT "Enable report generation from compiler auto-vectorization" OFF)
 option(NCINE_EMBED_SHADERS "Embed shader files in executable" ON)
 option(NCINE_STRIP_BINARIES "Enable symbols stripping from libraries and executables when in release" OFF)
+option(NCINE_BUILD_TESTS "Build self-check executable for optimized code paths" OFF)
 option(NCINE_VERSION_FROM_GIT "Try to set current game version from GIT repository" ON)
 #cmake_dependent_option(NCINE_DYNAMIC_LIBRARY "Compile the engine as a dynamic library" OFF "NOT EMSCRIPTEN" OFF)
 
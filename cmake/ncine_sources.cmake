@@ -47,6 +47,7 @@ list(APPEND SOURCES
 	${NCINE_SOURCE_DIR}/nCine/Base/HashFunctions.cpp
 	${NCINE_SOURCE_DIR}/nCine/Base/Object.cpp
 	${NCINE_SOURCE_DIR}/nCine/Base/Random.cpp
+	${NCINE_SOURCE_DIR}/nCine/Base/TickHistogram.cpp
 	${NCINE_SOURCE_DIR}/nCine/Base/Timer.cpp
 	${NCINE_SOURCE_DIR}/nCine/Base/TimeStamp.cpp
 	${NCINE_SOURCE_DIR}/nCine/Graphics/AnimatedSprite.cpp
@@ -120,6 +121,7 @@ list(APPEND SOURCES
 
 list(APPEND SOURCES
 	${NCINE_SOURCE_DIR}/Main.cpp
+	${NCINE_SOURCE_DIR}/Jazz2/CollisionMaskCache.cpp
 	${NCINE_SOURCE_DIR}/Jazz2/ContentResolver.cpp
 	${NCINE_SOURCE_DIR}/Jazz2/LevelHandler.cpp
 	${NCINE_SOURCE_DIR}/Jazz2/LevelInitialization.cpp
@@ -0,0 +1,40 @@
+# Self-check executable for optimized code paths, compiled from a small subset of game sources
+set(NCINE_TESTS_APP ${NCINE_APP}_tests)
+
+add_executable(${NCINE_TESTS_APP}
+	${NCINE_SOURCE_DIR}/Tests/Main.cpp
+	${NCINE_SOURCE_DIR}/Tests/CollisionQueryTests.cpp
+	${NCINE_SOURCE_DIR}/Tests/PacketCodecTests.cpp
+	${NCINE_SOURCE_DIR}/Tests/PixelKernelTests.cpp
+	${NCINE_SOURCE_DIR}/Tests/TileMaskTests.cpp
+	${NCINE_SOURCE_DIR}/Jazz2/Collisions/DynamicTree.cpp
+	${NCINE_SOURCE_DIR}/Jazz2/Collisions/DynamicTreeBroadPhase.cpp
+	${NCINE_SOURCE_DIR}/Jazz2/Multiplayer/PacketCodec.cpp
+	${NCINE_SOURCE_DIR}/nCine/Base/Clock.cpp
+	${NCINE_SOURCE_DIR}/nCine/Base/Random.cpp
+	${NCINE_SOURCE_DIR}/Shared/Cpu.cpp
+	${NCINE_SOURCE_DIR}/Shared/Containers/SmallVector.cpp
+	${NCINE_SOURCE_DIR}/Shared/IO/Compression/DeflateStream.cpp
+	${NCINE_SOURCE_DIR}/Shared/IO/MemoryStream.cpp
+	${NCINE_SOURCE_DIR}/Shared/IO/Stream.cpp
+)
+
+target_compile_features(${NCINE_TESTS_APP} PUBLIC cxx_std_17)
+set_target_properties(${NCINE_TESTS_APP} PROPERTIES CXX_EXTENSIONS OFF)
+target_include_directories(${NCINE_TESTS_APP} PRIVATE "${NCINE_SOURCE_DIR}/Shared")
+target_compile_definitions(${NCINE_TESTS_APP} PRIVATE "CMAKE_BUILD" "WITH_MULTIPLAYER")
+
+if(DEATH_CPU_USE_RUNTIME_DISPATCH)
+	target_compile_definitions(${NCINE_TESTS_APP} PRIVATE "DEATH_CPU_USE_RUNTIME_DISPATCH")
+	if(DEATH_CPU_USE_IFUNC)
+		target_compile_definitions(${NCINE_TESTS_APP} PRIVATE "DEATH_CPU_USE_IFUNC")
+	endif()
+endif()
+
+if(ZLIB_FOUND)
+	target_compile_definitions(${NCINE_TESTS_APP} PRIVATE "WITH_ZLIB")
+	target_link_libraries(${NCINE_TESTS_APP} PRIVATE ZLIB::ZLIB)
+endif()
+
+enable_testing()
+add_test(NAME ${NCINE_TESTS_APP} COMMAND ${NCINE_TESTS_APP})